@@ -0,0 +1,256 @@
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/program_options.hpp>
+#include "server/TlsStream.h"
+
+// echo round trips over loopback, built as IoBenchmark (epoll) and IoBenchmarkIoUring (see WITH_BENCHMARKS in CMakeLists.txt)
+
+#if defined(BOOST_ASIO_HAS_IO_URING) && defined(BOOST_ASIO_DISABLE_EPOLL)
+constexpr auto IO_BACKEND{ "io_uring" };
+#elif defined(__linux__)
+constexpr auto IO_BACKEND{ "epoll" };
+#else
+constexpr auto IO_BACKEND{ "native" };
+#endif
+
+constexpr auto MODE_SOCKET{ "socket" };
+constexpr auto MODE_STREAM{ "stream" };
+
+struct BenchmarkConfig final
+{
+    std::string mode;
+    int connections{ 0 };
+    int roundTrips{ 0 };
+    size_t messageSize{ 0 };
+    int threads{ 0 };
+};
+
+// echoes everything it reads; Stream is the Asio socket itself or the server's plaintext TlsStream
+template<typename Stream>
+class EchoSession final : public std::enable_shared_from_this<EchoSession<Stream>>
+{
+public:
+    EchoSession(std::unique_ptr<Stream> stream, size_t messageSize) :
+        stream_{ std::move(stream) },
+        buffer_(messageSize)
+    {
+    }
+
+    void start()
+    {
+        stream_->async_read_some(boost::asio::buffer(buffer_), [self = this->shared_from_this()](const boost::system::error_code& ec, size_t size)
+        {
+            if (ec)
+            {
+                return;
+            }
+
+            boost::asio::async_write(*self->stream_, boost::asio::buffer(self->buffer_.data(), size), [self](const boost::system::error_code& ec, size_t)
+            {
+                if (!ec)
+                {
+                    self->start();
+                }
+            });
+        });
+    }
+
+private:
+    std::unique_ptr<Stream> stream_;
+    std::vector<char> buffer_;
+};
+
+// sends a message and waits for its echo, one round trip after the other
+class EchoClient final : public std::enable_shared_from_this<EchoClient>
+{
+public:
+    EchoClient(boost::asio::io_context& ioc, size_t messageSize, int roundTrips, std::atomic<int>& failures) :
+        socket_{ ioc },
+        message_(messageSize, 'x'),
+        reply_(messageSize),
+        remaining_{ roundTrips },
+        failures_{ failures }
+    {
+    }
+
+    void start(const boost::asio::ip::tcp::endpoint& endpoint)
+    {
+        socket_.async_connect(endpoint, [self = shared_from_this()](const boost::system::error_code& ec)
+        {
+            if (ec)
+            {
+                self->fail(ec);
+                return;
+            }
+
+            self->socket_.set_option(boost::asio::ip::tcp::no_delay(true));
+            self->doRoundTrip();
+        });
+    }
+
+private:
+    void doRoundTrip()
+    {
+        boost::asio::async_write(socket_, boost::asio::buffer(message_), [self = shared_from_this()](const boost::system::error_code& ec, size_t)
+        {
+            if (ec)
+            {
+                self->fail(ec);
+                return;
+            }
+
+            boost::asio::async_read(self->socket_, boost::asio::buffer(self->reply_), [self](const boost::system::error_code& ec, size_t)
+            {
+                if (ec)
+                {
+                    self->fail(ec);
+                    return;
+                }
+
+                if (--self->remaining_ > 0)
+                {
+                    self->doRoundTrip();
+                    return;
+                }
+
+                boost::system::error_code closeEc{};
+                self->socket_.close(closeEc);
+            });
+        });
+    }
+
+    void fail(const boost::system::error_code& ec)
+    {
+        std::cerr << "Client error: " << ec.message() << std::endl;
+        ++failures_;
+    }
+
+    boost::asio::ip::tcp::socket socket_;
+    std::string message_;
+    std::vector<char> reply_;
+    int remaining_;
+    std::atomic<int>& failures_;
+};
+
+void doAccept(boost::asio::ip::tcp::acceptor& acceptor, const BenchmarkConfig& config, int remaining)
+{
+    if (remaining == 0)
+    {
+        return;
+    }
+
+    acceptor.async_accept([&acceptor, &config, remaining](const boost::system::error_code& ec, boost::asio::ip::tcp::socket socket)
+    {
+        if (ec)
+        {
+            std::cerr << "Accept error: " << ec.message() << std::endl;
+            return;
+        }
+
+        socket.set_option(boost::asio::ip::tcp::no_delay(true));
+
+        if (config.mode == MODE_STREAM)
+        {
+            std::make_shared<EchoSession<server::TlsStream>>(std::make_unique<server::TlsStream>(std::move(socket)), config.messageSize)->start();
+        }
+        else
+        {
+            std::make_shared<EchoSession<boost::asio::ip::tcp::socket>>(std::make_unique<boost::asio::ip::tcp::socket>(std::move(socket)), config.messageSize)->start();
+        }
+
+        doAccept(acceptor, config, remaining - 1);
+    });
+}
+
+[[nodiscard]] BenchmarkConfig parseCommandLine(int argc, char* argv[])
+{
+    namespace po = boost::program_options;
+
+    BenchmarkConfig config{};
+
+    po::options_description desc{ "I/O Backend Benchmark Options" };
+    desc.add_options()
+        ("help,h", "Show this help message")
+        ("mode,m", po::value<std::string>(&config.mode)->default_value(MODE_STREAM),
+            "Server side of the echo: 'stream' reads and writes through the plaintext TlsStream like the server, 'socket' through Asio's socket operations")
+        ("connections,c", po::value<int>(&config.connections)->default_value(64), "Number of concurrent connections")
+        ("round-trips,n", po::value<int>(&config.roundTrips)->default_value(10000), "Round trips per connection")
+        ("size,s", po::value<size_t>(&config.messageSize)->default_value(256), "Message size in bytes")
+        ("threads,t", po::value<int>(&config.threads)->default_value(1), "Number of threads running the I/O context");
+
+    po::variables_map vm{};
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help"))
+    {
+        std::cout << "Measures echo round trips over loopback with the I/O backend this binary is built for\n\n";
+        std::cout << "Usage: " << argv[0] << " [OPTIONS]\n\n";
+        std::cout << desc << "\n";
+        exit(0);
+    }
+
+    if ((config.mode != MODE_STREAM && config.mode != MODE_SOCKET) || config.connections < 1 || config.roundTrips < 1 || config.messageSize == 0 || config.threads < 1)
+    {
+        throw po::error{ "invalid option value, see --help" };
+    }
+
+    return config;
+}
+
+int main(int argc, char* argv[]) noexcept
+{
+    try
+    {
+        const auto config{ parseCommandLine(argc, argv) };
+
+        boost::asio::io_context ioc{ config.threads };
+        boost::asio::ip::tcp::acceptor acceptor{ ioc, { boost::asio::ip::make_address("127.0.0.1"), 0 } };
+        std::atomic<int> failures{ 0 };
+
+        doAccept(acceptor, config, config.connections);
+
+        for (auto i{ 0 }; i < config.connections; ++i)
+        {
+            std::make_shared<EchoClient>(ioc, config.messageSize, config.roundTrips, failures)->start(acceptor.local_endpoint());
+        }
+
+        // clients and echo sessions share the I/O context, so both sides run on the backend under test
+        const auto start{ std::chrono::steady_clock::now() };
+
+        std::vector<std::thread> threads{};
+        for (auto i{ 1 }; i < config.threads; ++i)
+        {
+            threads.emplace_back([&ioc]() { ioc.run(); });
+        }
+
+        ioc.run();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+        const auto total{ static_cast<double>(config.connections) * config.roundTrips };
+
+        std::cout << std::format("backend: {}, mode: {}, connections: {}, message size: {} B, threads: {}\n",
+            IO_BACKEND, config.mode, config.connections, config.messageSize, config.threads);
+        std::cout << std::format("{:.0f} round trips in {:.3f} s: {:.0f} round trips/s, {:.1f} us per round trip and connection\n",
+            total, elapsed.count(), total / elapsed.count(), elapsed.count() * 1e6 / config.roundTrips);
+
+        return failures == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
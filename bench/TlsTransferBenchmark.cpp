@@ -0,0 +1,423 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/program_options.hpp>
+#include "server/TlsStream.h"
+
+// bulk transfer of a file over TLS on loopback: Beast's ssl_stream, TlsStream with SSL_write, and TlsStream with kernel TLS and SSL_sendfile
+
+constexpr auto MODE_BEAST{ "beast" };
+constexpr auto MODE_TLS{ "tls" };
+constexpr auto MODE_KTLS{ "ktls" };
+constexpr size_t CHUNK_SIZE{ 64 * 1024 };
+constexpr size_t BYTES_PER_MIB{ 1024 * 1024 };
+
+struct BenchmarkConfig final
+{
+    std::string mode;
+    int connections{ 0 };
+    size_t fileSize{ 0 };
+    int threads{ 0 };
+};
+
+struct BenchmarkResult final
+{
+    std::atomic<int> failures{ 0 };
+    std::atomic<int> kernelTlsConnections{ 0 };
+};
+
+// generates a throwaway self-signed certificate, so the benchmark needs no files
+void useSelfSignedCertificate(SSL_CTX* context)
+{
+    auto* const key{ EVP_EC_gen("P-256") };
+    auto* const certificate{ X509_new() };
+
+    X509_set_version(certificate, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+    X509_gmtime_adj(X509_getm_notAfter(certificate), 3600);
+    X509_set_pubkey(certificate, key);
+    X509_NAME_add_entry_by_txt(X509_get_subject_name(certificate), "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(certificate, X509_get_subject_name(certificate));
+    X509_sign(certificate, key, EVP_sha256());
+
+    SSL_CTX_use_certificate(context, certificate);
+    SSL_CTX_use_PrivateKey(context, key);
+
+    X509_free(certificate);
+    EVP_PKEY_free(key);
+}
+
+// sends the whole file after the handshake, in chunks read from disk or with sendfile when kernel TLS is active
+template<typename Stream>
+class FileSender final : public std::enable_shared_from_this<FileSender<Stream>>
+{
+public:
+    FileSender(std::unique_ptr<Stream> stream, int fileDescriptor, size_t fileSize, BenchmarkResult& result) :
+        stream_{ std::move(stream) },
+        fileDescriptor_{ fileDescriptor },
+        fileSize_{ fileSize },
+        buffer_(CHUNK_SIZE),
+        result_{ result }
+    {
+    }
+
+    void start()
+    {
+        auto onHandshake{ [self = this->shared_from_this()](const boost::system::error_code& ec)
+        {
+            if (ec)
+            {
+                self->fail("Server handshake", ec);
+                return;
+            }
+
+            if constexpr (std::is_same_v<Stream, server::TlsStream>)
+            {
+                if (self->stream_->isKernelSendEnabled())
+                {
+                    ++self->result_.kernelTlsConnections;
+                    self->sendFile();
+                    return;
+                }
+            }
+
+            self->sendChunk();
+        } };
+
+        if constexpr (std::is_same_v<Stream, server::TlsStream>)
+        {
+            stream_->async_handshake(std::move(onHandshake));
+        }
+        else
+        {
+            stream_->async_handshake(boost::asio::ssl::stream_base::server, std::move(onHandshake));
+        }
+    }
+
+private:
+    // SSL_write path: the file is copied to user space and encrypted there
+    void sendChunk()
+    {
+        if (offset_ == fileSize_)
+        {
+            return;
+        }
+
+        const auto size{ ::pread(fileDescriptor_, buffer_.data(), std::min(CHUNK_SIZE, fileSize_ - offset_), static_cast<off_t>(offset_)) };
+        if (size <= 0)
+        {
+            fail("Read file", { errno, boost::system::system_category() });
+            return;
+        }
+
+        boost::asio::async_write(*stream_, boost::asio::buffer(buffer_.data(), static_cast<size_t>(size)),
+            [self = this->shared_from_this()](const boost::system::error_code& ec, size_t bytesTransferred)
+        {
+            if (ec)
+            {
+                self->fail("Server write", ec);
+                return;
+            }
+
+            self->offset_ += bytesTransferred;
+            self->sendChunk();
+        });
+    }
+
+    // SSL_sendfile path: the kernel reads and encrypts the file
+    void sendFile()
+    {
+        if constexpr (std::is_same_v<Stream, server::TlsStream>)
+        {
+            if (offset_ == fileSize_)
+            {
+                return;
+            }
+
+            stream_->async_sendfile(fileDescriptor_, offset_, fileSize_ - offset_,
+                [self = this->shared_from_this()](const boost::system::error_code& ec, size_t bytesTransferred)
+            {
+                if (ec)
+                {
+                    self->fail("Server sendfile", ec);
+                    return;
+                }
+
+                self->offset_ += bytesTransferred;
+                self->sendFile();
+            });
+        }
+    }
+
+    void fail(std::string_view operation, const boost::system::error_code& ec)
+    {
+        std::cerr << operation << " error: " << ec.message() << std::endl;
+        ++result_.failures;
+    }
+
+    std::unique_ptr<Stream> stream_;
+    int fileDescriptor_;
+    size_t fileSize_;
+    size_t offset_{ 0 };
+    std::vector<char> buffer_;
+    BenchmarkResult& result_;
+};
+
+// receives and discards the file
+class FileReceiver final : public std::enable_shared_from_this<FileReceiver>
+{
+public:
+    FileReceiver(boost::asio::io_context& ioc, boost::asio::ssl::context& context, size_t fileSize, BenchmarkResult& result) :
+        stream_{ ioc, context },
+        fileSize_{ fileSize },
+        buffer_(CHUNK_SIZE),
+        result_{ result }
+    {
+    }
+
+    void start(const boost::asio::ip::tcp::endpoint& endpoint)
+    {
+        stream_.next_layer().async_connect(endpoint, [self = shared_from_this()](const boost::system::error_code& ec)
+        {
+            if (ec)
+            {
+                self->fail("Connect", ec);
+                return;
+            }
+
+            self->stream_.async_handshake(boost::asio::ssl::stream_base::client, [self](const boost::system::error_code& ec)
+            {
+                if (ec)
+                {
+                    self->fail("Client handshake", ec);
+                    return;
+                }
+
+                self->receive();
+            });
+        });
+    }
+
+private:
+    void receive()
+    {
+        stream_.async_read_some(boost::asio::buffer(buffer_), [self = shared_from_this()](const boost::system::error_code& ec, size_t size)
+        {
+            if (ec)
+            {
+                self->fail("Client read", ec);
+                return;
+            }
+
+            self->received_ += size;
+            if (self->received_ < self->fileSize_)
+            {
+                self->receive();
+                return;
+            }
+
+            boost::system::error_code closeEc{};
+            self->stream_.next_layer().close(closeEc);
+        });
+    }
+
+    void fail(std::string_view operation, const boost::system::error_code& ec)
+    {
+        std::cerr << operation << " error: " << ec.message() << std::endl;
+        ++result_.failures;
+    }
+
+    boost::asio::ssl::stream<boost::asio::ip::tcp::socket> stream_;
+    size_t fileSize_;
+    size_t received_{ 0 };
+    std::vector<char> buffer_;
+    BenchmarkResult& result_;
+};
+
+void doAccept(boost::asio::ip::tcp::acceptor& acceptor, boost::asio::ssl::context& context, const BenchmarkConfig& config, int fileDescriptor,
+    BenchmarkResult& result, int remaining)
+{
+    if (remaining == 0)
+    {
+        return;
+    }
+
+    acceptor.async_accept([&acceptor, &context, &config, fileDescriptor, &result, remaining](const boost::system::error_code& ec, boost::asio::ip::tcp::socket socket)
+    {
+        if (ec)
+        {
+            std::cerr << "Accept error: " << ec.message() << std::endl;
+            ++result.failures;
+            return;
+        }
+
+        if (config.mode == MODE_BEAST)
+        {
+            using BeastStream = boost::beast::ssl_stream<boost::beast::tcp_stream>;
+            std::make_shared<FileSender<BeastStream>>(std::make_unique<BeastStream>(std::move(socket), context), fileDescriptor, config.fileSize, result)->start();
+        }
+        else
+        {
+            std::make_shared<FileSender<server::TlsStream>>(std::make_unique<server::TlsStream>(std::move(socket), context), fileDescriptor, config.fileSize, result)->start();
+        }
+
+        doAccept(acceptor, context, config, fileDescriptor, result, remaining - 1);
+    });
+}
+
+[[nodiscard]] std::filesystem::path createFile(size_t size)
+{
+    const auto path{ std::filesystem::temp_directory_path() / std::format("tls_transfer_benchmark_{}.bin", ::getpid()) };
+
+    // random bytes, so nothing along the way can take a shortcut on repeated data
+    std::mt19937_64 random{ 42 };
+    std::vector<std::uint64_t> block(CHUNK_SIZE / sizeof(std::uint64_t));
+    std::ofstream file{ path, std::ios::binary };
+
+    for (size_t written{ 0 }; written < size; written += CHUNK_SIZE)
+    {
+        std::ranges::generate(block, std::ref(random));
+        file.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(std::min(CHUNK_SIZE, size - written)));
+    }
+
+    if (!file)
+    {
+        throw std::runtime_error{ "Failed to write " + path.string() };
+    }
+
+    return path;
+}
+
+[[nodiscard]] BenchmarkConfig parseCommandLine(int argc, char* argv[])
+{
+    namespace po = boost::program_options;
+
+    BenchmarkConfig config{};
+    size_t fileSizeMiB{ 0 };
+
+    po::options_description desc{ "TLS Transfer Benchmark Options" };
+    desc.add_options()
+        ("help,h", "Show this help message")
+        ("mode,m", po::value<std::string>(&config.mode)->default_value(MODE_KTLS),
+            "Sending side: 'beast' Beast's ssl_stream with SSL_write, 'tls' TlsStream with kernel TLS off and SSL_write, "
+            "'ktls' TlsStream with SSL_OP_ENABLE_KTLS and SSL_sendfile, falling back to SSL_write where the kernel lacks TLS")
+        ("connections,c", po::value<int>(&config.connections)->default_value(8), "Number of concurrent connections")
+        ("size,s", po::value<size_t>(&fileSizeMiB)->default_value(64), "File size in MiB sent on every connection")
+        ("threads,t", po::value<int>(&config.threads)->default_value(1), "Number of threads running the I/O context");
+
+    po::variables_map vm{};
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help"))
+    {
+        std::cout << "Measures the throughput of sending a file over TLS on loopback\n\n";
+        std::cout << "Usage: " << argv[0] << " [OPTIONS]\n\n";
+        std::cout << desc << "\n";
+        exit(0);
+    }
+
+    if ((config.mode != MODE_BEAST && config.mode != MODE_TLS && config.mode != MODE_KTLS) || config.connections < 1 || fileSizeMiB == 0 || config.threads < 1)
+    {
+        throw po::error{ "invalid option value, see --help" };
+    }
+
+    config.fileSize = fileSizeMiB * BYTES_PER_MIB;
+    return config;
+}
+
+int main(int argc, char* argv[]) noexcept
+{
+    std::filesystem::path filePath{};
+
+    try
+    {
+        const auto config{ parseCommandLine(argc, argv) };
+
+        boost::asio::ssl::context serverContext{ boost::asio::ssl::context::tls_server };
+        useSelfSignedCertificate(serverContext.native_handle());
+
+        // the same switch as ssl.ktls_enabled
+        if (config.mode == MODE_KTLS)
+        {
+            SSL_CTX_set_options(serverContext.native_handle(), SSL_OP_ENABLE_KTLS);
+        }
+        else
+        {
+            SSL_CTX_clear_options(serverContext.native_handle(), SSL_OP_ENABLE_KTLS);
+        }
+
+        boost::asio::ssl::context clientContext{ boost::asio::ssl::context::tls_client };
+        clientContext.set_verify_mode(boost::asio::ssl::verify_none);
+
+        filePath = createFile(config.fileSize);
+        const auto fileDescriptor{ ::open(filePath.c_str(), O_RDONLY) };
+        if (fileDescriptor < 0)
+        {
+            throw std::runtime_error{ "Failed to open " + filePath.string() };
+        }
+
+        boost::asio::io_context ioc{ config.threads };
+        boost::asio::ip::tcp::acceptor acceptor{ ioc, { boost::asio::ip::make_address("127.0.0.1"), 0 } };
+        BenchmarkResult result{};
+
+        doAccept(acceptor, serverContext, config, fileDescriptor, result, config.connections);
+
+        for (auto i{ 0 }; i < config.connections; ++i)
+        {
+            std::make_shared<FileReceiver>(ioc, clientContext, config.fileSize, result)->start(acceptor.local_endpoint());
+        }
+
+        // the receivers decrypt on the same threads, so compare modes with each other rather than with line rate
+        const auto start{ std::chrono::steady_clock::now() };
+
+        std::vector<std::thread> threads{};
+        for (auto i{ 1 }; i < config.threads; ++i)
+        {
+            threads.emplace_back([&ioc]() { ioc.run(); });
+        }
+
+        ioc.run();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+        const auto totalMiB{ static_cast<double>(config.fileSize) * config.connections / BYTES_PER_MIB };
+
+        ::close(fileDescriptor);
+        std::filesystem::remove(filePath);
+
+        std::cout << std::format("mode: {}, connections: {}, file size: {} MiB, threads: {}, kernel TLS active on {} of {} connections\n",
+            config.mode, config.connections, config.fileSize / BYTES_PER_MIB, config.threads, result.kernelTlsConnections.load(), config.connections);
+        std::cout << std::format("{:.0f} MiB in {:.3f} s: {:.1f} MiB/s\n", totalMiB, elapsed.count(), totalMiB / elapsed.count());
+
+        return result.failures == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::error_code ec{};
+        std::filesystem::remove(filePath, ec);
+
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,168 @@
+#include <chrono>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+#include "utils/Validators.h"
+
+// the table-driven validators against the std::regex checks they replaced
+
+constexpr auto LOGIN_PATTERN{ "^[a-zA-Z0-9_]+$" };
+constexpr auto UUID_PATTERN{ R"(^[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}$)" };
+constexpr auto JWT_PATTERN{ R"(^[A-Za-z0-9_-]+\.[A-Za-z0-9_-]+\.[A-Za-z0-9_-]+$)" };
+
+struct Validator final
+{
+    std::string name;
+    std::string input;
+    std::function<bool(const std::string&)> regexPerCall;
+    std::function<bool(const std::string&)> regexCompiled;
+    std::function<bool(const std::string&)> table;
+};
+
+// the login and UUID checks as they were before the tables: a regex compiled on every call
+[[nodiscard]] bool isLoginValidRegex(const std::string& login)
+{
+    if (login.length() < 3 || login.length() > 50)
+    {
+        return false;
+    }
+
+    const std::regex pattern{ LOGIN_PATTERN };
+    return std::regex_match(login, pattern);
+}
+
+[[nodiscard]] bool isUUIDValidRegex(const std::string& uuid)
+{
+    if (uuid.length() != 36)
+    {
+        return false;
+    }
+
+    const std::regex pattern{ UUID_PATTERN };
+    return std::regex_match(uuid, pattern);
+}
+
+// there was no JWT shape check before, this is the regex it would have been
+[[nodiscard]] bool isJWTShapeValidRegex(const std::string& token)
+{
+    const std::regex pattern{ JWT_PATTERN };
+    return std::regex_match(token, pattern);
+}
+
+// the same checks with the regex compiled once, the cheapest a regex gets
+[[nodiscard]] bool isLoginValidCompiled(const std::string& login)
+{
+    static const std::regex pattern{ LOGIN_PATTERN };
+    return login.length() >= 3 && login.length() <= 50 && std::regex_match(login, pattern);
+}
+
+[[nodiscard]] bool isUUIDValidCompiled(const std::string& uuid)
+{
+    static const std::regex pattern{ UUID_PATTERN };
+    return uuid.length() == 36 && std::regex_match(uuid, pattern);
+}
+
+[[nodiscard]] bool isJWTShapeValidCompiled(const std::string& token)
+{
+    static const std::regex pattern{ JWT_PATTERN };
+    return std::regex_match(token, pattern);
+}
+
+// nanoseconds per call, averaged over the iterations
+[[nodiscard]] double measure(const std::function<bool(const std::string&)>& validate, const std::string& input, int iterations, bool expected)
+{
+    auto matches{ 0 };
+
+    const auto start{ std::chrono::steady_clock::now() };
+    for (auto i{ 0 }; i < iterations; ++i)
+    {
+        matches += validate(input) ? 1 : 0;
+    }
+    const std::chrono::duration<double, std::nano> elapsed{ std::chrono::steady_clock::now() - start };
+
+    // the result is used, so the loop cannot be dropped
+    if (matches != (expected ? iterations : 0))
+    {
+        throw std::runtime_error{ "Validators disagree on " + input };
+    }
+
+    return elapsed.count() / iterations;
+}
+
+[[nodiscard]] int parseCommandLine(int argc, char* argv[])
+{
+    namespace po = boost::program_options;
+
+    auto iterations{ 0 };
+
+    po::options_description desc{ "Validator Benchmark Options" };
+    desc.add_options()
+        ("help,h", "Show this help message")
+        ("iterations,n", po::value<int>(&iterations)->default_value(200000), "Calls per validator and input");
+
+    po::variables_map vm{};
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help"))
+    {
+        std::cout << "Measures the login, UUID and JWT shape validators against std::regex\n\n";
+        std::cout << "Usage: " << argv[0] << " [OPTIONS]\n\n";
+        std::cout << desc << "\n";
+        exit(0);
+    }
+
+    if (iterations < 1)
+    {
+        throw po::error{ "invalid option value, see --help" };
+    }
+
+    return iterations;
+}
+
+int main(int argc, char* argv[]) noexcept
+{
+    try
+    {
+        const auto iterations{ parseCommandLine(argc, argv) };
+
+        // the size of a token issued by JWTManager: HS256 header, claims and a 43 character signature
+        const std::string token{ std::string(36, 'e') + "." + std::string(160, 'p') + "." + std::string(43, 's') };
+
+        const std::vector<Validator> validators
+        {
+            { "login", "some_user_42", isLoginValidRegex, isLoginValidCompiled, utils::Validators::isLoginValid },
+            { "login (invalid)", "some_user_42!", isLoginValidRegex, isLoginValidCompiled, utils::Validators::isLoginValid },
+            { "UUID", "123e4567-e89b-12d3-a456-426614174000", isUUIDValidRegex, isUUIDValidCompiled, utils::Validators::isUUIDValid },
+            { "UUID (invalid)", "123e4567-e89b-12d3-a456-42661417400g", isUUIDValidRegex, isUUIDValidCompiled, utils::Validators::isUUIDValid },
+            { "JWT shape", token, isJWTShapeValidRegex, isJWTShapeValidCompiled, utils::Validators::isJWTShapeValid },
+            { "JWT shape (invalid)", token + ".x", isJWTShapeValidRegex, isJWTShapeValidCompiled, utils::Validators::isJWTShapeValid }
+        };
+
+        std::cout << std::format("{} calls per validator and input, ns per call\n", iterations);
+        std::cout << std::format("{:<20} {:>6} {:>14} {:>14} {:>10}\n", "validator", "bytes", "regex per call", "regex once", "table");
+
+        for (const auto& validator : validators)
+        {
+            const auto expected{ validator.table(validator.input) };
+
+            std::cout << std::format("{:<20} {:>6} {:>14.1f} {:>14.1f} {:>10.1f}\n",
+                validator.name,
+                validator.input.size(),
+                measure(validator.regexPerCall, validator.input, iterations, expected),
+                measure(validator.regexCompiled, validator.input, iterations, expected),
+                measure(validator.table, validator.input, iterations, expected));
+        }
+
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
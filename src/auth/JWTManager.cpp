@@ -1,5 +1,6 @@
 #include "JWTManager.h"
 #include "../utils/Logger.h"
+#include "../utils/Validators.h"
 #include <jwt-cpp/jwt.h>
 #include <jwt-cpp/traits/nlohmann-json/traits.h>
 #include <stdexcept>
@@ -10,6 +11,7 @@ namespace auth
     constexpr size_t MIN_SECRET_KEY_LENGTH{ 32 };
     constexpr unsigned int MIN_ACCESS_TOKEN_EXPIRY{ 1 }; // minute
     constexpr unsigned int MAX_ACCESS_TOKEN_EXPIRY{ 525600 }; // year in minutes
+    constexpr size_t MAX_VERIFIED_TOKENS_CACHE_SIZE{ 10000 };
 
 JWTManager::JWTManager(const std::string& secretKey, unsigned int accessTokenExpiryMinutes, unsigned int refreshTokenExpiryDays) :
     secretKey_{ secretKey },
@@ -109,11 +111,22 @@ JWTManager::TokenPayload JWTManager::verifyAndDecode(const std::string& token)
         throw std::invalid_argument{ "Token is empty" };
     }
 
+    // garbage is rejected before the cache lookups and the decoding
+    if (!utils::Validators::isJWTShapeValid(token))
+    {
+        throw std::runtime_error{ "Token is malformed" };
+    }
+
     if (isTokenBlacklisted(token)) 
     {
         throw std::invalid_argument{ "Token is blacklisted" };
     }
 
+    if (findVerifiedToken(token, payload)) 
+    {
+        return payload;
+    }
+
     try 
     {
         // token decoding and verification
@@ -146,6 +159,7 @@ JWTManager::TokenPayload JWTManager::verifyAndDecode(const std::string& token)
         }
 
         payload.isValid = true;
+        cacheVerifiedToken(token, payload);
 
         LOG_DEBUG("Token verified successfully for user: " + payload.userID);
         return payload;
@@ -253,4 +267,47 @@ std::chrono::system_clock::time_point JWTManager::getRefreshTokenExpiry() const
 {
     return std::chrono::system_clock::now() + std::chrono::hours(24 * refreshTokenExpiryDays_);
 }
+
+bool JWTManager::findVerifiedToken(const std::string& token, TokenPayload& payload) noexcept
+{
+    std::lock_guard lock{ verifiedTokensMutex_ };
+
+    if (const auto it{ verifiedTokens_.find(token) }; it != verifiedTokens_.end()) 
+    {
+        if (it->second.expiresAt > std::chrono::system_clock::now()) 
+        {
+            payload = it->second;
+            return true;
+        }
+
+        verifiedTokens_.erase(it);
+    }
+
+    return false;
+}
+
+void JWTManager::cacheVerifiedToken(const std::string& token, const TokenPayload& payload) noexcept
+{
+    std::lock_guard lock{ verifiedTokensMutex_ };
+
+    try 
+    {
+        if (verifiedTokens_.size() >= MAX_VERIFIED_TOKENS_CACHE_SIZE) 
+        {
+            const auto now{ std::chrono::system_clock::now() };
+            std::erase_if(verifiedTokens_, [&now](const auto& item) { return item.second.expiresAt <= now; });
+
+            if (verifiedTokens_.size() >= MAX_VERIFIED_TOKENS_CACHE_SIZE) 
+            {
+                verifiedTokens_.clear();
+            }
+        }
+
+        verifiedTokens_.emplace(token, payload);
+    }
+    catch (const std::exception& e) 
+    {
+        LOG_WARNING("Failed to cache verified token: " + std::string{ e.what() });
+    }
+}
 }
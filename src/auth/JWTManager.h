@@ -105,6 +105,9 @@ public:
      * @param token The JWT token string to verify
      * @return TokenPayload Decoded token payload with validation status
      * @throw std::runtime_error If token parsing or verification fails
+     * @note Successfully verified tokens are cached until they expire, so repeated
+     *       verification of the same token (e.g. sub-requests of a batch) skips signature checks.
+     *       The blacklist is always consulted before the cache.
      */
     [[nodiscard]] TokenPayload verifyAndDecode(const std::string& token);
 
@@ -150,6 +153,23 @@ private:
      */
     [[nodiscard]] std::chrono::system_clock::time_point getRefreshTokenExpiry() const noexcept;
 
+    /**
+     * @brief Looks up a previously verified token in the cache
+     * @param token The JWT token to look up
+     * @param[out] payload Cached payload if found and not expired
+     * @return bool True if a valid cached payload was found
+     * @note Thread-safe operation
+     */
+    [[nodiscard]] bool findVerifiedToken(const std::string& token, TokenPayload& payload) noexcept;
+
+    /**
+     * @brief Stores a verified token payload in the cache
+     * @param token The verified JWT token
+     * @param payload Decoded token payload
+     * @note Thread-safe operation; expired entries are evicted when the cache is full
+     */
+    void cacheVerifiedToken(const std::string& token, const TokenPayload& payload) noexcept;
+
 private:
     const std::string secretKey_;                 ///< Secret key for token signing
     const unsigned int accessTokenExpiryMinutes_; ///< Access token lifetime in minutes
@@ -165,6 +185,16 @@ private:
      * @brief Mutex for thread-safe access to blacklist
      */
     std::mutex blacklistMutex_;
+
+    /**
+     * @brief Cache of verified tokens and their decoded payloads
+     */
+    std::unordered_map<std::string, TokenPayload> verifiedTokens_;
+
+    /**
+     * @brief Mutex for thread-safe access to verified tokens cache
+     */
+    std::mutex verifiedTokensMutex_;
 };
 }
 
@@ -1,4 +1,6 @@
 #include "ConfigManager.h"
+#include <algorithm>
+#include <charconv>
 #include <fstream>
 #include <filesystem>
 #include <stdexcept>
@@ -10,6 +12,43 @@ constexpr uint16_t MAX_PORT{ 65535 };
 constexpr int MIN_THREADS{ 1 };
 constexpr int MAX_THREADS{ 1024 };
 constexpr unsigned int MIN_TOKEN_EXPIRY{ 1 };
+constexpr int MIN_COMPRESSION_LEVEL{ 1 };
+constexpr int MAX_COMPRESSION_LEVEL{ 9 };
+constexpr int DEFAULT_COMPRESSION_LEVEL{ 6 };
+constexpr size_t DEFAULT_COMPRESSION_MIN_SIZE{ 1024 };
+constexpr size_t DEFAULT_MAX_REQUEST_BODY_SIZE{ 1024 * 1024 };
+constexpr unsigned int MIN_DATABASE_CONCURRENCY{ 1 };
+constexpr unsigned int DEFAULT_CIRCUIT_FAILURE_THRESHOLD{ 5 };
+constexpr unsigned int MIN_CIRCUIT_FAILURE_THRESHOLD{ 1 };
+constexpr unsigned int DEFAULT_RECONNECT_INTERVAL{ 1000 };
+constexpr unsigned int MIN_RECONNECT_INTERVAL{ 10 };
+constexpr size_t DEFAULT_MAX_ATTACHMENT_SIZE{ 100 * 1024 * 1024 };
+constexpr unsigned int DEFAULT_HTTP_REQUEST_TIMEOUT{ 5000 };
+constexpr unsigned int MIN_HTTP_REQUEST_TIMEOUT{ 1 };
+constexpr uint32_t DEFAULT_HTTP2_MAX_CONCURRENT_STREAMS{ 100 };
+constexpr uint32_t MIN_HTTP2_MAX_CONCURRENT_STREAMS{ 1 };
+constexpr uint32_t DEFAULT_HTTP2_INITIAL_WINDOW_SIZE{ 1024 * 1024 };
+constexpr uint32_t MIN_HTTP2_INITIAL_WINDOW_SIZE{ 65535 };
+constexpr uint32_t MAX_HTTP2_INITIAL_WINDOW_SIZE{ 2147483647 };
+constexpr auto DEFAULT_SSL_CIPHER_LIST{ "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:ECDHE-ECDSA-AES256-GCM-SHA384:"
+    "ECDHE-RSA-AES256-GCM-SHA384:ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305" };
+constexpr auto DEFAULT_SSL_CIPHER_SUITES{ "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256" };
+constexpr auto DEFAULT_SSL_GROUPS{ "X25519:P-256:P-384" };
+constexpr size_t DEFAULT_SSL_SESSION_CACHE_SIZE{ 20480 };
+constexpr unsigned int DEFAULT_SSL_SESSION_TIMEOUT{ 86400 };
+constexpr unsigned int DEFAULT_SSL_TICKET_KEY_ROTATION{ 720 };
+constexpr unsigned int MIN_SSL_TICKET_KEY_ROTATION{ 1 };
+constexpr std::filesystem::perms DEFAULT_UNIX_SOCKET_PERMISSIONS{ 0660 };
+constexpr unsigned int MAX_UNIX_SOCKET_PERMISSIONS{ 0777 };
+constexpr size_t DEFAULT_MAX_CONNECTIONS{ 10000 };
+constexpr size_t DEFAULT_MAX_CONNECTIONS_PER_IP{ 100 };
+constexpr unsigned int DEFAULT_ACCEPT_BURST{ 100 };
+constexpr unsigned int MIN_ACCEPT_BURST{ 1 };
+constexpr size_t DEFAULT_RATE_LIMIT_MAX_BUCKETS{ 100000 };
+constexpr size_t MIN_RATE_LIMIT_MAX_BUCKETS{ 16 };
+constexpr int MIN_RATE_LIMIT_BURST{ 1 };
+constexpr size_t DEFAULT_LOAD_SHEDDING_MAX_QUEUE_DEPTH{ 64 };
+constexpr double DEFAULT_LOAD_SHEDDING_LOW_PRIORITY_SHARE{ 0.5 };
 
 using json = nlohmann::json;
 
@@ -39,16 +78,12 @@ void ConfigManager::validateConfig() const
         throw std::runtime_error{ "Config is empty" };
     }
 
-    constexpr std::array<std::string_view, 21> requiredPaths
+    constexpr std::array<std::string_view, 18> requiredPaths
 	{
         "server/address",
         "server/port",
         "server/threads",
 
-        "ssl/certificate_file",
-        "ssl/private_key_file",
-        "ssl/dh_params_file",
-
         "database/address",
         "database/port",
         "database/username",
@@ -68,12 +103,27 @@ void ConfigManager::validateConfig() const
         "logging/log_access",
     };
 
-    for (const auto& path : requiredPaths)
+    // certificates are only needed when TLS is not terminated by a load balancer
+    constexpr std::array<std::string_view, 3> requiredTlsPaths
+    {
+        "ssl/certificate_file",
+        "ssl/private_key_file",
+        "ssl/dh_params_file",
+    };
+
+    const auto requirePath{ [this](std::string_view path)
     {
         if (!config_.contains(json::json_pointer("/" + std::string{ path.begin(), path.end() })))
         {
             throw std::runtime_error{ "Missing required field: " + std::string{ path } };
         }
+    } };
+
+    std::ranges::for_each(requiredPaths, requirePath);
+
+    if (getServerTlsEnabled())
+    {
+        std::ranges::for_each(requiredTlsPaths, requirePath);
     }
 
 	// server settings validation
@@ -93,19 +143,22 @@ void ConfigManager::validateConfig() const
     }
 
 	// SSL files validation
-    if (const auto certFile{ getSSLCertificateFile() }; !std::filesystem::exists(certFile)) 
+    if (getServerTlsEnabled())
     {
-        throw std::runtime_error{ "SSL certificate file not found: " + certFile };
-    }
+        if (const auto certFile{ getSSLCertificateFile() }; !std::filesystem::exists(certFile))
+        {
+            throw std::runtime_error{ "SSL certificate file not found: " + certFile };
+        }
 
-    if (const auto keyFile{ getSSLPrivateKeyFile() }; !std::filesystem::exists(keyFile)) 
-    {
-        throw std::runtime_error{ "SSL private key file not found: " + keyFile };
-    }
+        if (const auto keyFile{ getSSLPrivateKeyFile() }; !std::filesystem::exists(keyFile))
+        {
+            throw std::runtime_error{ "SSL private key file not found: " + keyFile };
+        }
 
-    if (const auto dhFile{ getSSLDHParamsFile() }; !std::filesystem::exists(dhFile)) 
-    {
-        throw std::runtime_error{ "SSL DH params file not found: " + dhFile };
+        if (const auto dhFile{ getSSLDHParamsFile() }; !std::filesystem::exists(dhFile))
+        {
+            throw std::runtime_error{ "SSL DH params file not found: " + dhFile };
+        }
     }
 
 	// database settings validation
@@ -210,6 +263,62 @@ int ConfigManager::getServerThreads() const noexcept
     return getValue<int>("server/threads");
 }
 
+int ConfigManager::getServerHandlerThreads() const noexcept
+{
+    const auto threads{ getValue<int>("server/handler_threads", 0) };
+    return threads < MIN_THREADS ? getServerThreads() : std::min(threads, MAX_THREADS);
+}
+
+bool ConfigManager::getServerTlsEnabled() const noexcept
+{
+    return getValue<bool>("server/tls_enabled", true);
+}
+
+bool ConfigManager::getServerProxyProtocolEnabled() const noexcept
+{
+    return getValue<bool>("server/proxy_protocol", false);
+}
+
+std::string ConfigManager::getServerUnixSocketPath() const noexcept
+{
+    return getValue<std::string>("server/unix_socket_path", "");
+}
+
+std::filesystem::perms ConfigManager::getServerUnixSocketPermissions() const noexcept
+{
+    // JSON has no octal numbers, so the mode is a string such as "0660"
+    const auto text{ getValue<std::string>("server/unix_socket_permissions") };
+
+    unsigned int mode{ 0 };
+    const auto [end, ec] { std::from_chars(text.data(), text.data() + text.size(), mode, 8) };
+    if (text.empty() || ec != std::errc{} || end != text.data() + text.size() || mode > MAX_UNIX_SOCKET_PERMISSIONS)
+    {
+        return DEFAULT_UNIX_SOCKET_PERMISSIONS;
+    }
+
+    return static_cast<std::filesystem::perms>(mode);
+}
+
+size_t ConfigManager::getServerMaxConnections() const noexcept
+{
+    return getValue<size_t>("server/max_connections", DEFAULT_MAX_CONNECTIONS);
+}
+
+size_t ConfigManager::getServerMaxConnectionsPerIp() const noexcept
+{
+    return getValue<size_t>("server/max_connections_per_ip", DEFAULT_MAX_CONNECTIONS_PER_IP);
+}
+
+unsigned int ConfigManager::getServerAcceptRate() const noexcept
+{
+    return getValue<unsigned int>("server/accept_rate", 0);
+}
+
+unsigned int ConfigManager::getServerAcceptBurst() const noexcept
+{
+    return std::max(getValue<unsigned int>("server/accept_burst", DEFAULT_ACCEPT_BURST), MIN_ACCEPT_BURST);
+}
+
 std::string ConfigManager::getSSLCertificateFile() const noexcept
 {
     return getValue<std::string>("ssl/certificate_file");
@@ -225,6 +334,46 @@ std::string ConfigManager::getSSLDHParamsFile() const noexcept
     return getValue<std::string>("ssl/dh_params_file");
 }
 
+std::string ConfigManager::getSSLCipherList() const noexcept
+{
+    return getValue<std::string>("ssl/cipher_list", DEFAULT_SSL_CIPHER_LIST);
+}
+
+std::string ConfigManager::getSSLCipherSuites() const noexcept
+{
+    return getValue<std::string>("ssl/cipher_suites", DEFAULT_SSL_CIPHER_SUITES);
+}
+
+std::string ConfigManager::getSSLGroups() const noexcept
+{
+    return getValue<std::string>("ssl/groups", DEFAULT_SSL_GROUPS);
+}
+
+size_t ConfigManager::getSSLSessionCacheSize() const noexcept
+{
+    return getValue<size_t>("ssl/session_cache_size", DEFAULT_SSL_SESSION_CACHE_SIZE);
+}
+
+unsigned int ConfigManager::getSSLSessionTimeout() const noexcept
+{
+    return getValue<unsigned int>("ssl/session_timeout", DEFAULT_SSL_SESSION_TIMEOUT);
+}
+
+bool ConfigManager::getSSLSessionTicketsEnabled() const noexcept
+{
+    return getValue<bool>("ssl/session_tickets_enabled", true);
+}
+
+unsigned int ConfigManager::getSSLTicketKeyRotationMinutes() const noexcept
+{
+    return std::max(getValue<unsigned int>("ssl/ticket_key_rotation_minutes", DEFAULT_SSL_TICKET_KEY_ROTATION), MIN_SSL_TICKET_KEY_ROTATION);
+}
+
+bool ConfigManager::getSSLKernelTlsEnabled() const noexcept
+{
+    return getValue<bool>("ssl/ktls_enabled", true);
+}
+
 std::string ConfigManager::getDatabaseAddress() const noexcept
 {
     return getValue<std::string>("database/address");
@@ -260,6 +409,26 @@ unsigned int ConfigManager::getDatabaseConnectionTimeout() const noexcept
     return getValue<unsigned int>("database/connection_timeout");
 }
 
+bool ConfigManager::getDatabaseAdaptiveConcurrency() const noexcept
+{
+    return getValue<bool>("database/adaptive_concurrency", false);
+}
+
+unsigned int ConfigManager::getDatabaseMinConcurrency() const noexcept
+{
+    return std::max(getValue<unsigned int>("database/min_concurrency", MIN_DATABASE_CONCURRENCY), MIN_DATABASE_CONCURRENCY);
+}
+
+unsigned int ConfigManager::getDatabaseCircuitFailureThreshold() const noexcept
+{
+    return std::max(getValue<unsigned int>("database/circuit_failure_threshold", DEFAULT_CIRCUIT_FAILURE_THRESHOLD), MIN_CIRCUIT_FAILURE_THRESHOLD);
+}
+
+unsigned int ConfigManager::getDatabaseReconnectInterval() const noexcept
+{
+    return std::max(getValue<unsigned int>("database/reconnect_interval_ms", DEFAULT_RECONNECT_INTERVAL), MIN_RECONNECT_INTERVAL);
+}
+
 std::string ConfigManager::getJWTSecretKey() const noexcept
 {
     return getValue<std::string>("jwt/secret_key");
@@ -299,4 +468,114 @@ bool ConfigManager::getIsLogAccess() const noexcept
 {
     return getValue<bool>("logging/log_access", true);
 }
+
+std::string ConfigManager::getHttpCacheControl() const noexcept
+{
+    return getValue<std::string>("http/cache_control", "no-cache");
+}
+
+bool ConfigManager::getHttpCompressionEnabled() const noexcept
+{
+    return getValue<bool>("http/compression_enabled", true);
+}
+
+size_t ConfigManager::getHttpCompressionMinSize() const noexcept
+{
+    return getValue<size_t>("http/compression_min_size", DEFAULT_COMPRESSION_MIN_SIZE);
+}
+
+int ConfigManager::getHttpCompressionLevel() const noexcept
+{
+    return std::clamp(getValue<int>("http/compression_level", DEFAULT_COMPRESSION_LEVEL), MIN_COMPRESSION_LEVEL, MAX_COMPRESSION_LEVEL);
+}
+
+size_t ConfigManager::getHttpMaxRequestBodySize() const noexcept
+{
+    return getValue<size_t>("http/max_request_body_size", DEFAULT_MAX_REQUEST_BODY_SIZE);
+}
+
+unsigned int ConfigManager::getHttpRequestTimeout() const noexcept
+{
+    return std::max(getValue<unsigned int>("http/request_timeout_ms", DEFAULT_HTTP_REQUEST_TIMEOUT), MIN_HTTP_REQUEST_TIMEOUT);
+}
+
+bool ConfigManager::getHttp2Enabled() const noexcept
+{
+    return getValue<bool>("http/http2_enabled", true);
+}
+
+uint32_t ConfigManager::getHttp2MaxConcurrentStreams() const noexcept
+{
+    return std::max(getValue<uint32_t>("http/http2_max_concurrent_streams", DEFAULT_HTTP2_MAX_CONCURRENT_STREAMS), MIN_HTTP2_MAX_CONCURRENT_STREAMS);
+}
+
+uint32_t ConfigManager::getHttp2InitialWindowSize() const noexcept
+{
+    return std::clamp(getValue<uint32_t>("http/http2_initial_window_size", DEFAULT_HTTP2_INITIAL_WINDOW_SIZE), MIN_HTTP2_INITIAL_WINDOW_SIZE, MAX_HTTP2_INITIAL_WINDOW_SIZE);
+}
+
+std::string ConfigManager::getAttachmentsDirectory() const noexcept
+{
+    return getValue<std::string>("attachments/directory", "attachments");
+}
+
+size_t ConfigManager::getAttachmentsMaxSize() const noexcept
+{
+    return getValue<size_t>("attachments/max_size", DEFAULT_MAX_ATTACHMENT_SIZE);
+}
+
+std::vector<RateLimitRoute> ConfigManager::getRateLimitRoutes() const noexcept
+{
+    std::vector<RateLimitRoute> routes{};
+
+    for (const auto& entry : getValue<json>("rate_limits/routes", json::array()))
+    {
+        try
+        {
+            if (!entry.is_object() || !entry.contains("path") || !entry.at("path").is_string())
+            {
+                continue;
+            }
+
+            RateLimitRoute route{};
+            route.path = entry.at("path").get<std::string>();
+            route.userRate = std::max(entry.value("user_rate", 0.0), 0.0);
+            route.userBurst = static_cast<unsigned int>(std::max(entry.value("user_burst", MIN_RATE_LIMIT_BURST), MIN_RATE_LIMIT_BURST));
+            route.ipRate = std::max(entry.value("ip_rate", 0.0), 0.0);
+            route.ipBurst = static_cast<unsigned int>(std::max(entry.value("ip_burst", MIN_RATE_LIMIT_BURST), MIN_RATE_LIMIT_BURST));
+            routes.push_back(std::move(route));
+        }
+        catch (const json::exception&)
+        {
+            continue;
+        }
+    }
+
+    return routes;
+}
+
+size_t ConfigManager::getRateLimitMaxBuckets() const noexcept
+{
+    return std::max(getValue<size_t>("rate_limits/max_buckets", DEFAULT_RATE_LIMIT_MAX_BUCKETS), MIN_RATE_LIMIT_MAX_BUCKETS);
+}
+
+bool ConfigManager::getLoadSheddingEnabled() const noexcept
+{
+    return getValue<bool>("load_shedding/enabled", false);
+}
+
+size_t ConfigManager::getLoadSheddingMaxQueueDepth() const noexcept
+{
+    return getValue<size_t>("load_shedding/max_queue_depth", DEFAULT_LOAD_SHEDDING_MAX_QUEUE_DEPTH);
+}
+
+std::vector<std::string> ConfigManager::getLoadSheddingLowPriorityRoutes() const noexcept
+{
+    return getValue<std::vector<std::string>>("load_shedding/low_priority_routes", { "/api/v1/users" });
+}
+
+double ConfigManager::getLoadSheddingLowPriorityShare() const noexcept
+{
+    return std::clamp(getValue<double>("load_shedding/low_priority_share", DEFAULT_LOAD_SHEDDING_LOW_PRIORITY_SHARE), 0.0, 1.0);
+}
 }
@@ -1,11 +1,26 @@
 #ifndef CONFIG_MANAGER_H
 #define CONFIG_MANAGER_H
 
+#include <filesystem>
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 namespace config
 {
+/**
+ * @struct RateLimitRoute
+ * @brief Request rate limits of one route as given in the configuration
+ */
+struct RateLimitRoute final
+{
+    std::string path;            ///< Route the limits apply to, including nested paths
+    double userRate{ 0.0 };      ///< Requests per second per user, 0 for no limit
+    unsigned int userBurst{ 1 }; ///< Requests a user may make at once
+    double ipRate{ 0.0 };        ///< Requests per second per client IP address, 0 for no limit
+    unsigned int ipBurst{ 1 };   ///< Requests a client address may make at once
+};
+
 /**
  * @class ConfigManager
  * @brief Manages application configuration from JSON files
@@ -77,6 +92,63 @@ public:
      */
     [[nodiscard]] int getServerThreads() const noexcept;
 
+    /**
+     * @brief Gets the number of handler threads from configuration
+     * @return int Number of threads running HTTP/2 request handlers and batch sub-requests, at most 1024
+     * @note Returns the number of server threads if not specified in configuration or 0
+     */
+    [[nodiscard]] int getServerHandlerThreads() const noexcept;
+
+    /**
+     * @brief Gets whether the server terminates TLS itself from configuration
+     * @return bool True for HTTPS (default), false for plaintext HTTP behind a TLS-terminating load balancer
+     * @note The SSL certificate, key and DH params files are only required when TLS is enabled
+     */
+    [[nodiscard]] bool getServerTlsEnabled() const noexcept;
+
+    /**
+     * @brief Gets whether connections start with a PROXY protocol header from configuration
+     * @return bool True if every connection must start with a PROXY protocol v1 or v2 header (default false)
+     */
+    [[nodiscard]] bool getServerProxyProtocolEnabled() const noexcept;
+
+    /**
+     * @brief Gets the path of the Unix domain socket to listen on from configuration
+     * @return std::string Socket path, empty if the server only listens on TCP (default)
+     */
+    [[nodiscard]] std::string getServerUnixSocketPath() const noexcept;
+
+    /**
+     * @brief Gets the permissions of the Unix domain socket file from configuration
+     * @return std::filesystem::perms Permissions given as an octal string (default "0660"), the default if invalid
+     */
+    [[nodiscard]] std::filesystem::perms getServerUnixSocketPermissions() const noexcept;
+
+    /**
+     * @brief Gets the maximum number of open connections from configuration
+     * @return size_t Maximum number of connections (default 10000), 0 for no limit
+     */
+    [[nodiscard]] size_t getServerMaxConnections() const noexcept;
+
+    /**
+     * @brief Gets the maximum number of open connections per client IP address from configuration
+     * @return size_t Maximum number of connections from one address (default 100), 0 for no limit
+     * @note Not applied with the PROXY protocol, where all connections come from the load balancer
+     */
+    [[nodiscard]] size_t getServerMaxConnectionsPerIp() const noexcept;
+
+    /**
+     * @brief Gets the maximum number of accepted connections per second from configuration
+     * @return unsigned int Average accept rate (default 0 - no limit)
+     */
+    [[nodiscard]] unsigned int getServerAcceptRate() const noexcept;
+
+    /**
+     * @brief Gets the number of connections that may be accepted at once above the accept rate from configuration
+     * @return unsigned int Accept burst (default 100), at least 1
+     */
+    [[nodiscard]] unsigned int getServerAcceptBurst() const noexcept;
+
     // SSL/TLS configuration
 
     /**
@@ -97,6 +169,62 @@ public:
      */
     [[nodiscard]] std::string getSSLDHParamsFile() const noexcept;
 
+    /**
+     * @brief Gets the OpenSSL cipher list for TLS 1.2 from configuration
+     * @return std::string Colon-separated cipher list
+     * @note Returns ECDHE key exchange with AES-GCM and ChaCha20-Poly1305 ciphers if not specified in configuration
+     */
+    [[nodiscard]] std::string getSSLCipherList() const noexcept;
+
+    /**
+     * @brief Gets the OpenSSL cipher suites for TLS 1.3 from configuration
+     * @return std::string Colon-separated cipher suite list
+     * @note Returns "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256" if not specified in configuration
+     */
+    [[nodiscard]] std::string getSSLCipherSuites() const noexcept;
+
+    /**
+     * @brief Gets the key exchange groups from configuration
+     * @return std::string Colon-separated group list in order of preference
+     * @note Returns "X25519:P-256:P-384" if not specified in configuration
+     */
+    [[nodiscard]] std::string getSSLGroups() const noexcept;
+
+    /**
+     * @brief Gets the size of the server-side TLS session cache from configuration
+     * @return size_t Maximum number of cached sessions
+     * @note Returns 20480 if not specified in configuration
+     */
+    [[nodiscard]] size_t getSSLSessionCacheSize() const noexcept;
+
+    /**
+     * @brief Gets the lifetime of a resumable TLS session from configuration
+     * @return unsigned int Session lifetime in seconds
+     * @note Returns 86400 (24 hours) if not specified in configuration
+     */
+    [[nodiscard]] unsigned int getSSLSessionTimeout() const noexcept;
+
+    /**
+     * @brief Gets whether stateless TLS session tickets are enabled from configuration
+     * @return bool True if session tickets are issued
+     * @note Returns true if not specified in configuration
+     */
+    [[nodiscard]] bool getSSLSessionTicketsEnabled() const noexcept;
+
+    /**
+     * @brief Gets the session ticket key rotation interval from configuration
+     * @return unsigned int Rotation interval in minutes, at least 1
+     * @note Returns 720 (12 hours) if not specified in configuration
+     */
+    [[nodiscard]] unsigned int getSSLTicketKeyRotationMinutes() const noexcept;
+
+    /**
+     * @brief Gets whether TLS record encryption is offloaded to the kernel from configuration
+     * @return bool True if kernel TLS is used where OpenSSL and the kernel support it
+     * @note Returns true if not specified in configuration
+     */
+    [[nodiscard]] bool getSSLKernelTlsEnabled() const noexcept;
+
     // Database configuration
 
     /**
@@ -141,6 +269,34 @@ public:
      */
     [[nodiscard]] unsigned int getDatabaseConnectionTimeout() const noexcept;
 
+    /**
+     * @brief Gets whether the number of concurrent queries adapts to the query times from configuration
+     * @return bool True if the concurrency limit is adaptive, with max_connections as its upper bound
+     * @note Returns false if not specified in configuration
+     */
+    [[nodiscard]] bool getDatabaseAdaptiveConcurrency() const noexcept;
+
+    /**
+     * @brief Gets the lowest adaptive concurrency limit from configuration
+     * @return unsigned int Minimum number of concurrent queries, at least 1
+     * @note Returns 1 if not specified in configuration
+     */
+    [[nodiscard]] unsigned int getDatabaseMinConcurrency() const noexcept;
+
+    /**
+     * @brief Gets the number of consecutive connection failures that open the database circuit breaker from configuration
+     * @return unsigned int Failure threshold, at least 1
+     * @note Returns 5 if not specified in configuration
+     */
+    [[nodiscard]] unsigned int getDatabaseCircuitFailureThreshold() const noexcept;
+
+    /**
+     * @brief Gets the first delay between attempts to reconnect to the database from configuration
+     * @return unsigned int Reconnection interval in milliseconds, at least 10
+     * @note Returns 1000 if not specified in configuration
+     */
+    [[nodiscard]] unsigned int getDatabaseReconnectInterval() const noexcept;
+
     // JWT configuration
 
     /**
@@ -198,6 +354,133 @@ public:
      */
     [[nodiscard]] bool getIsLogAccess() const noexcept;
 
+    // HTTP configuration
+
+    /**
+     * @brief Gets the Cache-Control header value for JSON responses from configuration
+     * @return std::string Cache-Control header value
+     * @note Returns "no-cache" if not specified in configuration
+     */
+    [[nodiscard]] std::string getHttpCacheControl() const noexcept;
+
+    /**
+     * @brief Gets whether response compression is enabled from configuration
+     * @return bool True if responses are compressed for clients that accept it
+     * @note Returns true if not specified in configuration
+     */
+    [[nodiscard]] bool getHttpCompressionEnabled() const noexcept;
+
+    /**
+     * @brief Gets the minimum response body size to compress from configuration
+     * @return size_t Minimum body size in bytes
+     * @note Returns 1024 if not specified in configuration
+     */
+    [[nodiscard]] size_t getHttpCompressionMinSize() const noexcept;
+
+    /**
+     * @brief Gets the response compression level from configuration
+     * @return int Compression level clamped to the range 1 - 9
+     * @note Returns 6 if not specified in configuration
+     */
+    [[nodiscard]] int getHttpCompressionLevel() const noexcept;
+
+    /**
+     * @brief Gets the maximum request body size, as received and after decompression, from configuration
+     * @return size_t Maximum body size in bytes
+     * @note Returns 1048576 (1 MiB) if not specified in configuration
+     */
+    [[nodiscard]] size_t getHttpMaxRequestBodySize() const noexcept;
+
+    /**
+     * @brief Gets the time budget of a request, including its database queries, from configuration
+     * @return unsigned int Request timeout in milliseconds, at least 1
+     * @note Returns 5000 if not specified in configuration
+     */
+    [[nodiscard]] unsigned int getHttpRequestTimeout() const noexcept;
+
+    /**
+     * @brief Gets whether HTTP/2 is offered to clients via ALPN from configuration
+     * @return bool True if HTTP/2 is enabled, false to serve HTTP/1.1 only
+     * @note Returns true if not specified in configuration
+     */
+    [[nodiscard]] bool getHttp2Enabled() const noexcept;
+
+    /**
+     * @brief Gets the maximum number of concurrent HTTP/2 streams per connection from configuration
+     * @return uint32_t Maximum number of concurrent streams, at least 1
+     * @note Returns 100 if not specified in configuration
+     */
+    [[nodiscard]] uint32_t getHttp2MaxConcurrentStreams() const noexcept;
+
+    /**
+     * @brief Gets the initial HTTP/2 flow control window of request streams from configuration
+     * @return uint32_t Window size in bytes clamped to the range 65535 - 2147483647
+     * @note Returns 1048576 (1 MiB) if not specified in configuration
+     */
+    [[nodiscard]] uint32_t getHttp2InitialWindowSize() const noexcept;
+
+    // Attachments configuration
+
+    /**
+     * @brief Gets the directory of the attachment store from configuration
+     * @return std::string Path to the attachments directory
+     * @note Returns "attachments" if not specified in configuration
+     */
+    [[nodiscard]] std::string getAttachmentsDirectory() const noexcept;
+
+    /**
+     * @brief Gets the maximum size of an uploaded attachment from configuration
+     * @return size_t Maximum attachment size in bytes
+     * @note Returns 104857600 (100 MiB) if not specified in configuration
+     */
+    [[nodiscard]] size_t getAttachmentsMaxSize() const noexcept;
+
+    // Rate limits configuration
+
+    /**
+     * @brief Gets the rate limited routes from configuration
+     * @return std::vector<RateLimitRoute> Limits by route; entries without a path or with values of the wrong type are skipped
+     * @note Returns no routes, so no request is limited, if not specified in configuration
+     */
+    [[nodiscard]] std::vector<RateLimitRoute> getRateLimitRoutes() const noexcept;
+
+    /**
+     * @brief Gets the maximum number of rate limit buckets kept in memory from configuration
+     * @return size_t Maximum number of buckets, at least 16
+     * @note Returns 100000 if not specified in configuration
+     */
+    [[nodiscard]] size_t getRateLimitMaxBuckets() const noexcept;
+
+    // Load shedding configuration
+
+    /**
+     * @brief Gets whether requests are shed while the database is overloaded from configuration
+     * @return bool True if load shedding is enabled
+     * @note Returns false if not specified in configuration
+     */
+    [[nodiscard]] bool getLoadSheddingEnabled() const noexcept;
+
+    /**
+     * @brief Gets the number of queries waiting for a database connection at which requests are shed from configuration
+     * @return size_t Maximum queue depth, 0 to shed by wait time only
+     * @note Returns 64 if not specified in configuration
+     */
+    [[nodiscard]] size_t getLoadSheddingMaxQueueDepth() const noexcept;
+
+    /**
+     * @brief Gets the routes that are shed first from configuration
+     * @return std::vector<std::string> Low priority routes, including nested paths
+     * @note Returns "/api/v1/users" (user listing and search) if not specified in configuration
+     */
+    [[nodiscard]] std::vector<std::string> getLoadSheddingLowPriorityRoutes() const noexcept;
+
+    /**
+     * @brief Gets the share of the request timeout and queue depth left to low priority routes from configuration
+     * @return double Share between 0.0 and 1.0
+     * @note Returns 0.5 if not specified in configuration
+     */
+    [[nodiscard]] double getLoadSheddingLowPriorityShare() const noexcept;
+
 private:
     /**
      * @brief Validates the loaded configuration
@@ -0,0 +1,79 @@
+#include "CircuitBreaker.h"
+#include <algorithm>
+#include "../utils/Logger.h"
+
+namespace database
+{
+CircuitBreaker::CircuitBreaker(unsigned int failureThreshold) noexcept :
+    failureThreshold_{ std::max(failureThreshold, 1u) }
+{
+}
+
+bool CircuitBreaker::isAllowed() const noexcept
+{
+    return state_.load() != CircuitState::Open;
+}
+
+CircuitState CircuitBreaker::getState() const noexcept
+{
+    return state_.load();
+}
+
+void CircuitBreaker::recordSuccess() noexcept
+{
+    // the common case takes no lock
+    if (state_.load() == CircuitState::Closed && failures_ == 0)
+    {
+        return;
+    }
+
+    std::lock_guard lock{ mutex_ };
+    failures_ = 0;
+
+    if (state_.load() == CircuitState::HalfOpen)
+    {
+        state_ = CircuitState::Closed;
+        LOG_INFO("Database circuit closed: queries succeed again");
+    }
+}
+
+bool CircuitBreaker::recordFailure() noexcept
+{
+    std::lock_guard lock{ mutex_ };
+
+    const auto state{ state_.load() };
+    if (state == CircuitState::Open)
+    {
+        return false;
+    }
+
+    if (state == CircuitState::Closed && ++failures_ < failureThreshold_)
+    {
+        return false;
+    }
+
+    failures_ = 0;
+    state_ = CircuitState::Open;
+    ++openCount_;
+
+    LOG_WARNING(state == CircuitState::HalfOpen ? "Database circuit opened again: the database is still unreachable"
+        : "Database circuit opened after " + std::to_string(failureThreshold_) + " connection failures, queries fail until it reconnects");
+    return true;
+}
+
+void CircuitBreaker::recordRecovery() noexcept
+{
+    std::lock_guard lock{ mutex_ };
+
+    if (state_.load() == CircuitState::Open)
+    {
+        state_ = CircuitState::HalfOpen;
+        LOG_INFO("Database circuit half-open: a connection was reestablished");
+    }
+}
+
+uint64_t CircuitBreaker::getOpenCount() const noexcept
+{
+    return openCount_.load();
+}
+}
@@ -0,0 +1,141 @@
+#ifndef CIRCUIT_BREAKER_H
+#define CIRCUIT_BREAKER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+
+namespace database
+{
+/**
+ * @enum CircuitState
+ * @brief State of a CircuitBreaker
+ */
+enum class CircuitState
+{
+    Closed,  ///< The database is reachable, queries run
+    Open,    ///< The database is unreachable, queries fail at once
+    HalfOpen ///< A connection was reestablished, queries run and the first failure opens the circuit again
+};
+
+/**
+ * @struct CircuitBreakerSettings
+ * @brief Thresholds of the circuit breaker of a DatabaseManager
+ */
+struct CircuitBreakerSettings final
+{
+    unsigned int failureThreshold{ 5 };                 ///< Consecutive connection failures that open the circuit
+    std::chrono::milliseconds reconnectInterval{ 1000 }; ///< First delay between reconnection attempts, doubled after each failed attempt
+};
+
+/**
+ * @class DatabaseUnavailableError
+ * @brief Thrown instead of running a query while the database is unreachable
+ */
+class DatabaseUnavailableError final : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @class CircuitBreaker
+ * @brief Tracks whether the database is reachable, so queries fail fast while it is not
+ *
+ * Counts consecutive connection failures: lost connections of queries and failed
+ * reconnection attempts. Once the threshold is reached the circuit opens and queries
+ * are rejected without touching the pool. When a connection is established again the
+ * circuit is half-open: queries run, and the first success closes the circuit while
+ * the first failure opens it again. Other errors, such as SQL errors, show that the
+ * database answered and count as successes.
+ *
+ * @note Thread-safe
+ * @see DatabaseManager
+ */
+class CircuitBreaker final
+{
+public:
+    /**
+     * @brief Constructs a closed circuit breaker
+     * @param failureThreshold Consecutive failures that open the circuit, at least 1
+     */
+    explicit CircuitBreaker(unsigned int failureThreshold) noexcept;
+
+    /**
+     * @brief Default destructor
+     */
+    ~CircuitBreaker() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note CircuitBreaker should not be copied
+     */
+    CircuitBreaker(const CircuitBreaker&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note CircuitBreaker should not be copied
+     */
+    CircuitBreaker& operator=(const CircuitBreaker&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note CircuitBreaker should not be moved
+     */
+    CircuitBreaker(CircuitBreaker&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note CircuitBreaker should not be moved
+     */
+    CircuitBreaker& operator=(CircuitBreaker&&) = delete;
+
+    /**
+     * @brief Checks if queries may run
+     * @return bool False while the circuit is open
+     */
+    [[nodiscard]] bool isAllowed() const noexcept;
+
+    /**
+     * @brief Gets the current state
+     * @return CircuitState State of the circuit
+     */
+    [[nodiscard]] CircuitState getState() const noexcept;
+
+    /**
+     * @brief Records a query that reached the database
+     * @note Closes a half-open circuit
+     */
+    void recordSuccess() noexcept;
+
+    /**
+     * @brief Records a lost connection or a failed attempt to connect
+     * @return bool True if this failure opened the circuit
+     */
+    [[nodiscard]] bool recordFailure() noexcept;
+
+    /**
+     * @brief Records a connection established again while the circuit is open
+     * @note Makes an open circuit half-open
+     */
+    void recordRecovery() noexcept;
+
+    /**
+     * @brief Gets the number of times the circuit opened
+     * @return uint64_t Number of outages detected
+     */
+    [[nodiscard]] uint64_t getOpenCount() const noexcept;
+
+private:
+    const unsigned int failureThreshold_; ///< Consecutive failures that open the circuit
+
+    std::mutex mutex_;                                        ///< Mutex for state transitions and failures_
+    std::atomic<CircuitState> state_{ CircuitState::Closed }; ///< Current state, read without the lock
+    std::atomic<unsigned int> failures_{ 0 };                 ///< Consecutive failures while closed
+    std::atomic<uint64_t> openCount_{ 0 };                    ///< Number of times the circuit opened
+};
+}
+
+#endif // CIRCUIT_BREAKER_H
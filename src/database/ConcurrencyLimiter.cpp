@@ -0,0 +1,138 @@
+#include "ConcurrencyLimiter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace database
+{
+constexpr double MIN_GRADIENT{ 0.5 };
+constexpr double LIMIT_SMOOTHING{ 0.2 };
+constexpr double DROP_BACKOFF{ 0.9 };
+constexpr double PROBE_RATIO{ 0.5 };
+constexpr int64_t RTT_AVERAGE_WEIGHT{ 8 };
+
+ConcurrencyLimiter::ConcurrencyLimiter(unsigned int minLimit, unsigned int maxLimit) :
+    minLimit_{ static_cast<double>(std::max(minLimit, 1u)) },
+    maxLimit_{ static_cast<double>(std::max({ maxLimit, minLimit, 1u })) },
+    limit_{ minLimit_ }
+{
+    rttHistory_.reserve(RTT_HISTORY_SIZE);
+}
+
+bool ConcurrencyLimiter::acquire(std::chrono::steady_clock::duration timeout)
+{
+    std::unique_lock lock{ mutex_ };
+
+    if (!condition_.wait_for(lock, timeout, [this]()
+    {
+        return inFlight_ < getLimitLocked();
+    }))
+    {
+        return false;
+    }
+
+    ++inFlight_;
+    return true;
+}
+
+void ConcurrencyLimiter::release(std::chrono::steady_clock::duration rtt, bool isDropped)
+{
+    {
+        std::lock_guard lock{ mutex_ };
+
+        // the query counts as in flight for its own sample
+        const auto inFlight{ inFlight_ };
+        --inFlight_;
+
+        if (isDropped)
+        {
+            ++drops_;
+            limit_ = std::max(limit_ * DROP_BACKOFF, minLimit_);
+        }
+        else
+        {
+            const auto sample{ std::max(std::chrono::duration_cast<std::chrono::microseconds>(rtt), std::chrono::microseconds{ 1 }) };
+
+            if (rttHistory_.size() < RTT_HISTORY_SIZE)
+            {
+                rttHistory_.push_back(sample);
+            }
+            else
+            {
+                rttHistory_[samples_ % RTT_HISTORY_SIZE] = sample;
+            }
+
+            // the previous window still counts, so a new window does not start from a single sample
+            if (samples_ % MIN_RTT_WINDOW == 0)
+            {
+                minRtt_ = samples_ == 0 ? sample : std::min(windowMinRtt_, sample);
+                windowMinRtt_ = sample;
+                limit_ = std::max(limit_ * PROBE_RATIO, minLimit_);
+            }
+            else
+            {
+                windowMinRtt_ = std::min(windowMinRtt_, sample);
+                minRtt_ = std::min(minRtt_, sample);
+            }
+
+            smoothedRtt_ = samples_ == 0 ? sample : smoothedRtt_ + (sample - smoothedRtt_) / RTT_AVERAGE_WEIGHT;
+            ++samples_;
+
+            // a half idle limit says nothing about the capacity of the database
+            if (inFlight * 2 >= getLimitLocked())
+            {
+                const auto gradient{ std::clamp(static_cast<double>(minRtt_.count()) / static_cast<double>(smoothedRtt_.count()), MIN_GRADIENT, 1.0) };
+                const auto newLimit{ limit_ * gradient + std::sqrt(limit_) };
+                limit_ = std::clamp(limit_ * (1.0 - LIMIT_SMOOTHING) + newLimit * LIMIT_SMOOTHING, minLimit_, maxLimit_);
+            }
+        }
+    }
+
+    condition_.notify_all();
+}
+
+void ConcurrencyLimiter::abandon()
+{
+    {
+        std::lock_guard lock{ mutex_ };
+        --inFlight_;
+    }
+
+    condition_.notify_all();
+}
+
+unsigned int ConcurrencyLimiter::getLimit() const noexcept
+{
+    std::lock_guard lock{ mutex_ };
+    return getLimitLocked();
+}
+
+ConcurrencyStatistics ConcurrencyLimiter::getStatistics() const noexcept
+{
+    std::lock_guard lock{ mutex_ };
+    return ConcurrencyStatistics{ getLimitLocked(), inFlight_, minRtt_, smoothedRtt_, samples_, drops_ };
+}
+
+std::vector<std::chrono::microseconds> ConcurrencyLimiter::getRttSamples() const
+{
+    std::lock_guard lock{ mutex_ };
+
+    if (rttHistory_.size() < RTT_HISTORY_SIZE)
+    {
+        return rttHistory_;
+    }
+
+    // the oldest sample is the one overwritten next
+    std::vector<std::chrono::microseconds> samples{};
+    samples.reserve(RTT_HISTORY_SIZE);
+
+    const auto oldest{ rttHistory_.begin() + static_cast<std::ptrdiff_t>(samples_ % RTT_HISTORY_SIZE) };
+    samples.insert(samples.end(), oldest, rttHistory_.end());
+    samples.insert(samples.end(), rttHistory_.begin(), oldest);
+    return samples;
+}
+
+unsigned int ConcurrencyLimiter::getLimitLocked() const noexcept
+{
+    return static_cast<unsigned int>(limit_);
+}
+}
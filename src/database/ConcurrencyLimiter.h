@@ -0,0 +1,169 @@
+#ifndef CONCURRENCY_LIMITER_H
+#define CONCURRENCY_LIMITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace database
+{
+/**
+ * @struct ConcurrencySettings
+ * @brief Bounds of the adaptive concurrency limit of a DatabaseManager
+ */
+struct ConcurrencySettings final
+{
+    bool isAdaptive{ false };   ///< Adapts the number of concurrent queries; otherwise the pool size is the limit
+    unsigned int minLimit{ 1 }; ///< Lowest number of concurrent queries the limit may drop to
+};
+
+/**
+ * @struct ConcurrencyStatistics
+ * @brief Snapshot of the state of a ConcurrencyLimiter
+ */
+struct ConcurrencyStatistics final
+{
+    unsigned int limit{ 0 };                 ///< Number of queries allowed to run at once
+    unsigned int inFlight{ 0 };              ///< Number of running queries
+    std::chrono::microseconds minRtt{};      ///< Lowest query time of the current window, the latency without queueing
+    std::chrono::microseconds smoothedRtt{}; ///< Moving average of recent query times
+    uint64_t samples{ 0 };                   ///< Number of query times taken into account so far
+    uint64_t drops{ 0 };                     ///< Number of queries cancelled or timed out, each lowering the limit
+};
+
+/**
+ * @class ConcurrencyLimiter
+ * @brief Adaptive limit of the number of concurrent database queries
+ *
+ * Finds the concurrency at which PostgreSQL delivers the most throughput without
+ * queueing inside the database, using the latency gradient of the query time (RTT):
+ *
+ *     gradient = clamp(minRtt / smoothedRtt, 0.5, 1.0)
+ *     newLimit = limit * gradient + sqrt(limit)
+ *
+ * While query times stay at the minimum the limit grows by its square root, which
+ * probes for headroom; once queries slow down because the database is saturated the
+ * gradient shrinks the limit. The minimum RTT is the lowest sample of the current and
+ * the previous window of samples, so the limit follows changes of the query mix. Under
+ * constant saturation every sample would be queued and the minimum would creep up with
+ * the limit, so the limit is halved at the start of each window to measure query times
+ * with little queueing; it grows back within a few samples. A cancelled or timed out
+ * query lowers the limit multiplicatively. The limit starts at the minimum and only
+ * grows while at least half of it is in use, so an idle server does not drift to the
+ * maximum.
+ *
+ * Queries over the limit wait in acquire(), in front of the connection pool.
+ *
+ * @note Thread-safe
+ * @see DatabaseManager
+ */
+class ConcurrencyLimiter final
+{
+public:
+    /**
+     * @brief Constructs a limiter that starts at the minimum
+     * @param minLimit Lowest limit
+     * @param maxLimit Highest limit, the size of the connection pool
+     */
+    ConcurrencyLimiter(unsigned int minLimit, unsigned int maxLimit);
+
+    /**
+     * @brief Default destructor
+     */
+    ~ConcurrencyLimiter() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note ConcurrencyLimiter should not be copied
+     */
+    ConcurrencyLimiter(const ConcurrencyLimiter&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note ConcurrencyLimiter should not be copied
+     */
+    ConcurrencyLimiter& operator=(const ConcurrencyLimiter&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note ConcurrencyLimiter should not be moved
+     */
+    ConcurrencyLimiter(ConcurrencyLimiter&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note ConcurrencyLimiter should not be moved
+     */
+    ConcurrencyLimiter& operator=(ConcurrencyLimiter&&) = delete;
+
+    /**
+     * @brief Waits until a query may run
+     * @param timeout Maximum time to wait
+     * @return bool True if the query was admitted and must be released, false on timeout
+     */
+    [[nodiscard]] bool acquire(std::chrono::steady_clock::duration timeout);
+
+    /**
+     * @brief Ends an admitted query and adapts the limit to its duration
+     * @param rtt Time the query took
+     * @param isDropped True if the query was cancelled or timed out
+     */
+    void release(std::chrono::steady_clock::duration rtt, bool isDropped);
+
+    /**
+     * @brief Ends an admitted query that never reached the database, leaving the limit as it is
+     * @note For queries given up before they ran, whose time says nothing about the database
+     */
+    void abandon();
+
+    /**
+     * @brief Gets the current limit
+     * @return unsigned int Number of queries allowed to run at once
+     */
+    [[nodiscard]] unsigned int getLimit() const noexcept;
+
+    /**
+     * @brief Gets the current limit and the RTT estimates behind it
+     * @return ConcurrencyStatistics Snapshot of the limiter
+     */
+    [[nodiscard]] ConcurrencyStatistics getStatistics() const noexcept;
+
+    /**
+     * @brief Gets the most recent query times
+     * @return std::vector<std::chrono::microseconds> Up to RTT_HISTORY_SIZE samples, oldest first
+     */
+    [[nodiscard]] std::vector<std::chrono::microseconds> getRttSamples() const;
+
+    static constexpr size_t RTT_HISTORY_SIZE{ 64 };    ///< Number of recent query times kept for inspection
+    static constexpr uint64_t MIN_RTT_WINDOW{ 500 };   ///< Number of samples of a window of the minimum RTT
+
+private:
+    /**
+     * @brief Gets the current limit as a whole number of queries
+     * @return unsigned int Limit, within the bounds
+     * @note Requires mutex_ to be held
+     */
+    [[nodiscard]] unsigned int getLimitLocked() const noexcept;
+
+private:
+    const double minLimit_; ///< Lowest limit
+    const double maxLimit_; ///< Highest limit
+
+    mutable std::mutex mutex_;         ///< Mutex for the state below
+    std::condition_variable condition_; ///< Signals released queries and a raised limit
+    double limit_;                     ///< Current limit, fractional so that small steps add up
+    unsigned int inFlight_{ 0 };       ///< Number of running queries
+
+    std::chrono::microseconds minRtt_{};      ///< Lowest RTT of the current and the previous window
+    std::chrono::microseconds windowMinRtt_{}; ///< Lowest RTT of the current window
+    std::chrono::microseconds smoothedRtt_{}; ///< Moving average of the RTT
+    uint64_t samples_{ 0 };                   ///< Number of RTT samples so far
+    uint64_t drops_{ 0 };                     ///< Number of dropped queries so far
+
+    std::vector<std::chrono::microseconds> rttHistory_; ///< Ring buffer of recent RTT samples
+};
+}
+
+#endif // CONCURRENCY_LIMITER_H
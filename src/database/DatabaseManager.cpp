@@ -1,15 +1,30 @@
 #include "DatabaseManager.h"
+#include "../utils/Deadline.h"
 #include "../utils/Logger.h"
+#include <algorithm>
 #include <format>
 #include <chrono>
 #include <stdexcept>
 
 namespace database
 {
-DatabaseManager::DatabaseManager(const std::string& address, uint16_t port, const std::string& username, const std::string& password, const std::string& dbName, unsigned int maxConnections, unsigned int connectionTimeout) :
-	connectionString_{ std::format("postgresql://{}:{}@{}:{}/{}?connect_timeout={}&sslmode=require", username, password, address, port, dbName, connectionTimeout) },
+constexpr int64_t AVERAGE_WEIGHT{ 8 };
+constexpr std::chrono::milliseconds MIN_STATEMENT_TIMEOUT{ 1 };
+constexpr std::chrono::milliseconds STATEMENT_TIMEOUT_TOLERANCE{ 100 }; // overrun of the remaining budget accepted to save the SET LOCAL round trip
+constexpr std::chrono::milliseconds MAX_RECONNECT_DELAY{ 30000 };
+
+DatabaseManager::DatabaseManager(const std::string& address, uint16_t port, const std::string& username, const std::string& password, const std::string& dbName, unsigned int maxConnections, unsigned int connectionTimeout,
+    const ConcurrencySettings& concurrencySettings, const CircuitBreakerSettings& circuitSettings, std::chrono::milliseconds statementTimeout) :
+	connectionString_{ std::format("postgresql://{}:{}@{}:{}/{}?connect_timeout={}&sslmode=require", username, password, address, port, dbName, connectionTimeout) +
+        // the default is sent with the startup message, so it costs no round trip
+        (statementTimeout > std::chrono::milliseconds::zero() ? std::format("&options=-c%20statement_timeout%3D{}", statementTimeout.count()) : std::string{}) },
     maxConnections_{ maxConnections },
-    connectionTimeout_{ connectionTimeout }
+    connectionTimeout_{ connectionTimeout },
+    statementTimeout_{ std::max(statementTimeout, std::chrono::milliseconds::zero()) },
+    concurrencyLimiter_{ concurrencySettings.isAdaptive ? std::make_unique<ConcurrencyLimiter>(concurrencySettings.minLimit, maxConnections) : nullptr },
+    circuitBreaker_{ circuitSettings.failureThreshold },
+    reconnectInterval_{ circuitSettings.reconnectInterval },
+    reconnectDelay_{ circuitSettings.reconnectInterval.count() }
 {
     LOG_DEBUG("Connection string: " + connectionString_);
 
@@ -19,13 +34,7 @@ DatabaseManager::DatabaseManager(const std::string& address, uint16_t port, cons
     {
         for (auto _ : std::ranges::views::iota(0u, maxConnections_))
         {
-            auto conn{ std::make_unique<pqxx::connection>(connectionString_) };
-            if (!conn->is_open()) 
-            {
-                throw std::runtime_error("Failed to establish database connection");
-            }
-
-            conn->set_client_encoding("UTF8");
+            auto conn{ createConnection() };
 
             std::lock_guard lock{ poolMutex_ };
             connectionPool_.push(std::move(conn));
@@ -43,11 +52,23 @@ DatabaseManager::DatabaseManager(const std::string& address, uint16_t port, cons
         throw std::runtime_error{ "No database connections could be established during initialization" };
     }
 
+    reconnector_ = std::jthread{ [this](const std::stop_token& stopToken)
+    {
+        reconnect(stopToken);
+    } };
+
     LOG_INFO("Database connection pool initialized successfully");
 }
 
 DatabaseManager::~DatabaseManager() noexcept
 {
+    // the reconnection thread must not add connections to a pool being torn down
+    reconnector_.request_stop();
+    if (reconnector_.joinable())
+    {
+        reconnector_.join();
+    }
+
     poolCondition_.notify_all();
 
     std::lock_guard lock{ poolMutex_ };
@@ -61,14 +82,88 @@ DatabaseManager::~DatabaseManager() noexcept
 
 pqxx::result DatabaseManager::executeQuery(const std::string& query)
 {
-    auto connection{ acquireConnection() };
+    return executeInTransaction(query, [&query](pqxx::work& transaction)
+    {
+        return transaction.exec(query);
+    });
+}
+
+pqxx::result DatabaseManager::executeQuery(const std::string& query, const pqxx::params& params)
+{
+    return executeInTransaction(query, [&query, &params](pqxx::work& transaction)
+    {
+        return transaction.exec(query, params);
+    });
+}
+
+pqxx::result DatabaseManager::executeInTransaction(const std::string& query, const std::function<pqxx::result(pqxx::work&)>& action)
+{
+    // queries fail at once while the database is down, instead of each waiting for a connection timeout
+    if (!circuitBreaker_.isAllowed())
+    {
+        throw DatabaseUnavailableError{ "Database is unavailable" };
+    }
+
+    // the deadline of the request this thread serves, if any
+    const auto* deadline{ utils::DeadlineScope::getCurrent() };
+    if (deadline && (deadline->isCancelled() || deadline->isExpired()))
+    {
+        throw std::runtime_error{ "Request deadline exceeded before the query was sent" };
+    }
+
+    const auto waitTimeout{ getWaitTimeout(deadline) };
+    admitQuery(waitTimeout);
+
+    std::unique_ptr<pqxx::connection> connection{};
+    try
+    {
+        connection = acquireConnection(waitTimeout);
+    }
+    catch (const std::exception&)
+    {
+        // the pool could not keep up with the limit, so the limit is too high; a short request deadline or an outage says nothing about that
+        if (concurrencyLimiter_ && waitTimeout >= std::chrono::seconds{ connectionTimeout_ } && circuitBreaker_.isAllowed())
+        {
+            concurrencyLimiter_->release(std::chrono::steady_clock::duration::zero(), true);
+        }
+        else if (concurrencyLimiter_)
+        {
+            // no query ran, so there is no query time to learn from
+            concurrencyLimiter_->abandon();
+        }
+
+        throw;
+    }
+
+    const auto acquired{ std::chrono::steady_clock::now() };
 
     try 
     {
         pqxx::work transaction{ *connection };
-        auto result{ transaction.exec(query) };
+
+        utils::CancelRegistration cancelRegistration{};
+        if (deadline && deadline->hasLimit())
+        {
+            // the database stops the statement once the client stops waiting for it; the connection's default
+            // is the whole request budget, so the extra round trip is only needed once much of it is used up
+            const auto statementTimeout{ std::max(std::chrono::duration_cast<std::chrono::milliseconds>(deadline->getRemaining()), MIN_STATEMENT_TIMEOUT) };
+            if (statementTimeout_ == std::chrono::milliseconds::zero() || statementTimeout + STATEMENT_TIMEOUT_TOLERANCE < statementTimeout_)
+            {
+                transaction.exec(std::format("SET LOCAL statement_timeout = {}", statementTimeout.count()));
+            }
+
+            cancelRegistration = deadline->onCancel([&connection]()
+            {
+                connection->cancel_query();
+            });
+        }
+
+        auto result{ action(transaction) };
         transaction.commit();
+        cancelRegistration.reset();
 
+        circuitBreaker_.recordSuccess();
+        finishQuery(std::chrono::steady_clock::now() - acquired, false);
         releaseConnection(std::move(connection));
 
         LOG_DEBUG("Query executed successfully: " + query);
@@ -76,13 +171,24 @@ pqxx::result DatabaseManager::executeQuery(const std::string& query)
     }
     catch (const pqxx::sql_error& e)
     {
-        handleConnectionError(std::move(connection));
+        // a statement cancelled by its timeout means the database is too slow, one cancelled for a gone client
+        // and other SQL errors say nothing about load
+        const auto isDropped{ dynamic_cast<const pqxx::query_cancelled*>(&e) != nullptr && !(deadline && deadline->isCancelled()) };
+        circuitBreaker_.recordSuccess();
+        finishQuery(std::chrono::steady_clock::now() - acquired, isDropped);
+        releaseConnection(std::move(connection));
         LOG_ERROR("SQL error in query '" + query + "': " + e.what());
         throw std::runtime_error(std::format("Query execution failed: {}", e.what()));
     }
     catch (const std::exception& e) 
     {
-        handleConnectionError(std::move(connection));
+        if (dynamic_cast<const pqxx::broken_connection*>(&e) != nullptr)
+        {
+            recordConnectionFailure();
+        }
+
+        finishQuery(std::chrono::steady_clock::now() - acquired, false);
+        releaseConnection(std::move(connection));
         LOG_ERROR("Unexpected error in query '" + query + "': " + e.what());
         throw std::runtime_error(std::format("Query execution failed: {}", e.what()));
     }
@@ -102,34 +208,97 @@ bool DatabaseManager::healthCheck() noexcept
     }
 }
 
-std::unique_ptr<pqxx::connection> DatabaseManager::acquireConnection()
+PoolStatistics DatabaseManager::getPoolStatistics() noexcept
 {
-    std::unique_lock lock{ poolMutex_ };
+    PoolStatistics statistics{};
+    statistics.poolSize = maxConnections_;
+    statistics.concurrencyLimit = maxConnections_;
+    statistics.waitingQueries = waitingQueries_.load();
+    statistics.averageHoldTime = std::chrono::microseconds{ averageHoldTime_.load() };
+    statistics.averageWaitTime = std::chrono::microseconds{ averageWaitTime_.load() };
+
+    size_t freeSlots{ maxConnections_ };
+    if (concurrencyLimiter_)
+    {
+        const auto concurrency{ concurrencyLimiter_->getStatistics() };
+        statistics.concurrencyLimit = concurrency.limit;
+        freeSlots = concurrency.limit > concurrency.inFlight ? concurrency.limit - concurrency.inFlight : 0;
+    }
+
+    std::lock_guard lock{ poolMutex_ };
+    statistics.availableConnections = std::min(connectionPool_.size(), freeSlots);
 
-    const auto timeout{ std::chrono::seconds(connectionTimeout_) };
-    if (!poolCondition_.wait_for(lock, timeout, [this]()
+    return statistics;
+}
+
+std::chrono::milliseconds DatabaseManager::estimateWait(const PoolStatistics& statistics) noexcept
+{
+    if (statistics.concurrencyLimit == 0 || statistics.availableConnections > statistics.waitingQueries)
     {
-        return !connectionPool_.empty();
-    }))
+        return std::chrono::milliseconds::zero();
+    }
+
+    // a new query is served after the waiting ones that no idle connection is left for
+    const auto queriesAhead{ static_cast<int64_t>(statistics.waitingQueries - statistics.availableConnections + 1) };
+    return std::chrono::ceil<std::chrono::milliseconds>(statistics.averageHoldTime * queriesAhead / static_cast<int64_t>(statistics.concurrencyLimit));
+}
+
+ConcurrencyStatistics DatabaseManager::getConcurrencyStatistics() const noexcept
+{
+    if (concurrencyLimiter_)
     {
-        throw std::runtime_error{ "Timeout waiting for database connection" };
+        return concurrencyLimiter_->getStatistics();
     }
 
-    if (connectionPool_.empty()) 
+    ConcurrencyStatistics statistics{};
+    statistics.limit = maxConnections_;
+    statistics.inFlight = borrowedConnections_.load();
+    return statistics;
+}
+
+bool DatabaseManager::isAvailable() const noexcept
+{
+    return circuitBreaker_.isAllowed();
+}
+
+std::chrono::milliseconds DatabaseManager::getReconnectDelay() const noexcept
+{
+    return std::chrono::milliseconds{ reconnectDelay_.load() };
+}
+
+CircuitState DatabaseManager::getCircuitState() const noexcept
+{
+    return circuitBreaker_.getState();
+}
+
+std::vector<std::chrono::microseconds> DatabaseManager::getConcurrencyRttSamples() const
+{
+    return concurrencyLimiter_ ? concurrencyLimiter_->getRttSamples() : std::vector<std::chrono::microseconds>{};
+}
+
+std::unique_ptr<pqxx::connection> DatabaseManager::acquireConnection(std::chrono::milliseconds timeout)
+{
+    std::unique_lock lock{ poolMutex_ };
+
+    const auto waitStart{ std::chrono::steady_clock::now() };
+
+    ++waitingQueries_;
+    const auto isAvailable{ poolCondition_.wait_for(lock, timeout, [this]()
     {
-        // create new connection if pool is empty but we haven't reached max connections
-        auto conn{ std::make_unique<pqxx::connection>(connectionString_) };
-        if (!conn->is_open()) 
-        {
-            throw std::runtime_error("Failed to create new database connection");
-        }
+        return !connectionPool_.empty() || !circuitBreaker_.isAllowed();
+    }) };
+    --waitingQueries_;
 
-        conn->set_client_encoding("UTF8");
+    updateAverage(averageWaitTime_, std::chrono::steady_clock::now() - waitStart);
 
-        ++borrowedConnections_;
-        LOG_DEBUG("Database connection borrowed. Borrowed: " + std::to_string(borrowedConnections_) + ", Available: " + std::to_string(connectionPool_.size()));
+    if (!circuitBreaker_.isAllowed())
+    {
+        throw DatabaseUnavailableError{ "Database is unavailable" };
+    }
 
-        return conn;
+    if (!isAvailable)
+    {
+        throw std::runtime_error{ "Timeout waiting for database connection" };
     }
 
     auto conn{ std::move(connectionPool_.front()) };
@@ -145,70 +314,142 @@ void DatabaseManager::releaseConnection(std::unique_ptr<pqxx::connection> connec
 {
     {
         std::lock_guard lock{ poolMutex_ };
+        --borrowedConnections_;
+
         if (connection && connection->is_open()) 
         {
             connectionPool_.emplace(std::move(connection));
-
-            --borrowedConnections_;
             LOG_DEBUG("Database connection returned to pool. Borrowed: " + std::to_string(borrowedConnections_) + ", Available: " + std::to_string(connectionPool_.size()));
         }
         else 
         {
-            // Connection is bad, create a new one
-            try 
-            {
-	            if (auto newConn{ std::make_unique<pqxx::connection>(connectionString_) }; newConn->is_open()) 
-                {
-                    newConn->set_client_encoding("UTF8");
-	            	connectionPool_.emplace(std::move(newConn));
-
-                    --borrowedConnections_;
-                    LOG_DEBUG("Database connection returned to pool. Borrowed: " + std::to_string(borrowedConnections_) + ", Available: " + std::to_string(connectionPool_.size()));
-                }
-            }
-            catch (...) 
-            {
-                LOG_WARNING("Invalid connection discarded from pool");
-            }
+            // connecting may take the whole connection timeout, so the replacement is left to the reconnection thread
+            ++missingConnections_;
+            LOG_WARNING("Broken database connection discarded from pool");
         }
     }
 
     poolCondition_.notify_one();
+    reconnectCondition_.notify_one();
 }
 
-void DatabaseManager::handleConnectionError(std::unique_ptr<pqxx::connection> connection)
+std::unique_ptr<pqxx::connection> DatabaseManager::createConnection() const
 {
+    auto connection{ std::make_unique<pqxx::connection>(connectionString_) };
+    if (!connection->is_open())
+    {
+        throw std::runtime_error{ "Failed to establish database connection" };
+    }
+
+    connection->set_client_encoding("UTF8");
+    return connection;
+}
+
+void DatabaseManager::recordConnectionFailure() noexcept
+{
+    if (!circuitBreaker_.recordFailure())
+    {
+        return;
+    }
+
+    // the other idle connections most likely broke with the database, they are closed outside of the lock
+    std::queue<std::unique_ptr<pqxx::connection>> idleConnections{};
     {
         std::lock_guard lock{ poolMutex_ };
-        // try to recreate the connection if it's in a bad state
-        try 
-        {
-            if (!connection || !connection->is_open()) 
-            {
-	            if (auto newConn{ std::make_unique<pqxx::connection>(connectionString_) }; newConn->is_open()) 
-                {
-                    newConn->set_client_encoding("UTF8");
-	            	connectionPool_.emplace(std::move(newConn));
-
-                    --borrowedConnections_;
-                    LOG_DEBUG("Database connection returned to pool. Borrowed: " + std::to_string(borrowedConnections_) + ", Available: " + std::to_string(connectionPool_.size()));
-                }
-            }
-            else 
-            {
-                connection->set_client_encoding("UTF8");
-            	connectionPool_.emplace(std::move(connection));
+        missingConnections_ += connectionPool_.size();
+        std::swap(idleConnections, connectionPool_);
+    }
 
-                --borrowedConnections_;
-                LOG_DEBUG("Database connection returned to pool. Borrowed: " + std::to_string(borrowedConnections_) + ", Available: " + std::to_string(connectionPool_.size()));
-            }
+    poolCondition_.notify_all();
+    reconnectCondition_.notify_one();
+}
+
+void DatabaseManager::reconnect(const std::stop_token& stopToken)
+{
+    std::unique_lock lock{ poolMutex_ };
+
+    while (reconnectCondition_.wait(lock, stopToken, [this]() { return missingConnections_ > 0; }))
+    {
+        lock.unlock();
+
+        std::unique_ptr<pqxx::connection> connection{};
+        try
+        {
+            connection = createConnection();
+        }
+        catch (const std::exception& e)
+        {
+            LOG_WARNING("Failed to reconnect to the database: " + std::string{ e.what() });
         }
-        catch (...) 
+
+        if (connection)
         {
-            LOG_WARNING("Invalid connection discarded from pool");
+            circuitBreaker_.recordRecovery();
+            reconnectDelay_ = reconnectInterval_.count();
+
+            lock.lock();
+            connectionPool_.emplace(std::move(connection));
+            --missingConnections_;
+
+            LOG_INFO("Database connection reestablished, " + std::to_string(missingConnections_) + " still missing");
+            poolCondition_.notify_one();
+            continue;
         }
+
+        recordConnectionFailure();
+
+        // attempts back off while the database stays unreachable
+        const std::chrono::milliseconds delay{ reconnectDelay_.load() };
+        reconnectDelay_ = std::min(delay * 2, std::max(MAX_RECONNECT_DELAY, reconnectInterval_)).count();
+
+        lock.lock();
+        reconnectCondition_.wait_for(lock, stopToken, delay, []() { return false; });
     }
+}
 
-    poolCondition_.notify_one();
+void DatabaseManager::updateAverage(std::atomic<int64_t>& average, std::chrono::steady_clock::duration sample) noexcept
+{
+    const auto value{ std::chrono::duration_cast<std::chrono::microseconds>(sample).count() };
+    const auto current{ average.load() };
+    average.store(current + (value - current) / AVERAGE_WEIGHT);
+}
+
+void DatabaseManager::admitQuery(std::chrono::milliseconds timeout)
+{
+    if (!concurrencyLimiter_)
+    {
+        return;
+    }
+
+    // queries over the limit queue here instead of inside the database
+    ++waitingQueries_;
+    const auto isAdmitted{ concurrencyLimiter_->acquire(timeout) };
+    --waitingQueries_;
+
+    if (!isAdmitted)
+    {
+        throw std::runtime_error{ "Timeout waiting for the database concurrency limit" };
+    }
+}
+
+std::chrono::milliseconds DatabaseManager::getWaitTimeout(const utils::Deadline* deadline) const noexcept
+{
+    const std::chrono::milliseconds timeout{ std::chrono::seconds{ connectionTimeout_ } };
+    if (!deadline || !deadline->hasLimit())
+    {
+        return timeout;
+    }
+
+    return std::min(timeout, std::chrono::duration_cast<std::chrono::milliseconds>(deadline->getRemaining()));
+}
+
+void DatabaseManager::finishQuery(std::chrono::steady_clock::duration holdTime, bool isDropped) noexcept
+{
+    updateAverage(averageHoldTime_, holdTime);
+
+    if (concurrencyLimiter_)
+    {
+        concurrencyLimiter_->release(holdTime, isDropped);
+    }
 }
 }
\ No newline at end of file
@@ -1,15 +1,36 @@
 #ifndef DATABASE_MANAGER_H
 #define DATABASE_MANAGER_H
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
+#include <thread>
 #include <pqxx/pqxx>
+#include "CircuitBreaker.h"
+#include "ConcurrencyLimiter.h"
+#include "../utils/Deadline.h"
 
 namespace database
 {
+/**
+ * @struct PoolStatistics
+ * @brief Snapshot of the load of the connection pool of a DatabaseManager
+ */
+struct PoolStatistics final
+{
+    size_t poolSize{ 0 };                        ///< Number of connections of the pool
+    size_t concurrencyLimit{ 0 };                ///< Number of queries allowed to run at once, the pool size unless adaptive
+    size_t availableConnections{ 0 };            ///< Number of connections a new query could take now
+    size_t waitingQueries{ 0 };                  ///< Number of queries waiting for the concurrency limit or a connection
+    std::chrono::microseconds averageHoldTime{}; ///< Moving average of the time a query keeps its connection
+    std::chrono::microseconds averageWaitTime{}; ///< Moving average of the time a query waits for a connection
+};
+
 /**
  * @class DatabaseManager
  * @brief Manages a thread-safe connection pool for PostgreSQL database
@@ -20,7 +41,9 @@ namespace database
  * with proper error handling.
  *
  * @note The connection pool is initialized with a fixed number of connections
- *       and manages them using RAII principles.
+ *       and manages them using RAII principles. Broken connections are replaced by a
+ *       background thread, never while a query waits, and a CircuitBreaker makes queries
+ *       fail at once while the database is unreachable.
  */
 class DatabaseManager final
 {
@@ -34,6 +57,10 @@ public:
      * @param dbName Name of the database to connect to
      * @param maxConnections Maximum size of the connection pool
      * @param connectionTimeout Connection timeout in seconds
+     * @param concurrencySettings Adaptive limit of concurrent queries; maxConnections is its upper bound
+     * @param circuitSettings Failure threshold of the circuit breaker and reconnection interval
+     * @param statementTimeout Default statement timeout of every connection, zero for none; the request timeout,
+     *        so a query only sets a shorter timeout of its own once its request has used up part of the budget
      * @throw std::runtime_error If connection pool initialization fails
      */
     DatabaseManager(const std::string& address,
@@ -42,10 +69,13 @@ public:
         const std::string& password,
         const std::string& dbName,
         unsigned int maxConnections,
-        unsigned int connectionTimeout);
+        unsigned int connectionTimeout,
+        const ConcurrencySettings& concurrencySettings = {},
+        const CircuitBreakerSettings& circuitSettings = {},
+        std::chrono::milliseconds statementTimeout = std::chrono::milliseconds::zero());
 
     /**
-     * @brief Destructor that ensures proper cleanup of connection pool
+     * @brief Destructor that stops reconnecting and ensures proper cleanup of connection pool
      */
     ~DatabaseManager() noexcept;
 
@@ -78,9 +108,20 @@ public:
      * @param query SQL query string to execute
      * @return pqxx::result Result set from the query execution
      * @throw std::runtime_error If query execution fails or connection timeout occurs
+     * @throw DatabaseUnavailableError If the database is unreachable
      */
     pqxx::result executeQuery(const std::string& query);
 
+    /**
+     * @brief Executes a parameterized SQL query using a connection from the pool
+     * @param query SQL query string with positional placeholders ($1, $2, ...)
+     * @param params Values bound to the placeholders (containers are sent as SQL arrays)
+     * @return pqxx::result Result set from the query execution
+     * @throw std::runtime_error If query execution fails or connection timeout occurs
+     * @throw DatabaseUnavailableError If the database is unreachable
+     */
+    pqxx::result executeQuery(const std::string& query, const pqxx::params& params);
+
     /**
      * @brief Performs a health check on the database
      * @return bool True if database is responsive, false otherwise
@@ -88,7 +129,64 @@ public:
      */
     bool healthCheck() noexcept;
 
+    /**
+     * @brief Gets the current load of the connection pool
+     * @return PoolStatistics Snapshot of the pool counters and averages
+     */
+    [[nodiscard]] PoolStatistics getPoolStatistics() noexcept;
+
+    /**
+     * @brief Estimates how long a query issued now would wait for a connection
+     * @param statistics Current load of the pool
+     * @return std::chrono::milliseconds Expected wait, zero if a connection is idle
+     * @note Every connection is assumed to be returned after the average hold time,
+     *       so the queries ahead are served concurrencyLimit at a time
+     */
+    [[nodiscard]] static std::chrono::milliseconds estimateWait(const PoolStatistics& statistics) noexcept;
+
+    /**
+     * @brief Checks if queries are run, i.e. the circuit breaker is not open
+     * @return bool False while the database is unreachable and queries fail at once
+     */
+    [[nodiscard]] bool isAvailable() const noexcept;
+
+    /**
+     * @brief Gets the delay before the next attempt to reconnect to the database
+     * @return std::chrono::milliseconds Current reconnection delay, grows while attempts fail
+     */
+    [[nodiscard]] std::chrono::milliseconds getReconnectDelay() const noexcept;
+
+    /**
+     * @brief Gets the state of the circuit breaker
+     * @return CircuitState Current state
+     */
+    [[nodiscard]] CircuitState getCircuitState() const noexcept;
+
+    /**
+     * @brief Gets the state of the adaptive concurrency limit
+     * @return ConcurrencyStatistics Current limit and RTT estimates, or the pool size as a fixed limit if not adaptive
+     */
+    [[nodiscard]] ConcurrencyStatistics getConcurrencyStatistics() const noexcept;
+
+    /**
+     * @brief Gets the recent query times the adaptive concurrency limit is based on
+     * @return std::vector<std::chrono::microseconds> Query times, oldest first; empty if the limit is not adaptive
+     */
+    [[nodiscard]] std::vector<std::chrono::microseconds> getConcurrencyRttSamples() const;
+
 private:
+    /**
+     * @brief Runs an action inside a transaction on a pooled connection
+     * @param query SQL query string (used for logging)
+     * @param action Callable executing the statement on the transaction
+     * @return pqxx::result Result set returned by the action
+     * @throw std::runtime_error If query execution fails, connection timeout occurs or the request deadline has passed
+     * @throw DatabaseUnavailableError If the circuit breaker is open
+     * @note The deadline of utils::DeadlineScope caps the wait for a connection and the statement timeout,
+     *       and its cancellation cancels the running statement
+     */
+    pqxx::result executeInTransaction(const std::string& query, const std::function<pqxx::result(pqxx::work&)>& action);
+
     /**
      * @class ConnectionWrapper
      * @brief RAII wrapper for database connections
@@ -166,34 +264,94 @@ private:
 
     /**
      * @brief Acquires a connection from the pool
+     * @param timeout Maximum time to wait for a free connection
      * @return std::unique_ptr<pqxx::connection> Acquired database connection
      * @throw std::runtime_error If connection acquisition times out
+     * @throw DatabaseUnavailableError If the circuit breaker opens while waiting
      */
-    std::unique_ptr<pqxx::connection> acquireConnection();
+    std::unique_ptr<pqxx::connection> acquireConnection(std::chrono::milliseconds timeout);
 
     /**
      * @brief Releases a connection back to the pool
      * @param connection Database connection to release
-     * @note If connection is invalid, creates a new one to maintain pool size
+     * @note If connection is invalid, it is dropped and replaced by the reconnection thread
      */
     void releaseConnection(std::unique_ptr<pqxx::connection> connection);
 
     /**
-     * @brief Handles connection errors and attempts recovery
-     * @param connection Database connection that encountered an error
+     * @brief Opens a new connection to the database
+     * @return std::unique_ptr<pqxx::connection> Open connection
+     * @throw std::exception If the database cannot be reached
+     * @note Blocks up to the connection timeout, so it is never called with poolMutex_ held
      */
-    void handleConnectionError(std::unique_ptr<pqxx::connection> connection);
+    [[nodiscard]] std::unique_ptr<pqxx::connection> createConnection() const;
+
+    /**
+     * @brief Accounts for a lost connection or a failed attempt to connect
+     * @note Once the circuit opens, idle connections are dropped as they most likely broke as well,
+     *       and queries waiting for a connection fail at once
+     */
+    void recordConnectionFailure() noexcept;
+
+    /**
+     * @brief Replaces dropped connections until stopped; runs on reconnector_
+     * @param stopToken Stop request of the thread
+     */
+    void reconnect(const std::stop_token& stopToken);
+
+    /**
+     * @brief Waits until the adaptive concurrency limit admits a query
+     * @param timeout Maximum time to wait
+     * @throw std::runtime_error If the query is not admitted in time
+     * @note Does nothing if the limit is not adaptive
+     */
+    void admitQuery(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Gets how long a query may wait for the concurrency limit and for a connection
+     * @param deadline Deadline of the current request, or nullptr
+     * @return std::chrono::milliseconds Connection timeout, capped by the time left to the request
+     */
+    [[nodiscard]] std::chrono::milliseconds getWaitTimeout(const utils::Deadline* deadline) const noexcept;
+
+    /**
+     * @brief Accounts for a finished query that held a connection
+     * @param holdTime Time the query kept its connection
+     * @param isDropped True if the query was cancelled by the database
+     */
+    void finishQuery(std::chrono::steady_clock::duration holdTime, bool isDropped) noexcept;
+
+    /**
+     * @brief Adds a sample to a moving average
+     * @param average Moving average in microseconds
+     * @param sample New sample
+     * @note Concurrent updates may drop a sample, which does not matter for an estimate
+     */
+    static void updateAverage(std::atomic<int64_t>& average, std::chrono::steady_clock::duration sample) noexcept;
 
 private:
     const std::string connectionString_; ///< PostgreSQL connection string
     const unsigned int maxConnections_; ///< Maximum connections in the pool
     const unsigned int connectionTimeout_; ///< Connection timeout in seconds
+    const std::chrono::milliseconds statementTimeout_; ///< Default statement timeout of every connection, zero for none
 
     std::queue<std::unique_ptr<pqxx::connection>> connectionPool_; ///< Queue of available connections
     std::mutex poolMutex_; ///< Mutex for thread-safe pool operations
     std::condition_variable poolCondition_; ///< Condition variable for connection waiting
 
     std::atomic<unsigned int> borrowedConnections_{}; ///< Counter for borrowed connections
+    std::atomic<size_t> waitingQueries_{};            ///< Number of queries waiting for the concurrency limit or a connection
+    std::atomic<int64_t> averageHoldTime_{};          ///< Moving average of the connection hold time in microseconds
+    std::atomic<int64_t> averageWaitTime_{};          ///< Moving average of the connection wait time in microseconds
+
+    std::unique_ptr<ConcurrencyLimiter> concurrencyLimiter_; ///< Adaptive limit of concurrent queries, null if the pool size is the limit
+
+    CircuitBreaker circuitBreaker_;                     ///< Tracks whether the database is reachable
+    const std::chrono::milliseconds reconnectInterval_; ///< First delay between reconnection attempts
+    std::atomic<int64_t> reconnectDelay_;               ///< Current delay between reconnection attempts in milliseconds
+    size_t missingConnections_{ 0 };                    ///< Number of dropped connections not replaced yet, guarded by poolMutex_
+    std::condition_variable_any reconnectCondition_;    ///< Wakes the reconnection thread when a connection is dropped
+    std::jthread reconnector_;                          ///< Background thread replacing dropped connections
 };
 }
 
@@ -0,0 +1,319 @@
+#include "AttachmentHandlers.h"
+#include "FileResponseStream.h"
+#include "../utils/HttpRange.h"
+#include "../utils/Logger.h"
+#include "../utils/Validators.h"
+#include <boost/algorithm/string.hpp>
+
+namespace handlers
+{
+constexpr auto ATTACHMENTS_PATH{ "/api/v1/attachments" };
+constexpr std::string_view ATTACHMENT_PATH_PREFIX{ "/api/v1/attachments/" };
+constexpr auto DEFAULT_CONTENT_TYPE{ "application/octet-stream" };
+constexpr auto MAX_CONTENT_TYPE_SIZE{ 127u };
+// attachments are immutable: the same ID always refers to the same content
+constexpr auto ATTACHMENT_CACHE_CONTROL{ "private, max-age=31536000, immutable" };
+
+AttachmentHandlers::AttachmentHandlers(std::shared_ptr<auth::JWTManager> jwtManager, std::shared_ptr<database::DatabaseManager> dbManager, std::shared_ptr<storage::AttachmentStore> attachmentStore) noexcept :
+    jwtManager_{ std::move(jwtManager) },
+    dbManager_{ std::move(dbManager) },
+    attachmentStore_{ std::move(attachmentStore) }
+{
+}
+
+boost::beast::http::response<boost::beast::http::string_body> AttachmentHandlers::handleRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) noexcept
+{
+    if (isUploadRequest(request) || isStreamingRequest(request))
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "STREAMING_REQUIRED", "Attachments are only available as direct requests");
+    }
+
+    return createErrorResponse(boost::beast::http::status::not_found, "ENDPOINT_NOT_FOUND", "Endpoint not found");
+}
+
+std::vector<boost::beast::http::verb> AttachmentHandlers::getSupportedMethods() const noexcept
+{
+    return { boost::beast::http::verb::get, boost::beast::http::verb::post };
+}
+
+bool AttachmentHandlers::isStreamingRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
+{
+    const std::string target{ request.target() };
+    const auto path{ target.substr(0, target.find('?')) };
+
+    return request.method() == boost::beast::http::verb::get && path.starts_with(ATTACHMENT_PATH_PREFIX) && path.size() > ATTACHMENT_PATH_PREFIX.size();
+}
+
+bool AttachmentHandlers::isUploadRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
+{
+    const std::string target{ request.target() };
+    return request.method() == boost::beast::http::verb::post && target.substr(0, target.find('?')) == ATTACHMENTS_PATH;
+}
+
+std::shared_ptr<IResponseStream> AttachmentHandlers::handleStreamRequest(const boost::beast::http::request<boost::beast::http::string_body>& request, boost::beast::http::response<boost::beast::http::string_body>& response) noexcept
+{
+    std::string userId;
+    if (auto error{ authenticate(request, userId) })
+    {
+        response = std::move(*error);
+        return nullptr;
+    }
+
+    const std::string target{ request.target() };
+    const auto attachmentId{ target.substr(ATTACHMENT_PATH_PREFIX.size(), target.find('?') - ATTACHMENT_PATH_PREFIX.size()) };
+
+    if (!utils::Validators::isUUIDValid(attachmentId))
+    {
+        response = createErrorResponse(boost::beast::http::status::bad_request, "INVALID_ATTACHMENT_ID", "Invalid attachment ID format");
+        return nullptr;
+    }
+
+    try
+    {
+        // the uploader and both parties of a message with the attachment may download it
+        const auto result{ dbManager_->executeQuery(R"(
+            SELECT a.sha256, a.size_bytes, a.content_type, a.file_name
+            FROM attachments a
+            WHERE a.attachment_id = $1 AND (a.uploader_id = $2 OR EXISTS (
+                SELECT 1 FROM message_attachments ma
+                JOIN messages m ON m.message_id = ma.message_id
+                WHERE ma.attachment_id = a.attachment_id AND (m.from_user_id = $2 OR m.to_user_id = $2)
+            )))",
+            pqxx::params{ attachmentId, userId }
+        ) };
+
+        if (result.empty())
+        {
+            response = createErrorResponse(boost::beast::http::status::not_found, "ATTACHMENT_NOT_FOUND", "Attachment not found");
+            return nullptr;
+        }
+
+        const auto digest{ result[0]["sha256"].as<std::string>() };
+        const auto size{ result[0]["size_bytes"].as<std::uint64_t>() };
+        const auto contentType{ result[0]["content_type"].as<std::string>() };
+        const auto fileName{ result[0]["file_name"].as<std::string>() };
+
+        // the content digest is a natural strong validator
+        const auto etag{ "\"" + digest + "\"" };
+        if (isETagMatched(request, etag))
+        {
+            response = createNotModifiedResponse(etag);
+            response.set(boost::beast::http::field::cache_control, ATTACHMENT_CACHE_CONTROL);
+            response.erase(boost::beast::http::field::vary);
+            return nullptr;
+        }
+
+        const auto path{ attachmentStore_->getPath(digest) };
+        if (path.empty() || !std::filesystem::exists(path))
+        {
+            LOG_ERROR("Attachment " + attachmentId + " is missing from the store: " + digest);
+            response = createErrorResponse(boost::beast::http::status::internal_server_error, "ATTACHMENT_MISSING", "Attachment file is missing");
+            return nullptr;
+        }
+
+        utils::ByteRange range{ 0, size > 0 ? size - 1 : 0 };
+        const auto rangeStatus{ utils::HttpRange::parse(std::string{ request[boost::beast::http::field::range] }, size, range) };
+
+        if (rangeStatus == utils::RangeStatus::Unsatisfiable)
+        {
+            response = createErrorResponse(boost::beast::http::status::range_not_satisfiable, "RANGE_NOT_SATISFIABLE", "Requested range is outside the attachment");
+            response.set(boost::beast::http::field::content_range, utils::HttpRange::toUnsatisfiedContentRange(size));
+            return nullptr;
+        }
+
+        auto stream{ std::make_shared<FileResponseStream>(path, range.first, size > 0 ? range.length() : 0) };
+
+        response = createStreamResponse(contentType);
+        response.set(boost::beast::http::field::cache_control, ATTACHMENT_CACHE_CONTROL);
+        response.set(boost::beast::http::field::etag, etag);
+        response.set(boost::beast::http::field::accept_ranges, "bytes");
+        response.set(boost::beast::http::field::content_disposition, "attachment; filename=\"" + fileName + "\"");
+        response.set("X-Content-Type-Options", "nosniff");
+
+        if (rangeStatus == utils::RangeStatus::Satisfiable)
+        {
+            response.result(boost::beast::http::status::partial_content);
+            response.set(boost::beast::http::field::content_range, utils::HttpRange::toContentRange(range, size));
+        }
+
+        LOG_DEBUG(std::format("Sending attachment {} ({} of {} bytes) to user {}", attachmentId, *stream->getContentLength(), size, userId));
+        return stream;
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to send attachment: " + std::string{ e.what() });
+        response = createErrorResponse(boost::beast::http::status::internal_server_error, "ATTACHMENT_DOWNLOAD_FAILED", "Failed to download attachment");
+        return nullptr;
+    }
+}
+
+std::optional<boost::beast::http::response<boost::beast::http::string_body>> AttachmentHandlers::handleUploadHeader(const boost::beast::http::request<boost::beast::http::string_body>& request, std::filesystem::path& bodyFile) noexcept
+{
+    std::string userId;
+    if (auto error{ authenticate(request, userId) })
+    {
+        return error;
+    }
+
+    if (!utils::Validators::isFileNameValid(extractFileName(request)))
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_FILE_NAME",
+            "file_name is required and may contain only letters, numbers, dots, dashes and underscores");
+    }
+
+    if (extractContentType(request).empty())
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Invalid Content-Type");
+    }
+
+    // the stored file must be the content itself
+    if (request.count(boost::beast::http::field::content_encoding) != 0)
+    {
+        return createErrorResponse(boost::beast::http::status::unsupported_media_type, "UNSUPPORTED_CONTENT_ENCODING", "Attachments must be uploaded without Content-Encoding");
+    }
+
+    try
+    {
+        bodyFile = attachmentStore_->createTempPath();
+        return std::nullopt;
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to prepare attachment upload: " + std::string{ e.what() });
+        return createErrorResponse(boost::beast::http::status::internal_server_error, "ATTACHMENT_UPLOAD_FAILED", "Failed to upload attachment");
+    }
+}
+
+boost::beast::http::response<boost::beast::http::string_body> AttachmentHandlers::handleUploadRequest(const boost::beast::http::request<boost::beast::http::string_body>& request, const std::filesystem::path& bodyFile) noexcept
+{
+    std::string userId;
+    if (auto error{ authenticate(request, userId) })
+    {
+        return std::move(*error);
+    }
+
+    try
+    {
+        if (std::filesystem::file_size(bodyFile) == 0)
+        {
+            return createErrorResponse(boost::beast::http::status::bad_request, "EMPTY_ATTACHMENT", "Attachment cannot be empty");
+        }
+
+        std::string digest;
+        std::uintmax_t size{ 0 };
+        if (!attachmentStore_->commit(bodyFile, digest, size))
+        {
+            return createErrorResponse(boost::beast::http::status::internal_server_error, "ATTACHMENT_UPLOAD_FAILED", "Failed to upload attachment");
+        }
+
+        const auto fileName{ extractFileName(request) };
+        const auto contentType{ extractContentType(request) };
+
+        const auto result{ dbManager_->executeQuery(R"(
+            INSERT INTO attachments (uploader_id, sha256, size_bytes, content_type, file_name)
+            VALUES ($1, $2, $3, $4, $5)
+            RETURNING attachment_id, created_at)",
+            pqxx::params{ userId, digest, static_cast<long long>(size), contentType, fileName }
+        ) };
+
+        nlohmann::json responseData{};
+        responseData["attachment_id"] = result[0]["attachment_id"].as<std::string>();
+        responseData["file_name"] = fileName;
+        responseData["content_type"] = contentType;
+        responseData["size"] = size;
+        responseData["sha256"] = digest;
+        responseData["created_at"] = result[0]["created_at"].as<std::string>();
+
+        LOG_INFO(std::format("Attachment {} ({} bytes) uploaded by user {}", responseData["attachment_id"].get<std::string>(), size, userId));
+        return createSuccessResponse(responseData, boost::beast::http::status::created, "Attachment uploaded successfully");
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to upload attachment: " + std::string{ e.what() });
+        return createErrorResponse(boost::beast::http::status::internal_server_error, "ATTACHMENT_UPLOAD_FAILED", "Failed to upload attachment");
+    }
+}
+
+bool AttachmentHandlers::isAuthTokenValid(const std::string& token, std::string& userId) const noexcept
+{
+    try
+    {
+        if (const auto payload{ jwtManager_->verifyAndDecode(token) }; payload.isValid && payload.isAccessToken())
+        {
+            userId = payload.userID;
+            return true;
+        }
+
+        return false;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+std::optional<boost::beast::http::response<boost::beast::http::string_body>> AttachmentHandlers::authenticate(const boost::beast::http::request<boost::beast::http::string_body>& request, std::string& userId) const noexcept
+{
+    const auto accessToken{ extractBearerToken(request) };
+    if (accessToken.empty())
+    {
+        return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Access token is required");
+    }
+
+    if (!isAuthTokenValid(accessToken, userId))
+    {
+        return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Invalid access token");
+    }
+
+    return std::nullopt;
+}
+
+std::string AttachmentHandlers::extractFileName(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
+{
+    const std::string target{ request.target() };
+    const auto queryPos{ target.find('?') };
+    std::istringstream iss{ (queryPos != std::string::npos) ? target.substr(queryPos + 1) : "" };
+
+    std::string token;
+    while (std::getline(iss, token, '&'))
+    {
+        if (const auto eqPos{ token.find('=') }; eqPos != std::string::npos && token.substr(0, eqPos) == "file_name")
+        {
+            return token.substr(eqPos + 1);
+        }
+    }
+
+    return "";
+}
+
+std::string AttachmentHandlers::extractContentType(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
+{
+    const std::string header{ request[boost::beast::http::field::content_type] };
+
+    auto mediaType{ boost::algorithm::trim_copy(header.substr(0, header.find(';'))) };
+    if (mediaType.empty())
+    {
+        return DEFAULT_CONTENT_TYPE;
+    }
+
+    boost::algorithm::to_lower(mediaType);
+
+    // type "/" subtype, both RFC 9110 tokens
+    const auto slash{ mediaType.find('/') };
+    if (mediaType.size() > MAX_CONTENT_TYPE_SIZE || slash == 0 || slash == std::string::npos || slash + 1 == mediaType.size() ||
+        mediaType.find('/', slash + 1) != std::string::npos)
+    {
+        return "";
+    }
+
+    for (const auto c : mediaType)
+    {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && std::string_view{ "/!#$&^_.+-" }.find(c) == std::string_view::npos)
+        {
+            return "";
+        }
+    }
+
+    return mediaType;
+}
+}
@@ -0,0 +1,173 @@
+#ifndef ATTACHMENT_HANDLERS_H
+#define ATTACHMENT_HANDLERS_H
+
+#include "IHandler.h"
+#include "../auth/JWTManager.h"
+#include "../database/DatabaseManager.h"
+#include "../storage/AttachmentStore.h"
+
+namespace handlers
+{
+/**
+ * @class AttachmentHandlers
+ * @brief Handles attachment upload and download endpoints
+ *
+ * Uploads are received as raw request bodies that the session writes straight to
+ * a temporary file of the attachment store; the handler only sees the header and
+ * the file path. Downloads are streamed from the store in fixed-size blocks and
+ * support single byte ranges.
+ *
+ * @note All methods are thread-safe and exception-safe unless otherwise specified.
+ * @see IHandler
+ * @see storage::AttachmentStore
+ */
+class AttachmentHandlers final : public IHandler
+{
+public:
+    /**
+     * @brief Constructs an AttachmentHandlers instance with required dependencies
+     * @param jwtManager Shared pointer to JWT token manager for authentication
+     * @param dbManager Shared pointer to database manager for attachment metadata
+     * @param attachmentStore Shared pointer to the store of attachment files
+     */
+    AttachmentHandlers(std::shared_ptr<auth::JWTManager> jwtManager, std::shared_ptr<database::DatabaseManager> dbManager,
+        std::shared_ptr<storage::AttachmentStore> attachmentStore) noexcept;
+
+    /**
+     * @brief Default virtual destructor
+     */
+    virtual ~AttachmentHandlers() noexcept override = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note AttachmentHandlers should not be copied
+     */
+    AttachmentHandlers(const AttachmentHandlers&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note AttachmentHandlers should not be copied
+     */
+    AttachmentHandlers& operator=(const AttachmentHandlers&) = delete;
+
+    /**
+     * @brief Default move constructor
+     * @note AttachmentHandlers can be moved
+     */
+    AttachmentHandlers(AttachmentHandlers&&) noexcept = default;
+
+    /**
+     * @brief Default move assignment operator
+     * @note AttachmentHandlers can be moved
+     */
+    AttachmentHandlers& operator=(AttachmentHandlers&&) noexcept = default;
+
+    /**
+     * @brief Handles attachment requests that do not reach the upload or streaming paths
+     * @param request HTTP request to process
+     * @return boost::beast::http::response<boost::beast::http::string_body> HTTP error response
+     * @note Attachments are only served as direct requests, so inside batch requests
+     *       this returns 400 STREAMING_REQUIRED
+     */
+    [[nodiscard]] virtual boost::beast::http::response<boost::beast::http::string_body> handleRequest(
+        const boost::beast::http::request<boost::beast::http::string_body>& request) noexcept override;
+
+    /**
+     * @brief Returns HTTP methods supported by attachment endpoints
+     * @return std::vector<boost::beast::http::verb> List of supported HTTP methods
+     * @note Attachment endpoints support GET and POST methods
+     */
+    [[nodiscard]] virtual std::vector<boost::beast::http::verb> getSupportedMethods() const noexcept override;
+
+    /**
+     * @brief Checks if a request downloads an attachment
+     * @param request HTTP request to check
+     * @return bool True for GET /api/v1/attachments/{attachment_id}
+     */
+    [[nodiscard]] virtual bool isStreamingRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept override;
+
+    /**
+     * @brief Checks if a request uploads an attachment
+     * @param request HTTP request to check
+     * @return bool True for POST /api/v1/attachments
+     */
+    [[nodiscard]] virtual bool isUploadRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept override;
+
+protected:
+    /**
+     * @brief Handles attachment download endpoint
+     * @param request HTTP GET request
+     * @param[out] response Response header for the file, or a complete response (error or 304)
+     * @return std::shared_ptr<IResponseStream> File stream, or nullptr if response is complete
+     * @note Requires Bearer token in Authorization header; the attachment must have been uploaded
+     *       by the user or be attached to a message the user sent or received
+     * @note Supports a single byte range (206 Partial Content) and If-None-Match
+     * @see FileResponseStream
+     */
+    [[nodiscard]] virtual std::shared_ptr<IResponseStream> handleStreamRequest(const boost::beast::http::request<boost::beast::http::string_body>& request,
+        boost::beast::http::response<boost::beast::http::string_body>& response) noexcept override;
+
+    /**
+     * @brief Checks an attachment upload before its body is read
+     * @param request HTTP POST request header
+     * @param[out] bodyFile Temporary file in the attachment store for the body
+     * @return std::optional<boost::beast::http::response<boost::beast::http::string_body>> Error response, or std::nullopt to accept
+     * @details Supported query parameters:
+     * - file_name (string): Name of the file (required)
+     * @note Requires Bearer token in Authorization header
+     */
+    [[nodiscard]] virtual std::optional<boost::beast::http::response<boost::beast::http::string_body>> handleUploadHeader(
+        const boost::beast::http::request<boost::beast::http::string_body>& request, std::filesystem::path& bodyFile) noexcept override;
+
+    /**
+     * @brief Stores an uploaded attachment and records its metadata
+     * @param request HTTP POST request header
+     * @param bodyFile Temporary file with the uploaded body
+     * @return boost::beast::http::response<boost::beast::http::string_body> HTTP 201 response with the attachment metadata
+     * @see storage::AttachmentStore::commit
+     */
+    [[nodiscard]] virtual boost::beast::http::response<boost::beast::http::string_body> handleUploadRequest(
+        const boost::beast::http::request<boost::beast::http::string_body>& request, const std::filesystem::path& bodyFile) noexcept override;
+
+private:
+    /**
+     * @brief Validates JWT access tokens for attachment operations
+     * @param token JWT access token to validate
+     * @param[out] userId User ID extracted from valid token
+     * @return bool True if token is valid, false otherwise
+     * @note Implements the pure virtual method from IHandler
+     */
+    [[nodiscard]] virtual bool isAuthTokenValid(const std::string& token, std::string& userId) const noexcept override;
+
+    /**
+     * @brief Authenticates a request by its Bearer token
+     * @param request HTTP request
+     * @param[out] userId User ID extracted from valid token
+     * @return std::optional<boost::beast::http::response<boost::beast::http::string_body>> 401 response, or std::nullopt if authenticated
+     */
+    [[nodiscard]] std::optional<boost::beast::http::response<boost::beast::http::string_body>> authenticate(
+        const boost::beast::http::request<boost::beast::http::string_body>& request, std::string& userId) const noexcept;
+
+    /**
+     * @brief Extracts the file name of an upload from the query string
+     * @param request HTTP request
+     * @return std::string Value of the file_name query parameter, or empty string if absent
+     */
+    [[nodiscard]] std::string extractFileName(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept;
+
+    /**
+     * @brief Extracts and normalizes the media type of an upload
+     * @param request HTTP request
+     * @return std::string Lowercase media type without parameters, application/octet-stream if absent,
+     *         or empty string if malformed
+     */
+    [[nodiscard]] std::string extractContentType(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept;
+
+private:
+    std::shared_ptr<auth::JWTManager> jwtManager_;                 ///< JWT token manager for authentication
+    std::shared_ptr<database::DatabaseManager> dbManager_;         ///< Database manager for attachment metadata
+    std::shared_ptr<storage::AttachmentStore> attachmentStore_;    ///< Store of attachment files
+};
+}
+
+#endif // ATTACHMENT_HANDLERS_H
@@ -59,13 +59,13 @@ std::vector<boost::beast::http::verb> AuthHandlers::getSupportedMethods() const
 
 boost::beast::http::response<boost::beast::http::string_body> AuthHandlers::handleRegister(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
 {
-    if (!isJsonContentType(request)) 
+    if (!isPayloadContentType(request)) 
     {
-        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json");
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json, application/msgpack or application/cbor");
     }
 
     nlohmann::json jsonBody{};
-    if (!isJsonBodyValid(request.body(), jsonBody)) 
+    if (!isJsonBodyValid(request, jsonBody)) 
     {
         return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_JSON", "Invalid JSON body");
     }
@@ -81,11 +81,6 @@ boost::beast::http::response<boost::beast::http::string_body> AuthHandlers::hand
         return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_LOGIN", "Login must be 3-50 characters and contain only letters, numbers and underscores");
     }
 
-    if (isUserExists(login))
-    {
-        return createErrorResponse(boost::beast::http::status::conflict, "LOGIN_EXISTS", "User with this login already exists");
-    }
-
     const auto password{ jsonBody["password"].get<std::string>() };
     if (!utils::Validators::isPasswordValid(password)) 
     {
@@ -97,11 +92,18 @@ boost::beast::http::response<boost::beast::http::string_body> AuthHandlers::hand
         // creating a user
         const auto user{ models::User::createFromCredentials(login, password) };
 
-        // Saving to the database
-        dbManager_->executeQuery(user.generateInsertSql());
+        // saving to the database, an existing login leaves the table untouched and returns no rows
+        const auto result{ dbManager_->executeQuery(
+            "INSERT INTO users (login, password_hash, user_id) VALUES ($1, $2, $3::uuid) ON CONFLICT (login) DO NOTHING RETURNING user_id",
+            pqxx::params{ user.getLogin(), user.getPasswordHash(), user.getUserId() }
+        ) };
+        if (result.empty()) 
+        {
+            return createErrorResponse(boost::beast::http::status::conflict, "LOGIN_EXISTS", "User with this login already exists");
+        }
 
         nlohmann::json responseData{};
-        responseData["user_id"] = user.getUserId();
+        responseData["user_id"] = result[0]["user_id"].as<std::string>();
         responseData["login"] = user.getLogin();
 
         LOG_INFO("User registered successfully: " + login);
@@ -116,13 +118,13 @@ boost::beast::http::response<boost::beast::http::string_body> AuthHandlers::hand
 
 boost::beast::http::response<boost::beast::http::string_body> AuthHandlers::handleLogin(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
 {
-    if (!isJsonContentType(request)) 
+    if (!isPayloadContentType(request)) 
     {
-        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json");
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json, application/msgpack or application/cbor");
     }
 
     nlohmann::json jsonBody{};
-    if (!isJsonBodyValid(request.body(), jsonBody)) 
+    if (!isJsonBodyValid(request, jsonBody)) 
     {
         return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_JSON", "Invalid JSON body");
     }
@@ -182,13 +184,13 @@ boost::beast::http::response<boost::beast::http::string_body> AuthHandlers::hand
 
 boost::beast::http::response<boost::beast::http::string_body> AuthHandlers::handleRefresh(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
 {
-    if (!isJsonContentType(request)) 
+    if (!isPayloadContentType(request)) 
     {
-        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json");
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json, application/msgpack or application/cbor");
     }
 
     nlohmann::json jsonBody{};
-    if (!isJsonBodyValid(request.body(), jsonBody)) 
+    if (!isJsonBodyValid(request, jsonBody)) 
     {
         return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_JSON", "Invalid JSON body");
     }
@@ -210,42 +212,16 @@ boost::beast::http::response<boost::beast::http::string_body> AuthHandlers::hand
             return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_REFRESH_TOKEN", "Refresh token is invalid");
         }
 
-        // checking the existence of a refresh token in the database
-        auto result{ dbManager_->executeQuery(
-            "SELECT user_id FROM refresh_tokens WHERE token_hash = '" +
-            utils::PasswordHasher::sha256(refreshToken) + "' AND expires_at > NOW()"
-        ) };
+        // the old token is consumed and the new one stored in a single statement
+        auto newRefreshToken{ jwtManager_->generateRefreshToken(payload.userID) };
 
-        if (result.empty()) 
+        const auto login{ rotateRefreshToken(refreshToken, newRefreshToken, payload.userID) };
+        if (login.empty()) 
         {
             return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_REFRESH_TOKEN", "Refresh token not found or expired");
         }
 
-        // obtaining a user login
-        auto userResult{ dbManager_->executeQuery("SELECT login FROM users WHERE user_id = '" + payload.userID + "'") };
-
-        if (userResult.empty()) 
-        {
-            return createErrorResponse(boost::beast::http::status::unauthorized, "USER_NOT_FOUND", "User not found");
-        }
-
-        auto login{ userResult[0]["login"].as<std::string>() };
-
-        // generation of new tokens
         auto newAccessToken{ jwtManager_->generateAccessToken(payload.userID, login) };
-        auto newRefreshToken{ jwtManager_->generateRefreshToken(payload.userID) };
-
-        // updating the refresh token in the database
-        if (!storeRefreshToken(payload.userID, newRefreshToken)) 
-        {
-            return createErrorResponse(boost::beast::http::status::internal_server_error, "TOKEN_STORAGE_FAILED", "Failed to store refresh token");
-        }
-
-        // deleting the old refresh token
-        if (!invalidateRefreshToken(refreshToken))
-        {
-            LOG_WARNING(std::format("Failed to invalidate old refresh token for user: {}", payload.userID));
-        }
 
         nlohmann::json responseData{};
         responseData["access_token"] = newAccessToken;
@@ -272,13 +248,13 @@ boost::beast::http::response<boost::beast::http::string_body> AuthHandlers::hand
         return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Access token is required");
     }
 
-    if (!isJsonContentType(request)) 
+    if (!isPayloadContentType(request)) 
     {
-        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json");
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json, application/msgpack or application/cbor");
     }
 
     nlohmann::json jsonBody{};
-    if (!isJsonBodyValid(request.body(), jsonBody)) 
+    if (!isJsonBodyValid(request, jsonBody)) 
     {
         return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_JSON", "Invalid JSON body");
     }
@@ -326,13 +302,13 @@ boost::beast::http::response<boost::beast::http::string_body> AuthHandlers::hand
         return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Access token is required");
     }
 
-    if (!isJsonContentType(request)) 
+    if (!isPayloadContentType(request)) 
     {
-        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json");
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json, application/msgpack or application/cbor");
     }
 
     nlohmann::json jsonBody{};
-    if (!isJsonBodyValid(request.body(), jsonBody)) 
+    if (!isJsonBodyValid(request, jsonBody)) 
     {
         return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_JSON", "Invalid JSON body");
     }
@@ -434,20 +410,6 @@ bool AuthHandlers::isAuthTokenValid(const std::string& token, std::string& userI
     }
 }
 
-bool AuthHandlers::isUserExists(const std::string& login) const noexcept
-{
-    try 
-    {
-        const auto result{ dbManager_->executeQuery("SELECT user_id FROM users WHERE login = '" + login + "'") };
-        return !result.empty();
-    }
-    catch (const std::exception& e) 
-    {
-        LOG_ERROR("Error checking user existence: " + std::string{ e.what() });
-        return false;
-    }
-}
-
 bool AuthHandlers::isCurrentPasswordValid(const std::string& userId, const std::string& password) const noexcept
 {
     try 
@@ -476,23 +438,11 @@ bool AuthHandlers::storeRefreshToken(const std::string& userId, const std::strin
 
         // getting the expiration time from a token
         const auto expiry{ jwtManager_->getTokenExpiry(refreshToken) };
-        const auto expiryTimeT{ std::chrono::system_clock::to_time_t(expiry) };
-
-        std::stringstream ss{};
-        std::tm tmBuf{};
-
-#ifdef _WIN32
-        localtime_s(&tmBuf, &expiryTimeT);
-#else
-        localtime_r(&now, &tmBuf);
-#endif // endif _WIN32
-
-        ss << std::put_time(&tmBuf, "%Y-%m-%d %H:%M:%S");
-        const auto expiryStr{ ss.str() };
+        const auto expiryEpoch{ std::chrono::duration_cast<std::chrono::seconds>(expiry.time_since_epoch()).count() };
 
         auto result{ dbManager_->executeQuery(
-            "INSERT INTO refresh_tokens (user_id, token_hash, expires_at) VALUES ('" +
-            userId + "', '" + tokenHash + "', '" + expiryStr + "')"
+            "INSERT INTO refresh_tokens (user_id, token_hash, expires_at) VALUES ($1, $2, to_timestamp($3))",
+            pqxx::params{ userId, tokenHash, expiryEpoch }
         ) };
 
         return true;
@@ -517,4 +467,31 @@ bool AuthHandlers::invalidateRefreshToken(const std::string& refreshToken) const
         return false;
     }
 }
+
+std::string AuthHandlers::rotateRefreshToken(const std::string& refreshToken, const std::string& newRefreshToken, const std::string& userId) const
+{
+    const auto expiry{ jwtManager_->getTokenExpiry(newRefreshToken) };
+    const auto expiryEpoch{ std::chrono::duration_cast<std::chrono::seconds>(expiry.time_since_epoch()).count() };
+
+    const auto result{ dbManager_->executeQuery(R"(
+            WITH consumed AS (
+                DELETE FROM refresh_tokens
+                WHERE token_hash = $1 AND user_id = $2 AND expires_at > NOW()
+                RETURNING user_id
+            ), stored AS (
+                INSERT INTO refresh_tokens (user_id, token_hash, expires_at)
+                SELECT user_id, $3, to_timestamp($4) FROM consumed
+                RETURNING user_id
+            )
+            SELECT users.login FROM stored JOIN users ON users.user_id = stored.user_id)",
+        pqxx::params{ utils::PasswordHasher::sha256(refreshToken), userId, utils::PasswordHasher::sha256(newRefreshToken), expiryEpoch }
+    ) };
+
+    if (result.empty()) 
+    {
+        return "";
+    }
+
+    return result[0]["login"].as<std::string>();
+}
 }
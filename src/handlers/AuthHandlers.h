@@ -164,14 +164,6 @@ private:
      */
     [[nodiscard]] virtual bool isAuthTokenValid(const std::string& token, std::string& userId) const noexcept override;
 
-    /**
-     * @brief Checks if a user with given login exists
-     * @param login User login to check
-     * @return bool True if user exists, false otherwise
-     * @note Logs errors to the system logger
-     */
-    [[nodiscard]] bool isUserExists(const std::string& login) const noexcept;
-
     /**
      * @brief Validates current password for a user
      * @param userId User ID
@@ -202,6 +194,17 @@ private:
      */
     [[nodiscard]] bool invalidateRefreshToken(const std::string& refreshToken) const noexcept;
 
+    /**
+     * @brief Replaces a stored refresh token with a new one in a single statement
+     * @param refreshToken Current refresh token to consume
+     * @param newRefreshToken New refresh token to store
+     * @param userId User ID the tokens belong to
+     * @return std::string Login of the token owner, empty if the current token was not found or expired
+     * @throws std::exception on database errors
+     * @note Deleting the old token, storing the new one and reading the login happen in one CTE
+     */
+    [[nodiscard]] std::string rotateRefreshToken(const std::string& refreshToken, const std::string& newRefreshToken, const std::string& userId) const;
+
 private:
     std::shared_ptr<auth::JWTManager> jwtManager_;      ///< JWT token manager for token operations
     std::shared_ptr<database::DatabaseManager> dbManager_; ///< Database manager for data persistence
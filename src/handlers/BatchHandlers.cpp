@@ -0,0 +1,299 @@
+#include "BatchHandlers.h"
+#include "../server/RequestProcessor.h"
+#include "../utils/Logger.h"
+#include <algorithm>
+#include <boost/asio/post.hpp>
+
+namespace handlers
+{
+constexpr auto BATCH_PATH{ "/api/v1/batch" };
+constexpr auto MAX_BATCH_REQUESTS{ 20u };
+constexpr size_t MAX_PARALLEL_REQUESTS{ 4 };
+
+BatchHandlers::BatchHandlers(std::shared_ptr<auth::JWTManager> jwtManager, std::weak_ptr<server::Router> router, boost::asio::any_io_executor executor) noexcept :
+    jwtManager_{ std::move(jwtManager) },
+    router_{ std::move(router) },
+    executor_{ std::move(executor) }
+{
+}
+
+boost::beast::http::response<boost::beast::http::string_body> BatchHandlers::handleRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) noexcept
+{
+    try
+    {
+        const std::string path{ request.target() };
+
+        if (path == BATCH_PATH && request.method() == boost::beast::http::verb::post)
+        {
+            return handleBatch(request);
+        }
+
+        return createErrorResponse(boost::beast::http::status::not_found, "ENDPOINT_NOT_FOUND", "Endpoint not found");
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Error in BatchHandlers: " + std::string{ e.what() });
+        return createErrorResponse(boost::beast::http::status::internal_server_error, "INTERNAL_ERROR", "Internal server error");
+    }
+}
+
+std::vector<boost::beast::http::verb> BatchHandlers::getSupportedMethods() const noexcept
+{
+    return { boost::beast::http::verb::post };
+}
+
+boost::beast::http::response<boost::beast::http::string_body> BatchHandlers::handleBatch(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
+{
+    // sub-requests share the time budget of the batch
+    const auto* currentDeadline{ utils::DeadlineScope::getCurrent() };
+    const auto deadline{ currentDeadline ? *currentDeadline : utils::Deadline{} };
+
+    const auto accessToken{ extractBearerToken(request) };
+    if (accessToken.empty())
+    {
+        return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Access token is required");
+    }
+
+    // the token is verified once here, sub-requests reuse the verified token
+    std::string userId;
+    if (!isAuthTokenValid(accessToken, userId))
+    {
+        return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Invalid access token");
+    }
+
+    if (!isPayloadContentType(request))
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json, application/msgpack or application/cbor");
+    }
+
+    nlohmann::json jsonBody{};
+    if (!isJsonBodyValid(request, jsonBody))
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_JSON", "Invalid JSON body");
+    }
+
+    if (!jsonBody.contains("requests") || !jsonBody["requests"].is_array())
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "MISSING_FIELDS", "Requests array is required");
+    }
+
+    const auto& subRequests{ jsonBody["requests"] };
+    if (subRequests.empty())
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "EMPTY_BATCH", "Requests array cannot be empty");
+    }
+
+    if (subRequests.size() > MAX_BATCH_REQUESTS)
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "BATCH_TOO_LARGE", "Batch exceeds maximum size of " + std::to_string(MAX_BATCH_REQUESTS) + " requests");
+    }
+
+    // building sub-requests before executing any of them
+    std::vector<boost::beast::http::request<boost::beast::http::string_body>> requests;
+    requests.reserve(subRequests.size());
+
+    for (const auto& subRequest : subRequests)
+    {
+        if (!subRequest.is_object() || !subRequest.contains("method") || !subRequest["method"].is_string() ||
+            !subRequest.contains("path") || !subRequest["path"].is_string())
+        {
+            return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_BATCH_REQUEST", "Each request requires method and path");
+        }
+
+        const auto method{ boost::beast::http::string_to_verb(subRequest["method"].get<std::string>()) };
+        if (method == boost::beast::http::verb::unknown)
+        {
+            return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_BATCH_REQUEST", "Unknown method: " + subRequest["method"].get<std::string>());
+        }
+
+        const auto path{ subRequest["path"].get<std::string>() };
+        if (path.empty() || path.front() != '/')
+        {
+            return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_BATCH_REQUEST", "Path must start with /");
+        }
+
+        if (path.find(BATCH_PATH) == 0)
+        {
+            return createErrorResponse(boost::beast::http::status::bad_request, "NESTED_BATCH", "Nested batch requests are not allowed");
+        }
+
+        boost::beast::http::request<boost::beast::http::string_body> httpRequest{ method, path, request.version() };
+        httpRequest.set(boost::beast::http::field::authorization, request[boost::beast::http::field::authorization]);
+
+        if (subRequest.contains("body") && !subRequest["body"].is_null())
+        {
+            httpRequest.set(boost::beast::http::field::content_type, "application/json");
+            httpRequest.body() = subRequest["body"].dump();
+        }
+
+        httpRequest.prepare_payload();
+        requests.emplace_back(std::move(httpRequest));
+    }
+
+    const auto router{ router_.lock() };
+    if (!router)
+    {
+        LOG_ERROR("Batch router is not available");
+        return createErrorResponse(boost::beast::http::status::internal_server_error, "INTERNAL_ERROR", "Internal server error");
+    }
+
+    try
+    {
+        std::vector<boost::beast::http::response<boost::beast::http::string_body>> responses(requests.size());
+        std::shared_ptr<ParallelGroup> pending{};
+
+        // runs the collected group of read-only sub-requests
+        auto flushPending{ [this, &pending, &responses](std::size_t end)
+        {
+            if (!pending)
+            {
+                return;
+            }
+
+            executeParallel(pending);
+
+            const auto begin{ end - pending->responses.size() };
+            std::ranges::move(pending->responses, responses.begin() + static_cast<std::ptrdiff_t>(begin));
+            pending.reset();
+        } };
+
+        for (auto i : std::ranges::views::iota(0u, requests.size()))
+        {
+            if (requests[i].method() == boost::beast::http::verb::get)
+            {
+                // independent read-only sub-requests run in parallel
+                if (!pending)
+                {
+                    pending = std::make_shared<ParallelGroup>();
+                    pending->router = router;
+                    pending->deadline = deadline;
+                }
+
+                pending->requests.emplace_back(std::move(requests[i]));
+                continue;
+            }
+
+            // state-changing sub-requests keep their order relative to the others
+            flushPending(i);
+            responses[i] = dispatch(router, requests[i], deadline);
+        }
+
+        flushPending(requests.size());
+
+        auto responsesJson{ nlohmann::json::array() };
+        for (auto i : std::ranges::views::iota(0u, responses.size()))
+        {
+            const auto& subRequest{ subRequests[i] };
+            responsesJson.emplace_back(toJson(subRequest.contains("id") ? subRequest["id"] : nlohmann::json(i), responses[i]));
+        }
+
+        nlohmann::json responseData{};
+        responseData["responses"] = responsesJson;
+
+        LOG_DEBUG("Batch of " + std::to_string(requests.size()) + " requests processed for user: " + userId);
+        return createSuccessResponse(responseData);
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to process batch: " + std::string{ e.what() });
+        return createErrorResponse(boost::beast::http::status::internal_server_error, "BATCH_FAILED", "Failed to process batch");
+    }
+}
+
+boost::beast::http::response<boost::beast::http::string_body> BatchHandlers::dispatch(const std::shared_ptr<server::Router>& router, const boost::beast::http::request<boost::beast::http::string_body>& request,
+    const utils::Deadline& deadline) noexcept
+{
+    // the client address is not known here, so sub-requests count against the per-user limits only
+    if (auto error{ server::RequestProcessor::checkRateLimit(request, *router, "") })
+    {
+        return std::move(*error);
+    }
+
+    if (auto error{ server::RequestProcessor::checkLoad(request, *router, deadline) })
+    {
+        return std::move(*error);
+    }
+
+    if (const auto handler{ router->findHandler(request) })
+    {
+        // parallel sub-requests may run on other threads than the batch
+        const utils::DeadlineScope deadlineScope{ deadline };
+        return handler->process(request);
+    }
+
+    return router->handleNotFound(request);
+}
+
+void BatchHandlers::executeParallel(const std::shared_ptr<ParallelGroup>& group) const
+{
+    group->responses.resize(group->requests.size());
+
+    // the calling thread takes sub-requests as well, so it only waits for helpers that have started one
+    const auto helpers{ std::min(group->requests.size(), MAX_PARALLEL_REQUESTS) - 1 };
+    for (size_t i{ 0 }; i < helpers; ++i)
+    {
+        boost::asio::post(executor_, [group]()
+        {
+            runParallel(group);
+        });
+    }
+
+    runParallel(group);
+
+    std::unique_lock lock{ group->mutex };
+    group->condition.wait(lock, [&group]()
+    {
+        return group->finished == group->requests.size();
+    });
+}
+
+void BatchHandlers::runParallel(const std::shared_ptr<ParallelGroup>& group) noexcept
+{
+    // a helper started after the group is done finds nothing left to take
+    for (auto i{ group->next++ }; i < group->requests.size(); i = group->next++)
+    {
+        group->responses[i] = dispatch(group->router, group->requests[i], group->deadline);
+
+        {
+            std::lock_guard lock{ group->mutex };
+            ++group->finished;
+        }
+
+        group->condition.notify_all();
+    }
+}
+
+nlohmann::json BatchHandlers::toJson(const nlohmann::json& id, const boost::beast::http::response<boost::beast::http::string_body>& response) noexcept
+{
+    nlohmann::json json{};
+    json["id"] = id;
+    json["status"] = response.result_int();
+
+    // handlers respond with JSON, anything else is passed through as a string
+    json["body"] = nlohmann::json::parse(response.body(), nullptr, false);
+    if (json["body"].is_discarded())
+    {
+        json["body"] = response.body();
+    }
+
+    return json;
+}
+
+bool BatchHandlers::isAuthTokenValid(const std::string& token, std::string& userId) const noexcept
+{
+    try
+    {
+        if (const auto payload{ jwtManager_->verifyAndDecode(token) }; payload.isValid && payload.isAccessToken())
+        {
+            userId = payload.userID;
+            return true;
+        }
+
+        return false;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+}
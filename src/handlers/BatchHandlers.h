@@ -0,0 +1,165 @@
+#ifndef BATCH_HANDLERS_H
+#define BATCH_HANDLERS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <boost/asio/any_io_executor.hpp>
+#include "IHandler.h"
+#include "../auth/JWTManager.h"
+#include "../server/Router.h"
+#include "../utils/Deadline.h"
+
+namespace handlers
+{
+/**
+ * @class BatchHandlers
+ * @brief Handles the batch endpoint that executes several sub-requests in one round trip
+ *
+ * Each sub-request is dispatched in-process through the router to the handler
+ * registered for its path. Consecutive read-only (GET) sub-requests are executed
+ * in parallel, while state-changing sub-requests act as barriers and are executed
+ * sequentially in request order. A parallel group runs on the calling thread and at
+ * most a few threads of the handler executor, which the calling thread never waits
+ * for unless they have taken a sub-request, so a busy executor cannot stall a batch.
+ *
+ * @note All methods are thread-safe and exception-safe unless otherwise specified.
+ * @see IHandler
+ * @see server::Router
+ */
+class BatchHandlers final : public IHandler
+{
+public:
+    /**
+     * @brief Constructs a BatchHandlers instance with required dependencies
+     * @param jwtManager Shared pointer to JWT token manager for authentication
+     * @param router Weak pointer to the router used to dispatch sub-requests
+     * @param executor Executor that helps with parallel sub-requests, e.g. the handler threads of the server
+     * @note The router is held weakly because it owns this handler
+     */
+    BatchHandlers(std::shared_ptr<auth::JWTManager> jwtManager, std::weak_ptr<server::Router> router, boost::asio::any_io_executor executor) noexcept;
+
+    /**
+     * @brief Default virtual destructor
+     * @note Ensures proper cleanup of inherited resources
+     */
+    virtual ~BatchHandlers() noexcept override = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note BatchHandlers should not be copied
+     */
+    BatchHandlers(const BatchHandlers&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note BatchHandlers should not be copied
+     */
+    BatchHandlers& operator=(const BatchHandlers&) = delete;
+
+    /**
+     * @brief Default move constructor
+     * @note BatchHandlers can be moved
+     */
+    BatchHandlers(BatchHandlers&&) noexcept = default;
+
+    /**
+     * @brief Default move assignment operator
+     * @note BatchHandlers can be moved
+     */
+    BatchHandlers& operator=(BatchHandlers&&) noexcept = default;
+
+    /**
+     * @brief Main request handler for the batch endpoint
+     * @param request HTTP request to process
+     * @return boost::beast::http::response<boost::beast::http::string_body> HTTP response
+     * @warning This method never throws exceptions; errors are returned as HTTP error responses
+     * @see handleBatch
+     */
+    [[nodiscard]] virtual boost::beast::http::response<boost::beast::http::string_body> handleRequest(
+        const boost::beast::http::request<boost::beast::http::string_body>& request) noexcept override;
+
+    /**
+     * @brief Returns HTTP methods supported by the batch endpoint
+     * @return std::vector<boost::beast::http::verb> List of supported HTTP methods
+     * @note The batch endpoint supports POST method only
+     */
+    [[nodiscard]] virtual std::vector<boost::beast::http::verb> getSupportedMethods() const noexcept override;
+
+private:
+    /**
+     * @struct ParallelGroup
+     * @brief Consecutive read-only sub-requests executed in parallel
+     */
+    struct ParallelGroup final
+    {
+        std::shared_ptr<server::Router> router;                                          ///< Router used to dispatch the sub-requests
+        utils::Deadline deadline;                                                        ///< Time budget of the batch
+        std::vector<boost::beast::http::request<boost::beast::http::string_body>> requests;   ///< Sub-requests of the group
+        std::vector<boost::beast::http::response<boost::beast::http::string_body>> responses; ///< Sub-responses in request order
+        std::atomic<size_t> next{ 0 };                                                   ///< Index of the next sub-request to take
+        std::mutex mutex;                                                                ///< Mutex for finished
+        std::condition_variable condition;                                               ///< Signals finished sub-requests
+        size_t finished{ 0 };                                                            ///< Number of finished sub-requests
+    };
+
+    /**
+     * @brief Handles batch execution endpoint
+     * @param request HTTP POST request with sub-requests
+     * @return HTTP response with the list of sub-responses in request order
+     * @details Expected JSON body: {"requests": [{"id": string, "method": string, "path": string, "body": object}, ...]}
+     * @note Requires Bearer token in Authorization header; the token is verified once
+     *       and shared with all sub-requests
+     */
+    [[nodiscard]] boost::beast::http::response<boost::beast::http::string_body> handleBatch(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept;
+
+    /**
+     * @brief Dispatches a single sub-request through the router
+     * @param router Router used to find the handler
+     * @param request Sub-request to dispatch
+     * @param deadline Time budget of the batch, shared by its sub-requests
+     * @return HTTP response produced by the handler, a 404 response, a 429 response if the user exceeded the rate limit of the route,
+     *         or a 503 response if the sub-request was shed under load
+     */
+    [[nodiscard]] static boost::beast::http::response<boost::beast::http::string_body> dispatch(const std::shared_ptr<server::Router>& router,
+        const boost::beast::http::request<boost::beast::http::string_body>& request, const utils::Deadline& deadline) noexcept;
+
+    /**
+     * @brief Executes a group of read-only sub-requests in parallel
+     * @param group Group to execute, its responses are filled on return
+     * @note Helpers are posted to the executor, the calling thread takes sub-requests as well
+     */
+    void executeParallel(const std::shared_ptr<ParallelGroup>& group) const;
+
+    /**
+     * @brief Takes and dispatches sub-requests of a group until none is left
+     * @param group Group to work on
+     */
+    static void runParallel(const std::shared_ptr<ParallelGroup>& group) noexcept;
+
+    /**
+     * @brief Converts a sub-response into its JSON representation
+     * @param id Client-provided sub-request identifier
+     * @param response Sub-response to convert
+     * @return nlohmann::json Sub-response JSON with id, status and body
+     */
+    [[nodiscard]] static nlohmann::json toJson(const nlohmann::json& id, const boost::beast::http::response<boost::beast::http::string_body>& response) noexcept;
+
+    /**
+     * @brief Validates JWT access tokens for batch operations
+     * @param token JWT access token to validate
+     * @param[out] userId User ID extracted from valid token
+     * @return bool True if token is valid, false otherwise
+     * @note Implements the pure virtual method from IHandler
+     * @see auth::JWTManager::verifyAndDecode
+     */
+    [[nodiscard]] virtual bool isAuthTokenValid(const std::string& token, std::string& userId) const noexcept override;
+
+private:
+    std::shared_ptr<auth::JWTManager> jwtManager_; ///< JWT token manager for authentication
+    std::weak_ptr<server::Router> router_;         ///< Router used to dispatch sub-requests
+    boost::asio::any_io_executor executor_;        ///< Executor that helps with parallel sub-requests
+};
+}
+
+#endif // BATCH_HANDLERS_H
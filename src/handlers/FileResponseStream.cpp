@@ -0,0 +1,57 @@
+#include "FileResponseStream.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace handlers
+{
+constexpr std::uint64_t FILE_CHUNK_SIZE{ 64 * 1024 };
+
+FileResponseStream::FileResponseStream(const std::filesystem::path& path, std::uint64_t offset, std::uint64_t length) :
+    path_{ path },
+    file_{ path, std::ios::binary },
+    offset_{ offset },
+    length_{ length },
+    remaining_{ length }
+{
+    if (!file_)
+    {
+        throw std::runtime_error{ "Failed to open file: " + path.string() };
+    }
+
+    file_.seekg(static_cast<std::streamoff>(offset));
+    if (!file_)
+    {
+        throw std::runtime_error{ "Failed to seek in file: " + path.string() };
+    }
+}
+
+bool FileResponseStream::readNextChunk(std::string& chunk)
+{
+    if (remaining_ == 0)
+    {
+        chunk.clear();
+        return false;
+    }
+
+    chunk.resize(static_cast<size_t>(std::min(remaining_, FILE_CHUNK_SIZE)));
+    file_.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+
+    if (static_cast<size_t>(file_.gcount()) != chunk.size())
+    {
+        throw std::runtime_error{ "File is shorter than the requested range" };
+    }
+
+    remaining_ -= chunk.size();
+    return true;
+}
+
+std::optional<std::uint64_t> FileResponseStream::getContentLength() const noexcept
+{
+    return length_;
+}
+
+std::optional<FileRegion> FileResponseStream::getFileRegion() const
+{
+    return FileRegion{ path_, offset_, length_ };
+}
+}
@@ -0,0 +1,66 @@
+#ifndef FILE_RESPONSE_STREAM_H
+#define FILE_RESPONSE_STREAM_H
+
+#include "IResponseStream.h"
+#include <filesystem>
+#include <fstream>
+
+namespace handlers
+{
+/**
+ * @class FileResponseStream
+ * @brief Streams a byte range of a file as a response body of known length
+ *
+ * Reads the file in fixed-size blocks as the session asks for them, so that
+ * files of any size are sent with a bounded amount of memory.
+ *
+ * @see IResponseStream
+ * @see AttachmentHandlers
+ */
+class FileResponseStream final : public IResponseStream
+{
+public:
+    /**
+     * @brief Opens a file and positions the stream at the start of the range
+     * @param path File to send
+     * @param offset Offset of the first byte to send
+     * @param length Number of bytes to send
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    FileResponseStream(const std::filesystem::path& path, std::uint64_t offset, std::uint64_t length);
+
+    /**
+     * @brief Default virtual destructor
+     */
+    virtual ~FileResponseStream() noexcept override = default;
+
+    /**
+     * @brief Reads the next block of the range
+     * @param[out] chunk Next block of the file
+     * @return bool True if a block was read, false if the range is complete
+     * @throws std::runtime_error if the file is shorter than the range
+     */
+    [[nodiscard]] virtual bool readNextChunk(std::string& chunk) override;
+
+    /**
+     * @brief Gets the length of the range
+     * @return std::optional<std::uint64_t> Number of bytes sent in total
+     */
+    [[nodiscard]] virtual std::optional<std::uint64_t> getContentLength() const noexcept override;
+
+    /**
+     * @brief Gets the file and range being sent
+     * @return std::optional<FileRegion> File path, offset and length of the range
+     */
+    [[nodiscard]] virtual std::optional<FileRegion> getFileRegion() const override;
+
+private:
+    std::filesystem::path path_;    ///< Path of the file being sent
+    std::ifstream file_;            ///< File being sent
+    std::uint64_t offset_;          ///< Offset of the first byte to send
+    std::uint64_t length_;          ///< Total number of bytes to send
+    std::uint64_t remaining_;       ///< Number of bytes not sent yet
+};
+}
+
+#endif // FILE_RESPONSE_STREAM_H
@@ -3,6 +3,82 @@
 
 namespace handlers
 {
+void IHandler::setCacheControl(const std::string& cacheControl) noexcept
+{
+    cacheControl_ = cacheControl;
+}
+
+boost::beast::http::response<boost::beast::http::string_body> IHandler::process(const boost::beast::http::request<boost::beast::http::string_body>& request) noexcept
+{
+    // the previous format is restored for nested calls (batch sub-requests)
+    const auto previousFormat{ responseFormat_ };
+    responseFormat_ = utils::PayloadCodec::negotiate(std::string{ request[boost::beast::http::field::accept] });
+
+    auto response{ handleRequest(request) };
+
+    responseFormat_ = previousFormat;
+    return response;
+}
+
+bool IHandler::isStreamingRequest(const boost::beast::http::request<boost::beast::http::string_body>&) const noexcept
+{
+    return false;
+}
+
+std::shared_ptr<IResponseStream> IHandler::processStream(const boost::beast::http::request<boost::beast::http::string_body>& request, boost::beast::http::response<boost::beast::http::string_body>& response) noexcept
+{
+    const auto previousFormat{ responseFormat_ };
+    responseFormat_ = utils::PayloadCodec::negotiate(std::string{ request[boost::beast::http::field::accept] });
+
+    auto stream{ handleStreamRequest(request, response) };
+
+    responseFormat_ = previousFormat;
+    return stream;
+}
+
+std::shared_ptr<IResponseStream> IHandler::handleStreamRequest(const boost::beast::http::request<boost::beast::http::string_body>&, boost::beast::http::response<boost::beast::http::string_body>& response) noexcept
+{
+    response = createErrorResponse(boost::beast::http::status::not_found, "ENDPOINT_NOT_FOUND", "Endpoint not found");
+    return nullptr;
+}
+
+bool IHandler::isUploadRequest(const boost::beast::http::request<boost::beast::http::string_body>&) const noexcept
+{
+    return false;
+}
+
+std::optional<boost::beast::http::response<boost::beast::http::string_body>> IHandler::processUploadHeader(const boost::beast::http::request<boost::beast::http::string_body>& request, std::filesystem::path& bodyFile) noexcept
+{
+    const auto previousFormat{ responseFormat_ };
+    responseFormat_ = utils::PayloadCodec::negotiate(std::string{ request[boost::beast::http::field::accept] });
+
+    auto response{ handleUploadHeader(request, bodyFile) };
+
+    responseFormat_ = previousFormat;
+    return response;
+}
+
+boost::beast::http::response<boost::beast::http::string_body> IHandler::processUpload(const boost::beast::http::request<boost::beast::http::string_body>& request, const std::filesystem::path& bodyFile) noexcept
+{
+    const auto previousFormat{ responseFormat_ };
+    responseFormat_ = utils::PayloadCodec::negotiate(std::string{ request[boost::beast::http::field::accept] });
+
+    auto response{ handleUploadRequest(request, bodyFile) };
+
+    responseFormat_ = previousFormat;
+    return response;
+}
+
+std::optional<boost::beast::http::response<boost::beast::http::string_body>> IHandler::handleUploadHeader(const boost::beast::http::request<boost::beast::http::string_body>&, std::filesystem::path&) noexcept
+{
+    return createErrorResponse(boost::beast::http::status::not_found, "ENDPOINT_NOT_FOUND", "Endpoint not found");
+}
+
+boost::beast::http::response<boost::beast::http::string_body> IHandler::handleUploadRequest(const boost::beast::http::request<boost::beast::http::string_body>&, const std::filesystem::path&) noexcept
+{
+    return createErrorResponse(boost::beast::http::status::not_found, "ENDPOINT_NOT_FOUND", "Endpoint not found");
+}
+
 boost::beast::http::response<boost::beast::http::string_body> IHandler::createSuccessResponse(const nlohmann::json& data, boost::beast::http::status status, const std::string& message) const noexcept
 {
     nlohmann::json responseJson{};
@@ -34,15 +110,27 @@ boost::beast::http::response<boost::beast::http::string_body> IHandler::createEr
 boost::beast::http::response<boost::beast::http::string_body> IHandler::createJsonResponse(const nlohmann::json& json, boost::beast::http::status status) const noexcept
 {
     boost::beast::http::response<boost::beast::http::string_body> response{ status, 11 }; // 11 - HTTP/1.1
-    response.set(boost::beast::http::field::content_type, "application/json");
-    response.set(boost::beast::http::field::cache_control, "no-cache");
-    response.body() = json.dump(4); // pretty print with 4 spaces
+    response.set(boost::beast::http::field::content_type, std::string{ utils::PayloadCodec::toContentType(responseFormat_) });
+    response.set(boost::beast::http::field::cache_control, cacheControl_);
+    response.set(boost::beast::http::field::vary, "Accept");
+    response.body() = utils::PayloadCodec::encode(json, responseFormat_);
     response.prepare_payload();
 
     setCorsHeaders(response);
     return response;
 }
 
+boost::beast::http::response<boost::beast::http::string_body> IHandler::createStreamResponse(const std::string& contentType) const noexcept
+{
+    boost::beast::http::response<boost::beast::http::string_body> response{ boost::beast::http::status::ok, 11 }; // 11 - HTTP/1.1
+    response.set(boost::beast::http::field::content_type, contentType);
+    response.set(boost::beast::http::field::cache_control, cacheControl_);
+    response.chunked(true);
+
+    setCorsHeaders(response);
+    return response;
+}
+
 bool IHandler::isJsonBodyValid(const std::string& body, nlohmann::json& json) const noexcept
 {
     if (body.empty()) 
@@ -62,6 +150,23 @@ bool IHandler::isJsonBodyValid(const std::string& body, nlohmann::json& json) co
     }
 }
 
+bool IHandler::isJsonBodyValid(const boost::beast::http::request<boost::beast::http::string_body>& request, nlohmann::json& json) const noexcept
+{
+    auto format{ utils::PayloadFormat::Json };
+    if (!utils::PayloadCodec::fromContentType(std::string{ request[boost::beast::http::field::content_type] }, format))
+    {
+        return false;
+    }
+
+    if (!utils::PayloadCodec::decode(request.body(), format, json))
+    {
+        LOG_ERROR("Failed to parse " + std::string{ utils::PayloadCodec::toContentType(format) } + " request body");
+        return false;
+    }
+
+    return true;
+}
+
 std::string IHandler::extractBearerToken(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
 {
     const auto authHeader{ request.find(boost::beast::http::field::authorization) };
@@ -86,7 +191,7 @@ void IHandler::setCorsHeaders(boost::beast::http::response<boost::beast::http::s
     response.set(boost::beast::http::field::access_control_allow_headers, "Content-Type, Authorization");
 }
 
-bool IHandler::isJsonContentType(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
+bool IHandler::isPayloadContentType(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
 {
     const auto contentType{ request.find(boost::beast::http::field::content_type) };
     if (contentType == request.end()) 
@@ -94,8 +199,8 @@ bool IHandler::isJsonContentType(const boost::beast::http::request<boost::beast:
         return false;
     }
 
-    const std::string contentTypeValue{ contentType->value() };
-    return contentTypeValue.find("application/json") != std::string::npos;
+    auto format{ utils::PayloadFormat::Json };
+    return utils::PayloadCodec::fromContentType(std::string{ contentType->value() }, format);
 }
 
 int IHandler::stringToInt(const std::string& str, int defaultValue) const noexcept
@@ -109,4 +214,61 @@ int IHandler::stringToInt(const std::string& str, int defaultValue) const noexce
         return defaultValue;
     }
 }
+
+std::string IHandler::createWeakETag(const std::string& versionMarker) const noexcept
+{
+    const auto hash{ std::hash<std::string>{}(std::string{ utils::PayloadCodec::toContentType(responseFormat_) } + ":" + versionMarker) };
+    return std::format("W/\"{:016x}\"", static_cast<uint64_t>(hash));
+}
+
+bool IHandler::isETagMatched(const boost::beast::http::request<boost::beast::http::string_body>& request, const std::string& etag) const noexcept
+{
+    const auto ifNoneMatch{ request.find(boost::beast::http::field::if_none_match) };
+    if (ifNoneMatch == request.end()) 
+    {
+        return false;
+    }
+
+    // weak comparison: W/ prefixes are ignored
+    auto stripWeak{ [](std::string_view tag)
+    {
+        while (!tag.empty() && (tag.front() == ' ' || tag.front() == '\t'))
+        {
+            tag.remove_prefix(1);
+        }
+
+        while (!tag.empty() && (tag.back() == ' ' || tag.back() == '\t'))
+        {
+            tag.remove_suffix(1);
+        }
+
+        return tag.starts_with("W/") ? tag.substr(2) : tag;
+    } };
+
+    const auto current{ stripWeak(etag) };
+    const std::string_view header{ ifNoneMatch->value() };
+
+    for (const auto tag : header | std::views::split(','))
+    {
+        const auto candidate{ stripWeak(std::string_view{ tag.begin(), tag.end() }) };
+        if (candidate == "*" || candidate == current) 
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+boost::beast::http::response<boost::beast::http::string_body> IHandler::createNotModifiedResponse(const std::string& etag) const noexcept
+{
+    boost::beast::http::response<boost::beast::http::string_body> response{ boost::beast::http::status::not_modified, 11 }; // 11 - HTTP/1.1
+    response.set(boost::beast::http::field::etag, etag);
+    response.set(boost::beast::http::field::cache_control, cacheControl_);
+    response.set(boost::beast::http::field::vary, "Accept");
+    response.prepare_payload();
+
+    setCorsHeaders(response);
+    return response;
+}
 }
@@ -1,9 +1,14 @@
 #ifndef IHANDLER_H
 #define IHANDLER_H
 
+#include <filesystem>
+#include <memory>
+#include <optional>
 #include <string>
 #include <nlohmann/json.hpp>
 #include <boost/beast/http.hpp>
+#include "IResponseStream.h"
+#include "../utils/PayloadCodec.h"
 
 namespace handlers
 {
@@ -69,6 +74,73 @@ public:
      */
     [[nodiscard]] virtual std::vector<boost::beast::http::verb> getSupportedMethods() const noexcept = 0;
 
+    /**
+     * @brief Handles a request using the response format negotiated from its Accept header
+     * @param request HTTP request to handle
+     * @return boost::beast::http::response<boost::beast::http::string_body> HTTP response
+     * @note Entry point for the server and the batch dispatcher; responses created by
+     *       handleRequest are encoded as JSON, MessagePack or CBOR accordingly
+     * @see utils::PayloadCodec::negotiate
+     */
+    [[nodiscard]] boost::beast::http::response<boost::beast::http::string_body> process(const boost::beast::http::request<boost::beast::http::string_body>& request) noexcept;
+
+    /**
+     * @brief Checks if a request is served with a streaming (chunked) response
+     * @param request HTTP request to check
+     * @return bool True if the request must be handled with processStream instead of process
+     * @note Returns false by default; overridden by handlers with streaming endpoints
+     */
+    [[nodiscard]] virtual bool isStreamingRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept;
+
+    /**
+     * @brief Opens a streaming response using the format negotiated from the Accept header
+     * @param request HTTP request to handle
+     * @param[out] response Response header for the stream, or a complete error response
+     * @return std::shared_ptr<IResponseStream> Body stream, or nullptr if response holds an error response
+     * @see isStreamingRequest
+     * @see handleStreamRequest
+     */
+    [[nodiscard]] std::shared_ptr<IResponseStream> processStream(const boost::beast::http::request<boost::beast::http::string_body>& request,
+        boost::beast::http::response<boost::beast::http::string_body>& response) noexcept;
+
+    /**
+     * @brief Checks if a request body is received as a file upload
+     * @param request HTTP request with the header only (the body has not been read yet)
+     * @return bool True if the body must be written to a file and the request handled with processUpload
+     * @note Returns false by default; overridden by handlers with upload endpoints
+     */
+    [[nodiscard]] virtual bool isUploadRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept;
+
+    /**
+     * @brief Accepts or rejects an upload before its body is read
+     * @param request HTTP request with the header only
+     * @param[out] bodyFile Path of the file the body must be written to if the upload is accepted
+     * @return std::optional<boost::beast::http::response<boost::beast::http::string_body>> Error response
+     *         to send without reading the body, or std::nullopt if the upload is accepted
+     * @see isUploadRequest
+     * @see handleUploadHeader
+     */
+    [[nodiscard]] std::optional<boost::beast::http::response<boost::beast::http::string_body>> processUploadHeader(
+        const boost::beast::http::request<boost::beast::http::string_body>& request, std::filesystem::path& bodyFile) noexcept;
+
+    /**
+     * @brief Handles an upload whose body has been written to a file
+     * @param request HTTP request with the header only
+     * @param bodyFile File with the complete request body
+     * @return boost::beast::http::response<boost::beast::http::string_body> HTTP response
+     * @note The caller removes bodyFile afterwards if the handler has not moved it
+     * @see handleUploadRequest
+     */
+    [[nodiscard]] boost::beast::http::response<boost::beast::http::string_body> processUpload(
+        const boost::beast::http::request<boost::beast::http::string_body>& request, const std::filesystem::path& bodyFile) noexcept;
+
+    /**
+     * @brief Sets the Cache-Control header value used for all JSON responses
+     * @param cacheControl Cache-Control header value (e.g. "no-cache", "private, max-age=0")
+     * @note Must be called during startup, before requests are handled
+     */
+    static void setCacheControl(const std::string& cacheControl) noexcept;
+
 protected:
     /**
      * @brief Validates an authentication token
@@ -79,6 +151,36 @@ protected:
      */
     [[nodiscard]] virtual bool isAuthTokenValid(const std::string& token, std::string& userId) const noexcept = 0;
 
+    /**
+     * @brief Handles a streaming request
+     * @param request HTTP request to handle
+     * @param[out] response Response header for the stream (see createStreamResponse), or a complete error response
+     * @return std::shared_ptr<IResponseStream> Body stream, or nullptr if response holds an error response
+     * @note The default implementation responds with 404 ENDPOINT_NOT_FOUND
+     */
+    [[nodiscard]] virtual std::shared_ptr<IResponseStream> handleStreamRequest(const boost::beast::http::request<boost::beast::http::string_body>& request,
+        boost::beast::http::response<boost::beast::http::string_body>& response) noexcept;
+
+    /**
+     * @brief Checks the header of an upload request before its body is read
+     * @param request HTTP request with the header only
+     * @param[out] bodyFile Path of the file the body must be written to
+     * @return std::optional<boost::beast::http::response<boost::beast::http::string_body>> Error response, or std::nullopt to accept the upload
+     * @note The default implementation responds with 404 ENDPOINT_NOT_FOUND
+     */
+    [[nodiscard]] virtual std::optional<boost::beast::http::response<boost::beast::http::string_body>> handleUploadHeader(
+        const boost::beast::http::request<boost::beast::http::string_body>& request, std::filesystem::path& bodyFile) noexcept;
+
+    /**
+     * @brief Handles an upload whose body has been written to a file
+     * @param request HTTP request with the header only
+     * @param bodyFile File with the complete request body
+     * @return boost::beast::http::response<boost::beast::http::string_body> HTTP response
+     * @note The default implementation responds with 404 ENDPOINT_NOT_FOUND
+     */
+    [[nodiscard]] virtual boost::beast::http::response<boost::beast::http::string_body> handleUploadRequest(
+        const boost::beast::http::request<boost::beast::http::string_body>& request, const std::filesystem::path& bodyFile) noexcept;
+
     /**
      * @brief Creates a success HTTP response with JSON body
      * @param data JSON data to include in response
@@ -108,12 +210,21 @@ protected:
      * @param json JSON object for response body
      * @param status HTTP status code (default: 200 OK)
      * @return boost::beast::http::response<boost::beast::http::string_body> Formatted HTTP response
-     * @note Includes CORS headers and proper content type
+     * @note Includes CORS headers and proper content type; the body is serialized in the
+     *       format negotiated by process (JSON by default)
      */
     [[nodiscard]] boost::beast::http::response<boost::beast::http::string_body> createJsonResponse(
         const nlohmann::json& json,
         boost::beast::http::status status = boost::beast::http::status::ok) const noexcept;
 
+    /**
+     * @brief Creates the header of a streaming response
+     * @param contentType Content type of the streamed body
+     * @return boost::beast::http::response<boost::beast::http::string_body> HTTP 200 response without body and with chunked transfer encoding
+     * @note Includes CORS headers and the configured Cache-Control header
+     */
+    [[nodiscard]] boost::beast::http::response<boost::beast::http::string_body> createStreamResponse(const std::string& contentType) const noexcept;
+
     /**
      * @brief Validates if a request body contains valid JSON
      * @param body Request body string
@@ -122,6 +233,15 @@ protected:
      */
     [[nodiscard]] bool isJsonBodyValid(const std::string& body, nlohmann::json& json) const noexcept;
 
+    /**
+     * @brief Validates and parses a request body in the format given by its Content-Type
+     * @param request HTTP request with a JSON, MessagePack or CBOR body
+     * @param json[out] Parsed JSON object if valid
+     * @return bool True if body is valid in its declared format, false otherwise
+     * @see isPayloadContentType
+     */
+    [[nodiscard]] bool isJsonBodyValid(const boost::beast::http::request<boost::beast::http::string_body>& request, nlohmann::json& json) const noexcept;
+
     /**
      * @brief Extracts Bearer token from Authorization header
      * @param request HTTP request
@@ -138,11 +258,11 @@ protected:
     void setCorsHeaders(boost::beast::http::response<boost::beast::http::string_body>& response) const noexcept;
 
     /**
-     * @brief Checks if request has JSON content type
+     * @brief Checks if request has a supported payload content type
      * @param request HTTP request to check
-     * @return bool True if Content-Type is application/json, false otherwise
+     * @return bool True if Content-Type is application/json, application/msgpack or application/cbor, false otherwise
      */
-    [[nodiscard]] bool isJsonContentType(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept;
+    [[nodiscard]] bool isPayloadContentType(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept;
 
     /**
      * @brief Safely converts string to integer with default value
@@ -151,6 +271,35 @@ protected:
      * @return int Converted integer or defaultValue on failure
      */
     [[nodiscard]] int stringToInt(const std::string& str, int defaultValue) const noexcept;
+
+    /**
+     * @brief Creates a weak ETag from a version marker
+     * @param versionMarker String identifying the version of the representation
+     *        (counts and timestamps read from the database, requesting user, request target, ...)
+     * @return std::string Weak ETag in the form W/"<hash>"
+     * @note The negotiated response format is mixed in, so ETags differ between formats
+     */
+    [[nodiscard]] std::string createWeakETag(const std::string& versionMarker) const noexcept;
+
+    /**
+     * @brief Checks if the If-None-Match header of a request matches an ETag
+     * @param request HTTP request to check
+     * @param etag Current ETag of the requested representation
+     * @return bool True if the client already has the current representation
+     * @note Uses weak comparison as required for If-None-Match (RFC 9110)
+     */
+    [[nodiscard]] bool isETagMatched(const boost::beast::http::request<boost::beast::http::string_body>& request, const std::string& etag) const noexcept;
+
+    /**
+     * @brief Creates a 304 Not Modified response
+     * @param etag Current ETag of the requested representation
+     * @return boost::beast::http::response<boost::beast::http::string_body> HTTP 304 response without body
+     */
+    [[nodiscard]] boost::beast::http::response<boost::beast::http::string_body> createNotModifiedResponse(const std::string& etag) const noexcept;
+
+private:
+    static inline std::string cacheControl_{ "no-cache" }; ///< Cache-Control header value for JSON responses
+    static inline thread_local utils::PayloadFormat responseFormat_{ utils::PayloadFormat::Json }; ///< Response format of the request being processed on this thread
 };
 }
 
@@ -0,0 +1,103 @@
+#ifndef IRESPONSE_STREAM_H
+#define IRESPONSE_STREAM_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace handlers
+{
+/**
+ * @struct FileRegion
+ * @brief Part of a file that makes up a whole response body
+ */
+struct FileRegion final
+{
+    std::filesystem::path path;   ///< File the body is read from
+    std::uint64_t offset{ 0 };    ///< Offset of the first byte of the body
+    std::uint64_t length{ 0 };    ///< Number of bytes in the body
+};
+
+/**
+ * @class IResponseStream
+ * @brief Abstract source of a response body that is produced and sent chunk by chunk
+ *
+ * Returned by handlers for endpoints whose body is too large to be materialized
+ * at once. The session writes the response header with chunked transfer encoding
+ * and then pulls chunks one at a time, writing each one before the next is produced,
+ * so memory usage is bounded by the size of a single chunk.
+ *
+ * @note A stream is used by a single session and is not thread-safe; the session may
+ *       produce its chunks on different threads, but never two at once
+ * @see IHandler::processStream
+ */
+class IResponseStream
+{
+public:
+    /**
+     * @brief Default constructor
+     */
+    IResponseStream() noexcept = default;
+
+    /**
+     * @brief Virtual destructor for proper polymorphic destruction
+     */
+    virtual ~IResponseStream() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note Streams should not be copied
+     */
+    IResponseStream(const IResponseStream&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note Streams should not be copied
+     */
+    IResponseStream& operator=(const IResponseStream&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note Streams should not be moved
+     */
+    IResponseStream(IResponseStream&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note Streams should not be moved
+     */
+    IResponseStream& operator=(IResponseStream&&) = delete;
+
+    /**
+     * @brief Produces the next chunk of the response body
+     * @param[out] chunk Next non-empty part of the body
+     * @return bool True if a chunk was produced, false if the body is complete
+     * @throws std::exception if the body cannot be produced; the session then aborts
+     *         the connection without the final chunk so the client sees a truncated body
+     */
+    [[nodiscard]] virtual bool readNextChunk(std::string& chunk) = 0;
+
+    /**
+     * @brief Gets the total size of the body if it is known in advance
+     * @return std::optional<std::uint64_t> Body size in bytes, or std::nullopt for a body of unknown size
+     * @note A body of known size is sent with Content-Length instead of chunked transfer encoding
+     */
+    [[nodiscard]] virtual std::optional<std::uint64_t> getContentLength() const noexcept
+    {
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Gets the file region the body consists of, if it is a plain part of a file
+     * @return std::optional<FileRegion> File region, or std::nullopt for a generated body
+     * @note Lets the session hand the file to the kernel instead of pulling chunks
+     */
+    [[nodiscard]] virtual std::optional<FileRegion> getFileRegion() const
+    {
+        return std::nullopt;
+    }
+};
+}
+
+#endif // IRESPONSE_STREAM_H
@@ -0,0 +1,102 @@
+#include "MessageExportStream.h"
+#include "../models/Message.h"
+#include <format>
+
+namespace handlers
+{
+constexpr auto EXPORT_PAGE_SIZE{ 500 };
+
+MessageExportStream::MessageExportStream(std::shared_ptr<database::DatabaseManager> dbManager, std::string userId, std::string peerUserId) noexcept :
+    dbManager_{ std::move(dbManager) },
+    userId_{ std::move(userId) },
+    peerUserId_{ std::move(peerUserId) }
+{
+}
+
+bool MessageExportStream::readNextChunk(std::string& chunk)
+{
+    chunk.clear();
+
+    if (isFinished_)
+    {
+        return false;
+    }
+
+    std::string sql{ R"(
+            SELECT
+                m.message_id,
+                m.from_user_id,
+                m.to_user_id,
+                m.message_text,
+                m.is_read,
+                m.created_at,
+                from_user.login as from_login,
+                to_user.login as to_login,
+                (SELECT string_agg(ma.attachment_id::text, ',') FROM message_attachments ma WHERE ma.message_id = m.message_id) as attachment_ids
+            FROM messages m
+            LEFT JOIN users from_user ON m.from_user_id = from_user.user_id
+            LEFT JOIN users to_user ON m.to_user_id = to_user.user_id
+            WHERE (m.from_user_id = $1 OR m.to_user_id = $1))" };
+
+    pqxx::params params{ userId_ };
+    auto paramIndex{ 1 };
+
+    if (!peerUserId_.empty())
+    {
+        params.append(peerUserId_);
+        ++paramIndex;
+        sql += std::format(" AND (m.from_user_id = ${0} OR m.to_user_id = ${0})", paramIndex);
+    }
+
+    // keyset cursor: continue strictly after the last exported row
+    if (!lastMessageId_.empty())
+    {
+        params.append(lastCreatedAt_);
+        params.append(lastMessageId_);
+        sql += std::format(" AND (m.created_at, m.message_id) > (${}::timestamptz, ${}::uuid)", paramIndex + 1, paramIndex + 2);
+    }
+
+    sql += " ORDER BY m.created_at, m.message_id LIMIT " + std::to_string(EXPORT_PAGE_SIZE);
+
+    const auto result{ dbManager_->executeQuery(sql, params) };
+
+    for (const auto& row : result)
+    {
+        nlohmann::json messageJson{};
+        messageJson["message_id"] = row["message_id"].as<std::string>();
+        messageJson["from_user_id"] = row["from_user_id"].as<std::string>();
+        messageJson["to_user_id"] = row["to_user_id"].as<std::string>();
+        messageJson["from_login"] = row["from_login"].is_null() ? "" : row["from_login"].as<std::string>();
+        messageJson["to_login"] = row["to_login"].is_null() ? "" : row["to_login"].as<std::string>();
+        messageJson["message_text"] = row["message_text"].as<std::string>();
+        messageJson["is_read"] = row["is_read"].as<bool>();
+        messageJson["created_at"] = row["created_at"].as<std::string>();
+
+        if (!row["attachment_ids"].is_null())
+        {
+            messageJson["attachment_ids"] = row["attachment_ids"].as<std::string>();
+        }
+
+        lastCreatedAt_ = messageJson["created_at"].get<std::string>();
+        lastMessageId_ = messageJson["message_id"].get<std::string>();
+
+        chunk += models::Message::fromDatabase(messageJson).toJson().dump();
+        chunk += '\n';
+    }
+
+    exportedCount_ += result.size();
+
+    // a short page is the last one, no need to query again
+    if (result.size() < static_cast<size_t>(EXPORT_PAGE_SIZE))
+    {
+        isFinished_ = true;
+    }
+
+    return !chunk.empty();
+}
+
+size_t MessageExportStream::getExportedCount() const noexcept
+{
+    return exportedCount_;
+}
+}
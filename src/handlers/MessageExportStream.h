@@ -0,0 +1,65 @@
+#ifndef MESSAGE_EXPORT_STREAM_H
+#define MESSAGE_EXPORT_STREAM_H
+
+#include "IResponseStream.h"
+#include "../database/DatabaseManager.h"
+#include <memory>
+#include <string>
+
+namespace handlers
+{
+/**
+ * @class MessageExportStream
+ * @brief Streams the full message history of a user as newline-delimited JSON
+ *
+ * Pages through the history in chronological order with a keyset cursor
+ * (created_at, message_id) kept in the stream, so that every page is a short
+ * indexed query and no database connection is held while the client reads.
+ * Each page becomes one chunk with one JSON object per line.
+ *
+ * @note Memory usage is bounded by the page size regardless of the history length
+ * @see IResponseStream
+ * @see MessageHandlers
+ */
+class MessageExportStream final : public IResponseStream
+{
+public:
+    /**
+     * @brief Constructs an export stream positioned before the first message
+     * @param dbManager Shared pointer to database manager
+     * @param userId ID of the user whose messages are exported
+     * @param peerUserId Optional ID of the conversation peer to filter by (empty for all messages)
+     */
+    MessageExportStream(std::shared_ptr<database::DatabaseManager> dbManager, std::string userId, std::string peerUserId) noexcept;
+
+    /**
+     * @brief Default virtual destructor
+     */
+    virtual ~MessageExportStream() noexcept override = default;
+
+    /**
+     * @brief Fetches the next page of messages and serializes it as NDJSON
+     * @param[out] chunk Serialized page, one message per line
+     * @return bool True if a page was produced, false if the history is exhausted
+     * @throws std::exception on database errors
+     */
+    [[nodiscard]] virtual bool readNextChunk(std::string& chunk) override;
+
+    /**
+     * @brief Gets the number of messages exported so far
+     * @return size_t Number of exported messages
+     */
+    [[nodiscard]] size_t getExportedCount() const noexcept;
+
+private:
+    std::shared_ptr<database::DatabaseManager> dbManager_; ///< Database manager for data access
+    std::string userId_;        ///< ID of the exporting user
+    std::string peerUserId_;    ///< Optional conversation peer filter
+    std::string lastCreatedAt_; ///< Cursor: created_at of the last exported message
+    std::string lastMessageId_; ///< Cursor: message_id of the last exported message
+    size_t exportedCount_{ 0 }; ///< Number of messages exported so far
+    bool isFinished_{ false };  ///< Set once a short page has been read
+};
+}
+
+#endif // MESSAGE_EXPORT_STREAM_H
@@ -1,10 +1,19 @@
 #include "MessageHandlers.h"
+#include "MessageExportStream.h"
 #include "../models/User.h"
 #include "../utils/Logger.h"
+#include "../utils/Validators.h"
+#include "../utils/UUIDUtils.h"
+#include <unordered_set>
 
 namespace handlers
 {
 constexpr auto LIMIT_DEFAULT{ 50 };
+constexpr auto MAX_BATCH_SIZE{ 500u };
+constexpr auto MAX_MESSAGE_LENGTH{ 4096u };
+constexpr auto MAX_ATTACHMENTS_PER_MESSAGE{ 10u };
+constexpr auto EXPORT_PATH{ "/api/v1/messages/export" };
+constexpr auto EXPORT_CONTENT_TYPE{ "application/x-ndjson" };
 
 MessageHandlers::MessageHandlers(std::shared_ptr<auth::JWTManager> jwtManager, std::shared_ptr<database::DatabaseManager> dbManager) noexcept :
     jwtManager_{ std::move(jwtManager) },
@@ -22,10 +31,19 @@ boost::beast::http::response<boost::beast::http::string_body> MessageHandlers::h
         {
             return handleSendMessage(request);
         }
+        if (path == "/api/v1/messages/send_batch" && request.method() == boost::beast::http::verb::post)
+        {
+            return handleSendMessageBatch(request);
+        }
         if (path == "/api/v1/messages/read" && request.method() == boost::beast::http::verb::post)
         {
             return handleMarkAsRead(request);
         }
+        if (path.find(EXPORT_PATH) == 0)
+        {
+            // the export is only served as a streaming response (not through batch requests)
+            return createErrorResponse(boost::beast::http::status::bad_request, "STREAMING_REQUIRED", "Export is only available as a direct streaming request");
+        }
         if (path.find("/api/v1/messages") == 0 && request.method() == boost::beast::http::verb::get)
         {
             return handleGetMessages(request);
@@ -45,6 +63,77 @@ std::vector<boost::beast::http::verb> MessageHandlers::getSupportedMethods() con
     return { boost::beast::http::verb::get, boost::beast::http::verb::post };
 }
 
+bool MessageHandlers::isStreamingRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
+{
+    const std::string target{ request.target() };
+    return request.method() == boost::beast::http::verb::get && target.substr(0, target.find('?')) == EXPORT_PATH;
+}
+
+std::shared_ptr<IResponseStream> MessageHandlers::handleStreamRequest(const boost::beast::http::request<boost::beast::http::string_body>& request, boost::beast::http::response<boost::beast::http::string_body>& response) noexcept
+{
+    try
+    {
+        const auto accessToken{ extractBearerToken(request) };
+        if (accessToken.empty())
+        {
+            response = createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Access token is required");
+            return nullptr;
+        }
+
+        std::string userId;
+        if (!isAuthTokenValid(accessToken, userId))
+        {
+            response = createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Invalid access token");
+            return nullptr;
+        }
+
+        // parsing request parameters
+        const std::string target{ request.target() };
+        const auto queryPos{ target.find('?') };
+        std::istringstream iss{ (queryPos != std::string::npos) ? target.substr(queryPos + 1) : "" };
+
+        std::string conversationWith;
+        std::string token;
+
+        while (std::getline(iss, token, '&'))
+        {
+            if (const auto eqPos{ token.find('=') }; eqPos != std::string::npos && token.substr(0, eqPos) == "conversation_with")
+            {
+                conversationWith = token.substr(eqPos + 1);
+            }
+        }
+
+        std::string peerUserId;
+        if (!conversationWith.empty())
+        {
+            if (!utils::Validators::isLoginValid(conversationWith))
+            {
+                response = createErrorResponse(boost::beast::http::status::bad_request, "INVALID_LOGIN", "Invalid login format");
+                return nullptr;
+            }
+
+            peerUserId = getUserIdByLogin(conversationWith);
+            if (peerUserId.empty())
+            {
+                response = createErrorResponse(boost::beast::http::status::not_found, "USER_NOT_FOUND", "User not found");
+                return nullptr;
+            }
+        }
+
+        LOG_INFO("Starting message export for user: " + userId);
+
+        response = createStreamResponse(EXPORT_CONTENT_TYPE);
+        response.set(boost::beast::http::field::content_disposition, "attachment; filename=\"messages.ndjson\"");
+        return std::make_shared<MessageExportStream>(dbManager_, userId, peerUserId);
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to start message export: " + std::string{ e.what() });
+        response = createErrorResponse(boost::beast::http::status::internal_server_error, "EXPORT_FAILED", "Failed to export messages");
+        return nullptr;
+    }
+}
+
 boost::beast::http::response<boost::beast::http::string_body> MessageHandlers::handleSendMessage(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
 {
     auto accessToken{ extractBearerToken(request) };
@@ -59,13 +148,13 @@ boost::beast::http::response<boost::beast::http::string_body> MessageHandlers::h
         return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Invalid access token");
     }
 
-    if (!isJsonContentType(request)) 
+    if (!isPayloadContentType(request)) 
     {
-        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json");
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json, application/msgpack or application/cbor");
     }
 
     nlohmann::json jsonBody{};
-    if (!isJsonBodyValid(request.body(), jsonBody)) 
+    if (!isJsonBodyValid(request, jsonBody)) 
     {
         return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_JSON", "Invalid JSON body");
     }
@@ -78,40 +167,97 @@ boost::beast::http::response<boost::beast::http::string_body> MessageHandlers::h
     auto toLogin{ jsonBody["to_login"].get<std::string>() };
     auto messageText{ jsonBody["message"].get<std::string>() };
 
-    if (messageText.empty()) 
+    // the limit counts characters as the database does, of the text as it is stored with quotes and backslashes escaped
+    const auto storedText{ utils::Validators::sanitizeString(messageText, false) };
+
+    if (storedText.empty()) 
     {
         return createErrorResponse(boost::beast::http::status::bad_request, "EMPTY_MESSAGE", "Message cannot be empty");
     }
 
-    if (messageText.length() > 4096) 
+    if (!utils::Validators::isMessageLengthValid(storedText, MAX_MESSAGE_LENGTH)) 
     {
         return createErrorResponse(boost::beast::http::status::bad_request, "MESSAGE_TOO_LONG", "Message exceeds maximum length of 4096 characters");
     }
 
+    std::vector<std::string> attachmentIds;
+    if (jsonBody.contains("attachment_ids"))
+    {
+        if (!jsonBody["attachment_ids"].is_array() || jsonBody["attachment_ids"].size() > MAX_ATTACHMENTS_PER_MESSAGE)
+        {
+            return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_ATTACHMENTS",
+                "attachment_ids must be an array of at most " + std::to_string(MAX_ATTACHMENTS_PER_MESSAGE) + " attachment IDs");
+        }
+
+        for (const auto& attachmentId : jsonBody["attachment_ids"])
+        {
+            if (!attachmentId.is_string() || !utils::Validators::isUUIDValid(attachmentId.get<std::string>()))
+            {
+                return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_ATTACHMENT_ID", "Invalid attachment ID format");
+            }
+
+            if (std::ranges::find(attachmentIds, attachmentId.get<std::string>()) == attachmentIds.end())
+            {
+                attachmentIds.push_back(attachmentId.get<std::string>());
+            }
+        }
+    }
+
     try 
     {
-        // obtaining the recipient's ID
-        auto toUserId{ getUserIdByLogin(toLogin) };
-        if (toUserId.empty()) 
+        // only the uploader may attach a file to a message
+        if (!attachmentIds.empty())
+        {
+            const auto owned{ dbManager_->executeQuery("SELECT COUNT(*) as count FROM attachments WHERE attachment_id = ANY($1::uuid[]) AND uploader_id = $2",
+                pqxx::params{ attachmentIds, fromUserId }) };
+
+            if (owned[0]["count"].as<size_t>() != attachmentIds.size())
+            {
+                return createErrorResponse(boost::beast::http::status::not_found, "ATTACHMENT_NOT_FOUND", "Attachment not found");
+            }
+        }
+
+        // creating a message, the recipient is resolved by the insert itself and the attachments are linked in the same statement
+        auto message{ models::Message::createMessage(fromUserId, "", messageText) };
+
+        const auto result{ dbManager_->executeQuery(R"(
+            WITH recipient AS (
+                SELECT user_id FROM users WHERE login = $1
+            ), inserted AS (
+                INSERT INTO messages (from_user_id, to_user_id, message_text, message_id, is_read)
+                SELECT $3::uuid, user_id, $4, $5::uuid, FALSE
+                FROM recipient WHERE user_id <> $3::uuid
+                RETURNING message_id, to_user_id
+            ), linked AS (
+                INSERT INTO message_attachments (message_id, attachment_id)
+                SELECT inserted.message_id, unnest($2::uuid[]) FROM inserted
+            )
+            SELECT recipient.user_id, inserted.to_user_id FROM recipient LEFT JOIN inserted ON TRUE)",
+            pqxx::params{ toLogin, attachmentIds, fromUserId, message.getStoredMessageText(), message.getMessageId() }
+        ) };
+
+        if (result.empty()) 
         {
             return createErrorResponse(boost::beast::http::status::not_found, "USER_NOT_FOUND", "Recipient user not found");
         }
 
-        // checking that the user is not sending a message to himself
-        if (fromUserId == toUserId) 
+        // the recipient exists but nothing was inserted: the user is sending a message to himself
+        if (result[0]["to_user_id"].is_null()) 
         {
             return createErrorResponse(boost::beast::http::status::bad_request, "SELF_MESSAGE", "Cannot send message to yourself");
         }
 
-        // creating and saving a message
-        auto message{ models::Message::createMessage(fromUserId, toUserId, messageText) };
-
-        dbManager_->executeQuery(message.generateInsertSql());
+        const auto toUserId{ result[0]["to_user_id"].as<std::string>() };
 
         nlohmann::json responseData{};
         responseData["message_id"] = message.getMessageId();
         responseData["sent_at"] = message.getCreatedAt();
 
+        if (!attachmentIds.empty())
+        {
+            responseData["attachment_ids"] = attachmentIds;
+        }
+
         LOG_INFO("Message sent from " + fromUserId + " to " + toUserId);
         return createSuccessResponse(responseData, boost::beast::http::status::created, "Message sent successfully");
     }
@@ -122,6 +268,243 @@ boost::beast::http::response<boost::beast::http::string_body> MessageHandlers::h
     }
 }
 
+boost::beast::http::response<boost::beast::http::string_body> MessageHandlers::handleSendMessageBatch(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
+{
+    auto accessToken{ extractBearerToken(request) };
+    if (accessToken.empty()) 
+    {
+        return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Access token is required");
+    }
+
+    std::string fromUserId;
+    if (!isAuthTokenValid(accessToken, fromUserId)) 
+    {
+        return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Invalid access token");
+    }
+
+    if (!isPayloadContentType(request)) 
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json, application/msgpack or application/cbor");
+    }
+
+    nlohmann::json jsonBody{};
+    if (!isJsonBodyValid(request, jsonBody)) 
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_JSON", "Invalid JSON body");
+    }
+
+    const auto hasMessages{ jsonBody.contains("messages") && jsonBody["messages"].is_array() };
+    const auto hasBroadcast{ jsonBody.contains("to_logins") && jsonBody["to_logins"].is_array() &&
+        jsonBody.contains("message") && jsonBody["message"].is_string() };
+
+    if (!hasMessages && !hasBroadcast) 
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "MISSING_FIELDS", "messages or to_logins and message are required");
+    }
+
+    // flattening both request forms into (to_login, message) pairs
+    std::vector<std::pair<std::string, std::string>> items;
+    std::vector<std::string> itemErrors;
+
+    auto addItem{ [&items, &itemErrors](const nlohmann::json& toLogin, const nlohmann::json& message)
+    {
+        if (!toLogin.is_string() || !message.is_string()) 
+        {
+            items.emplace_back(toLogin.is_string() ? toLogin.get<std::string>() : "", "");
+            itemErrors.emplace_back("MISSING_FIELDS");
+            return;
+        }
+
+        items.emplace_back(toLogin.get<std::string>(), message.get<std::string>());
+        itemErrors.emplace_back();
+    } };
+
+    if (hasMessages) 
+    {
+        for (const auto& item : jsonBody["messages"]) 
+        {
+            if (!item.is_object() || !item.contains("to_login") || !item.contains("message")) 
+            {
+                addItem(item.is_object() && item.contains("to_login") ? item["to_login"] : nlohmann::json{}, nlohmann::json{});
+                continue;
+            }
+
+            addItem(item["to_login"], item["message"]);
+        }
+    }
+
+    if (hasBroadcast) 
+    {
+        for (const auto& toLogin : jsonBody["to_logins"]) 
+        {
+            addItem(toLogin, jsonBody["message"]);
+        }
+    }
+
+    if (items.empty()) 
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "EMPTY_BATCH", "Batch cannot be empty");
+    }
+
+    if (items.size() > MAX_BATCH_SIZE) 
+    {
+        return createErrorResponse(boost::beast::http::status::bad_request, "BATCH_TOO_LARGE", "Batch exceeds maximum size of " + std::to_string(MAX_BATCH_SIZE) + " messages");
+    }
+
+    // validating every item before touching the database
+    std::vector<std::string> logins;
+    std::unordered_set<std::string> uniqueLogins;
+
+    for (auto i : std::ranges::views::iota(0u, items.size()))
+    {
+        if (!itemErrors[i].empty()) 
+        {
+            continue;
+        }
+
+        const auto& [toLogin, messageText] { items[i] };
+        const auto storedText{ utils::Validators::sanitizeString(messageText, false) };
+
+        if (!utils::Validators::isLoginValid(toLogin)) 
+        {
+            itemErrors[i] = "INVALID_LOGIN";
+        }
+        else if (storedText.empty()) 
+        {
+            itemErrors[i] = "EMPTY_MESSAGE";
+        }
+        else if (!utils::Validators::isMessageLengthValid(storedText, MAX_MESSAGE_LENGTH)) 
+        {
+            itemErrors[i] = "MESSAGE_TOO_LONG";
+        }
+        else if (uniqueLogins.insert(toLogin).second) 
+        {
+            logins.emplace_back(toLogin);
+        }
+    }
+
+    try 
+    {
+        const auto userIds{ logins.empty() ? std::unordered_map<std::string, std::string>{} : resolveUserIdsByLogins(logins) };
+
+        // the same text is sanitized only once for all of its recipients
+        std::unordered_map<std::string, models::Message> prototypes;
+        std::vector<models::Message> messages;
+        std::vector<std::size_t> messageItems;
+
+        for (auto i : std::ranges::views::iota(0u, items.size()))
+        {
+            if (!itemErrors[i].empty()) 
+            {
+                continue;
+            }
+
+            const auto& [toLogin, messageText] { items[i] };
+
+            const auto userIt{ userIds.find(toLogin) };
+            if (userIt == userIds.end()) 
+            {
+                itemErrors[i] = "USER_NOT_FOUND";
+                continue;
+            }
+
+            if (userIt->second == fromUserId) 
+            {
+                itemErrors[i] = "SELF_MESSAGE";
+                continue;
+            }
+
+            auto prototypeIt{ prototypes.find(messageText) };
+            if (prototypeIt == prototypes.end()) 
+            {
+                try 
+                {
+                    prototypeIt = prototypes.emplace(messageText, models::Message::createMessage(fromUserId, "", messageText)).first;
+                }
+                catch (const std::invalid_argument&) 
+                {
+                    itemErrors[i] = "INVALID_MESSAGE";
+                    continue;
+                }
+            }
+
+            auto message{ prototypeIt->second };
+            message.setMessageId(utils::UUIDUtils::generateUUID());
+            message.setToUserId(userIt->second);
+
+            messages.emplace_back(std::move(message));
+            messageItems.emplace_back(i);
+        }
+
+        // storing all messages with a single statement in one transaction, one array parameter per column
+        if (!messages.empty()) 
+        {
+            std::vector<std::string> toUserIds;
+            std::vector<std::string> texts;
+            std::vector<std::string> messageIds;
+
+            toUserIds.reserve(messages.size());
+            texts.reserve(messages.size());
+            messageIds.reserve(messages.size());
+
+            for (const auto& message : messages) 
+            {
+                toUserIds.emplace_back(message.getToUserId());
+                texts.emplace_back(message.getStoredMessageText());
+                messageIds.emplace_back(message.getMessageId());
+            }
+
+            dbManager_->executeQuery(R"(
+                INSERT INTO messages (from_user_id, to_user_id, message_text, message_id, is_read)
+                SELECT $1::uuid, batch.to_user_id, batch.message_text, batch.message_id, FALSE
+                FROM unnest($2::uuid[], $3::text[], $4::uuid[]) AS batch(to_user_id, message_text, message_id))",
+                pqxx::params{ fromUserId, toUserIds, texts, messageIds }
+            );
+        }
+
+        std::vector<const models::Message*> sentMessages(items.size(), nullptr);
+        for (auto i : std::ranges::views::iota(0u, messages.size()))
+        {
+            sentMessages[messageItems[i]] = &messages[i];
+        }
+
+        auto results{ nlohmann::json::array() };
+        for (auto i : std::ranges::views::iota(0u, items.size()))
+        {
+            nlohmann::json result{};
+            result["index"] = i;
+            result["to_login"] = items[i].first;
+
+            if (const auto* message{ sentMessages[i] }; message != nullptr) 
+            {
+                result["status"] = "sent";
+                result["message_id"] = message->getMessageId();
+                result["sent_at"] = message->getCreatedAt();
+            }
+            else 
+            {
+                result["status"] = "failed";
+                result["code"] = itemErrors[i];
+            }
+
+            results.emplace_back(result);
+        }
+
+        nlohmann::json responseData{};
+        responseData["results"] = results;
+        responseData["sent_count"] = messages.size();
+        responseData["failed_count"] = items.size() - messages.size();
+
+        LOG_INFO("Batch of " + std::to_string(messages.size()) + " messages sent from " + fromUserId);
+        return createSuccessResponse(responseData, boost::beast::http::status::ok, "Batch processed");
+    }
+    catch (const std::exception& e) 
+    {
+        LOG_ERROR("Failed to send message batch: " + std::string{ e.what() });
+        return createErrorResponse(boost::beast::http::status::internal_server_error, "MESSAGE_SEND_FAILED", "Failed to send messages");
+    }
+}
+
 boost::beast::http::response<boost::beast::http::string_body> MessageHandlers::handleGetMessages(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept
 {
     auto accessToken{ extractBearerToken(request) };
@@ -185,40 +568,56 @@ boost::beast::http::response<boost::beast::http::string_body> MessageHandlers::h
 
     try 
     {
+        // the count query reads the version of the user's messages as well, so a revalidation costs a single query
+        std::string versionMarker;
+        const auto unreadCount{ getUnreadMessagesCount(userId, versionMarker) };
+        const auto etag{ createWeakETag(std::format("messages:{}:{}:{}", userId, versionMarker, target)) };
+
+        if (isETagMatched(request, etag)) 
+        {
+            return createNotModifiedResponse(etag);
+        }
+
         auto messages{ getMessagesForUser(userId, unreadOnly, afterMessageId, beforeMessageId, limit, conversationWith) };
-        auto unreadCount{ getUnreadMessagesCount(userId) };
 
         auto messagesJson{ nlohmann::json::array() };
-        for (const auto& message : messages) 
+        for (size_t i{ 0 }; i < messages.getSize(); ++i) 
         {
             nlohmann::json messageJson{};
-            messageJson["message_id"] = message.getMessageId();
-            messageJson["from_user_id"] = message.getFromUserId();
-            messageJson["to_user_id"] = message.getToUserId();
-            messageJson["from_login"] = message.getFromLogin();
-            messageJson["to_login"] = message.getToLogin();
-            messageJson["message_text"] = message.getMessageText();
-            messageJson["timestamp"] = message.getCreatedAt();
-            messageJson["is_read"] = message.getIsRead();
+            messageJson["message_id"] = messages.getMessageId(i);
+            messageJson["from_user_id"] = messages.getFromUserId(i);
+            messageJson["to_user_id"] = messages.getToUserId(i);
+            messageJson["from_login"] = messages.getFromLogin(i);
+            messageJson["to_login"] = messages.getToLogin(i);
+            messageJson["message_text"] = messages.getMessageText(i);
+            messageJson["timestamp"] = messages.getCreatedAt(i);
+            messageJson["is_read"] = messages.getIsRead(i);
+
+            if (auto attachmentIds{ messages.getAttachmentIds(i) }; !attachmentIds.empty())
+            {
+                messageJson["attachment_ids"] = std::move(attachmentIds);
+            }
 
-            messagesJson.emplace_back(messageJson);
+            messagesJson.emplace_back(std::move(messageJson));
         }
 
         nlohmann::json meta{};
-        meta["total_count"] = messages.size();
+        meta["total_count"] = messages.getSize();
         meta["unread_count"] = unreadCount;
-        meta["has_more"] = (messages.size() == limit);
+        meta["has_more"] = (messages.getSize() == static_cast<size_t>(limit));
 
-        if (!messages.empty()) 
+        if (!messages.isEmpty()) 
         {
-            meta["last_message_id"] = messages.back().getMessageId();
+            meta["last_message_id"] = messages.getMessageId(messages.getSize() - 1);
         }
 
         nlohmann::json responseData{};
         responseData["messages"] = messagesJson;
         responseData["meta"] = meta;
 
-        return createSuccessResponse(responseData);
+        auto response{ createSuccessResponse(responseData) };
+        response.set(boost::beast::http::field::etag, etag);
+        return response;
     }
     catch (const std::exception& e) 
     {
@@ -241,13 +640,13 @@ boost::beast::http::response<boost::beast::http::string_body> MessageHandlers::h
         return createErrorResponse(boost::beast::http::status::unauthorized, "INVALID_TOKEN", "Invalid access token");
     }
 
-    if (!isJsonContentType(request)) 
+    if (!isPayloadContentType(request)) 
     {
-        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json");
+        return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_CONTENT_TYPE", "Content-Type must be application/json, application/msgpack or application/cbor");
     }
 
     nlohmann::json jsonBody{};
-    if (!isJsonBodyValid(request.body(), jsonBody)) 
+    if (!isJsonBodyValid(request, jsonBody)) 
     {
         return createErrorResponse(boost::beast::http::status::bad_request, "INVALID_JSON", "Invalid JSON body");
     }
@@ -316,9 +715,31 @@ std::string MessageHandlers::getUserIdByLogin(const std::string& login) const no
     }
 }
 
-std::vector<models::Message> MessageHandlers::getMessagesForUser(const std::string& userId, bool isUnreadOnly, const std::string& afterMessageId, const std::string& beforeMessageId, int limit, const std::string& conversationWith) const
+std::unordered_map<std::string, std::string> MessageHandlers::resolveUserIdsByLogins(const std::vector<std::string>& logins) const
+{
+    std::unordered_map<std::string, std::string> userIds;
+
+    try 
+    {
+        const auto result{ dbManager_->executeQuery("SELECT user_id, login FROM users WHERE login = ANY($1)", pqxx::params{ logins }) };
+
+        for (const auto& row : result) 
+        {
+            userIds.emplace(row["login"].as<std::string>(), row["user_id"].as<std::string>());
+        }
+    }
+    catch (const std::exception& e) 
+    {
+        LOG_ERROR("Error resolving user IDs by logins: " + std::string{ e.what() });
+        throw;
+    }
+
+    return userIds;
+}
+
+models::MessagePage MessageHandlers::getMessagesForUser(const std::string& userId, bool isUnreadOnly, const std::string& afterMessageId, const std::string& beforeMessageId, int limit, const std::string& conversationWith) const
 {
-    std::vector<models::Message> messages;
+    models::MessagePage messages{};
 
     // SQL query with JOIN to get logins immediately
     std::string sql = R"(
@@ -328,9 +749,11 @@ std::vector<models::Message> MessageHandlers::getMessagesForUser(const std::stri
                 m.to_user_id,
                 m.message_text,
                 m.is_read,
-                m.created_at,
+                (EXTRACT(EPOCH FROM m.created_at) * 1000000)::bigint as created_at_us,
+                EXTRACT(TIMEZONE FROM m.created_at)::integer as utc_offset,
                 from_user.login as from_login,
-                to_user.login as to_login
+                to_user.login as to_login,
+                (SELECT string_agg(ma.attachment_id::text, ',') FROM message_attachments ma WHERE ma.message_id = m.message_id) as attachment_ids
             FROM messages m
             LEFT JOIN users from_user ON m.from_user_id = from_user.user_id
             LEFT JOIN users to_user ON m.to_user_id = to_user.user_id
@@ -366,23 +789,24 @@ std::vector<models::Message> MessageHandlers::getMessagesForUser(const std::stri
     {
         auto result = dbManager_->executeQuery(sql);
 
+        messages.reserve(result.size());
+
+        // fields are copied straight from the row into the page
         for (const auto& row : result) 
         {
-	        models::Message message{};
-            nlohmann::json messageJson{};
-
-            messageJson["message_id"] = row["message_id"].as<std::string>();
-            messageJson["from_user_id"] = row["from_user_id"].as<std::string>();
-            messageJson["to_user_id"] = row["to_user_id"].as<std::string>();
-            messageJson["from_login"] = row["from_login"].as<std::string>();
-            messageJson["to_login"] = row["to_login"].as<std::string>();
-            messageJson["message_text"] = row["message_text"].as<std::string>();
-            messageJson["is_read"] = row["is_read"].as<bool>();
-            messageJson["created_at"] = row["created_at"].as<std::string>();
-
-            message.fromDatabaseRow(messageJson);
-
-            messages.push_back(message);
+            models::MessageFields fields{};
+            fields.messageId = row["message_id"].view();
+            fields.fromUserId = row["from_user_id"].view();
+            fields.toUserId = row["to_user_id"].view();
+            fields.fromLogin = row["from_login"].view();
+            fields.toLogin = row["to_login"].view();
+            fields.text = row["message_text"].view();
+            fields.attachmentIds = row["attachment_ids"].view();
+            fields.createdAt = row["created_at_us"].as<int64_t>();
+            fields.utcOffset = row["utc_offset"].as<int32_t>();
+            fields.isRead = row["is_read"].as<bool>();
+
+            messages.add(fields);
         }
     }
     catch (const std::exception& e) 
@@ -415,9 +839,10 @@ int MessageHandlers::markMessagesAsRead(const std::vector<std::string>& messageI
             messageIdsStr += "'" + messageIds[i] + "'";
         }
 
-        const std::string sql{ "UPDATE messages SET is_read = TRUE WHERE message_id IN (" + messageIdsStr + ") AND to_user_id = '" + userId + "'" };
-        auto result{ dbManager_->executeQuery(sql) };
-        return static_cast<int>(messageIds.size());
+        const std::string sql{ "UPDATE messages SET is_read = TRUE WHERE message_id IN (" + messageIdsStr + ") AND to_user_id = '" + userId + "' RETURNING message_id" };
+        const auto result{ dbManager_->executeQuery(sql) };
+
+        return static_cast<int>(result.size());
     }
     catch (const std::exception& e) 
     {
@@ -426,26 +851,27 @@ int MessageHandlers::markMessagesAsRead(const std::vector<std::string>& messageI
     }
 }
 
-int MessageHandlers::getUnreadMessagesCount(const std::string& userId) const noexcept
+int MessageHandlers::getUnreadMessagesCount(const std::string& userId, std::string& versionMarker) const
 {
     try 
     {
-        const auto result{ dbManager_->executeQuery(
-            "SELECT COUNT(*) as count FROM messages WHERE to_user_id = '" +
-            userId + "' AND is_read = FALSE"
+        // sending and deleting change the count or the newest timestamp, reading only ever raises the read count
+        const auto result{ dbManager_->executeQuery(R"(
+            SELECT COUNT(*) FILTER (WHERE to_user_id = $1::uuid AND NOT is_read) AS unread_count,
+                COUNT(*) AS message_count,
+                COUNT(*) FILTER (WHERE is_read) AS read_count,
+                COALESCE(MAX(created_at)::text, '') AS last_created_at
+            FROM messages WHERE from_user_id = $1::uuid OR to_user_id = $1::uuid)",
+            pqxx::params{ userId }
         ) };
 
-        if (!result.empty()) 
-        {
-            return result[0]["count"].as<int>();
-        }
-
-        return 0;
+        versionMarker = std::format("{}:{}:{}", result[0]["message_count"].as<long long>(), result[0]["read_count"].as<long long>(), result[0]["last_created_at"].as<std::string>());
+        return result[0]["unread_count"].as<int>();
     }
     catch (const std::exception& e) 
     {
         LOG_ERROR("Error getting unread messages count: " + std::string{ e.what() });
-        return 0;
+        throw;
     }
 }
 }
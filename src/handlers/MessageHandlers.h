@@ -3,8 +3,10 @@
 
 #include "IHandler.h"
 #include "../models/Message.h"
+#include "../models/MessagePage.h"
 #include "../auth/JWTManager.h"
 #include "../database/DatabaseManager.h"
+#include <unordered_map>
 
 namespace handlers
 {
@@ -68,6 +70,7 @@ public:
      * @note Routes requests to appropriate handler methods based on endpoint and HTTP method
      * @warning This method never throws exceptions; errors are returned as HTTP error responses
      * @see handleSendMessage
+     * @see handleSendMessageBatch
      * @see handleGetMessages
      * @see handleMarkAsRead
      */
@@ -81,17 +84,53 @@ public:
      */
     [[nodiscard]] virtual std::vector<boost::beast::http::verb> getSupportedMethods() const noexcept override;
 
+    /**
+     * @brief Checks if a request targets the streaming export endpoint
+     * @param request HTTP request to check
+     * @return bool True for GET /api/v1/messages/export
+     */
+    [[nodiscard]] virtual bool isStreamingRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept override;
+
+protected:
+    /**
+     * @brief Handles message history export endpoint
+     * @param request HTTP GET request with optional query parameters
+     * @param[out] response Response header for the export, or a complete error response
+     * @return std::shared_ptr<IResponseStream> Export stream, or nullptr on error
+     * @details Supported query parameters:
+     * - conversation_with (string): Export only the conversation with specific user
+     * @note Requires Bearer token in Authorization header
+     * @note The body is newline-delimited JSON (application/x-ndjson) in chronological order
+     * @see MessageExportStream
+     */
+    [[nodiscard]] virtual std::shared_ptr<IResponseStream> handleStreamRequest(const boost::beast::http::request<boost::beast::http::string_body>& request,
+        boost::beast::http::response<boost::beast::http::string_body>& response) noexcept override;
+
 private:
     /**
      * @brief Handles message sending endpoint
      * @param request HTTP POST request with message data
      * @return HTTP response indicating send success or failure
-     * @details Expected JSON body: {"to_login": string, "message": string}
+     * @details Expected JSON body: {"to_login": string, "message": string, "attachment_ids": array of string (optional)}
      * @note Requires Bearer token in Authorization header
+     * @note Attachments must have been uploaded by the sender (see AttachmentHandlers)
      * @see models::Message::createMessage
      */
     [[nodiscard]] boost::beast::http::response<boost::beast::http::string_body> handleSendMessage(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept;
 
+    /**
+     * @brief Handles bulk message sending endpoint
+     * @param request HTTP POST request with a batch of messages
+     * @return HTTP response with per-item send results
+     * @details Expected JSON body (both forms may be combined):
+     * - {"messages": [{"to_login": string, "message": string}, ...]}
+     * - {"to_logins": array of string, "message": string}
+     * @note Requires Bearer token in Authorization header
+     * @note Recipients are resolved with a single query and all messages are stored with a single INSERT over unnested array parameters
+     * @see resolveUserIdsByLogins
+     */
+    [[nodiscard]] boost::beast::http::response<boost::beast::http::string_body> handleSendMessageBatch(const boost::beast::http::request<boost::beast::http::string_body>& request) const noexcept;
+
     /**
      * @brief Handles message retrieval endpoint
      * @param request HTTP GET request with optional query parameters
@@ -135,6 +174,14 @@ private:
      */
     [[nodiscard]] std::string getUserIdByLogin(const std::string& login) const noexcept;
 
+    /**
+     * @brief Retrieves user IDs for several logins with a single query
+     * @param logins User login names to lookup
+     * @return std::unordered_map<std::string, std::string> Map of login to user ID for logins that exist
+     * @throws std::exception on database errors
+     */
+    [[nodiscard]] std::unordered_map<std::string, std::string> resolveUserIdsByLogins(const std::vector<std::string>& logins) const;
+
     /**
      * @brief Retrieves messages for a specific user with various filters
      * @param userId ID of the user to retrieve messages for
@@ -143,11 +190,11 @@ private:
      * @param beforeMessageId Return messages before this message ID (default: empty)
      * @param limit Maximum number of messages to return (default: 50)
      * @param conversationWith Filter messages to conversation with specific user (default: empty)
-     * @return std::vector<models::Message> List of messages matching criteria
+     * @return models::MessagePage Messages matching criteria
      * @throws std::exception on database errors
      * @note Messages are returned in descending chronological order (newest first)
      */
-    [[nodiscard]] std::vector<models::Message> getMessagesForUser(const std::string& userId,
+    [[nodiscard]] models::MessagePage getMessagesForUser(const std::string& userId,
         bool isUnreadOnly = false,
         const std::string& afterMessageId = "",
         const std::string& beforeMessageId = "",
@@ -165,12 +212,14 @@ private:
     [[nodiscard]] int markMessagesAsRead(const std::vector<std::string>& messageIds, const std::string& userId) const;
 
     /**
-     * @brief Retrieves count of unread messages for a user
+     * @brief Retrieves count of unread messages for a user together with the version of their messages
      * @param userId ID of the user to check
+     * @param[out] versionMarker Changes whenever a message to or from the user is sent, read or deleted
      * @return int Number of unread messages
-     * @note Logs errors to the system logger
+     * @throws std::exception on database errors
+     * @note The marker is read from the database, so it sees changes made through every server instance
      */
-    [[nodiscard]] int getUnreadMessagesCount(const std::string& userId) const noexcept;
+    [[nodiscard]] int getUnreadMessagesCount(const std::string& userId, std::string& versionMarker) const;
 
 private:
     std::shared_ptr<auth::JWTManager> jwtManager_;      ///< JWT token manager for authentication
@@ -94,8 +94,17 @@ boost::beast::http::response<boost::beast::http::string_body> UserHandlers::hand
 
     try 
     {
+        // the user directory is the same for every requester, its version comes with the count
+        std::string versionMarker;
+        const auto totalCount{ getTotalUsersCount(search, versionMarker) };
+        const auto etag{ createWeakETag(std::format("users:{}:{}", versionMarker, target)) };
+
+        if (isETagMatched(request, etag)) 
+        {
+            return createNotModifiedResponse(etag);
+        }
+
         auto users{ getUsersPaginated(page, limit, search) };
-        auto totalCount{ getTotalUsersCount(search) };
         auto totalPages{ (totalCount + limit - 1) / limit };
 
         auto usersJson{ nlohmann::json::array() };
@@ -121,7 +130,9 @@ boost::beast::http::response<boost::beast::http::string_body> UserHandlers::hand
         responseData["users"] = usersJson;
         responseData["pagination"] = pagination;
 
-        return createSuccessResponse(responseData);
+        auto response{ createSuccessResponse(responseData) };
+        response.set(boost::beast::http::field::etag, etag);
+        return response;
     }
     catch (const std::exception& e) 
     {
@@ -182,6 +193,16 @@ boost::beast::http::response<boost::beast::http::string_body> UserHandlers::hand
 
     try 
     {
+        // the matching users are the same for every requester
+        std::string versionMarker;
+        [[maybe_unused]] const auto matchCount{ getTotalUsersCount(query, versionMarker) };
+        const auto etag{ createWeakETag(std::format("users:{}:{}", versionMarker, target)) };
+
+        if (isETagMatched(request, etag)) 
+        {
+            return createNotModifiedResponse(etag);
+        }
+
         auto users{ searchUsers(query, limit) };
 
         auto usersJson{ nlohmann::json::array() };
@@ -204,7 +225,9 @@ boost::beast::http::response<boost::beast::http::string_body> UserHandlers::hand
         responseData["users"] = usersJson;
         responseData["meta"] = meta;
 
-        return createSuccessResponse(responseData);
+        auto response{ createSuccessResponse(responseData) };
+        response.set(boost::beast::http::field::etag, etag);
+        return response;
     }
     catch (const std::exception& e) 
     {
@@ -306,28 +329,27 @@ std::vector<models::User> UserHandlers::searchUsers(const std::string& query, in
     return users;
 }
 
-int UserHandlers::getTotalUsersCount(const std::string& search) const noexcept
+int UserHandlers::getTotalUsersCount(const std::string& search, std::string& versionMarker) const
 {
-    std::string sql{ "SELECT COUNT(*) as count FROM users" };
+    // registering raises the newest timestamp, deleting lowers the count
+    std::string sql{ "SELECT COUNT(*) AS count, COALESCE(MAX(created_at)::text, '') AS last_created_at FROM users" };
 
     if (!search.empty()) 
     {
-        sql += " WHERE login ILIKE '%" + search + "%'";
+        sql += " WHERE login ILIKE '%' || $1 || '%'";
     }
 
     try 
     {
-	    if (const auto result{ dbManager_->executeQuery(sql) }; !result.empty()) 
-        {
-            return result[0]["count"].as<int>();
-        }
+        const auto result{ dbManager_->executeQuery(sql, search.empty() ? pqxx::params{} : pqxx::params{ search }) };
 
-        return 0;
+        versionMarker = std::format("{}:{}", result[0]["count"].as<int>(), result[0]["last_created_at"].as<std::string>());
+        return result[0]["count"].as<int>();
     }
     catch (const std::exception& e) 
     {
         LOG_ERROR("Error getting users count: " + std::string{ e.what() });
-        return 0;
+        throw;
     }
 }
 }
@@ -141,12 +141,14 @@ private:
     [[nodiscard]] std::vector<models::User> searchUsers(const std::string& query, int limit) const;
 
     /**
-     * @brief Retrieves total count of users with optional search filter
-     * @param search Optional search string to filter by login
+     * @brief Retrieves total count of users with optional search filter together with the version of the matching users
+     * @param search Search string to filter by login, empty for all users
+     * @param[out] versionMarker Changes whenever a matching user registers or is deleted
      * @return int Total number of users matching criteria
-     * @note Logs errors to the system logger
+     * @throws std::exception on database errors
+     * @note The marker is read from the database, so it sees changes made through every server instance
      */
-    [[nodiscard]] int getTotalUsersCount(const std::string& search = "") const noexcept;
+    [[nodiscard]] int getTotalUsersCount(const std::string& search, std::string& versionMarker) const;
 
 private:
     std::shared_ptr<auth::JWTManager> jwtManager_;      ///< JWT token manager for authentication
@@ -1,3 +1,4 @@
+#include <format>
 #include <iostream>
 #include <string>
 #include <memory>
@@ -105,6 +106,9 @@ int main(int argc, char* argv[]) noexcept
         LOG_DEBUG("SSL.CertificateFile: " + configManager->getSSLCertificateFile());
         LOG_DEBUG("SSL.PrivateKeyFile : " + configManager->getSSLPrivateKeyFile());
         LOG_DEBUG("SSL.DHParamsFile   : " + configManager->getSSLDHParamsFile());
+        LOG_DEBUG("SSL.CipherList     : " + configManager->getSSLCipherList());
+        LOG_DEBUG("SSL.CipherSuites   : " + configManager->getSSLCipherSuites());
+        LOG_DEBUG("SSL.Groups         : " + configManager->getSSLGroups());
 
         LOG_DEBUG("Database.Address          : " + configManager->getDatabaseAddress());
         LOG_DEBUG("Database.Port             : " + std::to_string(configManager->getDatabasePort()));
@@ -133,7 +137,10 @@ int main(int argc, char* argv[]) noexcept
             configManager->getDatabasePassword(),
             configManager->getDatabaseDBName(),
             configManager->getDatabaseMaxConnections(),
-            configManager->getDatabaseConnectionTimeout()
+            configManager->getDatabaseConnectionTimeout(),
+            database::ConcurrencySettings{ configManager->getDatabaseAdaptiveConcurrency(), configManager->getDatabaseMinConcurrency() },
+            database::CircuitBreakerSettings{ configManager->getDatabaseCircuitFailureThreshold(), std::chrono::milliseconds{ configManager->getDatabaseReconnectInterval() } },
+            std::chrono::milliseconds{ configManager->getHttpRequestTimeout() }
         ) };
 
         if (dbManager->healthCheck())
@@ -170,6 +177,21 @@ int main(int argc, char* argv[]) noexcept
             {
                 // Statistics logging every LOG_TIMEOUT_MIN minutes
                 LOG_INFO("Server is running normally");
+
+                const auto tlsStatistics{ server->getTlsStatistics() };
+                LOG_INFO(std::format("TLS handshakes: {}, resumed: {} ({:.1f}%), kernel TLS: {}, ticket key rotations: {}",
+                    tlsStatistics.handshakes, tlsStatistics.resumedHandshakes, tlsStatistics.getResumptionRate() * 100.0,
+                    tlsStatistics.kernelTlsHandshakes, tlsStatistics.ticketKeyRotations));
+
+                const auto connectionStatistics{ server->getConnectionStatistics() };
+                LOG_INFO(std::format("Connections open: {} (peak {}), accepted: {}, rejected: {}, accept pauses: {}",
+                    connectionStatistics.activeConnections, connectionStatistics.peakConnections, connectionStatistics.acceptedConnections,
+                    connectionStatistics.rejectedConnections, connectionStatistics.delayedAccepts));
+
+                const auto concurrencyStatistics{ server->getDatabaseConcurrencyStatistics() };
+                LOG_INFO(std::format("Database concurrency limit: {} (in flight {}), min RTT: {} us, smoothed RTT: {} us, samples: {}, drops: {}",
+                    concurrencyStatistics.limit, concurrencyStatistics.inFlight, concurrencyStatistics.minRtt.count(),
+                    concurrencyStatistics.smoothedRtt.count(), concurrencyStatistics.samples, concurrencyStatistics.drops));
                 last_stats_time = now;
             }
         }
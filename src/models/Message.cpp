@@ -3,6 +3,7 @@
 #include "../utils/Validators.h"
 #include "../utils/UUIDUtils.h"
 #include "../utils/SecurityUtils.h"
+#include <boost/algorithm/string.hpp>
 
 namespace models
 {
@@ -60,6 +61,11 @@ const std::string& Message::getMessageText() const noexcept
 	return text_;
 }
 
+const std::string& Message::getStoredMessageText() const noexcept
+{
+    return storedText_;
+}
+
 bool Message::getIsRead() const noexcept
 {
 	return isRead_;
@@ -70,6 +76,11 @@ const std::string& Message::getCreatedAt() const noexcept
 	return createdAt_;
 }
 
+const std::vector<std::string>& Message::getAttachmentIds() const noexcept
+{
+    return attachmentIds_;
+}
+
 void Message::setMessageId(const std::string& id) noexcept
 {
 	id_ = id;
@@ -97,7 +108,9 @@ void Message::setToLogin(const std::string& login) noexcept
 
 void Message::setMessageText(const std::string& text)
 {
-    if (!utils::Validators::isMessageLengthValid(text)) 
+    // the database counts the characters of the stored text, so the escaping counts towards the limit
+    auto storedText{ utils::Validators::sanitizeString(text, false) };
+    if (!utils::Validators::isMessageLengthValid(storedText)) 
     {
         throw std::invalid_argument{ "Invalid message length" };
     }
@@ -109,6 +122,7 @@ void Message::setMessageText(const std::string& text)
     }
 
     text_ = sanitized;
+    storedText_ = std::move(storedText);
 }
 
 void Message::setIsRead(bool isRead) noexcept
@@ -121,6 +135,11 @@ void Message::setCreatedAt(const std::string& timestamp) noexcept
 	createdAt_ = timestamp;
 }
 
+void Message::setAttachmentIds(const std::vector<std::string>& attachmentIds) noexcept
+{
+    attachmentIds_ = attachmentIds;
+}
+
 nlohmann::json Message::toJson() const noexcept
 {
     nlohmann::json json{};
@@ -138,6 +157,11 @@ nlohmann::json Message::toJson() const noexcept
     json["is_read"] = isRead_;
     json["created_at"] = createdAt_;
 
+    if (!attachmentIds_.empty())
+    {
+        json["attachment_ids"] = attachmentIds_;
+    }
+
     return json;
 }
 
@@ -185,6 +209,11 @@ bool Message::fromJson(const nlohmann::json& json) noexcept
             createdAt_ = json["created_at"].get<std::string>();
         }
 
+        if (json.contains("attachment_ids") && json["attachment_ids"].is_array())
+        {
+            attachmentIds_ = json["attachment_ids"].get<std::vector<std::string>>();
+        }
+
         return isValid();
 
     }
@@ -224,7 +253,7 @@ bool Message::isValid() const noexcept
         }
     }
 
-    if (!utils::Validators::isMessageLengthValid(text_)) 
+    if (!utils::Validators::isMessageLengthValid(storedText_)) 
     {
         LOG_ERROR("Message validation failed: invalid message length");
         return false;
@@ -318,6 +347,7 @@ void Message::fromDatabaseRow(const nlohmann::json& row)
         if (row.contains("message_text") && !row["message_text"].is_null()) 
         {
             text_ = row["message_text"].get<std::string>();
+            storedText_ = text_;
         }
 
         if (row.contains("is_read") && !row["is_read"].is_null()) 
@@ -330,6 +360,13 @@ void Message::fromDatabaseRow(const nlohmann::json& row)
             createdAt_ = row["created_at"].get<std::string>();
         }
 
+        // aggregated by the query as a comma-separated list
+        if (row.contains("attachment_ids") && row["attachment_ids"].is_string())
+        {
+            attachmentIds_.clear();
+            boost::algorithm::split(attachmentIds_, row["attachment_ids"].get<std::string>(), boost::algorithm::is_any_of(","));
+        }
+
         if (!isValid())
         {
             throw std::runtime_error{ "Invalid Message data in database row" };
@@ -104,6 +104,12 @@ public:
      */
     [[nodiscard]] const std::string& getMessageText() const noexcept;
 
+    /**
+     * @brief Gets the message text as the database stores it
+     * @return const std::string& Sanitized text without the quote doubling of a SQL literal, for a bound parameter
+     */
+    [[nodiscard]] const std::string& getStoredMessageText() const noexcept;
+
     /**
      * @brief Gets the read status of the message
      * @return bool True if message has been read, false otherwise
@@ -116,6 +122,12 @@ public:
      */
     [[nodiscard]] const std::string& getCreatedAt() const noexcept;
 
+    /**
+     * @brief Gets the IDs of the attachments of the message
+     * @return const std::vector<std::string>& Attachment IDs (empty if the message has no attachments)
+     */
+    [[nodiscard]] const std::vector<std::string>& getAttachmentIds() const noexcept;
+
     // Setter methods
 
     /**
@@ -167,6 +179,12 @@ public:
      */
     void setCreatedAt(const std::string& timestamp) noexcept;
 
+    /**
+     * @brief Sets the IDs of the attachments of the message
+     * @param attachmentIds Attachment IDs
+     */
+    void setAttachmentIds(const std::vector<std::string>& attachmentIds) noexcept;
+
     // IModel interface implementation
 
     /**
@@ -291,8 +309,10 @@ private:
     std::string fromLogin_;  ///< Sender login name (for display purposes)
     std::string toLogin_;    ///< Recipient login name (for display purposes)
     std::string text_;       ///< Message text content (sanitized)
+    std::string storedText_; ///< Message text content as stored (sanitized, quotes not doubled)
     bool isRead_{ false };   ///< Read status flag
     std::string createdAt_{ getCurrentTimestamp() }; ///< Creation timestamp
+    std::vector<std::string> attachmentIds_; ///< IDs of the attached files
 };
 }
 
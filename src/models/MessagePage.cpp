@@ -0,0 +1,234 @@
+#include "MessagePage.h"
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <boost/uuid/uuid_io.hpp>
+
+namespace models
+{
+constexpr auto UUID_SIZE{ 36 };
+constexpr auto SECONDS_PER_HOUR{ 3600 };
+constexpr auto SECONDS_PER_MINUTE{ 60 };
+constexpr auto MAX_ARENA_SIZE{ std::numeric_limits<uint32_t>::max() };
+
+void MessagePage::reserve(size_t count)
+{
+    records_.reserve(count);
+}
+
+void MessagePage::add(const MessageFields& fields)
+{
+    if (fields.text.size() > MAX_ARENA_SIZE - texts_.size())
+    {
+        throw std::length_error{ "Message page texts exceed the arena size" };
+    }
+
+    Record record{};
+    record.messageId = parseUuid(fields.messageId);
+    record.fromUserId = parseUuid(fields.fromUserId);
+    record.toUserId = parseUuid(fields.toUserId);
+    record.createdAt = fields.createdAt;
+    record.utcOffset = fields.utcOffset;
+    record.isRead = fields.isRead;
+
+    // aggregated by the query as a comma-separated list
+    record.firstAttachment = static_cast<uint32_t>(attachmentIds_.size());
+    try
+    {
+        for (const auto attachmentId : fields.attachmentIds | std::views::split(','))
+        {
+            attachmentIds_.push_back(parseUuid(std::string_view{ attachmentId.begin(), attachmentId.end() }));
+        }
+    }
+    catch (...)
+    {
+        attachmentIds_.resize(record.firstAttachment);
+        throw;
+    }
+
+    record.attachmentCount = static_cast<uint32_t>(attachmentIds_.size()) - record.firstAttachment;
+    record.fromLogin = internLogin(fields.fromLogin);
+    record.toLogin = internLogin(fields.toLogin);
+    record.textOffset = static_cast<uint32_t>(texts_.size());
+    record.textSize = static_cast<uint32_t>(fields.text.size());
+
+    texts_.append(fields.text);
+    records_.push_back(record);
+}
+
+size_t MessagePage::getSize() const noexcept
+{
+    return records_.size();
+}
+
+bool MessagePage::isEmpty() const noexcept
+{
+    return records_.empty();
+}
+
+size_t MessagePage::getLoginCount() const noexcept
+{
+    return logins_.size();
+}
+
+std::string MessagePage::getMessageId(size_t index) const
+{
+    return boost::uuids::to_string(records_[index].messageId);
+}
+
+std::string MessagePage::getFromUserId(size_t index) const
+{
+    return boost::uuids::to_string(records_[index].fromUserId);
+}
+
+std::string MessagePage::getToUserId(size_t index) const
+{
+    return boost::uuids::to_string(records_[index].toUserId);
+}
+
+const std::string& MessagePage::getFromLogin(size_t index) const noexcept
+{
+    return *logins_[records_[index].fromLogin];
+}
+
+const std::string& MessagePage::getToLogin(size_t index) const noexcept
+{
+    return *logins_[records_[index].toLogin];
+}
+
+std::string_view MessagePage::getMessageText(size_t index) const noexcept
+{
+    const auto& record{ records_[index] };
+    return std::string_view{ texts_ }.substr(record.textOffset, record.textSize);
+}
+
+bool MessagePage::getIsRead(size_t index) const noexcept
+{
+    return records_[index].isRead;
+}
+
+int64_t MessagePage::getCreatedAtEpoch(size_t index) const noexcept
+{
+    return records_[index].createdAt;
+}
+
+std::string MessagePage::getCreatedAt(size_t index) const
+{
+    return formatTimestamp(records_[index].createdAt, records_[index].utcOffset);
+}
+
+std::vector<std::string> MessagePage::getAttachmentIds(size_t index) const
+{
+    const auto& record{ records_[index] };
+
+    std::vector<std::string> attachmentIds;
+    attachmentIds.reserve(record.attachmentCount);
+
+    for (auto i{ record.firstAttachment }; i < record.firstAttachment + record.attachmentCount; ++i)
+    {
+        attachmentIds.push_back(boost::uuids::to_string(attachmentIds_[i]));
+    }
+
+    return attachmentIds;
+}
+
+std::string MessagePage::formatTimestamp(int64_t createdAt, int32_t utcOffset)
+{
+    const std::chrono::sys_time<std::chrono::microseconds> local{ std::chrono::microseconds{ createdAt } + std::chrono::seconds{ utcOffset } };
+    const auto day{ std::chrono::floor<std::chrono::days>(local) };
+    const std::chrono::year_month_day date{ day };
+    const std::chrono::hh_mm_ss time{ local - day };
+
+    auto timestamp{ std::format("{:04}-{:02}-{:02} {:02}:{:02}:{:02}", static_cast<int>(date.year()), static_cast<unsigned>(date.month()),
+        static_cast<unsigned>(date.day()), time.hours().count(), time.minutes().count(), time.seconds().count()) };
+
+    // PostgreSQL drops trailing zeros of the fraction, and the fraction itself if it is zero
+    if (const auto microseconds{ time.subseconds().count() }; microseconds != 0)
+    {
+        auto fraction{ std::format("{:06}", microseconds) };
+        fraction.erase(fraction.find_last_not_of('0') + 1);
+        timestamp += '.' + fraction;
+    }
+
+    // minutes and seconds of the offset only when they are not zero
+    const auto offset{ std::abs(utcOffset) };
+    timestamp += std::format("{}{:02}", utcOffset < 0 ? '-' : '+', offset / SECONDS_PER_HOUR);
+
+    if (offset % SECONDS_PER_HOUR != 0)
+    {
+        timestamp += std::format(":{:02}", offset % SECONDS_PER_HOUR / SECONDS_PER_MINUTE);
+    }
+
+    if (offset % SECONDS_PER_MINUTE != 0)
+    {
+        timestamp += std::format(":{:02}", offset % SECONDS_PER_MINUTE);
+    }
+
+    return timestamp;
+}
+
+uint32_t MessagePage::internLogin(std::string_view login)
+{
+    const auto [it, isInserted] { loginIndices_.try_emplace(std::string{ login }, static_cast<uint32_t>(logins_.size())) };
+    if (isInserted)
+    {
+        logins_.push_back(&it->first);
+    }
+
+    return it->second;
+}
+
+boost::uuids::uuid MessagePage::parseUuid(std::string_view text)
+{
+    if (text.size() != UUID_SIZE)
+    {
+        throw std::invalid_argument{ "Invalid UUID: " + std::string{ text } };
+    }
+
+    boost::uuids::uuid uuid{};
+    size_t digits{ 0 };
+
+    for (size_t i{ 0 }; i < text.size(); ++i)
+    {
+        const auto c{ text[i] };
+
+        // dashes of the 8-4-4-4-12 layout
+        if (i == 8 || i == 13 || i == 18 || i == 23)
+        {
+            if (c != '-')
+            {
+                throw std::invalid_argument{ "Invalid UUID: " + std::string{ text } };
+            }
+
+            continue;
+        }
+
+        uint8_t value{ 0 };
+        if (c >= '0' && c <= '9')
+        {
+            value = static_cast<uint8_t>(c - '0');
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            value = static_cast<uint8_t>(c - 'a' + 10);
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            value = static_cast<uint8_t>(c - 'A' + 10);
+        }
+        else
+        {
+            throw std::invalid_argument{ "Invalid UUID: " + std::string{ text } };
+        }
+
+        auto& byte{ *(uuid.begin() + digits / 2) };
+        byte = static_cast<uint8_t>(digits % 2 == 0 ? value << 4 : byte | value);
+        ++digits;
+    }
+
+    return uuid;
+}
+}
@@ -0,0 +1,234 @@
+#ifndef MESSAGE_PAGE_H
+#define MESSAGE_PAGE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <boost/uuid/uuid.hpp>
+
+namespace models
+{
+/**
+ * @struct MessageFields
+ * @brief Fields of one message added to a MessagePage, viewed in place (e.g. in a database row)
+ */
+struct MessageFields final
+{
+    std::string_view messageId;     ///< Message ID
+    std::string_view fromUserId;    ///< Sender user ID
+    std::string_view toUserId;      ///< Recipient user ID
+    std::string_view fromLogin;     ///< Sender login
+    std::string_view toLogin;       ///< Recipient login
+    std::string_view text;          ///< Message text
+    std::string_view attachmentIds; ///< Comma-separated attachment IDs, empty if the message has none
+    int64_t createdAt{ 0 };         ///< Creation time, microseconds since the Unix epoch
+    int32_t utcOffset{ 0 };         ///< UTC offset of the creation time as the database shows it, in seconds
+    bool isRead{ false };           ///< Read status
+};
+
+/**
+ * @class MessagePage
+ * @brief Compact, read-only list of messages for building timelines
+ *
+ * Holds the messages of one response without a std::string per field:
+ * IDs are kept as 16 byte UUIDs, creation times as integers, all texts in
+ * one arena, and logins are interned, so a page of a conversation stores
+ * its two logins once however many messages it has. Fields are converted
+ * back to strings only when the response is built.
+ *
+ * @note Not thread-safe
+ * @see Message
+ */
+class MessagePage final
+{
+public:
+    /**
+     * @brief Constructs an empty page
+     */
+    MessagePage() noexcept = default;
+
+    /**
+     * @brief Default destructor
+     */
+    ~MessagePage() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note MessagePage should not be copied, login views point into the page
+     */
+    MessagePage(const MessagePage&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note MessagePage should not be copied, login views point into the page
+     */
+    MessagePage& operator=(const MessagePage&) = delete;
+
+    /**
+     * @brief Default move constructor
+     */
+    MessagePage(MessagePage&&) noexcept = default;
+
+    /**
+     * @brief Default move assignment operator
+     */
+    MessagePage& operator=(MessagePage&&) noexcept = default;
+
+    /**
+     * @brief Reserves room for messages
+     * @param count Expected number of messages
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Appends a message
+     * @param fields Fields of the message, copied into the page
+     * @throws std::invalid_argument if an ID is not a valid UUID
+     * @throws std::length_error if the texts outgrow the arena
+     */
+    void add(const MessageFields& fields);
+
+    /**
+     * @brief Gets the number of messages
+     * @return size_t Number of messages
+     */
+    [[nodiscard]] size_t getSize() const noexcept;
+
+    /**
+     * @brief Checks if the page has no messages
+     * @return bool True if the page is empty
+     */
+    [[nodiscard]] bool isEmpty() const noexcept;
+
+    /**
+     * @brief Gets the number of distinct logins
+     * @return size_t Number of interned logins
+     */
+    [[nodiscard]] size_t getLoginCount() const noexcept;
+
+    /**
+     * @brief Gets the message ID
+     * @param index Index of the message
+     * @return std::string Message ID
+     */
+    [[nodiscard]] std::string getMessageId(size_t index) const;
+
+    /**
+     * @brief Gets the sender user ID
+     * @param index Index of the message
+     * @return std::string Sender user ID
+     */
+    [[nodiscard]] std::string getFromUserId(size_t index) const;
+
+    /**
+     * @brief Gets the recipient user ID
+     * @param index Index of the message
+     * @return std::string Recipient user ID
+     */
+    [[nodiscard]] std::string getToUserId(size_t index) const;
+
+    /**
+     * @brief Gets the sender login
+     * @param index Index of the message
+     * @return const std::string& Sender login
+     */
+    [[nodiscard]] const std::string& getFromLogin(size_t index) const noexcept;
+
+    /**
+     * @brief Gets the recipient login
+     * @param index Index of the message
+     * @return const std::string& Recipient login
+     */
+    [[nodiscard]] const std::string& getToLogin(size_t index) const noexcept;
+
+    /**
+     * @brief Gets the message text
+     * @param index Index of the message
+     * @return std::string_view Message text, valid while the page lives
+     */
+    [[nodiscard]] std::string_view getMessageText(size_t index) const noexcept;
+
+    /**
+     * @brief Gets the read status
+     * @param index Index of the message
+     * @return bool True if the message has been read
+     */
+    [[nodiscard]] bool getIsRead(size_t index) const noexcept;
+
+    /**
+     * @brief Gets the creation time
+     * @param index Index of the message
+     * @return int64_t Microseconds since the Unix epoch
+     */
+    [[nodiscard]] int64_t getCreatedAtEpoch(size_t index) const noexcept;
+
+    /**
+     * @brief Gets the creation timestamp as the database shows it
+     * @param index Index of the message
+     * @return std::string Timestamp, e.g. "2025-11-27 13:39:35.868799+01"
+     */
+    [[nodiscard]] std::string getCreatedAt(size_t index) const;
+
+    /**
+     * @brief Gets the attachment IDs
+     * @param index Index of the message
+     * @return std::vector<std::string> Attachment IDs, empty if the message has none
+     */
+    [[nodiscard]] std::vector<std::string> getAttachmentIds(size_t index) const;
+
+    /**
+     * @brief Formats a time like PostgreSQL shows a timestamptz in the ISO date style
+     * @param createdAt Microseconds since the Unix epoch
+     * @param utcOffset UTC offset in seconds
+     * @return std::string Timestamp, fractional seconds without trailing zeros, e.g. "2025-01-01 10:00:00.5+05:30"
+     */
+    [[nodiscard]] static std::string formatTimestamp(int64_t createdAt, int32_t utcOffset);
+
+private:
+    /**
+     * @struct Record
+     * @brief Fixed-size part of a message
+     */
+    struct Record final
+    {
+        boost::uuids::uuid messageId{};  ///< Message ID
+        boost::uuids::uuid fromUserId{}; ///< Sender user ID
+        boost::uuids::uuid toUserId{};   ///< Recipient user ID
+        int64_t createdAt{ 0 };          ///< Creation time, microseconds since the Unix epoch
+        int32_t utcOffset{ 0 };          ///< UTC offset in seconds
+        uint32_t fromLogin{ 0 };         ///< Index of the sender login in logins_
+        uint32_t toLogin{ 0 };           ///< Index of the recipient login in logins_
+        uint32_t textOffset{ 0 };        ///< Offset of the text in texts_
+        uint32_t textSize{ 0 };          ///< Size of the text in bytes
+        uint32_t firstAttachment{ 0 };   ///< Index of the first attachment ID in attachmentIds_
+        uint32_t attachmentCount{ 0 };   ///< Number of attachment IDs
+        bool isRead{ false };            ///< Read status
+    };
+
+    /**
+     * @brief Interns a login
+     * @param login Login
+     * @return uint32_t Index of the login in logins_
+     */
+    [[nodiscard]] uint32_t internLogin(std::string_view login);
+
+    /**
+     * @brief Parses a UUID
+     * @param text UUID in the canonical format
+     * @return boost::uuids::uuid Parsed UUID
+     * @throws std::invalid_argument if the text is not a valid UUID
+     */
+    [[nodiscard]] static boost::uuids::uuid parseUuid(std::string_view text);
+
+private:
+    std::vector<Record> records_;                            ///< Messages in order
+    std::string texts_;                                      ///< Arena of all texts
+    std::vector<boost::uuids::uuid> attachmentIds_;          ///< Attachment IDs of all messages
+    std::unordered_map<std::string, uint32_t> loginIndices_; ///< Index of each interned login
+    std::vector<const std::string*> logins_;                 ///< Interned logins, owned by loginIndices_
+};
+}
+
+#endif // MESSAGE_PAGE_H
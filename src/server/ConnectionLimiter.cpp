@@ -0,0 +1,147 @@
+#include "ConnectionLimiter.h"
+#include <algorithm>
+
+namespace server
+{
+ConnectionPermit::ConnectionPermit(std::shared_ptr<ConnectionLimiter> limiter, std::string address) noexcept :
+    limiter_{ std::move(limiter) },
+    address_{ std::move(address) }
+{
+}
+
+ConnectionPermit::~ConnectionPermit() noexcept
+{
+    release();
+}
+
+ConnectionPermit& ConnectionPermit::operator=(ConnectionPermit&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        limiter_ = std::move(other.limiter_);
+        address_ = std::move(other.address_);
+    }
+
+    return *this;
+}
+
+bool ConnectionPermit::isGranted() const noexcept
+{
+    return limiter_ != nullptr;
+}
+
+void ConnectionPermit::release() noexcept
+{
+    if (limiter_)
+    {
+        limiter_->release(address_);
+        limiter_.reset();
+    }
+}
+
+ConnectionLimiter::ConnectionLimiter(const ConnectionLimits& limits) :
+    limits_{ limits },
+    tokens_{ static_cast<double>(std::max(limits.acceptBurst, 1u)) },
+    lastRefill_{ std::chrono::steady_clock::now() }
+{
+}
+
+std::chrono::steady_clock::duration ConnectionLimiter::getAcceptDelay()
+{
+    std::lock_guard lock{ mutex_ };
+
+    if (limits_.maxConnections != 0 && activeConnections_.load() >= limits_.maxConnections)
+    {
+        ++delayedAccepts_;
+        return CAPACITY_RETRY_INTERVAL;
+    }
+
+    if (limits_.acceptRate == 0)
+    {
+        return std::chrono::steady_clock::duration::zero();
+    }
+
+    refillTokens(std::chrono::steady_clock::now());
+    if (tokens_ >= 1.0)
+    {
+        return std::chrono::steady_clock::duration::zero();
+    }
+
+    ++delayedAccepts_;
+
+    // the time until the bucket holds a whole token again
+    return std::chrono::ceil<std::chrono::steady_clock::duration>(std::chrono::duration<double>{ (1.0 - tokens_) / limits_.acceptRate });
+}
+
+ConnectionPermit ConnectionLimiter::tryAcquire(const std::string& address)
+{
+    std::lock_guard lock{ mutex_ };
+
+    if (limits_.maxConnections != 0 && activeConnections_.load() >= limits_.maxConnections)
+    {
+        ++rejectedConnections_;
+        return ConnectionPermit{};
+    }
+
+    const auto isCounted{ limits_.maxConnectionsPerAddress != 0 && !address.empty() };
+    if (isCounted)
+    {
+        auto& count{ connectionsPerAddress_[address] };
+        if (count >= limits_.maxConnectionsPerAddress)
+        {
+            ++rejectedConnections_;
+            return ConnectionPermit{};
+        }
+
+        ++count;
+    }
+
+    if (limits_.acceptRate != 0)
+    {
+        refillTokens(std::chrono::steady_clock::now());
+        tokens_ -= 1.0;
+    }
+
+    const auto active{ ++activeConnections_ };
+    ++acceptedConnections_;
+
+    if (active > peakConnections_.load())
+    {
+        peakConnections_ = active;
+    }
+
+    return ConnectionPermit{ shared_from_this(), isCounted ? address : std::string{} };
+}
+
+ConnectionStatistics ConnectionLimiter::getStatistics() const noexcept
+{
+    return ConnectionStatistics{ activeConnections_.load(), peakConnections_.load(), acceptedConnections_.load(), rejectedConnections_.load(), delayedAccepts_.load() };
+}
+
+void ConnectionLimiter::release(const std::string& address) noexcept
+{
+    std::lock_guard lock{ mutex_ };
+
+    --activeConnections_;
+
+    if (address.empty())
+    {
+        return;
+    }
+
+    // entries of addresses without connections are dropped, so the map only holds open clients
+    if (const auto it{ connectionsPerAddress_.find(address) }; it != connectionsPerAddress_.end() && --it->second == 0)
+    {
+        connectionsPerAddress_.erase(it);
+    }
+}
+
+void ConnectionLimiter::refillTokens(std::chrono::steady_clock::time_point now) noexcept
+{
+    const std::chrono::duration<double> elapsed{ now - lastRefill_ };
+    lastRefill_ = now;
+
+    tokens_ = std::min(tokens_ + elapsed.count() * limits_.acceptRate, static_cast<double>(std::max(limits_.acceptBurst, 1u)));
+}
+}
@@ -0,0 +1,211 @@
+#ifndef CONNECTION_LIMITER_H
+#define CONNECTION_LIMITER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "ConnectionLimits.h"
+
+namespace server
+{
+class ConnectionLimiter;
+
+/**
+ * @struct ConnectionStatistics
+ * @brief Snapshot of the admission counters of a ConnectionLimiter
+ */
+struct ConnectionStatistics final
+{
+    uint64_t activeConnections{ 0 };   ///< Number of open connections
+    uint64_t peakConnections{ 0 };     ///< Highest number of open connections so far
+    uint64_t acceptedConnections{ 0 }; ///< Number of admitted connections
+    uint64_t rejectedConnections{ 0 }; ///< Number of connections closed right after accept because a limit was reached
+    uint64_t delayedAccepts{ 0 };      ///< Number of times accepting was paused by the connection or rate limit
+};
+
+/**
+ * @class ConnectionPermit
+ * @brief Admission of one connection, released when the permit is destroyed
+ *
+ * Travels with the connection from the Listener to the Session, and on to the
+ * Http2Session if the connection switches to HTTP/2.
+ *
+ * @see ConnectionLimiter
+ */
+class ConnectionPermit final
+{
+public:
+    /**
+     * @brief Constructs an empty permit that admits nothing
+     */
+    ConnectionPermit() noexcept = default;
+
+    /**
+     * @brief Constructs a permit for an admitted connection
+     * @param limiter Limiter that admitted the connection
+     * @param address Client address the connection is counted for, empty if not counted per address
+     * @note Use ConnectionLimiter::tryAcquire
+     */
+    ConnectionPermit(std::shared_ptr<ConnectionLimiter> limiter, std::string address) noexcept;
+
+    /**
+     * @brief Destructor that releases the admission
+     */
+    ~ConnectionPermit() noexcept;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note A connection is admitted once
+     */
+    ConnectionPermit(const ConnectionPermit&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note A connection is admitted once
+     */
+    ConnectionPermit& operator=(const ConnectionPermit&) = delete;
+
+    /**
+     * @brief Default move constructor
+     * @note The moved-from permit becomes empty
+     */
+    ConnectionPermit(ConnectionPermit&&) noexcept = default;
+
+    /**
+     * @brief Move assignment operator that releases the current admission first
+     * @param other Permit to take over
+     * @return ConnectionPermit& Reference to this permit
+     */
+    ConnectionPermit& operator=(ConnectionPermit&& other) noexcept;
+
+    /**
+     * @brief Checks if the permit admits a connection
+     * @return bool True if the connection was admitted
+     */
+    [[nodiscard]] bool isGranted() const noexcept;
+
+private:
+    /**
+     * @brief Returns the admission to the limiter and empties the permit
+     */
+    void release() noexcept;
+
+private:
+    std::shared_ptr<ConnectionLimiter> limiter_; ///< Limiter that admitted the connection, null if empty
+    std::string address_;                        ///< Client address the connection is counted for
+};
+
+/**
+ * @class ConnectionLimiter
+ * @brief Admission control for the connections of a listener
+ *
+ * Caps the number of open connections in total and per client address, and
+ * limits the accept rate with a token bucket. When the total cap or the rate
+ * is reached, the listener stops accepting for a while and new clients wait
+ * in the kernel's listen backlog. A client that already holds the maximum
+ * number of connections is turned away, so one address cannot take all of them.
+ *
+ * @note Thread-safe
+ * @warning Must be managed as a shared_ptr, permits keep the limiter alive
+ * @see ConnectionLimits
+ * @see Listener
+ */
+class ConnectionLimiter final : public std::enable_shared_from_this<ConnectionLimiter>
+{
+public:
+    /**
+     * @brief Constructs a limiter
+     * @param limits Admission limits
+     */
+    explicit ConnectionLimiter(const ConnectionLimits& limits);
+
+    /**
+     * @brief Default destructor
+     */
+    ~ConnectionLimiter() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note ConnectionLimiter should not be copied
+     */
+    ConnectionLimiter(const ConnectionLimiter&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note ConnectionLimiter should not be copied
+     */
+    ConnectionLimiter& operator=(const ConnectionLimiter&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note ConnectionLimiter should not be moved
+     */
+    ConnectionLimiter(ConnectionLimiter&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note ConnectionLimiter should not be moved
+     */
+    ConnectionLimiter& operator=(ConnectionLimiter&&) = delete;
+
+    /**
+     * @brief Gets how long to wait before accepting the next connection
+     * @return std::chrono::steady_clock::duration Zero if a connection can be accepted now
+     * @note Counts a delayed accept when the result is not zero
+     */
+    [[nodiscard]] std::chrono::steady_clock::duration getAcceptDelay();
+
+    /**
+     * @brief Admits an accepted connection if the limits allow it
+     * @param address Client address, empty to skip the per-address limit (e.g. for Unix domain sockets)
+     * @return ConnectionPermit Granted permit, or an empty one if the connection must be closed
+     * @note Every admitted connection takes a token, so connections that did not wait for
+     *       getAcceptDelay slow down the following accepts instead of being rejected
+     */
+    [[nodiscard]] ConnectionPermit tryAcquire(const std::string& address);
+
+    /**
+     * @brief Gets the current admission counters
+     * @return ConnectionStatistics Snapshot of the counters
+     */
+    [[nodiscard]] ConnectionStatistics getStatistics() const noexcept;
+
+    static constexpr std::chrono::milliseconds CAPACITY_RETRY_INTERVAL{ 50 }; ///< Pause of accepting while all connections are taken
+
+private:
+    friend class ConnectionPermit;
+
+    /**
+     * @brief Returns the admission of a closed connection
+     * @param address Client address the connection was counted for
+     */
+    void release(const std::string& address) noexcept;
+
+    /**
+     * @brief Adds the tokens earned since the last refill, up to the burst
+     * @param now Current time
+     * @note Requires mutex_ to be held
+     */
+    void refillTokens(std::chrono::steady_clock::time_point now) noexcept;
+
+private:
+    const ConnectionLimits limits_; ///< Admission limits
+
+    std::mutex mutex_;                                            ///< Mutex for the token bucket and connectionsPerAddress_
+    std::unordered_map<std::string, size_t> connectionsPerAddress_; ///< Open connections by client address
+    double tokens_{ 0.0 };                                        ///< Accepts available now, negative if overdrawn
+    std::chrono::steady_clock::time_point lastRefill_;            ///< Time of the last refill of tokens_
+
+    std::atomic<uint64_t> activeConnections_{ 0 };   ///< Number of open connections
+    std::atomic<uint64_t> peakConnections_{ 0 };     ///< Highest number of open connections so far
+    std::atomic<uint64_t> acceptedConnections_{ 0 }; ///< Number of admitted connections
+    std::atomic<uint64_t> rejectedConnections_{ 0 }; ///< Number of rejected connections
+    std::atomic<uint64_t> delayedAccepts_{ 0 };      ///< Number of paused accepts
+};
+}
+
+#endif // CONNECTION_LIMITER_H
@@ -0,0 +1,27 @@
+#ifndef CONNECTION_LIMITS_H
+#define CONNECTION_LIMITS_H
+
+#include <cstddef>
+
+namespace server
+{
+/**
+ * @struct ConnectionLimits
+ * @brief Admission limits of the connections accepted by a listener
+ *
+ * Populated once from the configuration by the Server and enforced by the
+ * ConnectionLimiter of the Listener. A limit of 0 disables that check.
+ *
+ * @see ConnectionLimiter
+ * @see config::ConfigManager
+ */
+struct ConnectionLimits final
+{
+    size_t maxConnections{ 10000 };          ///< Maximum number of open connections; further clients wait in the listen backlog
+    size_t maxConnectionsPerAddress{ 100 };  ///< Maximum number of open connections from one client address; further ones are closed
+    unsigned int acceptRate{ 0 };            ///< Maximum number of accepted connections per second, on average
+    unsigned int acceptBurst{ 100 };         ///< Number of connections that may be accepted at once above the rate
+};
+}
+
+#endif // CONNECTION_LIMITS_H
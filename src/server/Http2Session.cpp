@@ -0,0 +1,853 @@
+#include "Http2Session.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <boost/algorithm/string.hpp>
+#include "RequestProcessor.h"
+#include "../utils/Logger.h"
+
+namespace server
+{
+constexpr std::chrono::seconds TIMEOUT_IDLE{ 30 };
+constexpr std::chrono::seconds TIMEOUT_SHUTDOWN{ 5 };
+
+constexpr int HTTP2_VERSION{ 20 };
+constexpr uint32_t MAX_HEADER_LIST_SIZE{ 16 * 1024 };
+constexpr int32_t CONNECTION_WINDOW_SIZE{ 16 * 1024 * 1024 };
+constexpr size_t MAX_WRITE_SIZE{ 64 * 1024 };
+
+Http2Session::Http2Session(std::unique_ptr<TlsStream> stream, std::shared_ptr<Router> router, std::shared_ptr<const SessionSettings> settings, std::shared_ptr<TimerWheel> timerWheel,
+    boost::asio::any_io_executor handlerExecutor, ConnectionPermit permit) :
+    stream_{ std::move(stream) },
+    router_{ std::move(router) },
+    settings_{ std::move(settings) },
+    timerWheel_{ std::move(timerWheel) },
+    handlerExecutor_{ std::move(handlerExecutor) },
+    executor_{ stream_->get_executor() },
+    permit_{ std::move(permit) },
+    clientIP_{ stream_->getRemoteAddress() },
+    session_{ nullptr, &nghttp2_session_del }
+{
+    nghttp2_session_callbacks* callbacks{ nullptr };
+    if (nghttp2_session_callbacks_new(&callbacks) != 0)
+    {
+        throw std::runtime_error{ "Failed to create HTTP/2 callbacks" };
+    }
+
+    const std::unique_ptr<nghttp2_session_callbacks, decltype(&nghttp2_session_callbacks_del)> callbacksGuard{ callbacks, &nghttp2_session_callbacks_del };
+
+    nghttp2_session_callbacks_set_on_begin_headers_callback(callbacks, &Http2Session::onBeginHeaders);
+    nghttp2_session_callbacks_set_on_header_callback(callbacks, &Http2Session::onHeader);
+    nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks, &Http2Session::onFrameReceived);
+    nghttp2_session_callbacks_set_on_data_chunk_recv_callback(callbacks, &Http2Session::onDataChunkReceived);
+    nghttp2_session_callbacks_set_on_frame_send_callback(callbacks, &Http2Session::onFrameSent);
+    nghttp2_session_callbacks_set_on_stream_close_callback(callbacks, &Http2Session::onStreamClosed);
+
+    nghttp2_session* session{ nullptr };
+    if (nghttp2_session_server_new(&session, callbacks, this) != 0)
+    {
+        throw std::runtime_error{ "Failed to create HTTP/2 session" };
+    }
+
+    session_.reset(session);
+}
+
+Http2Session::~Http2Session() noexcept
+{
+    // nghttp2 does not report streams that are still open when it is destroyed
+    session_.reset();
+
+    for (auto& [streamId, stream] : streams_)
+    {
+        if (!stream.uploadFile.empty())
+        {
+            stream.upload.close();
+
+            std::error_code ec{};
+            std::filesystem::remove(stream.uploadFile, ec);
+        }
+    }
+}
+
+void Http2Session::start()
+{
+    if (isRunning_)
+    {
+        LOG_WARNING("HTTP/2 session is already running");
+        return;
+    }
+
+    isRunning_ = true;
+
+    // the timer does not keep the session alive, the pending read does
+    deadline_ = timerWheel_->createTimer(executor_, [weakSelf = weak_from_this()]()
+    {
+        if (const auto self{ weakSelf.lock() })
+        {
+            self->onDeadline();
+        }
+    });
+
+    const std::array<nghttp2_settings_entry, 3> entries
+    { {
+        { NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, settings_->http2MaxConcurrentStreams },
+        { NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, settings_->http2InitialWindowSize },
+        { NGHTTP2_SETTINGS_MAX_HEADER_LIST_SIZE, MAX_HEADER_LIST_SIZE }
+    } };
+
+    // the connection window only bounds the bytes in flight, bodies are limited per stream
+    if (nghttp2_submit_settings(session_.get(), NGHTTP2_FLAG_NONE, entries.data(), entries.size()) != 0 ||
+        nghttp2_session_set_local_window_size(session_.get(), NGHTTP2_FLAG_NONE, 0, CONNECTION_WINDOW_SIZE) != 0)
+    {
+        LOG_ERROR("Failed to submit HTTP/2 settings for client: " + clientIP_);
+        doClose();
+        return;
+    }
+
+    LOG_DEBUG("HTTP/2 session started for client: " + clientIP_);
+
+    deadline_->expiresAfter(TIMEOUT_IDLE);
+
+    doWrite();
+    doRead();
+}
+
+void Http2Session::stop() noexcept
+{
+    if (!isRunning_)
+    {
+        return;
+    }
+
+    isRunning_ = false;
+
+    cancelRequests();
+    stream_->next_layer().cancel();
+    deadline_->cancel();
+
+    LOG_INFO("HTTP/2 session stopped");
+}
+
+int Http2Session::onBeginHeaders([[maybe_unused]] nghttp2_session* session, const nghttp2_frame* frame, void* userData)
+{
+    if (frame->hd.type != NGHTTP2_HEADERS || frame->headers.cat != NGHTTP2_HCAT_REQUEST)
+    {
+        return 0;
+    }
+
+    auto& stream{ static_cast<Http2Session*>(userData)->streams_[frame->hd.stream_id] };
+    stream.request.version(HTTP2_VERSION);
+
+    return 0;
+}
+
+int Http2Session::onHeader([[maybe_unused]] nghttp2_session* session, const nghttp2_frame* frame, const uint8_t* name, size_t nameLength,
+    const uint8_t* value, size_t valueLength, [[maybe_unused]] uint8_t flags, void* userData)
+{
+    auto* const stream{ static_cast<Http2Session*>(userData)->findStream(frame->hd.stream_id) };
+    if (stream == nullptr)
+    {
+        return 0;
+    }
+
+    // the size of a header list as defined for SETTINGS_MAX_HEADER_LIST_SIZE
+    stream->headerSize += nameLength + valueLength + 32;
+    if (stream->headerSize > MAX_HEADER_LIST_SIZE)
+    {
+        return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+    }
+
+    // nghttp2 has validated the fields: names are lowercase and pseudo-headers come first
+    const boost::beast::string_view fieldName{ reinterpret_cast<const char*>(name), nameLength };
+    const boost::beast::string_view fieldValue{ reinterpret_cast<const char*>(value), valueLength };
+    auto& request{ stream->request };
+
+    if (fieldName == ":method")
+    {
+        request.method_string(fieldValue);
+    }
+    else if (fieldName == ":path")
+    {
+        request.target(fieldValue);
+    }
+    else if (fieldName == ":authority")
+    {
+        request.set(boost::beast::http::field::host, fieldValue);
+    }
+    else if (fieldName == "cookie" && request.count(boost::beast::http::field::cookie) != 0)
+    {
+        // HTTP/2 splits the cookie header into one field per cookie
+        request.set(boost::beast::http::field::cookie, std::string{ request[boost::beast::http::field::cookie] } + "; " + std::string{ fieldValue });
+    }
+    else if (!fieldName.starts_with(':'))
+    {
+        request.insert(fieldName, fieldValue);
+    }
+
+    return 0;
+}
+
+int Http2Session::onFrameReceived([[maybe_unused]] nghttp2_session* session, const nghttp2_frame* frame, void* userData)
+{
+    if (frame->hd.type != NGHTTP2_HEADERS && frame->hd.type != NGHTTP2_DATA)
+    {
+        return 0;
+    }
+
+    auto* const self{ static_cast<Http2Session*>(userData) };
+    auto* const stream{ self->findStream(frame->hd.stream_id) };
+    if (stream == nullptr)
+    {
+        return 0;
+    }
+
+    if (frame->hd.type == NGHTTP2_HEADERS && frame->headers.cat == NGHTTP2_HCAT_REQUEST)
+    {
+        self->onRequestHeader(frame->hd.stream_id, *stream);
+    }
+
+    if ((frame->hd.flags & NGHTTP2_FLAG_END_STREAM) != 0)
+    {
+        self->onRequestComplete(frame->hd.stream_id, *stream);
+    }
+
+    return 0;
+}
+
+int Http2Session::onDataChunkReceived([[maybe_unused]] nghttp2_session* session, [[maybe_unused]] uint8_t flags, int32_t streamId, const uint8_t* data, size_t length, void* userData)
+{
+    auto* const self{ static_cast<Http2Session*>(userData) };
+    auto* const stream{ self->findStream(streamId) };
+    if (stream == nullptr || stream->isResponded)
+    {
+        // the rest of a rejected body is dropped
+        return 0;
+    }
+
+    if (stream->uploadHandler)
+    {
+        stream->uploadSize += length;
+        if (stream->uploadSize > self->settings_->maxAttachmentSize)
+        {
+            self->respondWithError(streamId, *stream, boost::beast::http::status::payload_too_large, "ATTACHMENT_TOO_LARGE",
+                "Attachment exceeds maximum size of " + std::to_string(self->settings_->maxAttachmentSize) + " bytes");
+            return 0;
+        }
+
+        if (!stream->upload.write({ reinterpret_cast<const char*>(data), length }))
+        {
+            LOG_ERROR("Failed to write upload file " + stream->uploadFile.string());
+            self->respondWithError(streamId, *stream, boost::beast::http::status::internal_server_error, "INTERNAL_ERROR", "Internal server error");
+        }
+
+        return 0;
+    }
+
+    auto& body{ stream->request.body() };
+    if (body.size() + length > self->settings_->maxRequestBodySize)
+    {
+        self->respondWithError(streamId, *stream, boost::beast::http::status::payload_too_large, "PAYLOAD_TOO_LARGE",
+            "Request body exceeds maximum size of " + std::to_string(self->settings_->maxRequestBodySize) + " bytes");
+        return 0;
+    }
+
+    body.append(reinterpret_cast<const char*>(data), length);
+    return 0;
+}
+
+int Http2Session::onFrameSent(nghttp2_session* session, const nghttp2_frame* frame, void* userData)
+{
+    if ((frame->hd.type != NGHTTP2_HEADERS && frame->hd.type != NGHTTP2_DATA) || (frame->hd.flags & NGHTTP2_FLAG_END_STREAM) == 0)
+    {
+        return 0;
+    }
+
+    // the response is complete before the request: the client may stop sending (RFC 9113, section 8.1)
+    if (const auto* const stream{ static_cast<Http2Session*>(userData)->findStream(frame->hd.stream_id) }; stream != nullptr && !stream->isRequestComplete)
+    {
+        nghttp2_submit_rst_stream(session, NGHTTP2_FLAG_NONE, frame->hd.stream_id, NGHTTP2_NO_ERROR);
+    }
+
+    return 0;
+}
+
+int Http2Session::onStreamClosed([[maybe_unused]] nghttp2_session* session, int32_t streamId, [[maybe_unused]] uint32_t errorCode, void* userData)
+{
+    auto* const self{ static_cast<Http2Session*>(userData) };
+
+    const auto it{ self->streams_.find(streamId) };
+    if (it == self->streams_.end())
+    {
+        return 0;
+    }
+
+    // a handler still running for a reset stream has no one to answer to
+    self->cancelRequest(it->second.deadline);
+
+    // an upload that was reset before it was complete
+    if (!it->second.uploadFile.empty())
+    {
+        it->second.upload.close();
+
+        std::error_code ec{};
+        std::filesystem::remove(it->second.uploadFile, ec);
+    }
+
+    self->streams_.erase(it);
+    return 0;
+}
+
+ssize_t Http2Session::readResponseBody([[maybe_unused]] nghttp2_session* session, int32_t streamId, uint8_t* buffer, size_t length,
+    uint32_t* dataFlags, nghttp2_data_source* source, void* userData)
+{
+    auto& stream{ *static_cast<Stream*>(source->ptr) };
+
+    // a chunk may query the database, so it is produced off the strand and the stream resumed once it is ready
+    if (stream.bodyOffset == stream.body.size() && stream.responseStream)
+    {
+        if (!stream.isChunkPending)
+        {
+            static_cast<Http2Session*>(userData)->produceChunk(streamId, stream);
+        }
+
+        return NGHTTP2_ERR_DEFERRED;
+    }
+
+    const auto size{ std::min(length, stream.body.size() - stream.bodyOffset) };
+    std::memcpy(buffer, stream.body.data() + stream.bodyOffset, size);
+    stream.bodyOffset += size;
+
+    if (stream.bodyOffset == stream.body.size() && !stream.responseStream)
+    {
+        *dataFlags |= NGHTTP2_DATA_FLAG_EOF;
+    }
+
+    return static_cast<ssize_t>(size);
+}
+
+Http2Session::Stream* Http2Session::findStream(int32_t streamId) noexcept
+{
+    const auto it{ streams_.find(streamId) };
+    return it == streams_.end() ? nullptr : &it->second;
+}
+
+void Http2Session::onRequestHeader(int32_t streamId, Stream& stream)
+{
+    RequestProcessor::logRequest(clientIP_, stream.request);
+
+    if (stream.request.method() != boost::beast::http::verb::post)
+    {
+        return;
+    }
+
+    // the handler decides on the header alone whether the body goes to a file
+    auto handler{ router_->findHandler(stream.request) };
+    if (!handler || !handler->isUploadRequest(stream.request))
+    {
+        return;
+    }
+
+    std::filesystem::path bodyFile{};
+    auto error{ RequestProcessor::checkRateLimit(stream.request, *router_, clientIP_) };
+    if (!error)
+    {
+        error = RequestProcessor::checkLoad(stream.request, *router_, utils::Deadline{ settings_->requestTimeout });
+    }
+
+    if (!error)
+    {
+        error = handler->processUploadHeader(stream.request, bodyFile);
+    }
+
+    if (error)
+    {
+        RequestProcessor::logResponse(clientIP_, *error);
+        submitResponse(streamId, stream, std::move(*error), nullptr);
+        return;
+    }
+
+    if (!stream.upload.open(bodyFile, true))
+    {
+        LOG_ERROR("Failed to open upload file " + bodyFile.string());
+        respondWithError(streamId, stream, boost::beast::http::status::internal_server_error, "INTERNAL_ERROR", "Internal server error");
+        return;
+    }
+
+    stream.uploadHandler = std::move(handler);
+    stream.uploadFile = std::move(bodyFile);
+}
+
+void Http2Session::onRequestComplete(int32_t streamId, Stream& stream)
+{
+    stream.isRequestComplete = true;
+
+    if (stream.isResponded)
+    {
+        return;
+    }
+
+    if (stream.uploadHandler)
+    {
+        if (!stream.upload.close())
+        {
+            LOG_ERROR("Failed to write upload file " + stream.uploadFile.string());
+            respondWithError(streamId, stream, boost::beast::http::status::internal_server_error, "INTERNAL_ERROR", "Internal server error");
+            return;
+        }
+    }
+
+    // the handler owns the upload file from now on, the stream may be reset before it finishes
+    auto request{ std::make_shared<boost::beast::http::request<boost::beast::http::string_body>>(std::move(stream.request)) };
+    auto uploadHandler{ std::move(stream.uploadHandler) };
+    auto uploadFile{ std::exchange(stream.uploadFile, {}) };
+
+    // the time spent in the queue of the handler executor counts against the request timeout
+    stream.deadline = utils::Deadline{ settings_->requestTimeout };
+
+    ++pendingHandlers_;
+
+    boost::asio::post(
+        handlerExecutor_,
+        [self = shared_from_this(), streamId, request, uploadHandler = std::move(uploadHandler), uploadFile = std::move(uploadFile), deadline = stream.deadline]()
+    {
+        std::shared_ptr<handlers::IResponseStream> responseStream{};
+        auto response{ self->processRequest(*request, uploadHandler, uploadFile, deadline, responseStream) };
+
+        boost::asio::post(
+            self->executor_,
+            [self, streamId, response = std::move(response), responseStream = std::move(responseStream)]() mutable
+        {
+            self->onRequestProcessed(streamId, std::move(response), std::move(responseStream));
+        });
+    });
+}
+
+boost::beast::http::response<boost::beast::http::string_body> Http2Session::processRequest(boost::beast::http::request<boost::beast::http::string_body>& request,
+    const std::shared_ptr<handlers::IHandler>& uploadHandler, const std::filesystem::path& uploadFile, const utils::Deadline& deadline,
+    std::shared_ptr<handlers::IResponseStream>& responseStream) const
+{
+    boost::beast::http::response<boost::beast::http::string_body> response{};
+
+    if (uploadHandler)
+    {
+        {
+            const utils::DeadlineScope deadlineScope{ deadline };
+            response = uploadHandler->processUpload(request, uploadFile);
+        }
+
+        // the handler moves the file into the store on success
+        std::error_code ec{};
+        std::filesystem::remove(uploadFile, ec);
+    }
+    else
+    {
+        response = RequestProcessor::process(request, *router_, *settings_, clientIP_, deadline, responseStream);
+    }
+
+    RequestProcessor::logResponse(clientIP_, response);
+
+    // compressing after logging keeps the access log readable
+    if (!responseStream)
+    {
+        RequestProcessor::encodeResponseBody(request, response, *settings_);
+    }
+
+    return response;
+}
+
+void Http2Session::onRequestProcessed(int32_t streamId, boost::beast::http::response<boost::beast::http::string_body> response, std::shared_ptr<handlers::IResponseStream> responseStream)
+{
+    --pendingHandlers_;
+
+    if (!isRunning_)
+    {
+        return;
+    }
+
+    // the client may have reset the stream in the meantime
+    if (auto* const stream{ findStream(streamId) })
+    {
+        submitResponse(streamId, *stream, std::move(response), std::move(responseStream));
+        doWrite();
+    }
+}
+
+void Http2Session::produceChunk(int32_t streamId, Stream& stream)
+{
+    stream.isChunkPending = true;
+    stream.deadline = utils::Deadline{ settings_->requestTimeout };
+
+    ++pendingHandlers_;
+
+    boost::asio::post(
+        handlerExecutor_,
+        [self = shared_from_this(), streamId, responseStream = stream.responseStream, deadline = stream.deadline]()
+    {
+        std::string chunk{};
+        auto isLast{ false };
+        auto isFailed{ false };
+
+        try
+        {
+            const utils::DeadlineScope deadlineScope{ deadline };
+            isLast = !responseStream->readNextChunk(chunk);
+        }
+        catch (const std::exception& e)
+        {
+            LOG_ERROR("Error streaming response: " + std::string{ e.what() });
+            isFailed = true;
+        }
+
+        boost::asio::post(
+            self->executor_,
+            [self, streamId, chunk = std::move(chunk), isLast, isFailed]() mutable
+        {
+            self->onChunkProduced(streamId, std::move(chunk), isLast, isFailed);
+        });
+    });
+}
+
+void Http2Session::onChunkProduced(int32_t streamId, std::string chunk, bool isLast, bool isFailed)
+{
+    --pendingHandlers_;
+
+    if (!isRunning_)
+    {
+        return;
+    }
+
+    // the client may have reset the stream in the meantime
+    auto* const stream{ findStream(streamId) };
+    if (stream == nullptr)
+    {
+        return;
+    }
+
+    stream->isChunkPending = false;
+
+    if (isFailed)
+    {
+        // the header is already sent: resetting the stream lets the client detect the truncation
+        stream->responseStream.reset();
+        nghttp2_submit_rst_stream(session_.get(), NGHTTP2_FLAG_NONE, streamId, NGHTTP2_INTERNAL_ERROR);
+    }
+    else
+    {
+        stream->body = std::move(chunk);
+        stream->bodyOffset = 0;
+
+        if (isLast)
+        {
+            stream->responseStream.reset();
+        }
+
+        nghttp2_session_resume_data(session_.get(), streamId);
+    }
+
+    doWrite();
+}
+
+void Http2Session::respondWithError(int32_t streamId, Stream& stream, boost::beast::http::status status, const std::string& code, const std::string& message)
+{
+    if (!stream.uploadFile.empty())
+    {
+        stream.upload.close();
+
+        std::error_code ec{};
+        std::filesystem::remove(stream.uploadFile, ec);
+
+        stream.uploadFile.clear();
+        stream.uploadHandler.reset();
+    }
+
+    auto response{ RequestProcessor::createErrorResponse(stream.request, status, code, message) };
+    RequestProcessor::logResponse(clientIP_, response);
+
+    submitResponse(streamId, stream, std::move(response), nullptr);
+}
+
+void Http2Session::submitResponse(int32_t streamId, Stream& stream, boost::beast::http::response<boost::beast::http::string_body> response, std::shared_ptr<handlers::IResponseStream> responseStream)
+{
+    stream.isResponded = true;
+    stream.responseStream = std::move(responseStream);
+    stream.body = std::move(response.body());
+    stream.bodyOffset = 0;
+
+    if (stream.responseStream)
+    {
+        // HTTP/2 frames the body itself, so a stream of unknown length needs no chunked coding
+        response.chunked(false);
+        if (const auto contentLength{ stream.responseStream->getContentLength() })
+        {
+            response.content_length(*contentLength);
+        }
+    }
+
+    // names and values must outlive nghttp2_submit_response, which copies them
+    std::vector<std::pair<std::string, std::string>> fields{};
+    fields.emplace_back(":status", std::to_string(response.result_int()));
+
+    for (const auto& field : response)
+    {
+        switch (field.name())
+        {
+        case boost::beast::http::field::connection:
+        case boost::beast::http::field::keep_alive:
+        case boost::beast::http::field::proxy_connection:
+        case boost::beast::http::field::transfer_encoding:
+        case boost::beast::http::field::upgrade:
+            // connection-specific fields are not allowed in HTTP/2
+            break;
+
+        default:
+            fields.emplace_back(boost::algorithm::to_lower_copy(std::string{ field.name_string() }), std::string{ field.value() });
+            break;
+        }
+    }
+
+    std::vector<nghttp2_nv> headers{};
+    headers.reserve(fields.size());
+
+    for (auto& [name, value] : fields)
+    {
+        headers.push_back({ reinterpret_cast<uint8_t*>(name.data()), reinterpret_cast<uint8_t*>(value.data()), name.size(), value.size(), NGHTTP2_NV_FLAG_NONE });
+    }
+
+    nghttp2_data_provider body{};
+    body.source.ptr = &stream;
+    body.read_callback = &Http2Session::readResponseBody;
+
+    const auto hasBody{ stream.responseStream || !stream.body.empty() };
+
+    if (const auto result{ nghttp2_submit_response(session_.get(), streamId, headers.data(), headers.size(), hasBody ? &body : nullptr) }; result != 0)
+    {
+        LOG_ERROR("Failed to submit HTTP/2 response: " + std::string{ nghttp2_strerror(result) });
+        nghttp2_submit_rst_stream(session_.get(), NGHTTP2_FLAG_NONE, streamId, NGHTTP2_INTERNAL_ERROR);
+    }
+}
+
+void Http2Session::cancelRequests() noexcept
+{
+    for (auto& [_, stream] : streams_)
+    {
+        cancelRequest(stream.deadline);
+    }
+}
+
+void Http2Session::cancelRequest(const utils::Deadline& deadline) const noexcept
+{
+    if (deadline.isCancelled())
+    {
+        return;
+    }
+
+    try
+    {
+        // the cancel handlers may block, e.g. for the round trip of a database query cancel, so they never run on the strand
+        boost::asio::post(handlerExecutor_, [deadline = utils::Deadline{ deadline }]() mutable
+        {
+            deadline.cancel();
+        });
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to cancel request: " + std::string{ e.what() });
+    }
+}
+
+void Http2Session::doRead()
+{
+    stream_->async_read_some(
+        boost::asio::buffer(readBuffer_),
+        boost::beast::bind_front_handler(
+            &Http2Session::onRead,
+            shared_from_this()));
+}
+
+void Http2Session::onRead(const boost::beast::error_code& ec, std::size_t bytesTransferred)
+{
+    if (!isRunning_)
+    {
+        return;
+    }
+
+    if (ec)
+    {
+        if (ec != boost::asio::error::eof && ec != boost::asio::error::operation_aborted && ec != boost::asio::ssl::error::stream_truncated)
+        {
+            LOG_ERROR("HTTP/2 read error: " + ec.message());
+        }
+
+        doClose();
+        return;
+    }
+
+    if (!isClosing_)
+    {
+        deadline_->expiresAfter(TIMEOUT_IDLE);
+    }
+
+    if (const auto result{ nghttp2_session_mem_recv(session_.get(), readBuffer_.data(), bytesTransferred) }; result < 0)
+    {
+        // nghttp2 has queued GOAWAY and stops reading, the connection closes once it is sent
+        LOG_ERROR("HTTP/2 protocol error from client " + clientIP_ + ": " + std::string{ nghttp2_strerror(static_cast<int>(result)) });
+    }
+
+    doWrite();
+
+    if (isRunning_ && nghttp2_session_want_read(session_.get()) != 0)
+    {
+        doRead();
+    }
+}
+
+void Http2Session::doWrite()
+{
+    if (isWriting_ || !isRunning_)
+    {
+        return;
+    }
+
+    // frames are collected up to a limit so that a large body is written in several steps
+    writeBuffer_.clear();
+    while (writeBuffer_.size() < MAX_WRITE_SIZE)
+    {
+        const uint8_t* data{ nullptr };
+        const auto size{ nghttp2_session_mem_send(session_.get(), &data) };
+        if (size < 0)
+        {
+            LOG_ERROR("HTTP/2 send error: " + std::string{ nghttp2_strerror(static_cast<int>(size)) });
+            doClose();
+            return;
+        }
+
+        if (size == 0)
+        {
+            break;
+        }
+
+        writeBuffer_.append(reinterpret_cast<const char*>(data), static_cast<size_t>(size));
+    }
+
+    if (writeBuffer_.empty())
+    {
+        if (nghttp2_session_want_read(session_.get()) == 0 && nghttp2_session_want_write(session_.get()) == 0)
+        {
+            doClose();
+        }
+
+        return;
+    }
+
+    isWriting_ = true;
+
+    boost::asio::async_write(
+        *stream_,
+        boost::asio::buffer(writeBuffer_),
+        boost::beast::bind_front_handler(
+            &Http2Session::onWrite,
+            shared_from_this()));
+}
+
+void Http2Session::onWrite(const boost::beast::error_code& ec, std::size_t)
+{
+    isWriting_ = false;
+
+    if (!isRunning_)
+    {
+        return;
+    }
+
+    if (ec)
+    {
+        if (ec != boost::asio::error::operation_aborted)
+        {
+            LOG_ERROR("HTTP/2 write error: " + ec.message());
+        }
+
+        doClose();
+        return;
+    }
+
+    if (!isClosing_)
+    {
+        deadline_->expiresAfter(TIMEOUT_IDLE);
+    }
+
+    doWrite();
+}
+
+void Http2Session::onDeadline()
+{
+    if (!isRunning_)
+    {
+        // the TLS shutdown did not finish in time
+        stream_->next_layer().close();
+        return;
+    }
+
+    if (isClosing_)
+    {
+        LOG_DEBUG("HTTP/2 session did not close in time for client: " + clientIP_);
+        isRunning_ = false;
+        stream_->next_layer().close();
+        return;
+    }
+
+    if (pendingHandlers_ != 0)
+    {
+        // requests are still being handled, so the connection is not idle
+        deadline_->expiresAfter(TIMEOUT_IDLE);
+        return;
+    }
+
+    LOG_DEBUG("HTTP/2 session timeout for client: " + clientIP_);
+
+    isClosing_ = true;
+    deadline_->expiresAfter(TIMEOUT_SHUTDOWN);
+
+    nghttp2_session_terminate_session(session_.get(), NGHTTP2_NO_ERROR);
+    doWrite();
+}
+
+void Http2Session::doClose()
+{
+    if (!isRunning_)
+    {
+        return;
+    }
+
+    isRunning_ = false;
+    cancelRequests();
+
+    if (isWriting_)
+    {
+        // close_notify cannot be sent while a write is in progress
+        stream_->next_layer().close();
+        deadline_->cancel();
+
+        LOG_DEBUG("HTTP/2 session closed for client: " + clientIP_);
+        return;
+    }
+
+    deadline_->expiresAfter(TIMEOUT_SHUTDOWN);
+
+    auto self{ shared_from_this() };
+
+    stream_->async_shutdown(
+        [self](const boost::beast::error_code& ec)
+    {
+        if (ec && ec != boost::asio::error::eof && ec != boost::asio::ssl::error::stream_truncated)
+        {
+            LOG_ERROR("SSL shutdown error: " + ec.message());
+        }
+
+        self->stream_->next_layer().close();
+        self->deadline_->cancel();
+
+        LOG_DEBUG("HTTP/2 session closed for client: " + self->clientIP_);
+    });
+}
+}
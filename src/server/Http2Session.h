@@ -0,0 +1,319 @@
+#ifndef HTTP2_SESSION_H
+#define HTTP2_SESSION_H
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <boost/asio.hpp>
+#include <boost/beast/http.hpp>
+#include <nghttp2/nghttp2.h>
+#include "../handlers/IResponseStream.h"
+#include "../utils/Deadline.h"
+#include "../utils/FileWriter.h"
+#include "ConnectionLimiter.h"
+#include "Router.h"
+#include "SessionSettings.h"
+#include "TimerWheel.h"
+#include "TlsStream.h"
+
+namespace server
+{
+/**
+ * @class Http2Session
+ * @brief Serves an HTTP/2 connection negotiated via ALPN on the TLS listener
+ *
+ * Framing, HPACK header compression and stream and connection flow control are done
+ * by nghttp2; the session moves bytes between nghttp2 and the TLS stream. Every request
+ * stream is dispatched through the Router on the handler executor as soon as it is complete,
+ * so the requests of one connection are handled concurrently and their responses are sent
+ * interleaved. Requests go through the same RequestProcessor steps as over HTTP/1.1,
+ * upload bodies are written to the file provided by the handler, and streaming responses
+ * are pulled chunk by chunk only as fast as the client's flow control window allows; each
+ * chunk is produced on the handler executor while nghttp2 holds the stream back.
+ *
+ * @note Each Http2Session instance is owned by a shared_ptr and manages its own lifetime.
+ *       nghttp2 and the TLS stream are only used on the executor of the stream; handlers
+ *       run on the handler executor and must be thread-safe, as they already are across sessions
+ * @see Session
+ * @see RequestProcessor
+ */
+class Http2Session final : public std::enable_shared_from_this<Http2Session>
+{
+public:
+    static constexpr std::string_view ALPN_PROTOCOL{ "h2" }; ///< ALPN identifier of HTTP/2 over TLS
+
+    /**
+     * @brief Constructs an HTTP/2 session on a TLS stream whose handshake selected h2
+     * @param stream TLS stream after the handshake
+     * @param router Shared pointer to request router for HTTP handling
+     * @param settings Shared pointer to HTTP settings (compression, body limits, HTTP/2 limits)
+     * @param timerWheel Timer wheel of the I/O context, drives the idle and shutdown timeouts
+     * @param handlerExecutor Executor that runs request handlers
+     * @param permit Admission of the connection by the listener, released when the connection closes
+     * @throws std::runtime_error if the nghttp2 session cannot be created
+     */
+    Http2Session(std::unique_ptr<TlsStream> stream, std::shared_ptr<Router> router, std::shared_ptr<const SessionSettings> settings, std::shared_ptr<TimerWheel> timerWheel,
+        boost::asio::any_io_executor handlerExecutor, ConnectionPermit permit);
+
+    /**
+     * @brief Destructor that removes the files of unfinished uploads
+     */
+    ~Http2Session() noexcept;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note Http2Session is registered with nghttp2 by address
+     */
+    Http2Session(const Http2Session&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note Http2Session is registered with nghttp2 by address
+     */
+    Http2Session& operator=(const Http2Session&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note Http2Session is registered with nghttp2 by address
+     */
+    Http2Session(Http2Session&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note Http2Session is registered with nghttp2 by address
+     */
+    Http2Session& operator=(Http2Session&&) = delete;
+
+    /**
+     * @brief Sends the server SETTINGS and starts reading frames
+     */
+    void start();
+
+    /**
+     * @brief Stops the session and cleans up resources
+     * @note Safe to call multiple times
+     */
+    void stop() noexcept;
+
+private:
+    /**
+     * @struct Stream
+     * @brief State of one request stream
+     */
+    struct Stream final
+    {
+        boost::beast::http::request<boost::beast::http::string_body> request; ///< Request, its body is filled as DATA frames arrive
+        size_t headerSize{ 0 };                                    ///< Size of the received header list as counted by HTTP/2
+        std::shared_ptr<handlers::IHandler> uploadHandler;         ///< Handler of an upload, whose body is written to uploadFile
+        std::filesystem::path uploadFile;                          ///< File of the upload body
+        utils::FileWriter upload;                                  ///< Writer of uploadFile
+        size_t uploadSize{ 0 };                                    ///< Number of upload body bytes received
+        bool isRequestComplete{ false };                           ///< Whether the client has ended its side of the stream
+        bool isResponded{ false };                                 ///< Whether a response has been submitted
+        std::shared_ptr<handlers::IResponseStream> responseStream; ///< Body source of a streaming response
+        std::string body;                                          ///< Response body, or the current chunk of a streaming response
+        size_t bodyOffset{ 0 };                                    ///< Number of bytes of body already passed to nghttp2
+        bool isChunkPending{ false };                              ///< Whether the next chunk is being produced on the handler executor
+        utils::Deadline deadline;                                  ///< Time budget of the handler, cancelled when the stream closes
+    };
+
+    /**
+     * @brief nghttp2 callback for the start of a HEADERS frame; creates the stream of a new request
+     * @return int 0 on success, or an nghttp2 error code
+     */
+    static int onBeginHeaders(nghttp2_session* session, const nghttp2_frame* frame, void* userData);
+
+    /**
+     * @brief nghttp2 callback for a decoded header field; adds it to the request
+     * @return int 0 on success, NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE to reset a stream with too large a header list
+     */
+    static int onHeader(nghttp2_session* session, const nghttp2_frame* frame, const uint8_t* name, size_t nameLength,
+        const uint8_t* value, size_t valueLength, uint8_t flags, void* userData);
+
+    /**
+     * @brief nghttp2 callback for a received frame; completes request headers and requests
+     * @return int 0 on success, or an nghttp2 error code
+     */
+    static int onFrameReceived(nghttp2_session* session, const nghttp2_frame* frame, void* userData);
+
+    /**
+     * @brief nghttp2 callback for a part of a request body; appends it to the body or the upload file
+     * @return int 0 on success, or an nghttp2 error code
+     */
+    static int onDataChunkReceived(nghttp2_session* session, uint8_t flags, int32_t streamId, const uint8_t* data, size_t length, void* userData);
+
+    /**
+     * @brief nghttp2 callback for a sent frame; stops the client sending a request that already has its response
+     * @return int 0 on success, or an nghttp2 error code
+     */
+    static int onFrameSent(nghttp2_session* session, const nghttp2_frame* frame, void* userData);
+
+    /**
+     * @brief nghttp2 callback for a closed stream; releases its state
+     * @return int 0 on success, or an nghttp2 error code
+     */
+    static int onStreamClosed(nghttp2_session* session, int32_t streamId, uint32_t errorCode, void* userData);
+
+    /**
+     * @brief nghttp2 data source callback that copies the next part of a response body
+     * @return ssize_t Number of bytes copied, or NGHTTP2_ERR_DEFERRED while the next chunk of a streaming response is produced
+     * @note The next chunk is requested only when the flow control window has room
+     */
+    static ssize_t readResponseBody(nghttp2_session* session, int32_t streamId, uint8_t* buffer, size_t length,
+        uint32_t* dataFlags, nghttp2_data_source* source, void* userData);
+
+    /**
+     * @brief Finds the state of a stream
+     * @param streamId Stream identifier
+     * @return Stream* Stream state, or nullptr if the stream is unknown or closed
+     */
+    [[nodiscard]] Stream* findStream(int32_t streamId) noexcept;
+
+    /**
+     * @brief Handles a complete request header: logs the request and accepts or rejects uploads
+     * @param streamId Stream identifier
+     * @param stream Stream state
+     */
+    void onRequestHeader(int32_t streamId, Stream& stream);
+
+    /**
+     * @brief Handles a complete request by dispatching it to the handler executor
+     * @param streamId Stream identifier
+     * @param stream Stream state
+     */
+    void onRequestComplete(int32_t streamId, Stream& stream);
+
+    /**
+     * @brief Runs the handler of a request; called on the handler executor
+     * @param request Complete request
+     * @param uploadHandler Handler of an upload, or nullptr for in-memory bodies
+     * @param uploadFile File with the upload body, removed afterwards
+     * @param deadline Time budget of the request, cancelled if the stream closes first
+     * @param[out] responseStream Body source if the handler streams the response
+     * @return boost::beast::http::response<boost::beast::http::string_body> Response, compressed unless streamed
+     */
+    [[nodiscard]] boost::beast::http::response<boost::beast::http::string_body> processRequest(boost::beast::http::request<boost::beast::http::string_body>& request,
+        const std::shared_ptr<handlers::IHandler>& uploadHandler, const std::filesystem::path& uploadFile, const utils::Deadline& deadline,
+        std::shared_ptr<handlers::IResponseStream>& responseStream) const;
+
+    /**
+     * @brief Submits the response of a processed request; called on the executor of the stream
+     * @param streamId Stream identifier
+     * @param response Response
+     * @param responseStream Body source of a streaming response, or nullptr
+     */
+    void onRequestProcessed(int32_t streamId, boost::beast::http::response<boost::beast::http::string_body> response, std::shared_ptr<handlers::IResponseStream> responseStream);
+
+    /**
+     * @brief Produces the next chunk of a streaming response on the handler executor
+     * @param streamId Stream identifier
+     * @param stream Stream state
+     * @note The chunk gets its own time budget, cancelled if the stream closes first
+     */
+    void produceChunk(int32_t streamId, Stream& stream);
+
+    /**
+     * @brief Hands a produced chunk to the stream and resumes it; called on the executor of the stream
+     * @param streamId Stream identifier
+     * @param chunk Next part of the body, empty at its end
+     * @param isLast Whether the body is complete
+     * @param isFailed Whether the chunk could not be produced; the stream is reset
+     */
+    void onChunkProduced(int32_t streamId, std::string chunk, bool isLast, bool isFailed);
+
+    /**
+     * @brief Logs an error response and submits it before the request is dispatched
+     * @param streamId Stream identifier
+     * @param stream Stream state
+     * @param status HTTP status code
+     * @param code Machine-readable error code
+     * @param message Human-readable error message
+     */
+    void respondWithError(int32_t streamId, Stream& stream, boost::beast::http::status status, const std::string& code, const std::string& message);
+
+    /**
+     * @brief Passes the header and body of a response to nghttp2
+     * @param streamId Stream identifier
+     * @param stream Stream state
+     * @param response Response; connection-specific header fields are not sent
+     * @param responseStream Body source of a streaming response, or nullptr
+     */
+    void submitResponse(int32_t streamId, Stream& stream, boost::beast::http::response<boost::beast::http::string_body> response, std::shared_ptr<handlers::IResponseStream> responseStream);
+
+    /**
+     * @brief Cancels the requests of all streams, so their running database queries are cancelled
+     */
+    void cancelRequests() noexcept;
+
+    /**
+     * @brief Cancels the request of a stream on the handler executor
+     * @param deadline Time budget of the request
+     * @note The cancel handlers run off the strand, because they may block
+     */
+    void cancelRequest(const utils::Deadline& deadline) const noexcept;
+
+    /**
+     * @brief Reads the next bytes from the client
+     */
+    void doRead();
+
+    /**
+     * @brief Callback handler for completed read operation; passes the bytes to nghttp2
+     * @param ec Error code from read operation
+     * @param bytesTransferred Number of bytes read
+     */
+    void onRead(const boost::beast::error_code& ec, std::size_t bytesTransferred);
+
+    /**
+     * @brief Writes the frames nghttp2 has queued, unless a write is in progress
+     * @note Closes the connection once nghttp2 neither wants to read nor to write
+     */
+    void doWrite();
+
+    /**
+     * @brief Callback handler for completed write operation
+     * @param ec Error code from write operation
+     * @param bytesTransferred Number of bytes written
+     */
+    void onWrite(const boost::beast::error_code& ec, std::size_t bytesTransferred);
+
+    /**
+     * @brief Handler of an expired deadline; ends an idle connection with GOAWAY
+     * @note Connections with requests being handled are not idle;
+     *       a connection that does not finish closing in time is closed abruptly
+     */
+    void onDeadline();
+
+    /**
+     * @brief Gracefully closes the SSL connection and TCP socket
+     */
+    void doClose();
+
+private:
+    std::unique_ptr<TlsStream> stream_;                       ///< TLS stream over TCP
+    std::shared_ptr<Router> router_;                          ///< HTTP request router
+    std::shared_ptr<const SessionSettings> settings_;         ///< HTTP settings (compression, body limits, HTTP/2 limits)
+    std::shared_ptr<TimerWheel> timerWheel_;                  ///< Timer wheel of the I/O context
+    boost::asio::any_io_executor handlerExecutor_;            ///< Executor that runs request handlers
+    boost::asio::any_io_executor executor_;                   ///< Executor of the stream, all nghttp2 calls run on it
+    std::shared_ptr<WheelTimer> deadline_;                    ///< Timer for idle and shutdown timeouts, created on start
+    ConnectionPermit permit_;                                 ///< Admission of the connection
+    const std::string clientIP_;                              ///< Client IP address for logging
+
+    std::unordered_map<int32_t, Stream> streams_;             ///< Open request streams by identifier
+    std::unique_ptr<nghttp2_session, decltype(&nghttp2_session_del)> session_; ///< nghttp2 server session, destroyed before the streams
+
+    std::array<uint8_t, 16384> readBuffer_{};                 ///< Buffer for incoming frames
+    std::string writeBuffer_;                                 ///< Frames being written
+    bool isWriting_{ false };                                 ///< Whether a write is in progress
+    size_t pendingHandlers_{ 0 };                             ///< Number of requests and chunks being handled on the handler executor
+    bool isClosing_{ false };                                 ///< Whether GOAWAY has been queued because the connection is idle
+    bool isRunning_{ false };                                 ///< Session running state flag
+};
+}
+
+#endif // HTTP2_SESSION_H
@@ -4,13 +4,31 @@
 
 namespace server
 {
-Listener::Listener(std::shared_ptr<boost::asio::io_context> ioc, std::shared_ptr<boost::asio::ssl::context> sslContext, std::unique_ptr<boost::asio::ip::tcp::endpoint> endpoint, std::shared_ptr<Router> router) :
+Listener::Listener(std::shared_ptr<boost::asio::io_context> ioc, std::shared_ptr<boost::asio::ssl::context> sslContext, std::unique_ptr<boost::asio::ip::tcp::endpoint> endpoint, std::shared_ptr<Router> router, std::shared_ptr<const SessionSettings> sessionSettings,
+    std::filesystem::path unixSocketPath, std::filesystem::perms unixSocketPermissions, const ConnectionLimits& connectionLimits, boost::asio::any_io_executor handlerExecutor) :
     ioc_{ std::move(ioc) },
     sslContext_{ std::move(sslContext) },
 	endpoint_{ std::move(endpoint) },
     router_{ std::move(router) },
-    acceptor_{ boost::asio::make_strand(*ioc_) }
+    sessionSettings_{ std::move(sessionSettings) },
+    timerWheel_{ std::make_shared<TimerWheel>(ioc_->get_executor()) },
+    handlerExecutor_{ handlerExecutor ? std::move(handlerExecutor) : ioc_->get_executor() },
+    acceptor_{ boost::asio::make_strand(*ioc_) },
+    acceptDelay_{ acceptor_.get_executor() },
+    connectionLimiter_{ std::make_shared<ConnectionLimiter>(connectionLimits) },
+    unixSocketPath_{ std::move(unixSocketPath) },
+    unixSocketPermissions_{ unixSocketPermissions }
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    , unixAcceptor_{ boost::asio::make_strand(*ioc_) }
+    , unixAcceptDelay_{ unixAcceptor_.get_executor() }
+#endif
 {
+#ifndef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    if (!unixSocketPath_.empty())
+    {
+        throw std::runtime_error{ "Unix domain sockets are not supported on this platform" };
+    }
+#endif
 }
 
 Listener::~Listener() noexcept
@@ -58,10 +76,24 @@ void Listener::start()
 
     LOG_INFO("Listener created on " + endpoint_->address().to_string() + ":" + std::to_string(endpoint_->port()));
 
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    if (!unixSocketPath_.empty())
+    {
+        startUnixSocket();
+    }
+#endif
+
     isRunning_ = true;
     LOG_INFO("Starting listener...");
 
     doAccept();
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    if (unixAcceptor_.is_open())
+    {
+        doAcceptUnix();
+    }
+#endif
 }
 
 void Listener::stop() noexcept
@@ -75,6 +107,24 @@ void Listener::stop() noexcept
 
     boost::beast::error_code ec{};
     acceptor_.close(ec);
+    acceptDelay_.cancel();
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    unixAcceptDelay_.cancel();
+    if (unixAcceptor_.is_open())
+    {
+        boost::beast::error_code unixEc{};
+        unixAcceptor_.close(unixEc);
+        if (unixEc)
+        {
+            LOG_ERROR("Error closing Unix socket: " + unixEc.message());
+        }
+
+        std::error_code removeEc{};
+        std::filesystem::remove(unixSocketPath_, removeEc);
+    }
+#endif
+
     if (ec) 
     {
         LOG_ERROR("Error stopping listener: " + ec.message());
@@ -85,16 +135,154 @@ void Listener::stop() noexcept
     }
 }
 
+ConnectionStatistics Listener::getConnectionStatistics() const noexcept
+{
+    return connectionLimiter_->getStatistics();
+}
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+void Listener::startUnixSocket()
+{
+    // a socket file left by a previous run would make bind fail; any other file is not ours to remove
+    std::error_code fsEc{};
+    if (const auto status{ std::filesystem::symlink_status(unixSocketPath_, fsEc) }; std::filesystem::exists(status))
+    {
+        if (!std::filesystem::is_socket(status))
+        {
+            LOG_ERROR("Unix socket path is taken by another file: " + unixSocketPath_.string());
+            throw std::runtime_error{ "Unix socket path is taken by another file: " + unixSocketPath_.string() };
+        }
+
+        std::filesystem::remove(unixSocketPath_, fsEc);
+    }
+
+    boost::beast::error_code ec{};
+    const boost::asio::local::stream_protocol::endpoint endpoint{ unixSocketPath_.string() };
+
+    unixAcceptor_.open(endpoint.protocol(), ec);
+    if (!ec)
+    {
+        unixAcceptor_.bind(endpoint, ec);
+    }
+
+    if (!ec)
+    {
+        unixAcceptor_.listen(boost::asio::socket_base::max_listen_connections, ec);
+    }
+
+    if (ec)
+    {
+        LOG_ERROR("Failed to listen on Unix socket " + unixSocketPath_.string() + ": " + ec.message());
+        throw std::runtime_error{ ec.message() };
+    }
+
+    std::filesystem::permissions(unixSocketPath_, unixSocketPermissions_, fsEc);
+    if (fsEc)
+    {
+        LOG_ERROR("Failed to set Unix socket permissions: " + fsEc.message());
+        throw std::runtime_error{ fsEc.message() };
+    }
+
+    LOG_INFO("Listener created on Unix socket " + unixSocketPath_.string());
+}
+
+void Listener::doAcceptUnix()
+{
+    if (!isRunning_)
+    {
+        return;
+    }
+
+    // local clients are paused by the same connection cap and accept rate as TCP clients
+    if (const auto delay{ connectionLimiter_->getAcceptDelay() }; delay > std::chrono::steady_clock::duration::zero())
+    {
+        unixAcceptDelay_.expires_after(delay);
+        unixAcceptDelay_.async_wait(
+            boost::beast::bind_front_handler(
+                &Listener::onAcceptUnixDelay,
+                shared_from_this()));
+        return;
+    }
+
+    unixAcceptor_.async_accept(
+        boost::asio::make_strand(*ioc_),
+        boost::beast::bind_front_handler(
+            &Listener::onAcceptUnix,
+            shared_from_this()));
+}
+
+void Listener::onAcceptUnixDelay(const boost::beast::error_code& ec)
+{
+    if (ec)
+    {
+        return;
+    }
+
+    doAcceptUnix();
+}
+
+void Listener::onAcceptUnix(const boost::beast::error_code& ec, boost::asio::local::stream_protocol::socket socket)
+{
+    if (ec)
+    {
+        if (ec != boost::asio::error::operation_aborted)
+        {
+            LOG_ERROR("Unix socket accept error: " + ec.message());
+        }
+
+        return;
+    }
+
+    LOG_DEBUG("New connection accepted on Unix socket");
+
+    // local clients share the connection cap, the per-address limit does not apply to them
+    if (auto permit{ connectionLimiter_->tryAcquire({}) }; permit.isGranted())
+    {
+        // local traffic never goes through TLS
+        startSession(std::move(socket), nullptr, std::move(permit));
+    }
+    else
+    {
+        LOG_DEBUG("Connection on Unix socket rejected: connection limit reached");
+    }
+
+    doAcceptUnix();
+}
+#endif
+
 void Listener::doAccept()
 {
-    if (isRunning_)
+    if (!isRunning_)
+    {
+        return;
+    }
+
+    // clients wait in the listen backlog while accepting is paused
+    if (const auto delay{ connectionLimiter_->getAcceptDelay() }; delay > std::chrono::steady_clock::duration::zero())
     {
-        acceptor_.async_accept(
-            boost::asio::make_strand(*ioc_),
+        acceptDelay_.expires_after(delay);
+        acceptDelay_.async_wait(
             boost::beast::bind_front_handler(
-                &Listener::onAccept,
+                &Listener::onAcceptDelay,
                 shared_from_this()));
+        return;
+    }
+
+    acceptor_.async_accept(
+        boost::asio::make_strand(*ioc_),
+        boost::beast::bind_front_handler(
+            &Listener::onAccept,
+            shared_from_this()));
+}
+
+void Listener::onAcceptDelay(const boost::beast::error_code& ec)
+{
+    if (ec)
+    {
+        return;
     }
+
+    doAccept();
 }
 
 void Listener::onAccept(const boost::beast::error_code& ec, boost::asio::ip::tcp::socket socket)
@@ -109,16 +297,19 @@ void Listener::onAccept(const boost::beast::error_code& ec, boost::asio::ip::tcp
         return;
     }
 
-    try 
-    {
-        LOG_DEBUG("New connection accepted from: " + socket.remote_endpoint().address().to_string());
+    boost::beast::error_code endpointEc{};
+    const auto endpoint{ socket.remote_endpoint(endpointEc) };
+    const auto address{ endpointEc ? std::string{} : endpoint.address().to_string() };
 
-        auto session{ std::make_shared<Session>(std::move(socket), *sslContext_, router_) };
-        session->start();
+    if (auto permit{ connectionLimiter_->tryAcquire(address) }; permit.isGranted())
+    {
+        LOG_DEBUG("New connection accepted from: " + address);
+        startSession(std::move(socket), sslContext_.get(), std::move(permit));
     }
-    catch (const std::exception& e) 
+    else
     {
-        LOG_ERROR("Failed to create session: " + std::string{ e.what() });
+        // nothing can be answered before the handshake, so the connection is closed right away
+        LOG_DEBUG("Connection rejected from: " + address + ", connection limit reached");
     }
 
     // accepting the next connection
@@ -127,4 +318,18 @@ void Listener::onAccept(const boost::beast::error_code& ec, boost::asio::ip::tcp
         doAccept();
     }
 }
+
+void Listener::startSession(boost::asio::generic::stream_protocol::socket socket, boost::asio::ssl::context* sslContext, ConnectionPermit permit)
+{
+    try 
+    {
+        // handlers of HTTP/2 streams run outside the strand of the connection
+        auto session{ std::make_shared<Session>(std::move(socket), sslContext, router_, sessionSettings_, timerWheel_, handlerExecutor_, std::move(permit)) };
+        session->start();
+    }
+    catch (const std::exception& e) 
+    {
+        LOG_ERROR("Failed to create session: " + std::string{ e.what() });
+    }
+}
 }
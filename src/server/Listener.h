@@ -1,11 +1,15 @@
 #ifndef LISTENER_H
 #define LISTENER_H
 
+#include <filesystem>
 #include <memory>
 #include <boost/beast.hpp>
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
+#include "ConnectionLimiter.h"
 #include "Router.h"
+#include "SessionSettings.h"
+#include "TimerWheel.h"
 
 namespace server
 {
@@ -15,7 +19,15 @@ namespace server
  *
  * Manages the server's TCP acceptor socket, listens for incoming connections,
  * and creates Session instances for each accepted connection. Implements
- * asynchronous I/O using Boost.Asio and supports SSL/TLS encryption.
+ * asynchronous I/O using Boost.Asio and supports SSL/TLS encryption, or plaintext
+ * HTTP when TLS is terminated by a load balancer.
+ *
+ * Optionally also accepts plaintext connections on a Unix domain socket for clients
+ * on the same host, such as sidecar proxies and batch jobs; access is controlled by
+ * the permissions of the socket file. Both kinds of connections are served by the same Session.
+ *
+ * Admission is controlled by a ConnectionLimiter: while all connections are taken or the
+ * accept rate is exceeded, accepting pauses and clients wait in the listen backlog.
  *
  * @note This class is thread-safe and uses strand-based synchronization
  * @warning Must be managed as a shared_ptr due to enable_shared_from_this
@@ -28,15 +40,25 @@ public:
     /**
      * @brief Constructs a Listener instance with required dependencies
      * @param ioc Shared pointer to the I/O context for asynchronous operations
-     * @param sslContext Shared pointer to SSL context for secure connections
+     * @param sslContext Shared pointer to SSL context for secure connections, or nullptr for plaintext HTTP
      * @param endpoint Unique pointer to TCP endpoint configuration (address and port)
      * @param router Shared pointer to request router for handling HTTP requests
-     * @throws std::invalid_argument if any parameter is null
+     * @param sessionSettings Shared pointer to HTTP settings passed to every session
+     * @param unixSocketPath Path of the Unix domain socket to listen on as well, empty for none
+     * @param unixSocketPermissions Permissions of the Unix domain socket file
+     * @param connectionLimits Limits on open connections and the accept rate
+     * @param handlerExecutor Executor that runs the handlers of HTTP/2 streams, the I/O context if empty
+     * @throws std::invalid_argument if any parameter other than sslContext is null
      */
     Listener(std::shared_ptr<boost::asio::io_context> ioc,
         std::shared_ptr<boost::asio::ssl::context> sslContext,
         std::unique_ptr<boost::asio::ip::tcp::endpoint> endpoint,
-        std::shared_ptr<Router> router);
+        std::shared_ptr<Router> router,
+        std::shared_ptr<const SessionSettings> sessionSettings,
+        std::filesystem::path unixSocketPath = {},
+        std::filesystem::perms unixSocketPermissions = std::filesystem::perms::owner_read | std::filesystem::perms::owner_write,
+        const ConnectionLimits& connectionLimits = {},
+        boost::asio::any_io_executor handlerExecutor = {});
 
     /**
      * @brief Destructor that ensures proper cleanup
@@ -53,17 +75,65 @@ public:
 
     /**
      * @brief Stops the listener and closes all connections
-     * @note Safe to call multiple times
+     * @note Safe to call multiple times; removes the Unix domain socket file
      */
     void stop() noexcept;
 
+    /**
+     * @brief Gets the admission counters of the listener
+     * @return ConnectionStatistics Snapshot of the counters
+     */
+    [[nodiscard]] ConnectionStatistics getConnectionStatistics() const noexcept;
+
 private:
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
     /**
-     * @brief Initiates an asynchronous accept operation
+     * @brief Binds the Unix domain socket and sets the permissions of its file
+     * @throws std::runtime_error if the socket cannot be bound or its path is taken by another file
+     * @note A socket file left behind by a previous run is replaced
+     */
+    void startUnixSocket();
+
+    /**
+     * @brief Initiates an asynchronous accept operation on the Unix domain socket, or waits first if the connection limits require it
+     * @note Only called when the listener is in running state
+     */
+    void doAcceptUnix();
+
+    /**
+     * @brief Callback handler for the end of a pause of accepting on the Unix domain socket
+     * @param ec Error code from the wait, operation_aborted when the listener stops
+     */
+    void onAcceptUnixDelay(const boost::beast::error_code& ec);
+
+    /**
+     * @brief Callback handler for connections accepted on the Unix domain socket
+     * @param ec Error code from the accept operation
+     * @param socket Accepted Unix domain socket, always served as plaintext
+     */
+    void onAcceptUnix(const boost::beast::error_code& ec, boost::asio::local::stream_protocol::socket socket);
+#endif
+
+    /**
+     * @brief Creates and starts the session of an accepted connection
+     * @param socket Accepted TCP or Unix domain socket
+     * @param sslContext SSL context of the connection, or nullptr for plaintext
+     * @param permit Admission of the connection, held by the session until it closes
+     */
+    void startSession(boost::asio::generic::stream_protocol::socket socket, boost::asio::ssl::context* sslContext, ConnectionPermit permit);
+
+    /**
+     * @brief Initiates an asynchronous accept operation, or waits first if the connection limits require it
      * @note Only called when the listener is in running state
      */
     void doAccept();
 
+    /**
+     * @brief Callback handler for the end of a pause of accepting
+     * @param ec Error code from the wait, operation_aborted when the listener stops
+     */
+    void onAcceptDelay(const boost::beast::error_code& ec);
+
     /**
      * @brief Callback handler for accepted connections
      * @param ec Error code from the accept operation
@@ -74,11 +144,22 @@ private:
 
 private:
     std::shared_ptr<boost::asio::io_context> ioc_;           ///< I/O context for asynchronous operations
-    std::shared_ptr<boost::asio::ssl::context> sslContext_;  ///< SSL context for secure connections
+    std::shared_ptr<boost::asio::ssl::context> sslContext_;  ///< SSL context for secure connections, null for plaintext
     std::unique_ptr<boost::asio::ip::tcp::endpoint> endpoint_; ///< Network endpoint configuration
 
     std::shared_ptr<Router> router_;          ///< HTTP request router
+    std::shared_ptr<const SessionSettings> sessionSettings_; ///< HTTP settings shared by all sessions
+    std::shared_ptr<TimerWheel> timerWheel_;  ///< Timer wheel that drives the timeouts of all sessions
+    boost::asio::any_io_executor handlerExecutor_; ///< Executor that runs the handlers of HTTP/2 streams
     boost::asio::ip::tcp::acceptor acceptor_; ///< TCP acceptor socket
+    boost::asio::steady_timer acceptDelay_;   ///< Timer of a pause of accepting, on the strand of acceptor_
+    std::shared_ptr<ConnectionLimiter> connectionLimiter_; ///< Admission control of all connections
+    std::filesystem::path unixSocketPath_;           ///< Path of the Unix domain socket, empty if disabled
+    std::filesystem::perms unixSocketPermissions_;   ///< Permissions of the Unix domain socket file
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    boost::asio::local::stream_protocol::acceptor unixAcceptor_; ///< Unix domain socket acceptor
+    boost::asio::steady_timer unixAcceptDelay_;                  ///< Timer of a pause of accepting, on the strand of unixAcceptor_
+#endif
     bool isRunning_{ false };                 ///< Listener running state flag
 };
 }
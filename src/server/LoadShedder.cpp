@@ -0,0 +1,72 @@
+#include "LoadShedder.h"
+#include <algorithm>
+#include <format>
+#include "../utils/Logger.h"
+
+namespace server
+{
+constexpr std::chrono::seconds MIN_RETRY_AFTER{ 1 };
+
+LoadShedder::LoadShedder(LoadShedSettings settings, LoadProbe loadProbe) :
+    settings_{ std::move(settings) },
+    loadProbe_{ std::move(loadProbe) }
+{
+}
+
+bool LoadShedder::tryAdmit(const boost::beast::http::request<boost::beast::http::string_body>& request, const utils::Deadline& deadline,
+    std::chrono::seconds& retryAfter)
+{
+    if (!loadProbe_)
+    {
+        return true;
+    }
+
+    std::string_view path{ request.target() };
+    path = path.substr(0, path.find('?'));
+
+    while (path.size() > 1 && path.back() == '/')
+    {
+        path.remove_suffix(1);
+    }
+
+    const auto share{ isLowPriority(path) ? settings_.lowPriorityShare : 1.0 };
+    const auto maxQueueDepth{ std::max<size_t>(static_cast<size_t>(static_cast<double>(settings_.maxQueueDepth) * share), 1) };
+
+    // a low priority request leaves the rest of its budget to the others
+    auto remaining{ std::chrono::milliseconds::max() };
+    if (deadline.hasLimit())
+    {
+        remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline.getRemaining())
+            - std::chrono::duration_cast<std::chrono::milliseconds>(deadline.getBudget() * (1.0 - share));
+    }
+
+    const auto load{ loadProbe_() };
+    const auto isLate{ load.expectedWait > remaining };
+    const auto isQueueFull{ settings_.maxQueueDepth != 0 && load.queueDepth >= maxQueueDepth };
+
+    if (!isLate && !isQueueFull)
+    {
+        return true;
+    }
+
+    ++shedCount_;
+    retryAfter = std::max(std::chrono::ceil<std::chrono::seconds>(load.expectedWait), MIN_RETRY_AFTER);
+
+    LOG_DEBUG(std::format("Request to {} shed: expected database wait {} ms with {} ms left, {} queries waiting",
+        path, load.expectedWait.count(), remaining.count(), load.queueDepth));
+    return false;
+}
+
+uint64_t LoadShedder::getShedCount() const noexcept
+{
+    return shedCount_.load();
+}
+
+bool LoadShedder::isLowPriority(std::string_view path) const noexcept
+{
+    return std::ranges::any_of(settings_.lowPriorityRoutes, [path](const std::string& route)
+    {
+        return path == route || (path.starts_with(route) && path[route.size()] == '/');
+    });
+}
+}
@@ -0,0 +1,128 @@
+#ifndef LOAD_SHEDDER_H
+#define LOAD_SHEDDER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/beast/http.hpp>
+#include "../utils/Deadline.h"
+
+namespace server
+{
+/**
+ * @struct LoadSample
+ * @brief Load of the database connection pool at one moment
+ */
+struct LoadSample final
+{
+    std::chrono::milliseconds expectedWait{}; ///< Expected wait of a new query for a connection
+    size_t queueDepth{ 0 };                   ///< Number of queries waiting for a connection
+};
+
+/**
+ * @struct LoadShedSettings
+ * @brief Thresholds of a LoadShedder
+ */
+struct LoadShedSettings final
+{
+    size_t maxQueueDepth{ 64 };                 ///< Queue depth at which requests are shed, 0 to ignore the queue depth
+    std::vector<std::string> lowPriorityRoutes; ///< Routes shed first, including nested paths
+    double lowPriorityShare{ 0.5 };             ///< Share of the request time budget and queue depth left to low priority routes
+};
+
+/**
+ * @class LoadShedder
+ * @brief Rejects requests early while the database cannot serve them in time
+ *
+ * When the database slows down, queries queue for a pooled connection until the
+ * pool timeout, and clients give up before they get an answer. A request is
+ * therefore rejected before its handler runs if the expected wait for a connection
+ * exceeds the time the client has left, or if too many queries are waiting already.
+ *
+ * Low priority routes (search, user listing) get only a share of both limits, so
+ * they are shed first and the remaining connections go to sending messages.
+ *
+ * @note Thread-safe
+ * @see RequestProcessor
+ */
+class LoadShedder final
+{
+public:
+    /**
+     * @typedef LoadProbe
+     * @brief Samples the current load of the database connection pool
+     */
+    using LoadProbe = std::function<LoadSample()>;
+
+    /**
+     * @brief Constructs a load shedder
+     * @param settings Thresholds and low priority routes
+     * @param loadProbe Source of load samples, called once per request
+     */
+    LoadShedder(LoadShedSettings settings, LoadProbe loadProbe);
+
+    /**
+     * @brief Default destructor
+     */
+    ~LoadShedder() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note LoadShedder should not be copied
+     */
+    LoadShedder(const LoadShedder&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note LoadShedder should not be copied
+     */
+    LoadShedder& operator=(const LoadShedder&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note LoadShedder should not be moved
+     */
+    LoadShedder(LoadShedder&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note LoadShedder should not be moved
+     */
+    LoadShedder& operator=(LoadShedder&&) = delete;
+
+    /**
+     * @brief Decides if a request is handled under the current load
+     * @param request HTTP request, only its target is used
+     * @param deadline Time budget of the request; without a time limit only the queue depth is checked
+     * @param[out] retryAfter Suggested time until the client tries again, set if the request is shed
+     * @return bool True if the request is admitted
+     */
+    [[nodiscard]] bool tryAdmit(const boost::beast::http::request<boost::beast::http::string_body>& request, const utils::Deadline& deadline,
+        std::chrono::seconds& retryAfter);
+
+    /**
+     * @brief Gets the number of shed requests
+     * @return uint64_t Number of requests rejected because of load
+     */
+    [[nodiscard]] uint64_t getShedCount() const noexcept;
+
+private:
+    /**
+     * @brief Checks if a request path belongs to a low priority route
+     * @param path Request path without query
+     * @return bool True if the path is shed first
+     */
+    [[nodiscard]] bool isLowPriority(std::string_view path) const noexcept;
+
+private:
+    const LoadShedSettings settings_;     ///< Thresholds and low priority routes
+    const LoadProbe loadProbe_;           ///< Source of load samples
+    std::atomic<uint64_t> shedCount_{ 0 }; ///< Number of shed requests
+};
+}
+
+#endif // LOAD_SHEDDER_H
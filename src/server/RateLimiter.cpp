@@ -0,0 +1,184 @@
+#include "RateLimiter.h"
+#include <algorithm>
+#include "../utils/Logger.h"
+
+namespace server
+{
+constexpr std::string_view BEARER_PREFIX{ "Bearer " };
+constexpr std::chrono::seconds MIN_RETRY_AFTER{ 1 };
+
+RateLimiter::RateLimiter(RateLimitSettings settings, UserResolver userResolver) :
+    settings_{ std::move(settings) },
+    userResolver_{ std::move(userResolver) },
+    maxBucketsPerShard_{ std::max<size_t>(settings_.maxBuckets / SHARD_COUNT, 1) }
+{
+}
+
+bool RateLimiter::tryAcquire(const boost::beast::http::request<boost::beast::http::string_body>& request, const std::string& clientAddress,
+    std::chrono::seconds& retryAfter)
+{
+    std::string_view path{ request.target() };
+    path = path.substr(0, path.find('?'));
+
+    while (path.size() > 1 && path.back() == '/')
+    {
+        path.remove_suffix(1);
+    }
+
+    const auto* rule{ findRule(path) };
+    if (!rule)
+    {
+        return true;
+    }
+
+    const auto now{ std::chrono::steady_clock::now() };
+    auto wait{ std::chrono::steady_clock::duration::zero() };
+
+    // the user is known from the token alone, so no request reaches the database before it is counted
+    std::string userKey{};
+    if (rule->userRate > 0.0 && userResolver_)
+    {
+        if (const auto token{ extractBearerToken(request) }; !token.empty())
+        {
+            if (const auto userId{ userResolver_(token) }; !userId.empty())
+            {
+                userKey = rule->path + "|user|" + userId;
+            }
+        }
+    }
+
+    auto isAdmitted{ userKey.empty() || take(userKey, rule->userRate, rule->userBurst, now, wait) };
+
+    if (isAdmitted && rule->ipRate > 0.0 && !clientAddress.empty() && !take(rule->path + "|ip|" + clientAddress, rule->ipRate, rule->ipBurst, now, wait))
+    {
+        // the request is not made, so it does not count against the user
+        if (!userKey.empty())
+        {
+            giveBack(userKey);
+        }
+
+        isAdmitted = false;
+    }
+
+    if (isAdmitted)
+    {
+        return true;
+    }
+
+    ++limitedCount_;
+    retryAfter = std::max(std::chrono::ceil<std::chrono::seconds>(wait), MIN_RETRY_AFTER);
+
+    LOG_DEBUG("Rate limit exceeded on " + rule->path + " by " + (userKey.empty() ? "client " + clientAddress : "user of client " + clientAddress));
+    return false;
+}
+
+size_t RateLimiter::getBucketCount() const noexcept
+{
+    size_t count{ 0 };
+    for (const auto& shard : shards_)
+    {
+        std::lock_guard lock{ shard.mutex };
+        count += shard.buckets.size();
+    }
+
+    return count;
+}
+
+uint64_t RateLimiter::getLimitedCount() const noexcept
+{
+    return limitedCount_.load();
+}
+
+const RateLimitRule* RateLimiter::findRule(std::string_view path) const noexcept
+{
+    const auto it{ std::ranges::find_if(settings_.rules, [path](const RateLimitRule& rule)
+    {
+        return path == rule.path || (path.starts_with(rule.path) && path[rule.path.size()] == '/');
+    }) };
+
+    return it != settings_.rules.end() ? &*it : nullptr;
+}
+
+RateLimiter::Shard& RateLimiter::getShard(const std::string& key) noexcept
+{
+    return shards_[std::hash<std::string>{}(key) % SHARD_COUNT];
+}
+
+bool RateLimiter::take(const std::string& key, double rate, unsigned int burst, std::chrono::steady_clock::time_point now, std::chrono::steady_clock::duration& retryAfter)
+{
+    auto& shard{ getShard(key) };
+    std::lock_guard lock{ shard.mutex };
+
+    auto it{ shard.buckets.find(key) };
+    if (it == shard.buckets.end())
+    {
+        if (shard.buckets.size() >= maxBucketsPerShard_)
+        {
+            evict(shard, now);
+        }
+
+        const auto size{ static_cast<double>(std::max(burst, 1u)) };
+        it = shard.buckets.emplace(key, Bucket{ size, now, rate, size }).first;
+    }
+    else
+    {
+        refill(it->second, now);
+    }
+
+    auto& bucket{ it->second };
+    if (bucket.tokens >= 1.0)
+    {
+        bucket.tokens -= 1.0;
+        return true;
+    }
+
+    retryAfter = std::chrono::ceil<std::chrono::steady_clock::duration>(std::chrono::duration<double>{ (1.0 - bucket.tokens) / bucket.rate });
+    return false;
+}
+
+void RateLimiter::giveBack(const std::string& key) noexcept
+{
+    auto& shard{ getShard(key) };
+    std::lock_guard lock{ shard.mutex };
+
+    if (const auto it{ shard.buckets.find(key) }; it != shard.buckets.end())
+    {
+        it->second.tokens = std::min(it->second.tokens + 1.0, it->second.burst);
+    }
+}
+
+void RateLimiter::evict(Shard& shard, std::chrono::steady_clock::time_point now) const noexcept
+{
+    // a full bucket behaves like a new one, so dropping it loses nothing
+    std::erase_if(shard.buckets, [now](const auto& entry)
+    {
+        const auto& bucket{ entry.second };
+        return bucket.tokens + std::chrono::duration<double>{ now - bucket.updated }.count() * bucket.rate >= bucket.burst;
+    });
+
+    if (shard.buckets.size() < maxBucketsPerShard_)
+    {
+        return;
+    }
+
+    const auto oldest{ std::ranges::min_element(shard.buckets, {}, [](const auto& entry) { return entry.second.updated; }) };
+    shard.buckets.erase(oldest);
+}
+
+std::string RateLimiter::extractBearerToken(const boost::beast::http::request<boost::beast::http::string_body>& request)
+{
+    const std::string_view header{ request[boost::beast::http::field::authorization] };
+    if (header.size() <= BEARER_PREFIX.size() || !header.starts_with(BEARER_PREFIX))
+    {
+        return "";
+    }
+
+    return std::string{ header.substr(BEARER_PREFIX.size()) };
+}
+
+void RateLimiter::refill(Bucket& bucket, std::chrono::steady_clock::time_point now) noexcept
+{
+    bucket.tokens = std::min(bucket.tokens + std::chrono::duration<double>{ now - bucket.updated }.count() * bucket.rate, bucket.burst);
+    bucket.updated = now;
+}
+}
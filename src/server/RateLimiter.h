@@ -0,0 +1,213 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <boost/beast/http.hpp>
+
+namespace server
+{
+/**
+ * @struct RateLimitRule
+ * @brief Request rate limits of one route
+ *
+ * A rate of 0 disables that limit. The burst is the number of requests
+ * that may be made at once after a pause.
+ */
+struct RateLimitRule final
+{
+    std::string path;          ///< Route the limits apply to, including nested paths
+    double userRate{ 0.0 };    ///< Requests per second per authenticated user
+    unsigned int userBurst{ 1 }; ///< Bucket size per user
+    double ipRate{ 0.0 };      ///< Requests per second per client IP address
+    unsigned int ipBurst{ 1 }; ///< Bucket size per client IP address
+};
+
+/**
+ * @struct RateLimitSettings
+ * @brief Route limits and memory bound of a RateLimiter
+ */
+struct RateLimitSettings final
+{
+    std::vector<RateLimitRule> rules; ///< Limited routes, requests to other routes are not limited
+    size_t maxBuckets{ 100000 };      ///< Maximum number of buckets kept in memory
+};
+
+/**
+ * @class RateLimiter
+ * @brief Token bucket rate limiting of requests per user and per client IP address
+ *
+ * Every limited route has one bucket per user id taken from the access token and
+ * one per client address. A request is admitted only if both buckets have a token;
+ * requests without a valid access token are limited by address only.
+ *
+ * Buckets are spread over shards with their own mutex, so requests of different
+ * clients rarely wait for each other. A bucket that has refilled completely is
+ * equivalent to a new one, so such idle buckets are evicted once a shard is full;
+ * if none is idle, the least recently used bucket is evicted.
+ *
+ * @note Thread-safe
+ * @see RequestProcessor
+ */
+class RateLimiter final
+{
+public:
+    /**
+     * @typedef UserResolver
+     * @brief Maps a Bearer token to the id of its user, or to an empty string if the token is not valid
+     */
+    using UserResolver = std::function<std::string(const std::string& token)>;
+
+    /**
+     * @brief Constructs a rate limiter
+     * @param settings Route limits and memory bound
+     * @param userResolver Resolves access tokens to user ids, must not touch the database
+     */
+    RateLimiter(RateLimitSettings settings, UserResolver userResolver);
+
+    /**
+     * @brief Default destructor
+     */
+    ~RateLimiter() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note RateLimiter should not be copied
+     */
+    RateLimiter(const RateLimiter&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note RateLimiter should not be copied
+     */
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note RateLimiter should not be moved
+     */
+    RateLimiter(RateLimiter&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note RateLimiter should not be moved
+     */
+    RateLimiter& operator=(RateLimiter&&) = delete;
+
+    /**
+     * @brief Takes a token for a request from the buckets of its user and client address
+     * @param request HTTP request, only its target and Authorization header are used
+     * @param clientAddress Client IP address
+     * @param[out] retryAfter Time until the request would be admitted, set if it is not
+     * @return bool True if the request is admitted or its route is not limited
+     */
+    [[nodiscard]] bool tryAcquire(const boost::beast::http::request<boost::beast::http::string_body>& request, const std::string& clientAddress,
+        std::chrono::seconds& retryAfter);
+
+    /**
+     * @brief Gets the number of buckets in memory
+     * @return size_t Number of buckets
+     */
+    [[nodiscard]] size_t getBucketCount() const noexcept;
+
+    /**
+     * @brief Gets the number of rejected requests
+     * @return uint64_t Number of requests that exceeded a limit
+     */
+    [[nodiscard]] uint64_t getLimitedCount() const noexcept;
+
+private:
+    /**
+     * @struct Bucket
+     * @brief Token bucket of one user or address on one route
+     */
+    struct Bucket final
+    {
+        double tokens{ 0.0 };                          ///< Tokens available at updated
+        std::chrono::steady_clock::time_point updated; ///< Time of the last refill
+        double rate{ 0.0 };                            ///< Tokens added per second
+        double burst{ 0.0 };                           ///< Bucket size
+    };
+
+    /**
+     * @struct Shard
+     * @brief Part of the buckets with its own lock
+     */
+    struct Shard final
+    {
+        mutable std::mutex mutex;                        ///< Mutex for buckets
+        std::unordered_map<std::string, Bucket> buckets; ///< Buckets by route, kind and user or address
+    };
+
+    /**
+     * @brief Finds the rule of a request path
+     * @param path Request path without query
+     * @return const RateLimitRule* Rule of the path, or nullptr if it is not limited
+     */
+    [[nodiscard]] const RateLimitRule* findRule(std::string_view path) const noexcept;
+
+    /**
+     * @brief Gets the shard of a bucket key
+     * @param key Bucket key
+     * @return Shard& Shard that holds the bucket
+     */
+    [[nodiscard]] Shard& getShard(const std::string& key) noexcept;
+
+    /**
+     * @brief Takes a token from a bucket, creating a full bucket if there is none
+     * @param key Bucket key
+     * @param rate Tokens added per second
+     * @param burst Bucket size
+     * @param now Current time
+     * @param[out] retryAfter Time until a token is available, set if there is none
+     * @return bool True if a token was taken
+     */
+    [[nodiscard]] bool take(const std::string& key, double rate, unsigned int burst, std::chrono::steady_clock::time_point now, std::chrono::steady_clock::duration& retryAfter);
+
+    /**
+     * @brief Returns a token taken for a request that was rejected by another bucket
+     * @param key Bucket key
+     */
+    void giveBack(const std::string& key) noexcept;
+
+    /**
+     * @brief Makes room for a new bucket in a full shard
+     * @param shard Shard to evict from, its mutex must be held
+     * @param now Current time
+     */
+    void evict(Shard& shard, std::chrono::steady_clock::time_point now) const noexcept;
+
+    /**
+     * @brief Extracts the token of an "Authorization: Bearer" header
+     * @param request HTTP request
+     * @return std::string Token, or an empty string if there is none
+     */
+    [[nodiscard]] static std::string extractBearerToken(const boost::beast::http::request<boost::beast::http::string_body>& request);
+
+    /**
+     * @brief Refills a bucket up to the current time
+     * @param bucket Bucket to refill
+     * @param now Current time
+     */
+    static void refill(Bucket& bucket, std::chrono::steady_clock::time_point now) noexcept;
+
+    static constexpr size_t SHARD_COUNT{ 16 }; ///< Number of shards
+
+private:
+    const RateLimitSettings settings_;       ///< Route limits and memory bound
+    const UserResolver userResolver_;        ///< Resolver of access tokens to user ids
+    const size_t maxBucketsPerShard_;        ///< Bucket limit of one shard
+    std::array<Shard, SHARD_COUNT> shards_;  ///< Buckets, sharded by key hash
+    std::atomic<uint64_t> limitedCount_{ 0 }; ///< Number of rejected requests
+};
+}
+
+#endif // RATE_LIMITER_H
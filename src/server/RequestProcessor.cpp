@@ -0,0 +1,226 @@
+#include "RequestProcessor.h"
+#include <format>
+#include <sstream>
+#include <nlohmann/json.hpp>
+#include <boost/algorithm/string.hpp>
+#include "../utils/Compressor.h"
+#include "../utils/Logger.h"
+
+namespace server
+{
+boost::beast::http::response<boost::beast::http::string_body> RequestProcessor::process(boost::beast::http::request<boost::beast::http::string_body>& request,
+    Router& router, const SessionSettings& settings, const std::string& clientIP, const utils::Deadline& deadline,
+    std::shared_ptr<handlers::IResponseStream>& responseStream)
+{
+    responseStream.reset();
+
+    try
+    {
+        if (auto error{ checkRateLimit(request, router, clientIP) })
+        {
+            return std::move(*error);
+        }
+
+        if (auto error{ checkLoad(request, router, deadline) })
+        {
+            return std::move(*error);
+        }
+
+        if (auto error{ decodeRequestBody(request, settings) })
+        {
+            return std::move(*error);
+        }
+
+        const auto handler{ router.findHandler(request) };
+        if (!handler)
+        {
+            return router.handleNotFound(request);
+        }
+
+        const utils::DeadlineScope deadlineScope{ deadline };
+
+        if (handler->isStreamingRequest(request))
+        {
+            boost::beast::http::response<boost::beast::http::string_body> response{};
+            responseStream = handler->processStream(request, response);
+            return response;
+        }
+
+        return handler->process(request);
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Error handling request: " + std::string{ e.what() });
+    }
+
+    responseStream.reset();
+    return createErrorResponse(request, boost::beast::http::status::internal_server_error, "INTERNAL_ERROR", "Internal server error");
+}
+
+std::optional<boost::beast::http::response<boost::beast::http::string_body>> RequestProcessor::checkRateLimit(
+    const boost::beast::http::request<boost::beast::http::string_body>& request, Router& router, const std::string& clientIP)
+{
+    auto* rateLimiter{ router.getRateLimiter() };
+    if (!rateLimiter)
+    {
+        return std::nullopt;
+    }
+
+    std::chrono::seconds retryAfter{};
+    if (rateLimiter->tryAcquire(request, clientIP, retryAfter))
+    {
+        return std::nullopt;
+    }
+
+    auto response{ createErrorResponse(request, boost::beast::http::status::too_many_requests, "RATE_LIMITED", "Too many requests, retry in " + std::to_string(retryAfter.count()) + " s") };
+    response.set(boost::beast::http::field::retry_after, std::to_string(retryAfter.count()));
+    return response;
+}
+
+std::optional<boost::beast::http::response<boost::beast::http::string_body>> RequestProcessor::checkLoad(
+    const boost::beast::http::request<boost::beast::http::string_body>& request, Router& router, const utils::Deadline& deadline)
+{
+    std::chrono::seconds retryAfter{};
+
+    // while the database is down every request would fail, so none waits for it
+    if (const auto& availabilityProbe{ router.getAvailabilityProbe() }; availabilityProbe && !availabilityProbe(retryAfter))
+    {
+        auto response{ createErrorResponse(request, boost::beast::http::status::service_unavailable, "SERVICE_UNAVAILABLE", "Service is temporarily unavailable, retry in " + std::to_string(retryAfter.count()) + " s") };
+        response.set(boost::beast::http::field::retry_after, std::to_string(retryAfter.count()));
+        return response;
+    }
+
+    auto* loadShedder{ router.getLoadShedder() };
+    if (!loadShedder)
+    {
+        return std::nullopt;
+    }
+
+    if (loadShedder->tryAdmit(request, deadline, retryAfter))
+    {
+        return std::nullopt;
+    }
+
+    auto response{ createErrorResponse(request, boost::beast::http::status::service_unavailable, "SERVICE_OVERLOADED", "Server is overloaded, retry in " + std::to_string(retryAfter.count()) + " s") };
+    response.set(boost::beast::http::field::retry_after, std::to_string(retryAfter.count()));
+    return response;
+}
+
+std::optional<boost::beast::http::response<boost::beast::http::string_body>> RequestProcessor::decodeRequestBody(
+    boost::beast::http::request<boost::beast::http::string_body>& request, const SessionSettings& settings)
+{
+    const auto contentEncoding{ boost::algorithm::trim_copy(std::string{ request[boost::beast::http::field::content_encoding] }) };
+    if (contentEncoding.empty())
+    {
+        return std::nullopt;
+    }
+
+    auto encoding{ utils::ContentEncoding::Identity };
+    if (!utils::Compressor::fromString(contentEncoding, encoding))
+    {
+        return createErrorResponse(request, boost::beast::http::status::unsupported_media_type, "UNSUPPORTED_CONTENT_ENCODING", "Unsupported Content-Encoding: " + contentEncoding);
+    }
+
+    if (encoding != utils::ContentEncoding::Identity)
+    {
+        std::string body{};
+        if (!utils::Compressor::decompress(request.body(), encoding, settings.maxRequestBodySize, body))
+        {
+            return createErrorResponse(request, boost::beast::http::status::bad_request, "INVALID_CONTENT_ENCODING",
+                "Request body is malformed or exceeds " + std::to_string(settings.maxRequestBodySize) + " bytes when decompressed");
+        }
+
+        LOG_DEBUG(std::format("Request body decompressed from {} to {} bytes", request.body().size(), body.size()));
+        request.body() = std::move(body);
+    }
+
+    // handlers always see the decoded body
+    request.erase(boost::beast::http::field::content_encoding);
+    request.prepare_payload();
+
+    return std::nullopt;
+}
+
+void RequestProcessor::encodeResponseBody(const boost::beast::http::request<boost::beast::http::string_body>& request,
+    boost::beast::http::response<boost::beast::http::string_body>& response, const SessionSettings& settings)
+{
+    if (!settings.isCompressionEnabled || response.body().size() < settings.compressionMinSize ||
+        response.count(boost::beast::http::field::content_encoding) != 0)
+    {
+        return;
+    }
+
+    const auto contentType{ response[boost::beast::http::field::content_type] };
+    if (!contentType.starts_with("application/json") && !contentType.starts_with("application/msgpack") &&
+        !contentType.starts_with("application/cbor") && !contentType.starts_with("text/"))
+    {
+        return;
+    }
+
+    // the representation depends on Accept-Encoding even when it is sent uncompressed
+    const std::string vary{ response[boost::beast::http::field::vary] };
+    response.set(boost::beast::http::field::vary, vary.empty() ? "Accept-Encoding" : vary + ", Accept-Encoding");
+
+    const auto encoding{ utils::Compressor::negotiate(std::string{ request[boost::beast::http::field::accept_encoding] }) };
+    if (encoding == utils::ContentEncoding::Identity)
+    {
+        return;
+    }
+
+    std::string body{};
+    if (!utils::Compressor::compress(response.body(), encoding, settings.compressionLevel, body) || body.size() >= response.body().size())
+    {
+        return;
+    }
+
+    response.body() = std::move(body);
+    response.set(boost::beast::http::field::content_encoding, std::string{ utils::Compressor::toString(encoding) });
+    response.prepare_payload();
+}
+
+boost::beast::http::response<boost::beast::http::string_body> RequestProcessor::createErrorResponse(const boost::beast::http::request<boost::beast::http::string_body>& request,
+    boost::beast::http::status status, const std::string& code, const std::string& message)
+{
+    nlohmann::json error_json{};
+    error_json["status"] = "error";
+    error_json["code"] = code;
+    error_json["message"] = message;
+
+    boost::beast::http::response<boost::beast::http::string_body> response{ status, request.version() };
+    response.set(boost::beast::http::field::content_type, "application/json");
+    response.set(boost::beast::http::field::access_control_allow_origin, "*");
+    response.keep_alive(request.keep_alive());
+    response.body() = error_json.dump();
+    response.prepare_payload();
+
+    return response;
+}
+
+void RequestProcessor::logRequest(const std::string& clientIP, const boost::beast::http::request<boost::beast::http::string_body>& request)
+{
+    const auto method{ request.method_string() };
+    const auto target{ request.target() };
+
+    std::stringstream logEntry{};
+    logEntry << clientIP << " - - ["
+        << std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count()
+        << "] \"" << method << " " << target << " HTTP/"
+        << (request.version() / 10) << "." << (request.version() % 10) << "\"";
+
+    LOG_ACCESS(logEntry.str());
+
+    LOG_DEBUG(std::format("Request from {}: {} {}", clientIP, method, target));
+}
+
+void RequestProcessor::logResponse(const std::string& clientIP, const boost::beast::http::response<boost::beast::http::string_body>& response)
+{
+    const auto statusCode{ response.result_int() };
+
+    std::stringstream log_entry{};
+    log_entry << " " << statusCode << " " << response.body();
+
+    LOG_ACCESS(log_entry.str());
+
+    LOG_DEBUG("Response to " + clientIP + ": " + response.body());
+}
+}
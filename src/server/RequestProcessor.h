@@ -0,0 +1,124 @@
+#ifndef REQUEST_PROCESSOR_H
+#define REQUEST_PROCESSOR_H
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <boost/beast/http.hpp>
+#include "../handlers/IResponseStream.h"
+#include "../utils/Deadline.h"
+#include "Router.h"
+#include "SessionSettings.h"
+
+namespace server
+{
+/**
+ * @class RequestProcessor
+ * @brief Protocol independent steps of handling a complete HTTP request
+ *
+ * Shared by the HTTP/1.1 Session and the HTTP/2 Http2Session: rate limiting, load shedding, request body decoding,
+ * dispatching through the Router, response compression, error responses and the access log.
+ * Framing, flow control and connection management stay with the sessions.
+ *
+ * @note All methods are static and thread-safe, so requests can be processed on any thread
+ * @see Session
+ * @see Http2Session
+ */
+class RequestProcessor final
+{
+public:
+    /**
+     * @brief Deleted constructor to enforce static usage
+     */
+    RequestProcessor() noexcept = delete;
+
+    /**
+     * @brief Decodes the body of a complete request and passes the request to its handler
+     * @param request Complete HTTP request, its compressed body is decoded in place
+     * @param router Router that finds the handler
+     * @param settings HTTP settings (body limits)
+     * @param clientIP Client IP address, used for rate limiting
+     * @param deadline Time budget of the request, current for the database queries of the handler
+     * @param[out] responseStream Body source if the handler streams the response, nullptr otherwise
+     * @return boost::beast::http::response<boost::beast::http::string_body> Response, or the header of a streaming response
+     * @note Exceptions of handlers are logged and turned into 500 responses
+     */
+    [[nodiscard]] static boost::beast::http::response<boost::beast::http::string_body> process(boost::beast::http::request<boost::beast::http::string_body>& request,
+        Router& router, const SessionSettings& settings, const std::string& clientIP, const utils::Deadline& deadline,
+        std::shared_ptr<handlers::IResponseStream>& responseStream);
+
+    /**
+     * @brief Checks a request against the rate limits of its route
+     * @param request HTTP request, the header is enough
+     * @param router Router whose rate limiter is applied
+     * @param clientIP Client IP address
+     * @return std::optional<boost::beast::http::response<boost::beast::http::string_body>> 429 response with Retry-After,
+     *         or std::nullopt if the request may proceed
+     * @note Called before the request reaches its handler, so a limited request does no database work
+     */
+    [[nodiscard]] static std::optional<boost::beast::http::response<boost::beast::http::string_body>> checkRateLimit(
+        const boost::beast::http::request<boost::beast::http::string_body>& request, Router& router, const std::string& clientIP);
+
+    /**
+     * @brief Checks if the database is available and can serve a request before the client gives up on it
+     * @param request HTTP request, the header is enough
+     * @param router Router whose availability probe and load shedder are applied
+     * @param deadline Time budget of the request
+     * @return std::optional<boost::beast::http::response<boost::beast::http::string_body>> 503 response with Retry-After,
+     *         or std::nullopt if the request may proceed
+     * @note Called after the rate limit, so a shed request does no database work either
+     */
+    [[nodiscard]] static std::optional<boost::beast::http::response<boost::beast::http::string_body>> checkLoad(
+        const boost::beast::http::request<boost::beast::http::string_body>& request, Router& router, const utils::Deadline& deadline);
+
+    /**
+     * @brief Decodes a compressed request body in place
+     * @param request Request whose body is decoded
+     * @param settings HTTP settings (maximum decompressed body size)
+     * @return std::optional<boost::beast::http::response<boost::beast::http::string_body>> Error response,
+     *         or std::nullopt if the body is ready for the handler
+     * @note Supports the codings of Content-Encoding accepted by utils::Compressor
+     */
+    [[nodiscard]] static std::optional<boost::beast::http::response<boost::beast::http::string_body>> decodeRequestBody(
+        boost::beast::http::request<boost::beast::http::string_body>& request, const SessionSettings& settings);
+
+    /**
+     * @brief Compresses the response body if the client accepts a supported coding
+     * @param request Request the response belongs to
+     * @param response Response whose body is compressed
+     * @param settings HTTP settings (compression switch, level and minimum size)
+     * @note Skips small bodies, non-text content types, already encoded bodies and
+     *       responses without a body; the compressed body is kept only if it is smaller
+     */
+    static void encodeResponseBody(const boost::beast::http::request<boost::beast::http::string_body>& request,
+        boost::beast::http::response<boost::beast::http::string_body>& response, const SessionSettings& settings);
+
+    /**
+     * @brief Creates a JSON error response
+     * @param request Request the response belongs to
+     * @param status HTTP status code
+     * @param code Machine-readable error code
+     * @param message Human-readable error message
+     * @return boost::beast::http::response<boost::beast::http::string_body> Error response
+     */
+    [[nodiscard]] static boost::beast::http::response<boost::beast::http::string_body> createErrorResponse(const boost::beast::http::request<boost::beast::http::string_body>& request,
+        boost::beast::http::status status, const std::string& code, const std::string& message);
+
+    /**
+     * @brief Logs incoming HTTP request details
+     * @param clientIP Client IP address
+     * @param request HTTP request to log
+     */
+    static void logRequest(const std::string& clientIP, const boost::beast::http::request<boost::beast::http::string_body>& request);
+
+    /**
+     * @brief Logs outgoing HTTP response details
+     * @param clientIP Client IP address
+     * @param response HTTP response to log
+     */
+    static void logResponse(const std::string& clientIP, const boost::beast::http::response<boost::beast::http::string_body>& response);
+};
+}
+
+#endif // REQUEST_PROCESSOR_H
@@ -125,6 +125,36 @@ void Router::removeHandler(const std::string& path) noexcept
     }
 }
 
+void Router::setRateLimiter(std::shared_ptr<RateLimiter> rateLimiter) noexcept
+{
+    rateLimiter_ = std::move(rateLimiter);
+}
+
+RateLimiter* Router::getRateLimiter() const noexcept
+{
+    return rateLimiter_.get();
+}
+
+void Router::setLoadShedder(std::shared_ptr<LoadShedder> loadShedder) noexcept
+{
+    loadShedder_ = std::move(loadShedder);
+}
+
+LoadShedder* Router::getLoadShedder() const noexcept
+{
+    return loadShedder_.get();
+}
+
+void Router::setAvailabilityProbe(AvailabilityProbe availabilityProbe) noexcept
+{
+    availabilityProbe_ = std::move(availabilityProbe);
+}
+
+const Router::AvailabilityProbe& Router::getAvailabilityProbe() const noexcept
+{
+    return availabilityProbe_;
+}
+
 std::string Router::normalizePath(const std::string& path) const noexcept
 {
     if (path.empty() || path == "/") 
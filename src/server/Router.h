@@ -1,12 +1,16 @@
 #ifndef ROUTER_H
 #define ROUTER_H
 
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <string>
 #include <vector>
 #include <boost/beast/http.hpp>
 #include "../handlers/IHandler.h"
+#include "LoadShedder.h"
+#include "RateLimiter.h"
 
 namespace server
 {
@@ -24,6 +28,12 @@ namespace server
 class Router final
 {
 public:
+    /**
+     * @typedef AvailabilityProbe
+     * @brief Checks if the backend of the handlers can serve requests; sets the suggested retry delay if it cannot
+     */
+    using AvailabilityProbe = std::function<bool(std::chrono::seconds& retryAfter)>;
+
     /**
      * @brief Default constructor
      */
@@ -97,6 +107,45 @@ public:
      */
     void removeHandler(const std::string& path) noexcept;
 
+    /**
+     * @brief Sets the rate limiter applied to requests before they reach their handler
+     * @param rateLimiter Rate limiter, or nullptr to not limit requests
+     * @note Must be called during startup, before requests are handled
+     */
+    void setRateLimiter(std::shared_ptr<RateLimiter> rateLimiter) noexcept;
+
+    /**
+     * @brief Gets the rate limiter of the router
+     * @return RateLimiter* Rate limiter, or nullptr if requests are not limited
+     */
+    [[nodiscard]] RateLimiter* getRateLimiter() const noexcept;
+
+    /**
+     * @brief Sets the load shedder applied to requests before they reach their handler
+     * @param loadShedder Load shedder, or nullptr to handle every request
+     * @note Must be called during startup, before requests are handled
+     */
+    void setLoadShedder(std::shared_ptr<LoadShedder> loadShedder) noexcept;
+
+    /**
+     * @brief Gets the load shedder of the router
+     * @return LoadShedder* Load shedder, or nullptr if requests are never shed
+     */
+    [[nodiscard]] LoadShedder* getLoadShedder() const noexcept;
+
+    /**
+     * @brief Sets the check of the backend applied to requests before they reach their handler
+     * @param availabilityProbe Probe, or nullptr to assume the backend is always available
+     * @note Must be called during startup, before requests are handled
+     */
+    void setAvailabilityProbe(AvailabilityProbe availabilityProbe) noexcept;
+
+    /**
+     * @brief Gets the check of the backend of the router
+     * @return const AvailabilityProbe& Probe, empty if the backend is assumed to be available
+     */
+    [[nodiscard]] const AvailabilityProbe& getAvailabilityProbe() const noexcept;
+
 private:
     /**
      * @brief Normalizes URL path for consistent matching
@@ -126,6 +175,9 @@ private:
     // path -> handler
     std::unordered_map<std::string, std::shared_ptr<handlers::IHandler>> handlers_; ///< Map of registered paths to handlers
     std::mutex mutex_; ///< Mutex for thread-safe access to handlers map
+    std::shared_ptr<RateLimiter> rateLimiter_; ///< Rate limiter of requests, null if not limited
+    std::shared_ptr<LoadShedder> loadShedder_; ///< Load shedder of requests, null if requests are never shed
+    AvailabilityProbe availabilityProbe_; ///< Check of the backend, empty if it is assumed to be available
 };
 }
 
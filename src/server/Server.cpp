@@ -1,8 +1,13 @@
 #include "Server.h"
+#include <algorithm>
 #include <filesystem>
+#include <format>
+#include "../handlers/AttachmentHandlers.h"
 #include "../handlers/AuthHandlers.h"
+#include "../handlers/BatchHandlers.h"
 #include "../handlers/UserHandlers.h"
 #include "../handlers/MessageHandlers.h"
+#include "../utils/FileWriter.h"
 #include "../utils/Logger.h"
 
 namespace server
@@ -14,9 +19,10 @@ Server::Server(std::unique_ptr<config::ConfigManager> config, std::shared_ptr<da
     config_{ std::move(config) },
     dbManager_{ std::move(dbManager) },
     jwtManager_{ std::move(jwtManager) },
-    ioc_{ std::make_shared<boost::asio::io_context>(config_->getServerThreads()) },
+    ioc_{ createIoContext(config_->getServerThreads()) },
     work_{ boost::asio::make_work_guard(*ioc_) }, // create a work object to prevent io_context from terminating
-    sslContext_{ std::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tlsv12) }
+    handlerPool_{ std::make_unique<boost::asio::thread_pool>(static_cast<size_t>(config_->getServerHandlerThreads())) },
+    sslContext_{ std::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tls_server) }
 {
     initializeSSL();
     initializeRouter();
@@ -66,6 +72,7 @@ void Server::start()
         }
 
         LOG_INFO("Started " + std::to_string(threadCount) + " worker threads");
+        LOG_INFO("Running request handlers on " + std::to_string(config_->getServerHandlerThreads()) + " handler threads");
 
         isRunning_ = true;
 
@@ -95,8 +102,47 @@ bool Server::isRunning() const noexcept
     return isRunning_;
 }
 
-void Server::initializeSSL() const
+TlsStatistics Server::getTlsStatistics() const noexcept
 {
+    return tlsSessionManager_ ? tlsSessionManager_->getStatistics() : TlsStatistics{};
+}
+
+ConnectionStatistics Server::getConnectionStatistics() const noexcept
+{
+    return listener_ ? listener_->getConnectionStatistics() : ConnectionStatistics{};
+}
+
+database::ConcurrencyStatistics Server::getDatabaseConcurrencyStatistics() const noexcept
+{
+    return dbManager_->getConcurrencyStatistics();
+}
+
+std::shared_ptr<boost::asio::io_context> Server::createIoContext(int threadCount)
+{
+#if defined(BOOST_ASIO_HAS_IO_URING) && defined(BOOST_ASIO_DISABLE_EPOLL)
+    // Asio would fail with a bare system error when it sets up its ring
+    if (!utils::FileWriter::isIoUringSupported())
+    {
+        throw std::runtime_error{ "The server is built with io_uring, but the kernel does not provide it (Linux 5.6+ with kernel.io_uring_disabled = 0 is required); "
+            "rebuild with -DWITH_IO_URING=OFF to use epoll" };
+    }
+
+    LOG_INFO("I/O backend: io_uring");
+#endif
+
+    return std::make_shared<boost::asio::io_context>(threadCount);
+}
+
+void Server::initializeSSL()
+{
+    if (!config_->getServerTlsEnabled())
+    {
+        // TLS is terminated by a load balancer in front of the server
+        sslContext_.reset();
+        LOG_WARNING("TLS disabled, serving plaintext HTTP: only expose the listener to a TLS-terminating load balancer");
+        return;
+    }
+
     try 
     {
         sslContext_->set_options(
@@ -126,6 +172,8 @@ void Server::initializeSSL() const
         }
         sslContext_->use_tmp_dh_file(dhFile);
 
+        tlsSessionManager_ = std::make_unique<TlsSessionManager>(sslContext_, createTlsSettings());
+
         LOG_INFO("SSL context initialized successfully");
     }
     catch (const std::exception& e) 
@@ -141,6 +189,8 @@ void Server::initializeRouter()
     {
 	    router_ = std::make_shared<Router>();
 
+        handlers::IHandler::setCacheControl(config_->getHttpCacheControl());
+
         // register handlers
         // auth
 	    const auto authHandler{ std::make_shared<handlers::AuthHandlers>(jwtManager_, dbManager_) };
@@ -160,7 +210,31 @@ void Server::initializeRouter()
 	    const auto messagesHandler{ std::make_shared<handlers::MessageHandlers>(jwtManager_, dbManager_) };
         router_->registerHandler("/api/v1/messages", messagesHandler);
         router_->registerHandler("/api/v1/messages/send", messagesHandler);
+        router_->registerHandler("/api/v1/messages/send_batch", messagesHandler);
         router_->registerHandler("/api/v1/messages/read", messagesHandler);
+        router_->registerHandler("/api/v1/messages/export", messagesHandler);
+
+        // attachments
+        const auto attachmentStore{ std::make_shared<storage::AttachmentStore>(config_->getAttachmentsDirectory()) };
+        router_->registerHandler("/api/v1/attachments", std::make_shared<handlers::AttachmentHandlers>(jwtManager_, dbManager_, attachmentStore));
+
+        // batch
+        router_->registerHandler("/api/v1/batch", std::make_shared<handlers::BatchHandlers>(jwtManager_, router_, handlerPool_->get_executor()));
+
+        router_->setRateLimiter(createRateLimiter());
+        router_->setLoadShedder(createLoadShedder());
+
+        // requests are answered at once while the database is down
+        router_->setAvailabilityProbe([dbManager = dbManager_](std::chrono::seconds& retryAfter)
+        {
+            if (dbManager->isAvailable())
+            {
+                return true;
+            }
+
+            retryAfter = std::max(std::chrono::ceil<std::chrono::seconds>(dbManager->getReconnectDelay()), std::chrono::seconds{ 1 });
+            return false;
+        });
 
         LOG_INFO("Router initialized with " + std::to_string(router_->getRegisteredPaths().size()) + " routes");
 
@@ -181,7 +255,14 @@ void Server::initializeListener()
 
         LOG_INFO("Listener initializing on " + endpoint->address().to_string() + ":" + std::to_string(endpoint->port()));
 
-        listener_ = std::make_shared<Listener>(ioc_, std::move(sslContext_), std::move(endpoint), std::move(router_));
+        const std::filesystem::path unixSocketPath{ config_->getServerUnixSocketPath() };
+        if (!unixSocketPath.empty())
+        {
+            LOG_INFO("Listener also initializing on Unix socket " + unixSocketPath.string());
+        }
+
+        listener_ = std::make_shared<Listener>(ioc_, std::move(sslContext_), std::move(endpoint), std::move(router_), createSessionSettings(),
+            unixSocketPath, config_->getServerUnixSocketPermissions(), createConnectionLimits(), handlerPool_->get_executor());
     }
     catch (const std::exception& e) 
     {
@@ -190,6 +271,45 @@ void Server::initializeListener()
     }
 }
 
+std::shared_ptr<const SessionSettings> Server::createSessionSettings() const
+{
+    auto settings{ std::make_shared<SessionSettings>() };
+    settings->isCompressionEnabled = config_->getHttpCompressionEnabled();
+    settings->compressionMinSize = config_->getHttpCompressionMinSize();
+    settings->compressionLevel = config_->getHttpCompressionLevel();
+    settings->maxRequestBodySize = config_->getHttpMaxRequestBodySize();
+    settings->maxAttachmentSize = config_->getAttachmentsMaxSize();
+    settings->http2MaxConcurrentStreams = config_->getHttp2MaxConcurrentStreams();
+    settings->http2InitialWindowSize = config_->getHttp2InitialWindowSize();
+    settings->isProxyProtocolEnabled = config_->getServerProxyProtocolEnabled();
+    settings->requestTimeout = std::chrono::milliseconds{ config_->getHttpRequestTimeout() };
+
+    if (settings->isProxyProtocolEnabled)
+    {
+        LOG_INFO("PROXY protocol enabled: client addresses are taken from the load balancer");
+    }
+
+    LOG_INFO("Response compression " + std::string{ settings->isCompressionEnabled ? "enabled (level " + std::to_string(settings->compressionLevel) +
+        ", min size " + std::to_string(settings->compressionMinSize) + " bytes)" : "disabled" });
+
+    return settings;
+}
+
+TlsSettings Server::createTlsSettings() const
+{
+    TlsSettings settings{};
+    settings.cipherList = config_->getSSLCipherList();
+    settings.cipherSuites = config_->getSSLCipherSuites();
+    settings.groups = config_->getSSLGroups();
+    settings.sessionCacheSize = config_->getSSLSessionCacheSize();
+    settings.sessionTimeout = std::chrono::seconds{ config_->getSSLSessionTimeout() };
+    settings.isSessionTicketsEnabled = config_->getSSLSessionTicketsEnabled();
+    settings.ticketKeyRotationInterval = std::chrono::minutes{ config_->getSSLTicketKeyRotationMinutes() };
+    settings.isKernelTlsEnabled = config_->getSSLKernelTlsEnabled();
+    settings.alpnProtocols = config_->getHttp2Enabled() ? std::vector<std::string>{ "h2", "http/1.1" } : std::vector<std::string>{ "http/1.1" };
+    return settings;
+}
+
 void Server::gracefulShutdown() noexcept
 {
     LOG_INFO("Stopping listener...");
@@ -224,6 +344,11 @@ void Server::gracefulShutdown() noexcept
     }
     threads_.clear();
 
+    // handlers still queued have no connection left to answer to
+    LOG_INFO("Waiting for handler threads to finish...");
+    handlerPool_->stop();
+    handlerPool_->join();
+
     isRunning_ = false;
     
     LOG_INFO("Server shutdown completed" + std::string{ graceful ? " gracefully" : " forcefully" });
@@ -251,4 +376,79 @@ bool Server::waitForGracefulShutdown() const noexcept
 
     return false;
 }
+
+ConnectionLimits Server::createConnectionLimits() const
+{
+    ConnectionLimits limits{};
+    limits.maxConnections = config_->getServerMaxConnections();
+    limits.maxConnectionsPerAddress = config_->getServerMaxConnectionsPerIp();
+    limits.acceptRate = config_->getServerAcceptRate();
+    limits.acceptBurst = config_->getServerAcceptBurst();
+
+    // behind a load balancer every connection comes from its address
+    if (config_->getServerProxyProtocolEnabled() && limits.maxConnectionsPerAddress != 0)
+    {
+        LOG_INFO("Per-IP connection limit disabled: connections come from the load balancer");
+        limits.maxConnectionsPerAddress = 0;
+    }
+
+    LOG_INFO("Connection limits: " + (limits.maxConnections != 0 ? std::to_string(limits.maxConnections) : std::string{ "unlimited" }) +
+        " total, " + (limits.maxConnectionsPerAddress != 0 ? std::to_string(limits.maxConnectionsPerAddress) : std::string{ "unlimited" }) +
+        " per IP, accept rate " + (limits.acceptRate != 0 ? std::to_string(limits.acceptRate) + "/s (burst " + std::to_string(limits.acceptBurst) + ")" : std::string{ "unlimited" }));
+
+    return limits;
+}
+
+std::shared_ptr<RateLimiter> Server::createRateLimiter() const
+{
+    RateLimitSettings settings{};
+    settings.maxBuckets = config_->getRateLimitMaxBuckets();
+
+    for (const auto& route : config_->getRateLimitRoutes())
+    {
+        settings.rules.push_back(RateLimitRule{ route.path, route.userRate, route.userBurst, route.ipRate, route.ipBurst });
+        LOG_INFO(std::format("Rate limit on {}: {}/s per user (burst {}), {}/s per IP (burst {})", route.path, route.userRate, route.userBurst, route.ipRate, route.ipBurst));
+    }
+
+    if (settings.rules.empty())
+    {
+        return nullptr;
+    }
+
+    // only verified access tokens identify a user; the result is cached by the JWT manager
+    return std::make_shared<RateLimiter>(std::move(settings), [jwtManager = jwtManager_](const std::string& token) -> std::string
+    {
+        try
+        {
+            const auto payload{ jwtManager->verifyAndDecode(token) };
+            return payload.isValid && payload.isAccessToken() ? payload.userID : std::string{};
+        }
+        catch (const std::exception&)
+        {
+            return {};
+        }
+    });
+}
+
+std::shared_ptr<LoadShedder> Server::createLoadShedder() const
+{
+    if (!config_->getLoadSheddingEnabled())
+    {
+        return nullptr;
+    }
+
+    LoadShedSettings settings{};
+    settings.maxQueueDepth = config_->getLoadSheddingMaxQueueDepth();
+    settings.lowPriorityRoutes = config_->getLoadSheddingLowPriorityRoutes();
+    settings.lowPriorityShare = config_->getLoadSheddingLowPriorityShare();
+
+    LOG_INFO(std::format("Load shedding enabled: max queue depth {}, {} low priority routes at {:.0f}%",
+        settings.maxQueueDepth, settings.lowPriorityRoutes.size(), settings.lowPriorityShare * 100.0));
+
+    return std::make_shared<LoadShedder>(std::move(settings), [dbManager = dbManager_]()
+    {
+        const auto statistics{ dbManager->getPoolStatistics() };
+        return LoadSample{ database::DatabaseManager::estimateWait(statistics), statistics.waitingQueries };
+    });
+}
 }
@@ -5,12 +5,14 @@
 #include <vector>
 #include <thread>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/asio/ssl.hpp>
 #include "../config/ConfigManager.h"
 #include "../database/DatabaseManager.h"
 #include "../auth/JWTManager.h"
 #include "Listener.h"
 #include "Router.h"
+#include "TlsSessionManager.h"
 
 namespace server
 {
@@ -89,12 +91,41 @@ public:
      */
     [[nodiscard]] bool isRunning() const noexcept;
 
+    /**
+     * @brief Gets the TLS handshake and session resumption counters
+     * @return TlsStatistics Snapshot of the counters
+     */
+    [[nodiscard]] TlsStatistics getTlsStatistics() const noexcept;
+
+    /**
+     * @brief Gets the connection admission counters
+     * @return ConnectionStatistics Snapshot of the counters
+     */
+    [[nodiscard]] ConnectionStatistics getConnectionStatistics() const noexcept;
+
+    /**
+     * @brief Gets the state of the database concurrency limit
+     * @return database::ConcurrencyStatistics Current limit and the query times it is based on
+     */
+    [[nodiscard]] database::ConcurrencyStatistics getDatabaseConcurrencyStatistics() const noexcept;
+
 private:
     /**
-     * @brief Initializes SSL/TLS context with certificates and security settings
+     * @brief Creates the I/O context of the server
+     * @param threadCount Number of threads that will run the context
+     * @return std::shared_ptr<boost::asio::io_context> I/O context
+     * @throws std::runtime_error if the server is built for io_uring and the kernel does not provide it
+     * @note Asio picks its I/O backend at compile time, so an io_uring build cannot fall back to epoll
+     */
+    [[nodiscard]] static std::shared_ptr<boost::asio::io_context> createIoContext(int threadCount);
+
+    /**
+     * @brief Initializes SSL/TLS context with certificates, security and session resumption settings
      * @throws std::runtime_error if SSL configuration fails
+     * @note Leaves no SSL context when TLS is disabled in the configuration
+     * @see TlsSessionManager
      */
-    void initializeSSL() const;
+    void initializeSSL();
 
     /**
      * @brief Initializes request router and registers all HTTP handlers
@@ -111,6 +142,36 @@ private:
      */
     void initializeListener();
 
+    /**
+     * @brief Creates the HTTP settings shared by all sessions from the configuration
+     * @return std::shared_ptr<const SessionSettings> Session settings
+     */
+    [[nodiscard]] std::shared_ptr<const SessionSettings> createSessionSettings() const;
+
+    /**
+     * @brief Creates the TLS protocol, cipher and session resumption settings from the configuration
+     * @return TlsSettings TLS settings
+     */
+    [[nodiscard]] TlsSettings createTlsSettings() const;
+
+    /**
+     * @brief Creates the connection admission limits from the configuration
+     * @return ConnectionLimits Connection limits
+     */
+    [[nodiscard]] ConnectionLimits createConnectionLimits() const;
+
+    /**
+     * @brief Creates the request rate limiter from the configuration
+     * @return std::shared_ptr<RateLimiter> Rate limiter, or nullptr if no route is limited
+     */
+    [[nodiscard]] std::shared_ptr<RateLimiter> createRateLimiter() const;
+
+    /**
+     * @brief Creates the load shedder from the configuration
+     * @return std::shared_ptr<LoadShedder> Load shedder fed by the database pool, or nullptr if load shedding is disabled
+     */
+    [[nodiscard]] std::shared_ptr<LoadShedder> createLoadShedder() const;
+
     /**
      * @brief Performs graceful shutdown sequence
      * @note Stops listener, waits for active connections, stops I/O context
@@ -130,8 +191,10 @@ private:
 
     std::shared_ptr<boost::asio::io_context> ioc_;           ///< I/O context for asynchronous operations
     boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_; ///< Work guard to keep I/O context active
+    std::unique_ptr<boost::asio::thread_pool> handlerPool_;  ///< Threads that run request handlers off the I/O threads
 
-    std::shared_ptr<boost::asio::ssl::context> sslContext_; ///< SSL context for secure connections
+    std::shared_ptr<boost::asio::ssl::context> sslContext_; ///< SSL context for secure connections, null when TLS is disabled
+    std::unique_ptr<TlsSessionManager> tlsSessionManager_;  ///< TLS session resumption and handshake counters
 
     std::vector<std::jthread> threads_;                     ///< Worker threads for handling I/O operations
 
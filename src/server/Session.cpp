@@ -1,5 +1,12 @@
 #include "Session.h"
-#include <nlohmann/json.hpp>
+#include "Http2Session.h"
+#include "RequestProcessor.h"
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <boost/algorithm/string.hpp>
+#include "../utils/Deadline.h"
 #include "../utils/Logger.h"
 
 // additional option /bigobj
@@ -18,13 +25,16 @@ constexpr std::chrono::seconds TIMEOUT_SHUTDOWN{ 5 };
 
 constexpr size_t MAX_BUFFER_SIZE{ 8192 };
 
-Session::Session(boost::asio::ip::tcp::socket socket, boost::asio::ssl::context& ssl_context, std::shared_ptr<Router> router) :
-    stream_{ std::move(socket), ssl_context },
+Session::Session(boost::asio::generic::stream_protocol::socket socket, boost::asio::ssl::context* ssl_context, std::shared_ptr<Router> router, std::shared_ptr<const SessionSettings> settings,
+    std::shared_ptr<TimerWheel> timerWheel, boost::asio::any_io_executor handlerExecutor, ConnectionPermit permit) :
+    stream_{ ssl_context ? std::make_unique<TlsStream>(std::move(socket), *ssl_context) : std::make_unique<TlsStream>(std::move(socket)) },
     router_{ std::move(router) },
-    deadline_{ stream_.get_executor() }
+    settings_{ std::move(settings) },
+    timerWheel_{ std::move(timerWheel) },
+    handlerExecutor_{ std::move(handlerExecutor) },
+    permit_{ std::move(permit) }
 {
     buffer_.reserve(MAX_BUFFER_SIZE);
-    deadline_.expires_at(std::chrono::steady_clock::time_point::max());
 }
 
 void Session::start()
@@ -37,16 +47,28 @@ void Session::start()
 
     isRunning_ = true;
 
-    checkDeadline();
+    // the timer does not keep the session alive, pending operations on the stream do
+    deadline_ = timerWheel_->createTimer(stream_->get_executor(), [weakSelf = weak_from_this()]()
+    {
+        if (const auto self{ weakSelf.lock() })
+        {
+            self->onDeadline();
+        }
+    });
 
-    // setting a timeout on a handshake
-    deadline_.expires_after(std::chrono::seconds(TIMEOUT_HANDSHAKE));
+    // setting a timeout on a handshake, which includes the PROXY header
+    deadline_->expiresAfter(TIMEOUT_HANDSHAKE);
 
-    stream_.async_handshake(
-        boost::asio::ssl::stream_base::server,
-        boost::beast::bind_front_handler(
-            &Session::onHandshake,
-            shared_from_this()));
+    if (settings_->isProxyProtocolEnabled)
+    {
+        stream_->async_read_proxy_header(
+            boost::beast::bind_front_handler(
+                &Session::onProxyHeader,
+                shared_from_this()));
+        return;
+    }
+
+    doHandshake();
 }
 
 void Session::stop() noexcept
@@ -58,12 +80,39 @@ void Session::stop() noexcept
 
     isRunning_ = false;
 
-    stream_.next_layer().cancel();
-    deadline_.cancel();
+    stream_->next_layer().cancel();
+    deadline_->cancel();
 
     LOG_INFO("Session stopped");
 }
 
+void Session::onProxyHeader(const boost::beast::error_code& ec)
+{
+    if (ec)
+    {
+        if (ec != boost::asio::error::operation_aborted)
+        {
+            LOG_ERROR("PROXY protocol header rejected: " + ec.message());
+        }
+
+        // nothing can be answered before the client is known
+        stream_->next_layer().close();
+        isRunning_ = false;
+        deadline_->cancel();
+        return;
+    }
+
+    doHandshake();
+}
+
+void Session::doHandshake()
+{
+    stream_->async_handshake(
+        boost::beast::bind_front_handler(
+            &Session::onHandshake,
+            shared_from_this()));
+}
+
 void Session::onHandshake(const boost::beast::error_code& ec)
 {
     if (ec) 
@@ -76,7 +125,19 @@ void Session::onHandshake(const boost::beast::error_code& ec)
         return;
     }
 
-    LOG_DEBUG("SSL handshake completed for client: " + getClientIP());
+    LOG_DEBUG(std::string{ stream_->isEncrypted() ? "SSL handshake completed" : "Plaintext connection" } + " for client: " + getClientIP() + (stream_->isKernelSendEnabled() ? " (kernel TLS)" : "") +
+        (stream_->getAlpnProtocol().empty() ? "" : ", protocol " + std::string{ stream_->getAlpnProtocol() }));
+
+    if (stream_->getAlpnProtocol() == Http2Session::ALPN_PROTOCOL)
+    {
+        // the connection continues as HTTP/2: this session only releases its timer
+        isRunning_ = false;
+        deadline_->cancel();
+
+        std::make_shared<Http2Session>(std::move(stream_), router_, settings_, timerWheel_, handlerExecutor_, std::move(permit_))->start();
+        return;
+    }
+
     doRead();
 }
 
@@ -86,73 +147,272 @@ void Session::doRead()
     request_ = {};
     buffer_.consume(buffer_.size());
 
+    bodyParser_.reset();
+    uploadParser_.reset();
+    headerParser_.emplace();
+
     // setting a timeout on reading
-    deadline_.expires_after(std::chrono::seconds(TIMEOUT_READ_WRITE));
+    deadline_->expiresAfter(TIMEOUT_READ_WRITE);
 
-    boost::beast::http::async_read(
-        stream_,
+    boost::beast::http::async_read_header(
+        *stream_,
         buffer_,
-        request_,
+        *headerParser_,
         boost::beast::bind_front_handler(
-            &Session::onRead,
+            &Session::onReadHeader,
             shared_from_this()));
 }
 
-void Session::onRead(const boost::beast::error_code& ec, std::size_t bytesTransferred)
+void Session::onReadHeader(const boost::beast::error_code& ec, std::size_t bytesTransferred)
 {
     if (ec) 
     {
-        if (ec != boost::beast::http::error::end_of_stream && ec != boost::asio::error::operation_aborted) 
+        onRead(ec, bytesTransferred);
+        return;
+    }
+
+    // the handler decides on the header alone whether the body goes to a file
+    request_ = boost::beast::http::request<boost::beast::http::string_body>{ headerParser_->get().base() };
+    RequestProcessor::logRequest(getClientIP(), request_);
+
+    if (request_.method() == boost::beast::http::verb::post)
+    {
+        if (auto handler{ router_->findHandler(request_) }; handler && handler->isUploadRequest(request_))
         {
-            LOG_ERROR("Read error: " + ec.message());
+            doReadUpload(std::move(handler));
+            return;
         }
+    }
 
-        doClose();
+    bodyParser_.emplace(std::move(*headerParser_));
+    bodyParser_->body_limit(settings_->maxRequestBodySize);
+
+    auto self{ shared_from_this() };
+
+    boost::beast::http::async_read(
+        *stream_,
+        buffer_,
+        *bodyParser_,
+        [self](const boost::beast::error_code& ec, std::size_t bytesTransferred)
+    {
+        if (!ec)
+        {
+            self->request_ = self->bodyParser_->release();
+        }
+
+        self->onRead(ec, bytesTransferred);
+    });
+}
+
+void Session::doReadUpload(std::shared_ptr<handlers::IHandler> handler)
+{
+    std::filesystem::path bodyFile{};
+    auto error{ RequestProcessor::checkRateLimit(request_, *router_, getClientIP()) };
+    if (!error)
+    {
+        error = RequestProcessor::checkLoad(request_, *router_, utils::Deadline{ settings_->requestTimeout });
+    }
+
+    if (!error)
+    {
+        error = handler->processUploadHeader(request_, bodyFile);
+    }
+
+    if (error)
+    {
+        response_ = std::make_shared<boost::beast::http::response<boost::beast::http::string_body>>(std::move(*error));
+        doWriteAndClose();
         return;
     }
 
-    logRequest(request_);
+    uploadParser_.emplace(std::move(*headerParser_));
+    uploadParser_->body_limit(settings_->maxAttachmentSize);
 
-    try 
+    boost::beast::error_code ec{};
+    uploadParser_->get().body().open(bodyFile.string().c_str(), boost::beast::file_mode::write, ec);
+    if (ec)
+    {
+        LOG_ERROR("Failed to open upload file " + bodyFile.string() + ": " + ec.message());
+        createErrorResponse(boost::beast::http::status::internal_server_error, "INTERNAL_ERROR", "Internal server error");
+        doWriteAndClose();
+        return;
+    }
+
+    uploadHandler_ = std::move(handler);
+    uploadFile_ = std::move(bodyFile);
+
+    // clients that wait for the interim response before sending a large body
+    if (boost::algorithm::iequals(std::string{ request_[boost::beast::http::field::expect] }, "100-continue"))
+    {
+        auto interim{ std::make_shared<boost::beast::http::response<boost::beast::http::empty_body>>(boost::beast::http::status::continue_, request_.version()) };
+
+        boost::beast::http::async_write(
+            *stream_,
+            *interim,
+            [self = shared_from_this(), interim](const boost::beast::error_code& ec, std::size_t bytesTransferred)
+        {
+            if (ec)
+            {
+                self->onReadUpload(ec, bytesTransferred);
+                return;
+            }
+
+            self->doReadUploadBody();
+        });
+
+        return;
+    }
+
+    doReadUploadBody();
+}
+
+void Session::doReadUploadBody()
+{
+    deadline_->expiresAfter(TIMEOUT_READ_WRITE);
+
+    boost::beast::http::async_read_some(
+        *stream_,
+        buffer_,
+        *uploadParser_,
+        boost::beast::bind_front_handler(
+            &Session::onReadUpload,
+            shared_from_this()));
+}
+
+void Session::onReadUpload(const boost::beast::error_code& ec, std::size_t)
+{
+    if (!ec && !uploadParser_->is_done())
+    {
+        doReadUploadBody();
+        return;
+    }
+
+    // writes submitted to io_uring report their errors when the file is closed
+    boost::beast::error_code closeEc{};
+    uploadParser_->get().body().file().close(closeEc);
+
+    if (!ec && closeEc)
     {
-	    if (const auto handler{ router_->findHandler(request_) })
-	    {
-            response_ = std::make_shared<boost::beast::http::response<boost::beast::http::string_body>>(handler->handleRequest(request_));
+        LOG_ERROR("Failed to write upload file " + uploadFile_.string() + ": " + closeEc.message());
+        removeUploadFile();
+        uploadHandler_.reset();
+        createErrorResponse(boost::beast::http::status::internal_server_error, "INTERNAL_ERROR", "Internal server error");
+        doWriteAndClose();
+        return;
+    }
+
+    if (ec)
+    {
+        removeUploadFile();
+        uploadHandler_.reset();
+
+        if (ec == boost::beast::http::error::body_limit)
+        {
+            createErrorResponse(boost::beast::http::status::payload_too_large, "ATTACHMENT_TOO_LARGE",
+                "Attachment exceeds maximum size of " + std::to_string(settings_->maxAttachmentSize) + " bytes");
+            doWriteAndClose();
+            return;
         }
-        else
+
+        if (ec != boost::beast::http::error::end_of_stream && ec != boost::asio::error::operation_aborted)
         {
-            response_ = std::make_shared<boost::beast::http::response<boost::beast::http::string_body>>(router_->handleNotFound(request_));
+            LOG_ERROR("Upload read error: " + ec.message());
         }
+
+        doClose();
+        return;
     }
-    catch (const std::exception& e) 
+
+    // the time budget covers storing the upload, not its transfer
+    const utils::Deadline deadline{ settings_->requestTimeout };
+    {
+        const utils::DeadlineScope deadlineScope{ deadline };
+        response_ = std::make_shared<boost::beast::http::response<boost::beast::http::string_body>>(uploadHandler_->processUpload(request_, uploadFile_));
+    }
+
+    // the handler moves the file into the store on success
+    removeUploadFile();
+    uploadHandler_.reset();
+    uploadParser_.reset();
+
+    RequestProcessor::logResponse(getClientIP(), *response_);
+    RequestProcessor::encodeResponseBody(request_, *response_, *settings_);
+    doWrite();
+}
+
+void Session::removeUploadFile() noexcept
+{
+    if (uploadFile_.empty())
+    {
+        return;
+    }
+
+    std::error_code ec{};
+    std::filesystem::remove(uploadFile_, ec);
+    uploadFile_.clear();
+}
+
+void Session::doWriteAndClose()
+{
+    // the rest of the request body is never read, so the connection cannot be reused
+    response_->keep_alive(false);
+    response_->version(request_.version());
+
+    RequestProcessor::logResponse(getClientIP(), *response_);
+    doWrite();
+}
+
+void Session::onRead(const boost::beast::error_code& ec, std::size_t bytesTransferred)
+{
+    if (ec == boost::beast::http::error::body_limit)
+    {
+        createErrorResponse(boost::beast::http::status::payload_too_large, "PAYLOAD_TOO_LARGE",
+            "Request body exceeds maximum size of " + std::to_string(settings_->maxRequestBodySize) + " bytes");
+        doWriteAndClose();
+        return;
+    }
+
+    if (ec) 
     {
-        LOG_ERROR("Error handling request: " + std::string{ e.what() });
+        if (ec != boost::beast::http::error::end_of_stream && ec != boost::asio::error::operation_aborted) 
+        {
+            LOG_ERROR("Read error: " + ec.message());
+        }
+
+        doClose();
+        return;
+    }
+
+    response_ = std::make_shared<boost::beast::http::response<boost::beast::http::string_body>>(RequestProcessor::process(request_, *router_, *settings_, getClientIP(),
+        utils::Deadline{ settings_->requestTimeout }, responseStream_));
 
-        nlohmann::json error_json{};
-        error_json["status"] = "error";
-        error_json["code"] = "INTERNAL_ERROR";
-        error_json["message"] = "Internal server error";
+    RequestProcessor::logResponse(getClientIP(), *response_);
 
-        response_ = std::make_shared<boost::beast::http::response<boost::beast::http::string_body>>(boost::beast::http::status::internal_server_error, request_.version());
-        response_->set(boost::beast::http::field::content_type, "application/json");
-        response_->set(boost::beast::http::field::access_control_allow_origin, "*");
-        response_->body() = error_json.dump();
-        response_->prepare_payload();
+    if (responseStream_)
+    {
+        doWriteStreamHeader();
+        return;
     }
 
-    logResponse(*response_);
+    // compressing after logging keeps the access log readable
+    RequestProcessor::encodeResponseBody(request_, *response_, *settings_);
 
     doWrite();
 }
 
+void Session::createErrorResponse(boost::beast::http::status status, const std::string& code, const std::string& message)
+{
+    response_ = std::make_shared<boost::beast::http::response<boost::beast::http::string_body>>(RequestProcessor::createErrorResponse(request_, status, code, message));
+}
+
 void Session::doWrite()
 {
-    deadline_.expires_after(std::chrono::seconds(TIMEOUT_READ_WRITE));
+    deadline_->expiresAfter(TIMEOUT_READ_WRITE);
 
     auto self{ shared_from_this() };
 
     boost::beast::http::async_write(
-        stream_,
+        *stream_,
         *response_,
         [self](const boost::beast::error_code& ec, std::size_t bytesTransferred) 
     {
@@ -160,6 +420,171 @@ void Session::doWrite()
     });
 }
 
+void Session::doWriteStreamHeader()
+{
+    deadline_->expiresAfter(TIMEOUT_READ_WRITE);
+
+    response_->version(request_.version());
+    response_->keep_alive(request_.keep_alive());
+
+    if (const auto contentLength{ responseStream_->getContentLength() })
+    {
+        response_->chunked(false);
+        response_->content_length(*contentLength);
+    }
+    else
+    {
+        response_->chunked(true);
+    }
+
+    streamSerializer_ = std::make_unique<boost::beast::http::response_serializer<boost::beast::http::string_body>>(*response_);
+
+    boost::beast::http::async_write_header(
+        *stream_,
+        *streamSerializer_,
+        [self = shared_from_this()](const boost::beast::error_code& ec, std::size_t)
+    {
+#ifdef __linux__
+        if (!ec && self->doSendFile())
+        {
+            return;
+        }
+#endif
+
+        self->onWriteStream(ec);
+    });
+}
+
+void Session::onWriteStream(const boost::beast::error_code& ec)
+{
+    if (ec)
+    {
+        LOG_ERROR("Write error: " + ec.message());
+        responseStream_.reset();
+        streamSerializer_.reset();
+        return;
+    }
+
+    auto hasMore{ false };
+    try
+    {
+        hasMore = responseStream_->readNextChunk(streamChunk_);
+    }
+    catch (const std::exception& e)
+    {
+        // the header is already sent: closing before the end of the body lets the client detect the truncation
+        LOG_ERROR("Error streaming response: " + std::string{ e.what() });
+        responseStream_.reset();
+        streamSerializer_.reset();
+        doClose();
+        return;
+    }
+
+    deadline_->expiresAfter(TIMEOUT_READ_WRITE);
+
+    auto self{ shared_from_this() };
+
+    const auto isChunked{ response_->chunked() };
+
+    if (hasMore)
+    {
+        auto onChunkWritten{ [self](const boost::beast::error_code& ec, std::size_t)
+        {
+            self->onWriteStream(ec);
+        } };
+
+        if (isChunked)
+        {
+            boost::asio::async_write(*stream_, boost::beast::http::make_chunk(boost::asio::buffer(streamChunk_)), std::move(onChunkWritten));
+        }
+        else
+        {
+            boost::asio::async_write(*stream_, boost::asio::buffer(streamChunk_), std::move(onChunkWritten));
+        }
+
+        return;
+    }
+
+    auto onBodyWritten{ [self](const boost::beast::error_code& ec, std::size_t bytesTransferred)
+    {
+        self->responseStream_.reset();
+        self->streamSerializer_.reset();
+        self->streamChunk_ = {};
+
+        self->onWrite(ec, bytesTransferred, self->response_->need_eof());
+    } };
+
+    if (isChunked)
+    {
+        boost::asio::async_write(*stream_, boost::beast::http::make_chunk_last(), std::move(onBodyWritten));
+        return;
+    }
+
+    // a body of known length ends with its last byte
+    onBodyWritten({}, 0);
+}
+
+#ifdef __linux__
+bool Session::doSendFile()
+{
+    if (response_->chunked() || !stream_->isSendFileAvailable())
+    {
+        return false;
+    }
+
+    const auto region{ responseStream_->getFileRegion() };
+    if (!region)
+    {
+        return false;
+    }
+
+    const auto fileDescriptor{ ::open(region->path.c_str(), O_RDONLY | O_CLOEXEC) };
+    if (fileDescriptor < 0)
+    {
+        // the stream reads the file itself and reports the error
+        return false;
+    }
+
+    sendFileRegion(fileDescriptor, region->offset, region->length);
+    return true;
+}
+
+void Session::sendFileRegion(int fileDescriptor, std::uint64_t offset, std::uint64_t remaining)
+{
+    if (remaining == 0)
+    {
+        ::close(fileDescriptor);
+        responseStream_.reset();
+        streamSerializer_.reset();
+
+        onWrite({}, 0, response_->need_eof());
+        return;
+    }
+
+    deadline_->expiresAfter(TIMEOUT_READ_WRITE);
+
+    stream_->async_sendfile(
+        fileDescriptor,
+        offset,
+        static_cast<size_t>(remaining),
+        [self = shared_from_this(), fileDescriptor, offset, remaining](const boost::beast::error_code& ec, std::size_t bytesTransferred)
+    {
+        if (ec || bytesTransferred == 0)
+        {
+            // the header is already sent: closing before the end of the body lets the client detect the truncation
+            LOG_ERROR("Sendfile error: " + (ec ? ec.message() : std::string{ "file is shorter than the requested range" }));
+            ::close(fileDescriptor);
+            self->responseStream_.reset();
+            self->streamSerializer_.reset();
+            self->doClose();
+            return;
+        }
+
+        self->sendFileRegion(fileDescriptor, offset + bytesTransferred, remaining - bytesTransferred);
+    });
+}
+#endif
+
 void Session::onWrite(const boost::beast::error_code& ec, std::size_t bytesTransferred, bool isClose)
 {
     if (ec) 
@@ -178,28 +603,20 @@ void Session::onWrite(const boost::beast::error_code& ec, std::size_t bytesTrans
     doRead();
 }
 
-void Session::checkDeadline()
+void Session::onDeadline()
 {
-    if (!isRunning_)
-    {
-        return;
-    }
-
-    if (deadline_.expiry() <= std::chrono::steady_clock::now()) 
+    if (isRunning_)
     {
         LOG_DEBUG("Session timeout for client: " + getClientIP());
         doClose();
         return;
     }
 
-    deadline_.async_wait(
-        [self = shared_from_this()](const boost::beast::error_code& ec) 
+    // the shutdown of the connection did not finish in time
+    if (stream_)
     {
-        if (!ec) 
-        {
-            self->checkDeadline();
-        }
-    });
+        stream_->next_layer().close();
+    }
 }
 
 void Session::doClose()
@@ -211,11 +628,11 @@ void Session::doClose()
 
     isRunning_ = false;
 
-    deadline_.expires_after(std::chrono::seconds(TIMEOUT_SHUTDOWN));
+    deadline_->expiresAfter(TIMEOUT_SHUTDOWN);
 
     auto self{ shared_from_this() };
 
-    stream_.async_shutdown(
+    stream_->async_shutdown(
         [self](const boost::beast::error_code& ec) 
     {
         if (ec && ec != boost::asio::error::eof && ec != boost::asio::ssl::error::stream_truncated) 
@@ -223,53 +640,18 @@ void Session::doClose()
             LOG_ERROR("SSL shutdown error: " + ec.message());
         }
 
-        self->stream_.next_layer().close();
-        self->deadline_.cancel();
+        self->stream_->next_layer().close();
+        self->deadline_->cancel();
 
         LOG_DEBUG("Session closed for client: " + self->getClientIP());
     });
 }
 
-void Session::logRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) const
-{
-    const auto clientIP{ getClientIP() };
-    const auto method{ request.method_string() };
-    const auto target{ request.target() };
-
-    std::stringstream logEntry{};
-    logEntry << clientIP << " - - ["
-        << std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count()
-        << "] \"" << method << " " << target << " HTTP/"
-        << (request.version() / 10) << "." << (request.version() % 10) << "\"";
-
-    LOG_ACCESS(logEntry.str());
-
-    LOG_DEBUG(std::format("Request from {}: {} {}", clientIP, method, target));
-}
-
-void Session::logResponse(const boost::beast::http::response<boost::beast::http::string_body>& response) const
-{
-    const auto clientIP{ getClientIP() };
-    const auto statusCode{ response.result_int() };
-
-    std::stringstream log_entry{};
-    log_entry << " " << statusCode << " " << response.body();
-
-    LOG_ACCESS(log_entry.str());
-
-    LOG_DEBUG("Response to " + clientIP + ": " + response.body());
-}
-
 std::string Session::getClientIP() const
 {
     try 
     {
-        boost::beast::error_code ec{};
-        const auto endpoint{ stream_.next_layer().socket().remote_endpoint(ec) };
-        if (!ec) 
-        {
-            return endpoint.address().to_string();
-        }
+        return stream_->getRemoteAddress();
     }
     catch (const std::exception& e) 
     {
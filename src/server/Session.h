@@ -1,10 +1,17 @@
 ﻿#ifndef SESSION_H
 #define SESSION_H
 
+#include <filesystem>
 #include <memory>
+#include <optional>
 #include <boost/beast.hpp>
 #include <boost/beast/ssl.hpp>
+#include "ConnectionLimiter.h"
 #include "Router.h"
+#include "SessionSettings.h"
+#include "TimerWheel.h"
+#include "TlsStream.h"
+#include "UploadFile.h"
 
 namespace server
 {
@@ -12,29 +19,37 @@ namespace server
  * @class Session
  * @brief Manages a single SSL/TLS connection session with a client
  *
- * Handles the complete lifecycle of an HTTP connection over SSL/TLS,
- * including handshake, request reading, response writing, and timeout management.
+ * Handles the complete lifecycle of an HTTP connection over SSL/TLS, or over plaintext
+ * behind a TLS-terminating load balancer, including the optional PROXY protocol header,
+ * handshake, request reading, response writing, and timeout management.
  * Implements asynchronous operations using Boost.Beast and Boost.Asio.
+ * Connections that negotiate HTTP/2 are handed over to an Http2Session after the handshake.
  *
  * @note Each Session instance is owned by a shared_ptr and manages its own lifetime
  * @warning Timeouts are enforced for handshake, read, write, and shutdown operations
  * @see Listener
  * @see Router
+ * @see Http2Session
  */
 class Session final : public std::enable_shared_from_this<Session>
 {
 public:
     /**
      * @brief Constructs a Session instance with a connected TCP socket
-     * @param socket Connected TCP socket (moved into the session)
-     * @param ssl_context SSL context for secure connection establishment
+     * @param socket Connected TCP or Unix domain socket (moved into the session)
+     * @param ssl_context SSL context for secure connection establishment, or nullptr for plaintext HTTP
      * @param router Shared pointer to request router for HTTP handling
+     * @param settings Shared pointer to HTTP settings (compression, body limits)
+     * @param timerWheel Timer wheel of the I/O context, drives the connection timeouts
+     * @param handlerExecutor Executor that runs the handlers of HTTP/2 streams concurrently
+     * @param permit Admission of the connection by the listener, released when the connection closes
      */
-    Session(boost::asio::ip::tcp::socket socket, boost::asio::ssl::context& ssl_context, std::shared_ptr<Router> router);
+    Session(boost::asio::generic::stream_protocol::socket socket, boost::asio::ssl::context* ssl_context, std::shared_ptr<Router> router, std::shared_ptr<const SessionSettings> settings,
+        std::shared_ptr<TimerWheel> timerWheel, boost::asio::any_io_executor handlerExecutor, ConnectionPermit permit);
 
     /**
      * @brief Starts the session by initiating SSL handshake
-     * @note Begins the asynchronous operation chain (handshake → read → write)
+     * @note Begins the asynchronous operation chain (PROXY header → handshake → read → write)
      */
     void start();
 
@@ -45,9 +60,23 @@ public:
     void stop() noexcept;
 
 private:
+    /**
+     * @brief Callback handler for a read PROXY protocol header; starts the handshake
+     * @param ec Error code from read operation
+     * @note Connections without a valid header are closed without a response
+     */
+    void onProxyHeader(const boost::beast::error_code& ec);
+
+    /**
+     * @brief Initiates the SSL handshake
+     * @note Completes at once for plaintext connections
+     */
+    void doHandshake();
+
     /**
      * @brief Callback handler for SSL handshake completion
      * @param ec Error code from handshake operation
+     * @note Hands the connection over to an Http2Session if the client negotiated h2 via ALPN
      */
     void onHandshake(const boost::beast::error_code& ec);
 
@@ -56,6 +85,45 @@ private:
      */
     void doRead();
 
+    /**
+     * @brief Callback handler for a read request header; starts reading the body
+     * @param ec Error code from read operation
+     * @param bytesTransferred Number of bytes read
+     * @note Upload bodies are written to a file, all other bodies are read into memory
+     */
+    void onReadHeader(const boost::beast::error_code& ec, std::size_t bytesTransferred);
+
+    /**
+     * @brief Starts receiving an upload body into the file provided by the handler
+     * @param handler Handler of the upload request
+     * @note Responds without reading the body and closes the connection if the handler rejects the upload
+     */
+    void doReadUpload(std::shared_ptr<handlers::IHandler> handler);
+
+    /**
+     * @brief Reads the next part of an upload body
+     * @note The read timeout is restarted on every part, so large uploads only time out when stalled
+     */
+    void doReadUploadBody();
+
+    /**
+     * @brief Callback handler for a read part of an upload body
+     * @param ec Error code from read operation
+     * @param bytesTransferred Number of bytes read
+     */
+    void onReadUpload(const boost::beast::error_code& ec, std::size_t bytesTransferred);
+
+    /**
+     * @brief Removes the file of the current upload if it still exists
+     */
+    void removeUploadFile() noexcept;
+
+    /**
+     * @brief Writes response_ and closes the connection afterwards
+     * @note Used when the request body has not been read completely
+     */
+    void doWriteAndClose();
+
     /**
      * @brief Callback handler for completed read operation
      * @param ec Error code from read operation
@@ -63,57 +131,98 @@ private:
      */
     void onRead(const boost::beast::error_code& ec, std::size_t bytesTransferred);
 
+    /**
+     * @brief Creates a JSON error response in response_
+     * @param status HTTP status code
+     * @param code Machine-readable error code
+     * @param message Human-readable error message
+     */
+    void createErrorResponse(boost::beast::http::status status, const std::string& code, const std::string& message);
+
     /**
      * @brief Initiates asynchronous HTTP response writing
      */
     void doWrite();
 
     /**
-     * @brief Callback handler for completed write operation
+     * @brief Writes the header of a streaming response
+     * @note Bodies of known length are sent with Content-Length, others with chunked transfer encoding;
+     *       the body is then written part by part by onWriteStream
+     */
+    void doWriteStreamHeader();
+
+    /**
+     * @brief Callback handler for a written stream header or chunk; writes the next chunk
      * @param ec Error code from write operation
-     * @param bytesTransferred Number of bytes written
-     * @param isClose Flag indicating if connection should be closed after write
+     * @note Produces the next chunk only after the previous one has been written,
+     *       so at most one chunk is held in memory
      */
-    void onWrite(const boost::beast::error_code& ec, std::size_t bytesTransferred, bool isClose);
+    void onWriteStream(const boost::beast::error_code& ec);
 
+#ifdef __linux__
     /**
-     * @brief Checks deadline timer and closes session on timeout
-     * @note Recursively reschedules itself to maintain timeout checking
+     * @brief Starts sending the body of a streaming response with sendfile
+     * @return bool True if the body is being sent, false if it must be written chunk by chunk
+     * @note Only bodies that are a plain file region, have a known length and go over
+     *       a connection with kernel TLS are sent this way
      */
-    void checkDeadline();
+    [[nodiscard]] bool doSendFile();
 
     /**
-     * @gracefully closes the SSL connection and TCP socket
+     * @brief Sends the rest of a file region and then completes the response
+     * @param fileDescriptor Open file, closed once the region is sent or on error
+     * @param offset Offset of the next byte to send
+     * @param remaining Number of bytes still to send
      */
-    void doClose();
+    void sendFileRegion(int fileDescriptor, std::uint64_t offset, std::uint64_t remaining);
+#endif
 
     /**
-     * @brief Logs incoming HTTP request details
-     * @param request HTTP request to log
+     * @brief Callback handler for completed write operation
+     * @param ec Error code from write operation
+     * @param bytesTransferred Number of bytes written
+     * @param isClose Flag indicating if connection should be closed after write
      */
-    void logRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) const;
+    void onWrite(const boost::beast::error_code& ec, std::size_t bytesTransferred, bool isClose);
 
     /**
-     * @brief Logs outgoing HTTP response details
-     * @param response HTTP response to log
+     * @brief Handler of an expired deadline; closes the session, or the socket if closing takes too long
      */
-    void logResponse(const boost::beast::http::response<boost::beast::http::string_body>& response) const;
+    void onDeadline();
+
+    /**
+     * @gracefully closes the SSL connection and TCP socket
+     */
+    void doClose();
 
     /**
      * @brief Retrieves client IP address for logging
-     * @return std::string Client IP address or "unknown" on error
+     * @return std::string Client IP address, as sent in the PROXY header if any, or "unknown" on error
      */
     [[nodiscard]] std::string getClientIP() const;
 
 private:
-    boost::beast::ssl_stream<boost::beast::tcp_stream> stream_; ///< SSL/TLS stream over TCP
+    std::unique_ptr<TlsStream> stream_;                         ///< TLS or plaintext stream over TCP, with kernel TLS where available; moved to Http2Session for h2
     std::shared_ptr<Router> router_;                            ///< HTTP request router
-    boost::asio::steady_timer deadline_;                        ///< Timer for connection timeouts
+    std::shared_ptr<const SessionSettings> settings_;           ///< HTTP settings (compression, body limits)
+    std::shared_ptr<TimerWheel> timerWheel_;                    ///< Timer wheel of the I/O context, passed on to Http2Session
+    boost::asio::any_io_executor handlerExecutor_;              ///< Executor for the handlers of HTTP/2 streams
+    std::shared_ptr<WheelTimer> deadline_;                      ///< Timer for connection timeouts, created on start
+    ConnectionPermit permit_;                                   ///< Admission of the connection; moved to Http2Session for h2
 
     boost::beast::flat_buffer buffer_;  ///< Buffer for incoming request data
     boost::beast::http::request<boost::beast::http::string_body> request_; ///< Current HTTP request
+    std::optional<boost::beast::http::request_parser<boost::beast::http::empty_body>> headerParser_; ///< Parser of the current request header
+    std::optional<boost::beast::http::request_parser<boost::beast::http::string_body>> bodyParser_;  ///< Parser of an in-memory request body
+    std::optional<boost::beast::http::request_parser<UploadBody>> uploadParser_;  ///< Parser of an upload body written to a file
+    std::shared_ptr<handlers::IHandler> uploadHandler_; ///< Handler of the current upload
+    std::filesystem::path uploadFile_;                   ///< File of the current upload
     std::shared_ptr<boost::beast::http::response<boost::beast::http::string_body>> response_; ///< Current HTTP response
 
+    std::shared_ptr<handlers::IResponseStream> responseStream_; ///< Body source of the current streaming response
+    std::unique_ptr<boost::beast::http::response_serializer<boost::beast::http::string_body>> streamSerializer_; ///< Serializer of the streaming response header
+    std::string streamChunk_; ///< Chunk of the streaming response being written
+
     bool isRunning_{ false }; ///< Session running state flag
 };
 }
@@ -0,0 +1,34 @@
+#ifndef SESSION_SETTINGS_H
+#define SESSION_SETTINGS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace server
+{
+/**
+ * @struct SessionSettings
+ * @brief Per-connection HTTP settings shared by all sessions of a listener
+ *
+ * Populated once from the configuration by the Server and passed to every
+ * Session through the Listener as an immutable shared object.
+ *
+ * @see Session
+ * @see config::ConfigManager
+ */
+struct SessionSettings final
+{
+    bool isCompressionEnabled{ true };            ///< Whether responses are compressed when the client accepts it
+    size_t compressionMinSize{ 1024 };            ///< Minimum response body size in bytes to compress
+    int compressionLevel{ 6 };                    ///< zlib compression level (1 - fastest, 9 - smallest)
+    size_t maxRequestBodySize{ 1024 * 1024 };     ///< Maximum request body size in bytes, as received and after decompression
+    size_t maxAttachmentSize{ 100 * 1024 * 1024 }; ///< Maximum size in bytes of an uploaded attachment
+    uint32_t http2MaxConcurrentStreams{ 100 };     ///< Maximum number of concurrent HTTP/2 streams per connection
+    uint32_t http2InitialWindowSize{ 1024 * 1024 }; ///< Initial HTTP/2 flow control window of request streams in bytes
+    bool isProxyProtocolEnabled{ false };          ///< Whether connections start with a PROXY protocol header from a load balancer
+    std::chrono::milliseconds requestTimeout{ 5000 }; ///< Time budget of a request from its arrival, including its database queries
+};
+}
+
+#endif // SESSION_SETTINGS_H
@@ -0,0 +1,243 @@
+#include "TimerWheel.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace server
+{
+TimerWheel::TimerWheel(const boost::asio::any_io_executor& executor, std::chrono::milliseconds resolution, size_t slotCount) :
+    strand_{ boost::asio::make_strand(executor) },
+    tickTimer_{ strand_ },
+    resolution_{ resolution },
+    epoch_{ std::chrono::steady_clock::now() },
+    slots_(slotCount)
+{
+    if (resolution.count() <= 0)
+    {
+        throw std::invalid_argument{ "Timer wheel resolution must be positive" };
+    }
+
+    if (slotCount == 0)
+    {
+        throw std::invalid_argument{ "Timer wheel must have at least one slot" };
+    }
+}
+
+std::shared_ptr<WheelTimer> TimerWheel::createTimer(boost::asio::any_io_executor executor, std::function<void()> onExpired)
+{
+    return std::make_shared<WheelTimer>(shared_from_this(), std::move(executor), std::move(onExpired));
+}
+
+size_t TimerWheel::getArmedCount() const noexcept
+{
+    return armedCount_.load();
+}
+
+std::uint64_t TimerWheel::getTick(std::chrono::steady_clock::time_point time) const noexcept
+{
+    return static_cast<std::uint64_t>((time - epoch_) / resolution_);
+}
+
+std::uint64_t TimerWheel::getCurrentTick() const noexcept
+{
+    return getTick(std::chrono::steady_clock::now());
+}
+
+void TimerWheel::insert(const std::shared_ptr<WheelTimer>& timer, std::uint64_t tick)
+{
+    std::lock_guard lock{ mutex_ };
+    slots_[tick % slots_.size()].push_back({ timer, tick });
+}
+
+void TimerWheel::onArmed()
+{
+    if (armedCount_.fetch_add(1) == 0)
+    {
+        boost::asio::post(strand_, [self = shared_from_this()]() { self->startTicking(); });
+    }
+}
+
+void TimerWheel::onDisarmed() noexcept
+{
+    if (armedCount_.fetch_sub(1) != 1)
+    {
+        return;
+    }
+
+    try
+    {
+        // with nothing left to time out, the wheel stops so that the io_context can run out of work
+        boost::asio::post(strand_, [self = shared_from_this()]()
+        {
+            if (self->armedCount_.load() == 0)
+            {
+                self->tickTimer_.cancel();
+            }
+        });
+    }
+    catch (const std::exception&)
+    {
+        // the wheel then stops at its next tick
+    }
+}
+
+void TimerWheel::startTicking()
+{
+    if (isTicking_)
+    {
+        return;
+    }
+
+    isTicking_ = true;
+    scheduleTick();
+}
+
+void TimerWheel::scheduleTick()
+{
+    tickTimer_.expires_at(epoch_ + resolution_ * static_cast<std::chrono::steady_clock::rep>(lastTick_ + 1));
+    tickTimer_.async_wait(
+        [self = shared_from_this()](const boost::system::error_code& ec)
+    {
+        self->onTick(ec);
+    });
+}
+
+void TimerWheel::onTick(const boost::system::error_code& ec)
+{
+    if (!ec)
+    {
+        // after a pause longer than a turn every slot is visited once, which reaches all entries
+        const auto currentTick{ getCurrentTick() };
+        const auto firstTick{ std::max(lastTick_ + 1, currentTick >= slots_.size() ? currentTick - slots_.size() + 1 : 0) };
+
+        for (auto tick{ firstTick }; tick <= currentTick; ++tick)
+        {
+            processSlot(tick);
+        }
+
+        lastTick_ = std::max(lastTick_, currentTick);
+    }
+
+    // a timer armed while the tick timer was being cancelled keeps the wheel running
+    if (armedCount_.load() == 0)
+    {
+        isTicking_ = false;
+        return;
+    }
+
+    scheduleTick();
+}
+
+void TimerWheel::processSlot(std::uint64_t tick)
+{
+    std::vector<Entry> entries{};
+    {
+        std::lock_guard lock{ mutex_ };
+        entries.swap(slots_[tick % slots_.size()]);
+    }
+
+    for (const auto& entry : entries)
+    {
+        const auto timer{ entry.timer.lock() };
+        if (!timer)
+        {
+            continue;
+        }
+
+        // entries of later turns stay in their slot
+        if (entry.tick > tick)
+        {
+            insert(timer, entry.tick);
+            continue;
+        }
+
+        // the timer has been queued again at an earlier tick since this entry was made
+        auto queuedTick{ entry.tick };
+        if (!timer->queuedTick_.compare_exchange_strong(queuedTick, WheelTimer::NEVER))
+        {
+            continue;
+        }
+
+        // read after dequeuing: a timer re-armed from now on queues itself again
+        const auto expiryTick{ timer->expiryTick_.load() };
+        if (expiryTick == WheelTimer::NEVER)
+        {
+            continue;
+        }
+
+        if (expiryTick > tick)
+        {
+            timer->enqueue(expiryTick);
+            continue;
+        }
+
+        boost::asio::post(timer->executor_, [timer]() { timer->fire(); });
+    }
+}
+
+WheelTimer::WheelTimer(std::shared_ptr<TimerWheel> wheel, boost::asio::any_io_executor executor, std::function<void()> onExpired) :
+    wheel_{ std::move(wheel) },
+    executor_{ std::move(executor) },
+    onExpired_{ std::move(onExpired) },
+    expiryTick_{ NEVER },
+    queuedTick_{ NEVER }
+{
+}
+
+WheelTimer::~WheelTimer() noexcept
+{
+    cancel();
+}
+
+void WheelTimer::expiresAfter(std::chrono::steady_clock::duration timeout)
+{
+    // the current tick has partly elapsed, so the deadline is rounded up to the next one
+    const auto tick{ wheel_->getTick(std::chrono::steady_clock::now() + timeout) + 1 };
+
+    if (expiryTick_.exchange(tick) == NEVER)
+    {
+        wheel_->onArmed();
+    }
+
+    enqueue(tick);
+}
+
+void WheelTimer::cancel() noexcept
+{
+    if (expiryTick_.exchange(NEVER) != NEVER)
+    {
+        wheel_->onDisarmed();
+    }
+}
+
+bool WheelTimer::isArmed() const noexcept
+{
+    return expiryTick_.load() != NEVER;
+}
+
+void WheelTimer::enqueue(std::uint64_t tick)
+{
+    // an entry due no later than the deadline is moved on when its slot comes due
+    auto queuedTick{ queuedTick_.load() };
+    while (queuedTick > tick)
+    {
+        if (queuedTick_.compare_exchange_weak(queuedTick, tick))
+        {
+            wheel_->insert(shared_from_this(), tick);
+            return;
+        }
+    }
+}
+
+void WheelTimer::fire()
+{
+    // moved or cancelled after the wheel posted this
+    auto expiryTick{ expiryTick_.load() };
+    if (expiryTick == NEVER || expiryTick > wheel_->getCurrentTick() || !expiryTick_.compare_exchange_strong(expiryTick, NEVER))
+    {
+        return;
+    }
+
+    wheel_->onDisarmed();
+    onExpired_();
+}
+}
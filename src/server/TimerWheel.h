@@ -0,0 +1,270 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <boost/asio.hpp>
+
+namespace server
+{
+class WheelTimer;
+
+/**
+ * @class TimerWheel
+ * @brief Hashed timer wheel shared by the connection timeouts of one io_context
+ *
+ * Time is divided into ticks of a coarse resolution, and the wheel has one slot per
+ * tick modulo its size. A single steady_timer advances the wheel, so the reactor holds
+ * one timer however many connections are open. Re-arming a WheelTimer is O(1) and only
+ * touches two atomics: the timer stays in its slot, and when that slot comes due it is
+ * moved on to its new deadline or fired. Only a timer whose deadline moves earlier is
+ * inserted again, which takes the wheel's mutex.
+ *
+ * The wheel ticks only while at least one timer is armed, so an io_context with no
+ * pending timeouts runs out of work as before.
+ *
+ * @note Thread-safe; timers are armed from any strand and fire on their own executor
+ * @warning Must be managed as a shared_ptr due to enable_shared_from_this
+ * @see WheelTimer
+ */
+class TimerWheel final : public std::enable_shared_from_this<TimerWheel>
+{
+public:
+    /**
+     * @brief Constructs a timer wheel
+     * @param executor Executor of the I/O context that advances the wheel
+     * @param resolution Length of a tick; timers fire up to one tick after their timeout
+     * @param slotCount Number of slots; deadlines further away than one turn wait in their slot for more turns
+     * @throws std::invalid_argument if resolution is not positive or slotCount is 0
+     */
+    explicit TimerWheel(const boost::asio::any_io_executor& executor, std::chrono::milliseconds resolution = DEFAULT_RESOLUTION, size_t slotCount = DEFAULT_SLOT_COUNT);
+
+    /**
+     * @brief Default destructor
+     */
+    ~TimerWheel() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note TimerWheel should not be copied
+     */
+    TimerWheel(const TimerWheel&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note TimerWheel should not be copied
+     */
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note TimerWheel should not be moved
+     */
+    TimerWheel(TimerWheel&&) noexcept = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note TimerWheel should not be moved
+     */
+    TimerWheel& operator=(TimerWheel&&) noexcept = delete;
+
+    /**
+     * @brief Creates a disarmed timer on this wheel
+     * @param executor Executor the expiry handler runs on, usually the strand of a connection
+     * @param onExpired Handler called when the armed timer expires
+     * @return std::shared_ptr<WheelTimer> New timer
+     * @note The handler should not own the object that owns the timer
+     */
+    [[nodiscard]] std::shared_ptr<WheelTimer> createTimer(boost::asio::any_io_executor executor, std::function<void()> onExpired);
+
+    /**
+     * @brief Gets the number of armed timers
+     * @return size_t Number of armed timers
+     */
+    [[nodiscard]] size_t getArmedCount() const noexcept;
+
+    static constexpr std::chrono::milliseconds DEFAULT_RESOLUTION{ 1000 }; ///< Default length of a tick
+    static constexpr size_t DEFAULT_SLOT_COUNT{ 512 };                   ///< Default number of slots, about 8.5 minutes at the default resolution
+
+private:
+    friend class WheelTimer;
+
+    /**
+     * @struct Entry
+     * @brief Place of a timer in a slot
+     */
+    struct Entry final
+    {
+        std::weak_ptr<WheelTimer> timer; ///< Timer, dropped from the wheel once it is destroyed
+        std::uint64_t tick;              ///< Tick the entry is due at
+    };
+
+    /**
+     * @brief Gets the tick of a time point
+     * @param time Time point
+     * @return std::uint64_t Number of whole ticks since the wheel was created
+     */
+    [[nodiscard]] std::uint64_t getTick(std::chrono::steady_clock::time_point time) const noexcept;
+
+    /**
+     * @brief Gets the current tick
+     * @return std::uint64_t Number of whole ticks since the wheel was created
+     */
+    [[nodiscard]] std::uint64_t getCurrentTick() const noexcept;
+
+    /**
+     * @brief Puts a timer into the slot of a tick
+     * @param timer Timer to insert
+     * @param tick Tick the timer is due at
+     */
+    void insert(const std::shared_ptr<WheelTimer>& timer, std::uint64_t tick);
+
+    /**
+     * @brief Counts a timer that was armed and starts ticking if it is the first one
+     */
+    void onArmed();
+
+    /**
+     * @brief Counts a timer that was cancelled, fired or destroyed, and stops ticking after the last one
+     */
+    void onDisarmed() noexcept;
+
+    /**
+     * @brief Starts the tick timer unless it is running
+     * @note Runs on the wheel's strand
+     */
+    void startTicking();
+
+    /**
+     * @brief Waits for the next tick
+     * @note Runs on the wheel's strand
+     */
+    void scheduleTick();
+
+    /**
+     * @brief Callback of the tick timer; processes all slots that came due
+     * @param ec Error code of the wait, operation_aborted when ticking is stopped
+     */
+    void onTick(const boost::system::error_code& ec);
+
+    /**
+     * @brief Moves or fires the timers of one slot
+     * @param tick Tick being processed
+     */
+    void processSlot(std::uint64_t tick);
+
+private:
+    boost::asio::strand<boost::asio::any_io_executor> strand_; ///< Strand of the tick timer
+    boost::asio::steady_timer tickTimer_;                      ///< The only reactor timer of the wheel
+    const std::chrono::steady_clock::duration resolution_;     ///< Length of a tick
+    const std::chrono::steady_clock::time_point epoch_;        ///< Start of tick 0
+
+    std::mutex mutex_;                     ///< Mutex for slots_
+    std::vector<std::vector<Entry>> slots_; ///< Entries by tick modulo the number of slots
+
+    std::atomic<size_t> armedCount_{ 0 }; ///< Number of armed timers
+    std::uint64_t lastTick_{ 0 };         ///< Last processed tick, used on the strand only
+    bool isTicking_{ false };             ///< Whether the tick timer runs, used on the strand only
+};
+
+/**
+ * @class WheelTimer
+ * @brief Coarse deadline timer of a connection, driven by a TimerWheel
+ *
+ * Replaces a steady_timer that is re-armed on every read and write: arming and
+ * cancelling are O(1) and do not reach the reactor. The expiry handler runs on the
+ * timer's executor and only if the deadline has not been moved or cancelled meanwhile.
+ *
+ * @note expiresAfter and cancel may be called from any thread
+ * @see TimerWheel
+ */
+class WheelTimer final : public std::enable_shared_from_this<WheelTimer>
+{
+public:
+    /**
+     * @brief Constructs a disarmed timer
+     * @param wheel Wheel that drives the timer
+     * @param executor Executor the expiry handler runs on
+     * @param onExpired Handler called when the timer expires
+     * @note Use TimerWheel::createTimer
+     */
+    WheelTimer(std::shared_ptr<TimerWheel> wheel, boost::asio::any_io_executor executor, std::function<void()> onExpired);
+
+    /**
+     * @brief Destructor that disarms the timer
+     */
+    ~WheelTimer() noexcept;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note WheelTimer should not be copied
+     */
+    WheelTimer(const WheelTimer&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note WheelTimer should not be copied
+     */
+    WheelTimer& operator=(const WheelTimer&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note WheelTimer should not be moved
+     */
+    WheelTimer(WheelTimer&&) noexcept = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note WheelTimer should not be moved
+     */
+    WheelTimer& operator=(WheelTimer&&) noexcept = delete;
+
+    /**
+     * @brief Arms the timer, replacing any earlier deadline
+     * @param timeout Time until expiry; the timer fires within one tick after it
+     */
+    void expiresAfter(std::chrono::steady_clock::duration timeout);
+
+    /**
+     * @brief Disarms the timer
+     */
+    void cancel() noexcept;
+
+    /**
+     * @brief Checks if the timer is armed
+     * @return bool True if the timer has a deadline
+     */
+    [[nodiscard]] bool isArmed() const noexcept;
+
+private:
+    friend class TimerWheel;
+
+    /**
+     * @brief Makes sure an entry of the timer is due no later than a tick
+     * @param tick Tick of the deadline
+     */
+    void enqueue(std::uint64_t tick);
+
+    /**
+     * @brief Runs the expiry handler if the deadline has passed
+     * @note Runs on the timer's executor
+     */
+    void fire();
+
+    static constexpr std::uint64_t NEVER{ UINT64_MAX }; ///< Tick of a disarmed or dequeued timer
+
+private:
+    std::shared_ptr<TimerWheel> wheel_;       ///< Wheel that drives the timer
+    boost::asio::any_io_executor executor_;   ///< Executor of the expiry handler
+    std::function<void()> onExpired_;         ///< Expiry handler
+    std::atomic<std::uint64_t> expiryTick_;   ///< Tick of the deadline, or NEVER when disarmed
+    std::atomic<std::uint64_t> queuedTick_;   ///< Tick of the entry the wheel acts on, or NEVER if none
+};
+}
+
+#endif // TIMER_WHEEL_H
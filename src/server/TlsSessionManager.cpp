@@ -0,0 +1,294 @@
+#include "TlsSessionManager.h"
+#include <algorithm>
+#include <stdexcept>
+#include <openssl/core_names.h>
+#include <openssl/rand.h>
+#include <boost/algorithm/string/join.hpp>
+#include "../utils/Logger.h"
+
+namespace server
+{
+constexpr unsigned char SESSION_ID_CONTEXT[]{ "NovaChatServer" };
+constexpr auto TICKET_HMAC_DIGEST{ "SHA256" };
+constexpr int OK_CODE{ 1 };
+constexpr int TICKET_KEY_UNKNOWN{ 0 };
+constexpr int TICKET_KEY_OK{ 1 };
+constexpr int TICKET_KEY_RENEW{ 2 };
+constexpr int TICKET_KEY_ERROR{ -1 };
+constexpr size_t MAX_ALPN_PROTOCOL_LENGTH{ 255 };
+
+double TlsStatistics::getResumptionRate() const noexcept
+{
+    return handshakes == 0 ? 0.0 : static_cast<double>(resumedHandshakes) / static_cast<double>(handshakes);
+}
+
+TlsSessionManager::TlsSessionManager(std::shared_ptr<boost::asio::ssl::context> sslContext, const TlsSettings& settings) :
+    sslContext_{ std::move(sslContext) },
+    ticketKeyRotationInterval_{ settings.ticketKeyRotationInterval },
+    alpnProtocols_{ encodeAlpnProtocols(settings.alpnProtocols) },
+    currentKey_{ generateTicketKey() }
+{
+    if (!sslContext_)
+    {
+        throw std::invalid_argument{ "SSL context cannot be null" };
+    }
+
+    auto* const context{ sslContext_->native_handle() };
+
+    // TLS 1.2 is the oldest protocol accepted, TLS 1.3 is preferred
+    if (SSL_CTX_set_min_proto_version(context, TLS1_2_VERSION) != OK_CODE)
+    {
+        throw std::runtime_error{ "Failed to set the minimum TLS protocol version" };
+    }
+
+    SSL_CTX_set_options(context, SSL_OP_CIPHER_SERVER_PREFERENCE);
+
+    if (!settings.cipherList.empty() && SSL_CTX_set_cipher_list(context, settings.cipherList.c_str()) != OK_CODE)
+    {
+        throw std::runtime_error{ "Invalid TLS 1.2 cipher list: " + settings.cipherList };
+    }
+
+    if (!settings.cipherSuites.empty() && SSL_CTX_set_ciphersuites(context, settings.cipherSuites.c_str()) != OK_CODE)
+    {
+        throw std::runtime_error{ "Invalid TLS 1.3 cipher suites: " + settings.cipherSuites };
+    }
+
+    if (!settings.groups.empty() && SSL_CTX_set1_groups_list(context, settings.groups.c_str()) != OK_CODE)
+    {
+        throw std::runtime_error{ "Invalid TLS key exchange groups: " + settings.groups };
+    }
+
+    // server-side session cache for clients without ticket support
+    SSL_CTX_set_session_id_context(context, SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+    SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_cache_size(context, static_cast<long>(settings.sessionCacheSize));
+    SSL_CTX_set_timeout(context, static_cast<long>(settings.sessionTimeout.count()));
+
+    SSL_CTX_set_app_data(context, this);
+    SSL_CTX_set_info_callback(context, &TlsSessionManager::onInfo);
+
+    // OpenSSL falls back to user space encryption when the kernel lacks TLS support
+    if (settings.isKernelTlsEnabled)
+    {
+        SSL_CTX_set_options(context, SSL_OP_ENABLE_KTLS);
+    }
+    else
+    {
+        SSL_CTX_clear_options(context, SSL_OP_ENABLE_KTLS);
+    }
+
+    if (!alpnProtocols_.empty())
+    {
+        SSL_CTX_set_alpn_select_cb(context, &TlsSessionManager::onAlpnSelect, this);
+    }
+
+    if (settings.isSessionTicketsEnabled)
+    {
+        SSL_CTX_clear_options(context, SSL_OP_NO_TICKET);
+        SSL_CTX_set_tlsext_ticket_key_evp_cb(context, &TlsSessionManager::onTicketKey);
+    }
+    else
+    {
+        SSL_CTX_set_options(context, SSL_OP_NO_TICKET);
+    }
+
+    LOG_INFO("TLS session cache of " + std::to_string(settings.sessionCacheSize) + " sessions, timeout " +
+        std::to_string(settings.sessionTimeout.count()) + "s, session tickets " + (settings.isSessionTicketsEnabled ?
+            "enabled (key rotation every " + std::to_string(settings.ticketKeyRotationInterval.count()) + " min)" : std::string{ "disabled" }) +
+        ", kernel TLS " + (settings.isKernelTlsEnabled ? "enabled where supported" : "disabled") +
+        ", ALPN protocols: " + (settings.alpnProtocols.empty() ? std::string{ "none" } : boost::algorithm::join(settings.alpnProtocols, ", ")));
+}
+
+TlsSessionManager::~TlsSessionManager() noexcept
+{
+    auto* const context{ sslContext_->native_handle() };
+
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(context, nullptr);
+    SSL_CTX_set_alpn_select_cb(context, nullptr, nullptr);
+    SSL_CTX_set_info_callback(context, nullptr);
+    SSL_CTX_set_app_data(context, nullptr);
+}
+
+TlsStatistics TlsSessionManager::getStatistics() const noexcept
+{
+    return TlsStatistics{ handshakes_.load(), resumedHandshakes_.load(), ticketKeyRotations_.load(), kernelTlsHandshakes_.load() };
+}
+
+void TlsSessionManager::rotateTicketKeys()
+{
+    std::lock_guard lock{ keyMutex_ };
+    rotateTicketKeysLocked();
+}
+
+TlsSessionManager::TicketKey TlsSessionManager::generateTicketKey()
+{
+    TicketKey key{};
+
+    if (RAND_bytes(key.name.data(), static_cast<int>(key.name.size())) != OK_CODE ||
+        RAND_bytes(key.aesKey.data(), static_cast<int>(key.aesKey.size())) != OK_CODE ||
+        RAND_bytes(key.hmacKey.data(), static_cast<int>(key.hmacKey.size())) != OK_CODE)
+    {
+        throw std::runtime_error{ "Failed to generate session ticket key" };
+    }
+
+    key.createdAt = std::chrono::steady_clock::now();
+    return key;
+}
+
+int TlsSessionManager::onTicketKey(SSL* ssl, unsigned char* keyName, unsigned char* iv, EVP_CIPHER_CTX* cipherContext, EVP_MAC_CTX* macContext, int encrypt)
+{
+    auto* const manager{ fromConnection(ssl) };
+    if (manager == nullptr)
+    {
+        return TICKET_KEY_ERROR;
+    }
+
+    return manager->handleTicketKey(keyName, iv, cipherContext, macContext, encrypt == 1);
+}
+
+int TlsSessionManager::onAlpnSelect([[maybe_unused]] SSL* ssl, const unsigned char** out, unsigned char* outLength, const unsigned char* in, unsigned int inLength, void* arg)
+{
+    const auto* const manager{ static_cast<const TlsSessionManager*>(arg) };
+    const auto& protocols{ manager->alpnProtocols_ };
+
+    // the server list comes first, so the server preference wins
+    unsigned char* selected{ nullptr };
+    if (SSL_select_next_proto(&selected, outLength, reinterpret_cast<const unsigned char*>(protocols.data()), static_cast<unsigned int>(protocols.size()),
+        in, inLength) != OPENSSL_NPN_NEGOTIATED)
+    {
+        return SSL_TLSEXT_ERR_NOACK;
+    }
+
+    *out = selected;
+    return SSL_TLSEXT_ERR_OK;
+}
+
+std::string TlsSessionManager::encodeAlpnProtocols(const std::vector<std::string>& protocols)
+{
+    std::string encoded{};
+
+    for (const auto& protocol : protocols)
+    {
+        if (protocol.empty() || protocol.size() > MAX_ALPN_PROTOCOL_LENGTH)
+        {
+            throw std::invalid_argument{ "Invalid ALPN protocol name: '" + protocol + "'" };
+        }
+
+        encoded += static_cast<char>(protocol.size());
+        encoded += protocol;
+    }
+
+    return encoded;
+}
+
+void TlsSessionManager::onInfo(const SSL* ssl, int where, [[maybe_unused]] int ret)
+{
+    if ((where & SSL_CB_HANDSHAKE_DONE) == 0)
+    {
+        return;
+    }
+
+    auto* const manager{ fromConnection(ssl) };
+    if (manager == nullptr)
+    {
+        return;
+    }
+
+    ++manager->handshakes_;
+    if (SSL_session_reused(ssl) == 1)
+    {
+        ++manager->resumedHandshakes_;
+    }
+
+    if (BIO_get_ktls_send(SSL_get_wbio(ssl)) == 1)
+    {
+        ++manager->kernelTlsHandshakes_;
+    }
+}
+
+TlsSessionManager* TlsSessionManager::fromConnection(const SSL* ssl) noexcept
+{
+    return static_cast<TlsSessionManager*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+}
+
+int TlsSessionManager::handleTicketKey(unsigned char* keyName, unsigned char* iv, EVP_CIPHER_CTX* cipherContext, EVP_MAC_CTX* macContext, bool encrypt) noexcept
+{
+    std::lock_guard lock{ keyMutex_ };
+
+    try
+    {
+        rotateExpiredTicketKeyLocked();
+    }
+    catch (const std::exception& e)
+    {
+        // keep issuing tickets with the current key
+        LOG_ERROR("Session ticket key rotation failed: " + std::string{ e.what() });
+    }
+
+    const TicketKey* key{ nullptr };
+    auto result{ TICKET_KEY_OK };
+
+    if (encrypt)
+    {
+        key = &currentKey_;
+        std::copy(key->name.begin(), key->name.end(), keyName);
+
+        if (RAND_bytes(iv, EVP_CIPHER_get_iv_length(EVP_aes_256_cbc())) != OK_CODE)
+        {
+            return TICKET_KEY_ERROR;
+        }
+    }
+    else if (std::equal(currentKey_.name.begin(), currentKey_.name.end(), keyName))
+    {
+        key = &currentKey_;
+    }
+    else if (previousKey_ && std::equal(previousKey_->name.begin(), previousKey_->name.end(), keyName))
+    {
+        // accepted, but the client gets a ticket under the current key
+        key = &*previousKey_;
+        result = TICKET_KEY_RENEW;
+    }
+    else
+    {
+        // unknown or expired key: fall back to a full handshake
+        return TICKET_KEY_UNKNOWN;
+    }
+
+    const OSSL_PARAM params[]
+    {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, const_cast<unsigned char*>(key->hmacKey.data()), key->hmacKey.size()),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>(TICKET_HMAC_DIGEST), 0),
+        OSSL_PARAM_construct_end()
+    };
+
+    if (EVP_MAC_CTX_set_params(macContext, params) != OK_CODE)
+    {
+        return TICKET_KEY_ERROR;
+    }
+
+    const auto cipherResult{ encrypt ?
+        EVP_EncryptInit_ex(cipherContext, EVP_aes_256_cbc(), nullptr, key->aesKey.data(), iv) :
+        EVP_DecryptInit_ex(cipherContext, EVP_aes_256_cbc(), nullptr, key->aesKey.data(), iv) };
+
+    return cipherResult == OK_CODE ? result : TICKET_KEY_ERROR;
+}
+
+void TlsSessionManager::rotateExpiredTicketKeyLocked()
+{
+    if (std::chrono::steady_clock::now() - currentKey_.createdAt >= ticketKeyRotationInterval_)
+    {
+        rotateTicketKeysLocked();
+    }
+}
+
+void TlsSessionManager::rotateTicketKeysLocked()
+{
+    auto newKey{ generateTicketKey() };
+
+    previousKey_ = currentKey_;
+    currentKey_ = newKey;
+    ++ticketKeyRotations_;
+
+    LOG_DEBUG("Session ticket key rotated");
+}
+}
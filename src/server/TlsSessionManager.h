@@ -0,0 +1,217 @@
+#ifndef TLS_SESSION_MANAGER_H
+#define TLS_SESSION_MANAGER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <boost/asio/ssl.hpp>
+#include "TlsSettings.h"
+
+namespace server
+{
+/**
+ * @struct TlsStatistics
+ * @brief Snapshot of the TLS handshake counters of a TlsSessionManager
+ */
+struct TlsStatistics final
+{
+    uint64_t handshakes{ 0 };            ///< Number of completed handshakes, full and resumed
+    uint64_t resumedHandshakes{ 0 };     ///< Number of completed handshakes that resumed a session
+    uint64_t ticketKeyRotations{ 0 };    ///< Number of session ticket key rotations
+    uint64_t kernelTlsHandshakes{ 0 };   ///< Number of completed handshakes after which the kernel encrypts records
+
+    /**
+     * @brief Gets the share of handshakes that resumed a session
+     * @return double Resumption rate in the range 0 - 1, 0 if there were no handshakes
+     */
+    [[nodiscard]] double getResumptionRate() const noexcept;
+};
+
+/**
+ * @class TlsSessionManager
+ * @brief Configures protocols, ciphers and session resumption of the server SSL context
+ *
+ * Enables TLS 1.2 and TLS 1.3 with the configured cipher and key exchange group lists,
+ * a server-side session cache and stateless session tickets. Ticket keys are generated
+ * in memory and rotated once the rotation interval has passed; tickets issued with the
+ * previous key are still accepted and renewed, so a ticket stays usable for at least one
+ * and at most two rotation intervals (and never longer than the session timeout).
+ * Optionally enables kernel TLS, which OpenSSL uses where both it and the kernel support
+ * it and silently skips otherwise. Selects the application protocol via ALPN in server
+ * preference order; clients without a common protocol continue without ALPN (HTTP/1.1).
+ * Counts completed, resumed and kernel TLS handshakes.
+ *
+ * @note Thread-safe. The manager registers itself on the SSL context, so it must outlive
+ *       every handshake on that context; the destructor unregisters it.
+ * @see TlsSettings
+ * @see Server
+ */
+class TlsSessionManager final
+{
+public:
+    /**
+     * @brief Applies the TLS settings to an SSL context
+     * @param sslContext Shared pointer to the SSL context of the listener
+     * @param settings TLS settings to apply
+     * @throws std::invalid_argument if sslContext is null
+     * @throws std::runtime_error if a cipher or group list is invalid or no ticket key can be generated
+     * @throws std::invalid_argument if an ALPN protocol name is empty or longer than 255 bytes
+     */
+    TlsSessionManager(std::shared_ptr<boost::asio::ssl::context> sslContext, const TlsSettings& settings);
+
+    /**
+     * @brief Destructor that unregisters the callbacks from the SSL context
+     */
+    ~TlsSessionManager() noexcept;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note TlsSessionManager is registered on the SSL context by address
+     */
+    TlsSessionManager(const TlsSessionManager&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note TlsSessionManager is registered on the SSL context by address
+     */
+    TlsSessionManager& operator=(const TlsSessionManager&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note TlsSessionManager is registered on the SSL context by address
+     */
+    TlsSessionManager(TlsSessionManager&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note TlsSessionManager is registered on the SSL context by address
+     */
+    TlsSessionManager& operator=(TlsSessionManager&&) = delete;
+
+    /**
+     * @brief Gets the current handshake counters
+     * @return TlsStatistics Snapshot of the counters
+     */
+    [[nodiscard]] TlsStatistics getStatistics() const noexcept;
+
+    /**
+     * @brief Replaces the session ticket key with a new one, keeping the current one for decryption
+     * @throws std::runtime_error if no random key can be generated
+     * @note Called automatically once the rotation interval has passed
+     */
+    void rotateTicketKeys();
+
+private:
+    /**
+     * @struct TicketKey
+     * @brief Key material used to protect session tickets
+     */
+    struct TicketKey final
+    {
+        std::array<unsigned char, 16> name{};                       ///< Key name sent in the clear with the ticket
+        std::array<unsigned char, 32> aesKey{};                     ///< AES-256-CBC encryption key
+        std::array<unsigned char, 32> hmacKey{};                    ///< HMAC-SHA256 key
+        std::chrono::steady_clock::time_point createdAt{};          ///< Time the key was generated
+    };
+
+    /**
+     * @brief Generates new random ticket key material
+     * @return TicketKey New key
+     * @throws std::runtime_error if the random generator fails
+     */
+    [[nodiscard]] static TicketKey generateTicketKey();
+
+    /**
+     * @brief OpenSSL session ticket key callback
+     * @param ssl Connection the ticket belongs to
+     * @param keyName Name of the key, written when encrypting and read when decrypting
+     * @param iv Initialization vector, written when encrypting and read when decrypting
+     * @param cipherContext Cipher context to initialize
+     * @param macContext MAC context to initialize
+     * @param encrypt 1 to issue a ticket, 0 to decrypt one
+     * @return int 1 on success, 2 if the ticket must be renewed, 0 if the key is unknown, -1 on error
+     */
+    static int onTicketKey(SSL* ssl, unsigned char* keyName, unsigned char* iv, EVP_CIPHER_CTX* cipherContext, EVP_MAC_CTX* macContext, int encrypt);
+
+    /**
+     * @brief OpenSSL info callback that counts completed handshakes
+     * @param ssl Connection the event belongs to
+     * @param where Event flags
+     * @param ret Event result
+     */
+    static void onInfo(const SSL* ssl, int where, int ret);
+
+    /**
+     * @brief OpenSSL ALPN callback that selects the most preferred protocol the client offers
+     * @param ssl Connection being negotiated
+     * @param out Selected protocol, pointing into the configured protocol list
+     * @param outLength Length of the selected protocol
+     * @param in Protocols offered by the client in wire format
+     * @param inLength Length of in
+     * @param arg Registered TlsSessionManager
+     * @return int SSL_TLSEXT_ERR_OK if a protocol was selected, SSL_TLSEXT_ERR_NOACK otherwise
+     */
+    static int onAlpnSelect(SSL* ssl, const unsigned char** out, unsigned char* outLength, const unsigned char* in, unsigned int inLength, void* arg);
+
+    /**
+     * @brief Encodes protocol names in the ALPN wire format (length-prefixed names)
+     * @param protocols Protocol names
+     * @return std::string Encoded protocol list
+     * @throws std::invalid_argument if a name is empty or longer than 255 bytes
+     */
+    [[nodiscard]] static std::string encodeAlpnProtocols(const std::vector<std::string>& protocols);
+
+    /**
+     * @brief Finds the manager registered on the context of a connection
+     * @param ssl Connection
+     * @return TlsSessionManager* Registered manager, or nullptr if none
+     */
+    [[nodiscard]] static TlsSessionManager* fromConnection(const SSL* ssl) noexcept;
+
+    /**
+     * @brief Initializes the cipher and MAC contexts for a ticket
+     * @param keyName Name of the key
+     * @param iv Initialization vector
+     * @param cipherContext Cipher context to initialize
+     * @param macContext MAC context to initialize
+     * @param encrypt True to issue a ticket, false to decrypt one
+     * @return int Result as defined by onTicketKey
+     */
+    [[nodiscard]] int handleTicketKey(unsigned char* keyName, unsigned char* iv, EVP_CIPHER_CTX* cipherContext, EVP_MAC_CTX* macContext, bool encrypt) noexcept;
+
+    /**
+     * @brief Rotates the ticket key if it is older than the rotation interval
+     * @throws std::runtime_error if no random key can be generated
+     * @note Must be called with the key mutex held
+     */
+    void rotateExpiredTicketKeyLocked();
+
+    /**
+     * @brief Replaces the ticket key with a new one, keeping the current one for decryption
+     * @throws std::runtime_error if no random key can be generated
+     * @note Must be called with the key mutex held
+     */
+    void rotateTicketKeysLocked();
+
+private:
+    std::shared_ptr<boost::asio::ssl::context> sslContext_;    ///< SSL context the manager is registered on
+    std::chrono::minutes ticketKeyRotationInterval_;            ///< Interval after which a new ticket key is used
+    std::string alpnProtocols_;                                 ///< Protocols offered via ALPN in wire format, most preferred first
+
+    mutable std::mutex keyMutex_;                               ///< Protects the ticket keys
+    TicketKey currentKey_;                                      ///< Key used to issue and decrypt tickets
+    std::optional<TicketKey> previousKey_;                      ///< Key of the previous interval, used to decrypt only
+
+    std::atomic<uint64_t> handshakes_{ 0 };                     ///< Number of completed handshakes
+    std::atomic<uint64_t> resumedHandshakes_{ 0 };              ///< Number of resumed handshakes
+    std::atomic<uint64_t> ticketKeyRotations_{ 0 };             ///< Number of ticket key rotations
+    std::atomic<uint64_t> kernelTlsHandshakes_{ 0 };            ///< Number of handshakes with kernel TLS for sending
+};
+}
+
+#endif // TLS_SESSION_MANAGER_H
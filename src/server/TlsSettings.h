@@ -0,0 +1,35 @@
+#ifndef TLS_SETTINGS_H
+#define TLS_SETTINGS_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace server
+{
+/**
+ * @struct TlsSettings
+ * @brief TLS protocol, cipher, session resumption and ALPN settings of the listener
+ *
+ * Populated once from the configuration by the Server and applied to the
+ * SSL context by the TlsSessionManager.
+ *
+ * @see TlsSessionManager
+ * @see config::ConfigManager
+ */
+struct TlsSettings final
+{
+    std::string cipherList;                                      ///< OpenSSL cipher list for TLS 1.2
+    std::string cipherSuites;                                    ///< OpenSSL cipher suites for TLS 1.3
+    std::string groups;                                          ///< Colon-separated list of key exchange groups
+    size_t sessionCacheSize{ 20480 };                            ///< Maximum number of sessions in the server-side cache
+    std::chrono::seconds sessionTimeout{ 86400 };                ///< Lifetime of a resumable session
+    bool isSessionTicketsEnabled{ true };                        ///< Whether stateless session tickets are issued
+    std::chrono::minutes ticketKeyRotationInterval{ 720 };       ///< Interval after which a new ticket key is used
+    bool isKernelTlsEnabled{ true };                             ///< Whether record encryption is offloaded to the kernel where supported
+    std::vector<std::string> alpnProtocols{ "h2", "http/1.1" };  ///< Application protocols offered via ALPN, most preferred first
+};
+}
+
+#endif // TLS_SETTINGS_H
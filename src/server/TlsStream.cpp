@@ -0,0 +1,238 @@
+#include "TlsStream.h"
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+#include "../utils/ProxyProtocol.h"
+
+namespace server
+{
+TlsStream::TlsStream(boost::asio::generic::stream_protocol::socket socket, boost::asio::ssl::context& sslContext) :
+    nextLayer_{ std::move(socket) },
+    ssl_{ SSL_new(sslContext.native_handle()), &SSL_free }
+{
+    ignoreBrokenPipe();
+
+    if (!ssl_)
+    {
+        throw std::runtime_error{ "Failed to create SSL object" };
+    }
+
+    // OpenSSL calls never block; readiness is awaited through the executor
+    nextLayer_.socket().non_blocking(true);
+
+    if (SSL_set_fd(ssl_.get(), static_cast<int>(nextLayer_.socket().native_handle())) != 1)
+    {
+        throw std::runtime_error{ "Failed to attach SSL object to socket" };
+    }
+
+    SSL_set_accept_state(ssl_.get());
+}
+
+TlsStream::TlsStream(boost::asio::generic::stream_protocol::socket socket) :
+    nextLayer_{ std::move(socket) },
+    ssl_{ nullptr, &SSL_free }
+{
+    ignoreBrokenPipe();
+
+    // reads and writes are the socket's own operations, which io_uring only performs itself on a blocking socket
+}
+
+TlsStream::executor_type TlsStream::get_executor() noexcept
+{
+    return nextLayer_.get_executor();
+}
+
+TlsStream::next_layer_type& TlsStream::next_layer() noexcept
+{
+    return nextLayer_;
+}
+
+const TlsStream::next_layer_type& TlsStream::next_layer() const noexcept
+{
+    return nextLayer_;
+}
+
+bool TlsStream::isEncrypted() const noexcept
+{
+    return ssl_ != nullptr;
+}
+
+bool TlsStream::isKernelSendEnabled() const noexcept
+{
+    return ssl_ && BIO_get_ktls_send(SSL_get_wbio(ssl_.get())) == 1;
+}
+
+bool TlsStream::isKernelReceiveEnabled() const noexcept
+{
+    return ssl_ && BIO_get_ktls_recv(SSL_get_rbio(ssl_.get())) == 1;
+}
+
+bool TlsStream::isSendFileAvailable() const noexcept
+{
+    return !ssl_ || isKernelSendEnabled();
+}
+
+std::string_view TlsStream::getAlpnProtocol() const noexcept
+{
+    if (!ssl_)
+    {
+        return {};
+    }
+
+    const unsigned char* protocol{ nullptr };
+    unsigned int length{ 0 };
+    SSL_get0_alpn_selected(ssl_.get(), &protocol, &length);
+
+    return { reinterpret_cast<const char*>(protocol), length };
+}
+
+std::string TlsStream::getRemoteAddress() const
+{
+    if (proxiedEndpoint_)
+    {
+        return proxiedEndpoint_->address().to_string();
+    }
+
+    boost::system::error_code ec{};
+    const auto endpoint{ nextLayer_.socket().remote_endpoint(ec) };
+    if (ec)
+    {
+        return "unknown";
+    }
+
+    const auto family{ endpoint.protocol().family() };
+    if (family != boost::asio::ip::tcp::v4().family() && family != boost::asio::ip::tcp::v6().family())
+    {
+        return "unix";
+    }
+
+    // the generic endpoint holds the sockaddr of the IP peer
+    boost::asio::ip::tcp::endpoint ipEndpoint{};
+    std::memcpy(ipEndpoint.data(), endpoint.data(), endpoint.size());
+    ipEndpoint.resize(endpoint.size());
+    return ipEndpoint.address().to_string();
+}
+
+TlsStream::NonBlockingScope::NonBlockingScope(TlsStream& stream) noexcept :
+    stream{ stream },
+    isSwitched{ false }
+{
+    // with epoll Asio keeps the socket non-blocking already once it has waited on it
+    if (!stream.ssl_ && !stream.nextLayer_.socket().native_non_blocking())
+    {
+        boost::system::error_code ec{};
+        stream.nextLayer_.socket().native_non_blocking(true, ec);
+        isSwitched = !ec;
+    }
+}
+
+TlsStream::NonBlockingScope::~NonBlockingScope() noexcept
+{
+    if (isSwitched)
+    {
+        boost::system::error_code ec{};
+        stream.nextLayer_.socket().native_non_blocking(false, ec);
+    }
+}
+
+void TlsStream::ignoreBrokenPipe() noexcept
+{
+#ifndef _WIN32
+    // OpenSSL and sendfile write to the socket without MSG_NOSIGNAL, unlike Asio
+    [[maybe_unused]] static const auto previousHandler{ std::signal(SIGPIPE, SIG_IGN) };
+#endif
+}
+
+void TlsStream::clearErrors() noexcept
+{
+    ERR_clear_error();
+
+#ifdef _WIN32
+    WSASetLastError(0);
+#else
+    errno = 0;
+#endif
+}
+
+TlsStream::Progress TlsStream::getSocketProgress(const boost::system::error_code& ec, boost::asio::socket_base::wait_type wait) noexcept
+{
+    if (ec == boost::asio::error::would_block || ec == boost::asio::error::try_again || ec == boost::asio::error::interrupted)
+    {
+        return { wait, {} };
+    }
+
+    return { std::nullopt, ec };
+}
+
+TlsStream::Progress TlsStream::readProxyHeader()
+{
+    const NonBlockingScope nonBlockingScope{ *this };
+    std::array<char, utils::ProxyProtocol::MAX_HEADER_SIZE> data{};
+    boost::system::error_code ec{};
+
+    // peeking leaves the client's own data, such as the TLS ClientHello, in the socket
+    const auto size{ nextLayer_.socket().receive(boost::asio::buffer(data), boost::asio::socket_base::message_peek, ec) };
+    if (ec)
+    {
+        return getSocketProgress(ec, boost::asio::socket_base::wait_read);
+    }
+
+    utils::ProxyHeader header{};
+    if (utils::ProxyProtocol::parse({ data.data(), size }, header) != utils::ProxyStatus::Complete)
+    {
+        return { std::nullopt, boost::system::errc::make_error_code(boost::system::errc::protocol_error) };
+    }
+
+    // the header has already arrived, so it is consumed in one call
+    if (nextLayer_.socket().receive(boost::asio::buffer(data.data(), header.size), 0, ec) != header.size)
+    {
+        return { std::nullopt, ec ? ec : boost::system::errc::make_error_code(boost::system::errc::protocol_error) };
+    }
+
+    proxiedEndpoint_ = header.source;
+    return {};
+}
+
+TlsStream::Progress TlsStream::getProgress(int result) const noexcept
+{
+    if (result > 0)
+    {
+        return {};
+    }
+
+    switch (SSL_get_error(ssl_.get(), result))
+    {
+    case SSL_ERROR_WANT_READ:
+        return { boost::asio::socket_base::wait_read, {} };
+
+    case SSL_ERROR_WANT_WRITE:
+        return { boost::asio::socket_base::wait_write, {} };
+
+    case SSL_ERROR_ZERO_RETURN:
+        return { std::nullopt, boost::asio::error::eof };
+
+    case SSL_ERROR_SYSCALL:
+        if (const auto error{ ERR_get_error() }; error != 0)
+        {
+            return { std::nullopt, { static_cast<int>(error), boost::asio::error::get_ssl_category() } };
+        }
+
+#ifdef _WIN32
+        if (const auto error{ WSAGetLastError() }; error != 0)
+#else
+        if (const auto error{ errno }; error != 0)
+#endif
+        {
+            return { std::nullopt, { error, boost::system::system_category() } };
+        }
+
+        // the client closed the connection without close_notify
+        return { std::nullopt, boost::asio::ssl::error::stream_truncated };
+
+    default:
+        return { std::nullopt, { static_cast<int>(ERR_get_error()), boost::asio::error::get_ssl_category() } };
+    }
+}
+}
@@ -0,0 +1,501 @@
+#ifndef TLS_STREAM_H
+#define TLS_STREAM_H
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+#include <string>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+
+namespace server
+{
+/**
+ * @class TlsStream
+ * @brief Server side TLS stream where OpenSSL reads and writes the socket directly
+ *
+ * boost::asio::ssl::stream keeps OpenSSL behind memory BIOs, so every record is encrypted
+ * and copied in user space. Here the SSL object is attached to the socket itself and
+ * asynchronous operations wait for socket readiness between non-blocking OpenSSL calls.
+ * With SSL_OP_ENABLE_KTLS on the context and kernel TLS support in both OpenSSL and the
+ * kernel, OpenSSL moves record encryption into the kernel after the handshake and files
+ * can be sent with sendfile; otherwise OpenSSL keeps encrypting in user space.
+ *
+ * Without an SSL context the stream carries plaintext HTTP, for deployments where a load
+ * balancer terminates TLS: the handshake completes at once and bytes pass through unchanged.
+ * The stream can also read a PROXY protocol header sent by such a balancer before any other
+ * data, and then reports the client address from the header instead of the balancer's.
+ * The socket is type-erased to a generic stream socket, so the same stream, and the sessions
+ * on top of it, serve both TCP and Unix domain socket connections.
+ *
+ * Satisfies the AsyncReadStream and AsyncWriteStream requirements used by Beast.
+ *
+ * Plaintext reads and writes are the socket's own asynchronous operations, so in io_uring
+ * builds the ring performs them. Encrypted reads and writes are non-blocking OpenSSL calls
+ * made between readiness waits; only the waits go through the ring then.
+ *
+ * @note Not thread-safe: operations must be started from the executor of the socket,
+ *       with at most one read and one write in flight
+ * @see Session
+ * @see TlsSessionManager
+ */
+class TlsStream
+{
+public:
+    using next_layer_type = boost::beast::basic_stream<boost::asio::generic::stream_protocol>; ///< Stream over a TCP or Unix domain socket
+    using executor_type = next_layer_type::executor_type; ///< Executor of the underlying socket
+
+    /**
+     * @brief Attaches a new server side SSL object to an accepted socket
+     * @param socket Accepted TCP or Unix domain socket
+     * @param sslContext SSL context of the listener
+     * @throws std::runtime_error if the SSL object cannot be created
+     */
+    TlsStream(boost::asio::generic::stream_protocol::socket socket, boost::asio::ssl::context& sslContext);
+
+    /**
+     * @brief Wraps an accepted socket without TLS
+     * @param socket Accepted TCP or Unix domain socket
+     */
+    explicit TlsStream(boost::asio::generic::stream_protocol::socket socket);
+
+    /**
+     * @brief Default destructor
+     * @note Frees the SSL object before the socket is closed
+     */
+    ~TlsStream() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note TlsStream is bound to its pending operations by address
+     */
+    TlsStream(const TlsStream&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note TlsStream is bound to its pending operations by address
+     */
+    TlsStream& operator=(const TlsStream&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note TlsStream is bound to its pending operations by address
+     */
+    TlsStream(TlsStream&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note TlsStream is bound to its pending operations by address
+     */
+    TlsStream& operator=(TlsStream&&) = delete;
+
+    /**
+     * @brief Gets the executor of the underlying socket
+     * @return executor_type Socket executor
+     */
+    [[nodiscard]] executor_type get_executor() noexcept;
+
+    /**
+     * @brief Gets the underlying socket stream
+     * @return next_layer_type& TCP or Unix domain socket stream
+     */
+    [[nodiscard]] next_layer_type& next_layer() noexcept;
+
+    /**
+     * @brief Gets the underlying socket stream
+     * @return const next_layer_type& TCP or Unix domain socket stream
+     */
+    [[nodiscard]] const next_layer_type& next_layer() const noexcept;
+
+    /**
+     * @brief Checks if the stream is encrypted
+     * @return bool True for TLS, false for plaintext
+     */
+    [[nodiscard]] bool isEncrypted() const noexcept;
+
+    /**
+     * @brief Checks if records are encrypted by the kernel
+     * @return bool True if kernel TLS is active for sending
+     */
+    [[nodiscard]] bool isKernelSendEnabled() const noexcept;
+
+    /**
+     * @brief Checks if records are decrypted by the kernel
+     * @return bool True if kernel TLS is active for receiving
+     */
+    [[nodiscard]] bool isKernelReceiveEnabled() const noexcept;
+
+    /**
+     * @brief Checks if files can be sent with async_sendfile
+     * @return bool True for plaintext streams and for kernel TLS
+     */
+    [[nodiscard]] bool isSendFileAvailable() const noexcept;
+
+    /**
+     * @brief Gets the application protocol selected during the handshake
+     * @return std::string_view ALPN protocol name (e.g. "h2"), empty if the client did not use ALPN
+     */
+    [[nodiscard]] std::string_view getAlpnProtocol() const noexcept;
+
+    /**
+     * @brief Gets the IP address of the client for logging
+     * @return std::string Source address from the PROXY header if it had one, otherwise of the peer of the socket;
+     *         "unix" for peers on a Unix domain socket and "unknown" if the socket is not connected
+     */
+    [[nodiscard]] std::string getRemoteAddress() const;
+
+    /**
+     * @brief Reads the PROXY protocol header that a load balancer sends ahead of the client's data
+     * @param token Completion token with signature void(boost::system::error_code)
+     * @note Only the header is consumed. It must arrive in one piece, as the specification requires
+     *       of senders; a partial, invalid or missing header fails with boost::system::errc::protocol_error
+     */
+    template<typename CompletionToken>
+    auto async_read_proxy_header(CompletionToken&& token);
+
+    /**
+     * @brief Performs the server side TLS handshake
+     * @param token Completion token with signature void(boost::system::error_code)
+     * @note Completes without any I/O for plaintext streams
+     */
+    template<typename CompletionToken>
+    auto async_handshake(CompletionToken&& token);
+
+    /**
+     * @brief Reads decrypted data into the first non-empty buffer of a sequence
+     * @param buffers Buffers to read into
+     * @param token Completion token with signature void(boost::system::error_code, std::size_t)
+     * @note Completes with boost::asio::error::eof when the client sent close_notify
+     */
+    template<typename MutableBufferSequence, typename CompletionToken>
+    auto async_read_some(const MutableBufferSequence& buffers, CompletionToken&& token);
+
+    /**
+     * @brief Encrypts and writes the first non-empty buffer of a sequence
+     * @param buffers Buffers to write
+     * @param token Completion token with signature void(boost::system::error_code, std::size_t)
+     */
+    template<typename ConstBufferSequence, typename CompletionToken>
+    auto async_write_some(const ConstBufferSequence& buffers, CompletionToken&& token);
+
+    /**
+     * @brief Sends close_notify without waiting for the client's one
+     * @param token Completion token with signature void(boost::system::error_code)
+     * @note Plaintext streams shut down the sending side of the socket instead
+     */
+    template<typename CompletionToken>
+    auto async_shutdown(CompletionToken&& token);
+
+#ifdef __linux__
+    /**
+     * @brief Sends part of a file through kernel TLS or a plaintext socket without copying it to user space
+     * @param fileDescriptor Open file to send
+     * @param offset Offset of the first byte to send
+     * @param size Maximum number of bytes to send
+     * @param token Completion token with signature void(boost::system::error_code, std::size_t)
+     * @warning Only valid while isSendFileAvailable() is true
+     */
+    template<typename CompletionToken>
+    auto async_sendfile(int fileDescriptor, uint64_t offset, size_t size, CompletionToken&& token);
+#endif
+
+private:
+    /**
+     * @struct Progress
+     * @brief Outcome of one non-blocking OpenSSL call
+     */
+    struct Progress final
+    {
+        std::optional<boost::asio::socket_base::wait_type> wait; ///< Socket readiness to wait for before retrying
+        boost::system::error_code ec;                            ///< Error, if the operation failed
+    };
+
+    /**
+     * @struct NonBlockingScope
+     * @brief Puts the socket of a plaintext stream into non-blocking mode while the scope lives
+     *
+     * Plaintext reads and writes are the socket's own asynchronous operations, which io_uring
+     * performs itself only while the socket is in blocking mode. The PROXY header peek and
+     * sendfile are direct system calls and must not block, so they switch it for one call.
+     * Encrypted streams are always non-blocking, OpenSSL reads and writes the socket itself.
+     */
+    struct NonBlockingScope final
+    {
+        /**
+         * @brief Switches the socket of a plaintext stream to non-blocking mode unless it is already
+         * @param stream Stream whose socket is switched
+         */
+        explicit NonBlockingScope(TlsStream& stream) noexcept;
+
+        /**
+         * @brief Switches the socket back to blocking mode if the scope switched it
+         */
+        ~NonBlockingScope() noexcept;
+
+        /**
+         * @brief Deleted copy constructor
+         * @note The socket is switched back once
+         */
+        NonBlockingScope(const NonBlockingScope&) = delete;
+
+        /**
+         * @brief Deleted copy assignment operator
+         * @note The socket is switched back once
+         */
+        NonBlockingScope& operator=(const NonBlockingScope&) = delete;
+
+        /**
+         * @brief Deleted move constructor
+         * @note The socket is switched back once
+         */
+        NonBlockingScope(NonBlockingScope&&) = delete;
+
+        /**
+         * @brief Deleted move assignment operator
+         * @note The socket is switched back once
+         */
+        NonBlockingScope& operator=(NonBlockingScope&&) = delete;
+
+        TlsStream& stream; ///< Stream whose socket is switched
+        bool isSwitched;   ///< Whether the socket was blocking and is switched back
+    };
+
+    /**
+     * @brief Ignores SIGPIPE once per process
+     * @note Writes to a connection the client has reset then fail with EPIPE instead of terminating the process
+     */
+    static void ignoreBrokenPipe() noexcept;
+
+    /**
+     * @brief Clears the OpenSSL error queue and the last system error before an OpenSSL call
+     * @note SSL_get_error and getProgress rely on both describing the last call only
+     */
+    static void clearErrors() noexcept;
+
+    /**
+     * @brief Classifies the result of an OpenSSL call
+     * @param result Return value of the OpenSSL call, positive on success
+     * @return Progress Readiness to wait for, error, or neither if the call succeeded
+     */
+    [[nodiscard]] Progress getProgress(int result) const noexcept;
+
+    /**
+     * @brief Classifies the result of a non-blocking socket call
+     * @param ec Error of the call
+     * @param wait Readiness to wait for if the call would block
+     * @return Progress Readiness to wait for, error, or neither if the call succeeded
+     */
+    [[nodiscard]] static Progress getSocketProgress(const boost::system::error_code& ec, boost::asio::socket_base::wait_type wait) noexcept;
+
+    /**
+     * @brief Peeks at the received data and consumes a complete PROXY protocol header
+     * @return Progress Readiness to wait for if nothing was received yet, error, or neither if the header was read
+     */
+    [[nodiscard]] Progress readProxyHeader();
+
+    /**
+     * @brief Runs an OpenSSL call until it succeeds or fails, waiting for the socket in between
+     * @tparam Signature Completion signature, with or without the number of bytes transferred
+     * @param attempt Callable Progress(std::size_t&) that makes one non-blocking OpenSSL or socket call
+     * @param token Completion token
+     * @note Never completes inside the initiating function
+     */
+    template<typename Signature, typename Attempt, typename CompletionToken>
+    auto asyncRun(Attempt attempt, CompletionToken&& token);
+
+private:
+    next_layer_type nextLayer_;                          ///< Socket stream OpenSSL reads and writes
+    std::unique_ptr<SSL, decltype(&SSL_free)> ssl_;      ///< Server side SSL object attached to the socket, null for plaintext
+    std::optional<boost::asio::ip::tcp::endpoint> proxiedEndpoint_; ///< Client address received in a PROXY header
+};
+
+template<typename CompletionToken>
+auto TlsStream::async_read_proxy_header(CompletionToken&& token)
+{
+    return asyncRun<void(boost::system::error_code)>(
+        [this](std::size_t&)
+        {
+            return readProxyHeader();
+        },
+        std::forward<CompletionToken>(token));
+}
+
+template<typename CompletionToken>
+auto TlsStream::async_handshake(CompletionToken&& token)
+{
+    return asyncRun<void(boost::system::error_code)>(
+        [this](std::size_t&)
+        {
+            return ssl_ ? getProgress(SSL_do_handshake(ssl_.get())) : Progress{};
+        },
+        std::forward<CompletionToken>(token));
+}
+
+template<typename MutableBufferSequence, typename CompletionToken>
+auto TlsStream::async_read_some(const MutableBufferSequence& buffers, CompletionToken&& token)
+{
+    return boost::asio::async_initiate<CompletionToken, void(boost::system::error_code, std::size_t)>(
+        [this](auto handler, const MutableBufferSequence& buffers)
+        {
+            if (!ssl_)
+            {
+                // the socket's own operation, which io_uring performs itself
+                nextLayer_.socket().async_read_some(buffers, std::move(handler));
+                return;
+            }
+
+            const auto buffer{ boost::beast::buffers_front(buffers) };
+
+            asyncRun<void(boost::system::error_code, std::size_t)>(
+                [this, buffer](std::size_t& bytesTransferred)
+                {
+                    return buffer.size() == 0 ? Progress{} : getProgress(SSL_read_ex(ssl_.get(), buffer.data(), buffer.size(), &bytesTransferred));
+                },
+                std::move(handler));
+        },
+        token, buffers);
+}
+
+template<typename ConstBufferSequence, typename CompletionToken>
+auto TlsStream::async_write_some(const ConstBufferSequence& buffers, CompletionToken&& token)
+{
+    return boost::asio::async_initiate<CompletionToken, void(boost::system::error_code, std::size_t)>(
+        [this](auto handler, const ConstBufferSequence& buffers)
+        {
+            if (!ssl_)
+            {
+                nextLayer_.socket().async_write_some(buffers, std::move(handler));
+                return;
+            }
+
+            const auto buffer{ boost::beast::buffers_front(buffers) };
+
+            asyncRun<void(boost::system::error_code, std::size_t)>(
+                [this, buffer](std::size_t& bytesTransferred)
+                {
+                    return buffer.size() == 0 ? Progress{} : getProgress(SSL_write_ex(ssl_.get(), buffer.data(), buffer.size(), &bytesTransferred));
+                },
+                std::move(handler));
+        },
+        token, buffers);
+}
+
+template<typename CompletionToken>
+auto TlsStream::async_shutdown(CompletionToken&& token)
+{
+    return asyncRun<void(boost::system::error_code)>(
+        [this](std::size_t&)
+        {
+            if (!ssl_)
+            {
+                boost::system::error_code ec{};
+                nextLayer_.socket().shutdown(boost::asio::socket_base::shutdown_send, ec);
+                return Progress{ std::nullopt, ec };
+            }
+
+            // 0 means close_notify was sent, which is all a closing server needs
+            const auto result{ SSL_shutdown(ssl_.get()) };
+            return result == 0 ? Progress{} : getProgress(result);
+        },
+        std::forward<CompletionToken>(token));
+}
+
+#ifdef __linux__
+template<typename CompletionToken>
+auto TlsStream::async_sendfile(int fileDescriptor, uint64_t offset, size_t size, CompletionToken&& token)
+{
+    return asyncRun<void(boost::system::error_code, std::size_t)>(
+        [this, fileDescriptor, offset, size](std::size_t& bytesTransferred)
+        {
+            if (!ssl_)
+            {
+                const NonBlockingScope nonBlockingScope{ *this };
+                auto fileOffset{ static_cast<off_t>(offset) };
+                const auto sent{ ::sendfile(nextLayer_.socket().native_handle(), fileDescriptor, &fileOffset, size) };
+                if (sent < 0)
+                {
+                    return getSocketProgress({ errno, boost::system::system_category() }, boost::asio::socket_base::wait_write);
+                }
+
+                bytesTransferred = static_cast<std::size_t>(sent);
+                return Progress{};
+            }
+
+            const auto sent{ SSL_sendfile(ssl_.get(), fileDescriptor, static_cast<off_t>(offset), size, 0) };
+            if (sent < 0)
+            {
+                return getProgress(static_cast<int>(sent));
+            }
+
+            bytesTransferred = static_cast<std::size_t>(sent);
+            return Progress{};
+        },
+        std::forward<CompletionToken>(token));
+}
+#endif
+
+template<typename Signature, typename Attempt, typename CompletionToken>
+auto TlsStream::asyncRun(Attempt attempt, CompletionToken&& token)
+{
+    return boost::asio::async_compose<CompletionToken, Signature>(
+        [this, attempt = std::move(attempt), isWaiting = false, result = std::optional<std::pair<boost::system::error_code, std::size_t>>{}]
+        (auto& self, boost::system::error_code ec = {}) mutable
+        {
+            const auto complete{ [&self](const boost::system::error_code& ec, std::size_t bytesTransferred)
+            {
+                if constexpr (std::is_same_v<Signature, void(boost::system::error_code)>)
+                {
+                    self.complete(ec);
+                }
+                else
+                {
+                    self.complete(ec, bytesTransferred);
+                }
+            } };
+
+            if (result)
+            {
+                complete(result->first, result->second);
+                return;
+            }
+
+            if (ec)
+            {
+                complete(ec, 0);
+                return;
+            }
+
+            std::size_t bytesTransferred{ 0 };
+            clearErrors();
+            const auto progress{ attempt(bytesTransferred) };
+
+            if (progress.wait)
+            {
+                isWaiting = true;
+                nextLayer_.socket().async_wait(*progress.wait, std::move(self));
+                return;
+            }
+
+            if (!isWaiting)
+            {
+                // finished without waiting: complete through the executor, as asynchronous operations must
+                result.emplace(progress.ec, bytesTransferred);
+                boost::asio::post(get_executor(), std::move(self));
+                return;
+            }
+
+            complete(progress.ec, bytesTransferred);
+        },
+        token, nextLayer_);
+}
+}
+
+#endif // TLS_STREAM_H
@@ -0,0 +1,98 @@
+#include "UploadFile.h"
+
+namespace server
+{
+bool UploadFile::is_open() const noexcept
+{
+    return writer_ && writer_->isOpen();
+}
+
+void UploadFile::close(boost::beast::error_code& ec) noexcept
+{
+    ec = {};
+
+    if (!writer_)
+    {
+        return;
+    }
+
+    if (!writer_->close())
+    {
+        ec = boost::beast::errc::make_error_code(boost::beast::errc::io_error);
+    }
+
+    writer_.reset();
+}
+
+void UploadFile::open(const char* path, boost::beast::file_mode mode, boost::beast::error_code& ec) noexcept
+{
+    ec = {};
+
+    if (mode != boost::beast::file_mode::write)
+    {
+        ec = boost::beast::errc::make_error_code(boost::beast::errc::operation_not_supported);
+        return;
+    }
+
+    try
+    {
+        writer_ = std::make_unique<utils::FileWriter>();
+        if (!writer_->open(path, true))
+        {
+            writer_.reset();
+            ec = boost::beast::errc::make_error_code(boost::beast::errc::io_error);
+        }
+    }
+    catch (const std::exception&)
+    {
+        writer_.reset();
+        ec = boost::beast::errc::make_error_code(boost::beast::errc::not_enough_memory);
+    }
+}
+
+std::uint64_t UploadFile::size(boost::beast::error_code& ec) const noexcept
+{
+    return pos(ec);
+}
+
+std::uint64_t UploadFile::pos(boost::beast::error_code& ec) const noexcept
+{
+    if (!is_open())
+    {
+        ec = boost::beast::errc::make_error_code(boost::beast::errc::bad_file_descriptor);
+        return 0;
+    }
+
+    ec = {};
+    return writer_->getSize();
+}
+
+void UploadFile::seek(std::uint64_t, boost::beast::error_code& ec) noexcept
+{
+    ec = boost::beast::errc::make_error_code(boost::beast::errc::operation_not_supported);
+}
+
+size_t UploadFile::read(void*, size_t, boost::beast::error_code& ec) noexcept
+{
+    ec = boost::beast::errc::make_error_code(boost::beast::errc::operation_not_supported);
+    return 0;
+}
+
+size_t UploadFile::write(const void* buffer, size_t n, boost::beast::error_code& ec) noexcept
+{
+    if (!is_open())
+    {
+        ec = boost::beast::errc::make_error_code(boost::beast::errc::bad_file_descriptor);
+        return 0;
+    }
+
+    if (!writer_->write({ static_cast<const char*>(buffer), n }))
+    {
+        ec = boost::beast::errc::make_error_code(boost::beast::errc::io_error);
+        return 0;
+    }
+
+    ec = {};
+    return n;
+}
+}
@@ -0,0 +1,131 @@
+#ifndef UPLOAD_FILE_H
+#define UPLOAD_FILE_H
+
+#include <cstdint>
+#include <memory>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/file_base.hpp>
+#include <boost/beast/http/basic_file_body.hpp>
+#include "../utils/FileWriter.h"
+
+namespace server
+{
+/**
+ * @class UploadFile
+ * @brief Beast File that writes an upload body through utils::FileWriter
+ *
+ * Lets a Beast parser store a request body with io_uring when it is available,
+ * so the session's thread does not wait for the disk. Only writing a new file
+ * is supported; the file is read back through the attachment store.
+ *
+ * @note A write the kernel fails after write() returned is reported by close()
+ * @see Session
+ */
+class UploadFile final
+{
+public:
+    /**
+     * @brief Constructs an object without an open file
+     */
+    UploadFile() noexcept = default;
+
+    /**
+     * @brief Default destructor, closes an open file
+     */
+    ~UploadFile() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note UploadFile should not be copied
+     */
+    UploadFile(const UploadFile&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note UploadFile should not be copied
+     */
+    UploadFile& operator=(const UploadFile&) = delete;
+
+    /**
+     * @brief Default move constructor
+     * @note UploadFile can be moved, the writer stays in place
+     */
+    UploadFile(UploadFile&&) noexcept = default;
+
+    /**
+     * @brief Default move assignment operator
+     * @note UploadFile can be moved, the writer stays in place
+     */
+    UploadFile& operator=(UploadFile&&) noexcept = default;
+
+    /**
+     * @brief Checks if a file is open
+     * @return bool True if a file is open
+     */
+    [[nodiscard]] bool is_open() const noexcept;
+
+    /**
+     * @brief Waits for pending writes and closes the file
+     * @param ec[out] Set if a write or closing failed
+     */
+    void close(boost::beast::error_code& ec) noexcept;
+
+    /**
+     * @brief Opens a file
+     * @param path File to open
+     * @param mode Only file_mode::write (create or truncate) is supported
+     * @param ec[out] Set on failure
+     */
+    void open(const char* path, boost::beast::file_mode mode, boost::beast::error_code& ec) noexcept;
+
+    /**
+     * @brief Gets the size of the file
+     * @param ec[out] Set if no file is open
+     * @return std::uint64_t Number of bytes written
+     */
+    [[nodiscard]] std::uint64_t size(boost::beast::error_code& ec) const noexcept;
+
+    /**
+     * @brief Gets the current position, which is always the end of the file
+     * @param ec[out] Set if no file is open
+     * @return std::uint64_t Number of bytes written
+     */
+    [[nodiscard]] std::uint64_t pos(boost::beast::error_code& ec) const noexcept;
+
+    /**
+     * @brief Not supported, writes are sequential
+     * @param offset Ignored
+     * @param ec[out] Set to operation_not_supported
+     */
+    void seek(std::uint64_t offset, boost::beast::error_code& ec) noexcept;
+
+    /**
+     * @brief Not supported, the file is write-only
+     * @param buffer Ignored
+     * @param n Ignored
+     * @param ec[out] Set to operation_not_supported
+     * @return size_t Always 0
+     */
+    [[nodiscard]] size_t read(void* buffer, size_t n, boost::beast::error_code& ec) noexcept;
+
+    /**
+     * @brief Writes data at the end of the file
+     * @param buffer Data to write
+     * @param n Number of bytes to write
+     * @param ec[out] Set if this or an earlier write failed
+     * @return size_t Number of bytes written
+     */
+    [[nodiscard]] size_t write(const void* buffer, size_t n, boost::beast::error_code& ec) noexcept;
+
+private:
+    std::unique_ptr<utils::FileWriter> writer_; ///< Writer of the open file
+};
+
+/**
+ * @typedef UploadBody
+ * @brief Beast body of a request whose body is written to an UploadFile
+ */
+using UploadBody = boost::beast::http::basic_file_body<UploadFile>;
+}
+
+#endif // UPLOAD_FILE_H
@@ -0,0 +1,160 @@
+#include "AttachmentStore.h"
+#include <array>
+#include <format>
+#include <fstream>
+#include <ranges>
+#include "../utils/Logger.h"
+#include "../utils/PasswordHasher.h"
+#include "../utils/UUIDUtils.h"
+
+namespace storage
+{
+constexpr auto TEMP_DIRECTORY{ "tmp" };
+constexpr auto TEMP_EXTENSION{ ".part" };
+constexpr size_t DIGEST_LENGTH{ 64 };
+constexpr size_t FAN_OUT_LENGTH{ 2 };
+constexpr size_t HASH_BLOCK_SIZE{ 64 * 1024 };
+constexpr int OK_CODE{ 1 };
+
+AttachmentStore::AttachmentStore(std::filesystem::path rootDirectory) :
+    rootDirectory_{ std::move(rootDirectory) },
+    tempDirectory_{ rootDirectory_ / TEMP_DIRECTORY }
+{
+    std::filesystem::create_directories(tempDirectory_);
+
+    // uploads interrupted by a restart can never be committed
+    for (const auto& entry : std::filesystem::directory_iterator{ tempDirectory_ })
+    {
+        std::error_code ec{};
+        std::filesystem::remove(entry.path(), ec);
+    }
+
+    LOG_INFO("Attachment store initialized in " + rootDirectory_.string());
+}
+
+std::filesystem::path AttachmentStore::createTempPath() const
+{
+    return tempDirectory_ / (utils::UUIDUtils::generateUUID() + TEMP_EXTENSION);
+}
+
+bool AttachmentStore::commit(const std::filesystem::path& tempFile, std::string& digest, std::uintmax_t& size) const noexcept
+{
+    try
+    {
+        if (!hashFile(tempFile, digest))
+        {
+            return false;
+        }
+
+        size = std::filesystem::file_size(tempFile);
+
+        const auto path{ getPath(digest) };
+        std::filesystem::create_directories(path.parent_path());
+
+        // content addressing: the same content is stored once
+        if (std::filesystem::exists(path))
+        {
+            std::filesystem::remove(tempFile);
+            LOG_DEBUG("Attachment " + digest + " is already stored");
+            return true;
+        }
+
+        std::filesystem::rename(tempFile, path);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to store attachment: " + std::string{ e.what() });
+        return false;
+    }
+}
+
+std::filesystem::path AttachmentStore::getPath(std::string_view digest) const noexcept
+{
+    if (!isDigestValid(digest))
+    {
+        return {};
+    }
+
+    // two levels of fan-out keep directories small
+    return rootDirectory_ / digest.substr(0, FAN_OUT_LENGTH) / digest.substr(FAN_OUT_LENGTH, FAN_OUT_LENGTH) / digest;
+}
+
+bool AttachmentStore::isDigestValid(std::string_view digest) noexcept
+{
+    if (digest.size() != DIGEST_LENGTH)
+    {
+        return false;
+    }
+
+    for (const auto c : digest)
+    {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool AttachmentStore::hashFile(const std::filesystem::path& path, std::string& digest) noexcept
+{
+    try
+    {
+        std::ifstream file{ path, std::ios::binary };
+        if (!file)
+        {
+            LOG_ERROR("Failed to open attachment file: " + path.string());
+            return false;
+        }
+
+        const utils::EVP_MD_CTX_Wrapper context{};
+        if (!context || EVP_DigestInit_ex(context.get(), EVP_sha256(), nullptr) != OK_CODE)
+        {
+            LOG_ERROR("Failed to initialize SHA-256 digest");
+            return false;
+        }
+
+        std::array<char, HASH_BLOCK_SIZE> block{};
+        while (file)
+        {
+            file.read(block.data(), block.size());
+            if (file.gcount() > 0 && EVP_DigestUpdate(context.get(), block.data(), static_cast<size_t>(file.gcount())) != OK_CODE)
+            {
+                LOG_ERROR("Failed to update SHA-256 digest");
+                return false;
+            }
+        }
+
+        if (file.bad())
+        {
+            LOG_ERROR("Failed to read attachment file: " + path.string());
+            return false;
+        }
+
+        std::array<unsigned char, EVP_MAX_MD_SIZE> hash{};
+        unsigned int hashLength{ 0 };
+        if (EVP_DigestFinal_ex(context.get(), hash.data(), &hashLength) != OK_CODE)
+        {
+            LOG_ERROR("Failed to finalize SHA-256 digest");
+            return false;
+        }
+
+        digest.clear();
+        digest.reserve(hashLength * 2);
+
+        for (auto i : std::ranges::views::iota(0u, hashLength))
+        {
+            digest += std::format("{:02x}", hash[i]);
+        }
+
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to hash attachment file: " + std::string{ e.what() });
+        return false;
+    }
+}
+}
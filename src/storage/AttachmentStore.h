@@ -0,0 +1,109 @@
+#ifndef ATTACHMENT_STORE_H
+#define ATTACHMENT_STORE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace storage
+{
+/**
+ * @class AttachmentStore
+ * @brief Content-addressed local store for attachment files
+ *
+ * Uploaded bodies are first written to a temporary file inside the store and then
+ * committed under their SHA-256 digest (<root>/ab/cd/abcd...). Identical files are
+ * stored once, and committing is a rename within one file system, so a file becomes
+ * visible only when it is complete.
+ *
+ * @note All methods are thread-safe: files are never modified once committed
+ * @see handlers::AttachmentHandlers
+ */
+class AttachmentStore final
+{
+public:
+    /**
+     * @brief Constructs a store rooted at a directory
+     * @param rootDirectory Directory for the stored files, created if missing
+     * @throws std::filesystem::filesystem_error if the directories cannot be created
+     * @note Removes temporary files left over by interrupted uploads
+     */
+    explicit AttachmentStore(std::filesystem::path rootDirectory);
+
+    /**
+     * @brief Default destructor
+     */
+    ~AttachmentStore() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note AttachmentStore should not be copied
+     */
+    AttachmentStore(const AttachmentStore&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note AttachmentStore should not be copied
+     */
+    AttachmentStore& operator=(const AttachmentStore&) = delete;
+
+    /**
+     * @brief Default move constructor
+     * @note AttachmentStore can be moved
+     */
+    AttachmentStore(AttachmentStore&&) noexcept = default;
+
+    /**
+     * @brief Default move assignment operator
+     * @note AttachmentStore can be moved
+     */
+    AttachmentStore& operator=(AttachmentStore&&) noexcept = default;
+
+    /**
+     * @brief Creates a unique path for a temporary upload file
+     * @return std::filesystem::path Path inside the store's temporary directory (the file is not created)
+     */
+    [[nodiscard]] std::filesystem::path createTempPath() const;
+
+    /**
+     * @brief Moves a completely written temporary file into the store
+     * @param tempFile Temporary file created at a path from createTempPath
+     * @param digest[out] Lowercase hex SHA-256 digest of the file content
+     * @param size[out] File size in bytes
+     * @return bool True on success, false otherwise
+     * @note If the same content is already stored, the temporary file is removed
+     */
+    [[nodiscard]] bool commit(const std::filesystem::path& tempFile, std::string& digest, std::uintmax_t& size) const noexcept;
+
+    /**
+     * @brief Gets the path of a stored file
+     * @param digest Lowercase hex SHA-256 digest of the file content
+     * @return std::filesystem::path Path of the file, or an empty path if the digest is malformed
+     */
+    [[nodiscard]] std::filesystem::path getPath(std::string_view digest) const noexcept;
+
+    /**
+     * @brief Checks if a string is a lowercase hex SHA-256 digest
+     * @param digest String to check
+     * @return bool True if digest consists of 64 lowercase hex digits
+     */
+    [[nodiscard]] static bool isDigestValid(std::string_view digest) noexcept;
+
+private:
+    /**
+     * @brief Computes the SHA-256 digest of a file
+     * @param path File to hash
+     * @param digest[out] Lowercase hex digest
+     * @return bool True on success, false otherwise
+     * @note Reads the file in fixed-size blocks, so memory usage does not depend on the file size
+     */
+    [[nodiscard]] static bool hashFile(const std::filesystem::path& path, std::string& digest) noexcept;
+
+private:
+    std::filesystem::path rootDirectory_; ///< Root directory of the stored files
+    std::filesystem::path tempDirectory_; ///< Directory of uploads in progress
+};
+}
+
+#endif // ATTACHMENT_STORE_H
@@ -0,0 +1,50 @@
+#ifndef CHAR_CLASS_H
+#define CHAR_CLASS_H
+
+#include <array>
+#include <string_view>
+
+namespace utils
+{
+/**
+ * @brief Lookup table of a character class, true for every byte in the class
+ */
+using CharClass = std::array<bool, 256>;
+
+/**
+ * @brief Builds the lookup table of a character class at compile time
+ * @param ranges Pairs of first and last characters of the ranges in the class
+ * @return CharClass Lookup table of the class
+ */
+consteval CharClass makeCharClass(std::string_view ranges) noexcept
+{
+    CharClass table{};
+    for (size_t i{ 0 }; i + 1 < ranges.size(); i += 2)
+    {
+        for (auto c{ static_cast<unsigned char>(ranges[i]) }; c <= static_cast<unsigned char>(ranges[i + 1]); ++c)
+        {
+            table[c] = true;
+        }
+    }
+
+    return table;
+}
+
+/**
+ * @brief Checks whether a character belongs to a character class
+ * @param table Lookup table of the class
+ * @param c Character to check
+ * @return bool True if the character is in the class
+ */
+constexpr bool isInClass(const CharClass& table, char c) noexcept
+{
+    return table[static_cast<unsigned char>(c)];
+}
+
+/**
+ * @brief ASCII letters, digits and underscore, the characters of a word
+ */
+inline constexpr auto WORD_CHARS{ makeCharClass("azAZ09__") };
+}
+
+#endif // CHAR_CLASS_H
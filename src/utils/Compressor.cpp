@@ -0,0 +1,447 @@
+#include "Compressor.h"
+#include <array>
+#include <charconv>
+#include <limits>
+#include <ranges>
+#include <boost/algorithm/string.hpp>
+
+#ifdef NOVA_CHAT_WITH_BROTLI
+#include <algorithm>
+#include <memory>
+#include <brotli/decode.h>
+#include <brotli/encode.h>
+#endif
+
+namespace utils
+{
+constexpr auto GZIP_WINDOW_BITS{ MAX_WBITS + 16 };   // gzip header and trailer
+constexpr auto ZLIB_WINDOW_BITS{ MAX_WBITS };        // zlib header and trailer
+constexpr auto INFLATE_WINDOW_BITS{ MAX_WBITS + 32 }; // automatic gzip/zlib header detection
+constexpr auto MEMORY_LEVEL{ 8 };
+constexpr size_t INFLATE_CHUNK_SIZE{ 16384 };
+
+#ifdef NOVA_CHAT_WITH_BROTLI
+constexpr auto MIN_BROTLI_QUALITY{ 1 };
+constexpr auto MAX_BROTLI_QUALITY{ 9 }; // higher qualities are too slow for on-the-fly compression
+#endif
+
+ZStreamWrapper::ZStreamWrapper(Mode mode, int windowBits, int level) noexcept :
+    mode_{ mode },
+    level_{ level }
+{
+    isValid_ = mode_ == Mode::Deflate ?
+        deflateInit2(&stream_, level_, Z_DEFLATED, windowBits, MEMORY_LEVEL, Z_DEFAULT_STRATEGY) == Z_OK :
+        inflateInit2(&stream_, windowBits) == Z_OK;
+}
+
+ZStreamWrapper::~ZStreamWrapper() noexcept
+{
+    if (!isValid_)
+    {
+        return;
+    }
+
+    if (mode_ == Mode::Deflate)
+    {
+        deflateEnd(&stream_);
+    }
+    else
+    {
+        inflateEnd(&stream_);
+    }
+}
+
+z_stream* ZStreamWrapper::get() noexcept
+{
+    return &stream_;
+}
+
+bool ZStreamWrapper::reset(int level) noexcept
+{
+    if (!isValid_)
+    {
+        return false;
+    }
+
+    if (mode_ == Mode::Inflate)
+    {
+        return inflateReset(&stream_) == Z_OK;
+    }
+
+    if (deflateReset(&stream_) != Z_OK)
+    {
+        return false;
+    }
+
+    // the level can only be changed on a fresh stream
+    if (level != level_)
+    {
+        if (deflateParams(&stream_, level, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            return false;
+        }
+
+        level_ = level;
+    }
+
+    return true;
+}
+
+ZStreamWrapper::operator bool() const noexcept
+{
+    return isValid_;
+}
+
+ContentEncoding Compressor::negotiate(std::string_view acceptEncoding) noexcept
+{
+    try
+    {
+        // server preference order used on equal q-values
+#ifdef NOVA_CHAT_WITH_BROTLI
+        constexpr std::array supported{ ContentEncoding::Brotli, ContentEncoding::Gzip, ContentEncoding::Deflate };
+#else
+        constexpr std::array supported{ ContentEncoding::Gzip, ContentEncoding::Deflate };
+#endif
+
+        std::array<double, supported.size()> qValues{};
+        qValues.fill(-1.0);
+        auto wildcard{ -1.0 };
+
+        for (const auto& range : acceptEncoding | std::views::split(','))
+        {
+            std::string_view item{ range.begin(), range.end() };
+
+            auto qValue{ 1.0 };
+            if (const auto semicolon{ item.find(';') }; semicolon != std::string_view::npos)
+            {
+                auto params{ boost::algorithm::trim_copy(std::string{ item.substr(semicolon + 1) }) };
+                boost::algorithm::to_lower(params);
+                boost::algorithm::erase_all(params, " ");
+
+                if (params.starts_with("q="))
+                {
+                    const auto* begin{ params.data() + 2 };
+                    const auto* end{ params.data() + params.size() };
+                    if (std::from_chars(begin, end, qValue).ec != std::errc{})
+                    {
+                        continue;
+                    }
+                }
+
+                item = item.substr(0, semicolon);
+            }
+
+            auto token{ boost::algorithm::trim_copy(std::string{ item }) };
+            boost::algorithm::to_lower(token);
+
+            if (token == "*")
+            {
+                wildcard = qValue;
+                continue;
+            }
+
+            auto encoding{ ContentEncoding::Identity };
+            if (!fromString(token, encoding))
+            {
+                continue;
+            }
+
+            for (auto i : std::views::iota(0u, supported.size()))
+            {
+                if (supported[i] == encoding)
+                {
+                    qValues[i] = qValue;
+                }
+            }
+        }
+
+        auto best{ ContentEncoding::Identity };
+        auto bestQValue{ 0.0 };
+
+        for (auto i : std::views::iota(0u, supported.size()))
+        {
+            // codings that are not listed explicitly take the wildcard q-value
+            const auto qValue{ qValues[i] < 0.0 ? wildcard : qValues[i] };
+            if (qValue > bestQValue)
+            {
+                best = supported[i];
+                bestQValue = qValue;
+            }
+        }
+
+        return best;
+    }
+    catch (const std::exception&)
+    {
+        return ContentEncoding::Identity;
+    }
+}
+
+bool Compressor::fromString(std::string_view contentEncoding, ContentEncoding& encoding) noexcept
+{
+    if (contentEncoding.empty() || boost::algorithm::iequals(contentEncoding, "identity"))
+    {
+        encoding = ContentEncoding::Identity;
+        return true;
+    }
+
+    if (boost::algorithm::iequals(contentEncoding, "gzip") || boost::algorithm::iequals(contentEncoding, "x-gzip"))
+    {
+        encoding = ContentEncoding::Gzip;
+        return true;
+    }
+
+    if (boost::algorithm::iequals(contentEncoding, "deflate"))
+    {
+        encoding = ContentEncoding::Deflate;
+        return true;
+    }
+
+#ifdef NOVA_CHAT_WITH_BROTLI
+    if (boost::algorithm::iequals(contentEncoding, "br"))
+    {
+        encoding = ContentEncoding::Brotli;
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+std::string_view Compressor::toString(ContentEncoding encoding) noexcept
+{
+    switch (encoding)
+    {
+    case ContentEncoding::Gzip:
+        return "gzip";
+    case ContentEncoding::Deflate:
+        return "deflate";
+    case ContentEncoding::Brotli:
+        return "br";
+    default:
+        return "identity";
+    }
+}
+
+bool Compressor::compress(std::string_view input, ContentEncoding encoding, int level, std::string& output) noexcept
+{
+    switch (encoding)
+    {
+    case ContentEncoding::Gzip:
+        return deflateData(input, GZIP_WINDOW_BITS, level, output);
+    case ContentEncoding::Deflate:
+        return deflateData(input, ZLIB_WINDOW_BITS, level, output);
+#ifdef NOVA_CHAT_WITH_BROTLI
+    case ContentEncoding::Brotli:
+        return brotliCompress(input, level, output);
+#endif
+    default:
+        return false;
+    }
+}
+
+bool Compressor::decompress(std::string_view input, ContentEncoding encoding, size_t maxSize, std::string& output) noexcept
+{
+    switch (encoding)
+    {
+    case ContentEncoding::Gzip:
+    case ContentEncoding::Deflate:
+        return inflateData(input, maxSize, output);
+#ifdef NOVA_CHAT_WITH_BROTLI
+    case ContentEncoding::Brotli:
+        return brotliDecompress(input, maxSize, output);
+#endif
+    default:
+        return false;
+    }
+}
+
+bool Compressor::deflateData(std::string_view input, int windowBits, int level, std::string& output) noexcept
+{
+    try
+    {
+        if (input.size() > std::numeric_limits<uInt>::max())
+        {
+            return false;
+        }
+
+        thread_local ZStreamWrapper gzipStream{ ZStreamWrapper::Mode::Deflate, GZIP_WINDOW_BITS };
+        thread_local ZStreamWrapper zlibStream{ ZStreamWrapper::Mode::Deflate, ZLIB_WINDOW_BITS };
+
+        auto& stream{ windowBits == GZIP_WINDOW_BITS ? gzipStream : zlibStream };
+        if (!stream.reset(level))
+        {
+            return false;
+        }
+
+        auto* zs{ stream.get() };
+
+        // the bound is large enough to compress the whole input in a single call
+        output.resize(deflateBound(zs, static_cast<uLong>(input.size())));
+
+        zs->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        zs->avail_in = static_cast<uInt>(input.size());
+        zs->next_out = reinterpret_cast<Bytef*>(output.data());
+        zs->avail_out = static_cast<uInt>(output.size());
+
+        if (deflate(zs, Z_FINISH) != Z_STREAM_END)
+        {
+            output.clear();
+            return false;
+        }
+
+        output.resize(output.size() - zs->avail_out);
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        output.clear();
+        return false;
+    }
+}
+
+bool Compressor::inflateData(std::string_view input, size_t maxSize, std::string& output) noexcept
+{
+    try
+    {
+        output.clear();
+
+        if (input.size() > std::numeric_limits<uInt>::max())
+        {
+            return false;
+        }
+
+        thread_local ZStreamWrapper stream{ ZStreamWrapper::Mode::Inflate, INFLATE_WINDOW_BITS };
+        if (!stream.reset())
+        {
+            return false;
+        }
+
+        auto* zs{ stream.get() };
+        zs->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        zs->avail_in = static_cast<uInt>(input.size());
+
+        std::array<char, INFLATE_CHUNK_SIZE> chunk{};
+        auto result{ Z_OK };
+
+        while (result != Z_STREAM_END)
+        {
+            zs->next_out = reinterpret_cast<Bytef*>(chunk.data());
+            zs->avail_out = static_cast<uInt>(chunk.size());
+
+            // Z_BUF_ERROR here means the input ended before the end of the stream
+            result = inflate(zs, Z_NO_FLUSH);
+            if (result != Z_OK && result != Z_STREAM_END)
+            {
+                output.clear();
+                return false;
+            }
+
+            const auto produced{ chunk.size() - zs->avail_out };
+            if (output.size() + produced > maxSize)
+            {
+                output.clear();
+                return false;
+            }
+
+            output.append(chunk.data(), produced);
+        }
+
+        // trailing data after the end of the stream is rejected
+        if (zs->avail_in != 0)
+        {
+            output.clear();
+            return false;
+        }
+
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        output.clear();
+        return false;
+    }
+}
+
+#ifdef NOVA_CHAT_WITH_BROTLI
+bool Compressor::brotliCompress(std::string_view input, int level, std::string& output) noexcept
+{
+    try
+    {
+        auto encodedSize{ BrotliEncoderMaxCompressedSize(input.size()) };
+        if (encodedSize == 0)
+        {
+            return false;
+        }
+
+        output.resize(encodedSize);
+
+        if (!BrotliEncoderCompress(std::clamp(level, MIN_BROTLI_QUALITY, MAX_BROTLI_QUALITY), BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+            input.size(), reinterpret_cast<const uint8_t*>(input.data()), &encodedSize, reinterpret_cast<uint8_t*>(output.data())))
+        {
+            output.clear();
+            return false;
+        }
+
+        output.resize(encodedSize);
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        output.clear();
+        return false;
+    }
+}
+
+bool Compressor::brotliDecompress(std::string_view input, size_t maxSize, std::string& output) noexcept
+{
+    try
+    {
+        output.clear();
+
+        const std::unique_ptr<BrotliDecoderState, decltype(&BrotliDecoderDestroyInstance)> state{
+            BrotliDecoderCreateInstance(nullptr, nullptr, nullptr), &BrotliDecoderDestroyInstance };
+        if (!state)
+        {
+            return false;
+        }
+
+        auto availableIn{ input.size() };
+        const auto* nextIn{ reinterpret_cast<const uint8_t*>(input.data()) };
+
+        std::array<uint8_t, INFLATE_CHUNK_SIZE> chunk{};
+        auto result{ BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT };
+
+        while (result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT)
+        {
+            auto availableOut{ chunk.size() };
+            auto* nextOut{ chunk.data() };
+
+            result = BrotliDecoderDecompressStream(state.get(), &availableIn, &nextIn, &availableOut, &nextOut, nullptr);
+
+            const auto produced{ chunk.size() - availableOut };
+            if (output.size() + produced > maxSize)
+            {
+                output.clear();
+                return false;
+            }
+
+            output.append(reinterpret_cast<const char*>(chunk.data()), produced);
+        }
+
+        if (result != BROTLI_DECODER_RESULT_SUCCESS || availableIn != 0)
+        {
+            output.clear();
+            return false;
+        }
+
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        output.clear();
+        return false;
+    }
+}
+#endif
+}
@@ -0,0 +1,215 @@
+#ifndef COMPRESSOR_H
+#define COMPRESSOR_H
+
+#include <string>
+#include <string_view>
+#include <zlib.h>
+
+namespace utils
+{
+/**
+ * @enum ContentEncoding
+ * @brief HTTP content codings supported for request and response bodies
+ */
+enum class ContentEncoding
+{
+    Identity, ///< No compression
+    Gzip,     ///< gzip (RFC 1952)
+    Deflate,  ///< zlib-wrapped deflate (RFC 1950)
+    Brotli    ///< Brotli (RFC 7932), available when built with NOVA_CHAT_WITH_BROTLI
+};
+
+/**
+ * @class ZStreamWrapper
+ * @brief RAII wrapper for a zlib z_stream used for compression or decompression
+ *
+ * Initializes the stream once and resets it between uses, so that the internal
+ * zlib state (window, hash tables) is allocated once per owner and then reused.
+ *
+ * @note The z_stream keeps a pointer to itself, so the wrapper can be neither copied nor moved
+ * @warning Not thread-safe - each instance should be used by single thread
+ */
+class ZStreamWrapper final
+{
+public:
+    /**
+     * @enum Mode
+     * @brief Direction of the wrapped stream
+     */
+    enum class Mode
+    {
+        Deflate, ///< Compression stream
+        Inflate  ///< Decompression stream
+    };
+
+    /**
+     * @brief Constructs and initializes the z_stream
+     * @param mode Compression or decompression stream
+     * @param windowBits zlib window bits selecting the stream format (gzip, zlib or auto-detect)
+     * @param level Compression level (ignored for decompression streams)
+     */
+    ZStreamWrapper(Mode mode, int windowBits, int level = Z_DEFAULT_COMPRESSION) noexcept;
+
+    /**
+     * @brief Destructor that releases the zlib state
+     */
+    ~ZStreamWrapper() noexcept;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note ZStreamWrapper should not be copied
+     */
+    ZStreamWrapper(const ZStreamWrapper&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note ZStreamWrapper should not be copied
+     */
+    ZStreamWrapper& operator=(const ZStreamWrapper&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note ZStreamWrapper should not be moved
+     */
+    ZStreamWrapper(ZStreamWrapper&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note ZStreamWrapper should not be moved
+     */
+    ZStreamWrapper& operator=(ZStreamWrapper&&) = delete;
+
+    /**
+     * @brief Gets raw pointer to the underlying z_stream
+     * @return z_stream* Pointer to zlib stream
+     */
+    [[nodiscard]] z_stream* get() noexcept;
+
+    /**
+     * @brief Resets the stream so it can process a new input
+     * @param level Compression level for the next input (ignored for decompression streams)
+     * @return bool True if the stream is ready for use, false otherwise
+     */
+    [[nodiscard]] bool reset(int level = Z_DEFAULT_COMPRESSION) noexcept;
+
+    /**
+     * @brief Boolean conversion operator
+     * @return bool True if the stream was initialized successfully, false otherwise
+     */
+    explicit operator bool() const noexcept;
+
+private:
+    z_stream stream_{}; ///< zlib stream state
+    Mode mode_;         ///< Direction of the stream
+    int level_;         ///< Current compression level
+    bool isValid_;      ///< Initialization result flag
+};
+
+/**
+ * @class Compressor
+ * @brief Provides HTTP content coding negotiation, compression and decompression
+ *
+ * Implements Accept-Encoding negotiation and gzip/deflate (optionally Brotli)
+ * compression of response bodies and decompression of request bodies.
+ * zlib streams are kept per thread and reset between calls instead of being
+ * allocated for every message.
+ *
+ * @note All methods are thread-safe (use thread-local zlib contexts)
+ */
+class Compressor final
+{
+public:
+    /**
+     * @brief Deleted default constructor
+     * @note This is a utility class with only static methods
+     */
+    Compressor() noexcept = delete;
+
+    /**
+     * @brief Selects the response content coding from an Accept-Encoding header value
+     * @param acceptEncoding Accept-Encoding header value
+     * @return ContentEncoding Best supported coding, Identity if none is acceptable
+     * @note Honors q-values (q=0 excludes a coding) and the "*" wildcard; on equal
+     *       q-values prefers br, then gzip, then deflate
+     */
+    [[nodiscard]] static ContentEncoding negotiate(std::string_view acceptEncoding) noexcept;
+
+    /**
+     * @brief Parses a Content-Encoding header value
+     * @param contentEncoding Content-Encoding header value
+     * @param[out] encoding Parsed content coding
+     * @return bool True if the coding is supported, false otherwise
+     * @note An empty value and "identity" are parsed as Identity
+     */
+    [[nodiscard]] static bool fromString(std::string_view contentEncoding, ContentEncoding& encoding) noexcept;
+
+    /**
+     * @brief Converts a content coding to its header token
+     * @param encoding Content coding
+     * @return std::string_view Header token ("gzip", "deflate", "br" or "identity")
+     */
+    [[nodiscard]] static std::string_view toString(ContentEncoding encoding) noexcept;
+
+    /**
+     * @brief Compresses data with the given content coding
+     * @param input Data to compress
+     * @param encoding Content coding to apply
+     * @param level Compression level (1-9 for gzip/deflate, mapped to 0-11 for Brotli)
+     * @param[out] output Compressed data
+     * @return bool True on success, false if the coding is not supported or compression failed
+     */
+    [[nodiscard]] static bool compress(std::string_view input, ContentEncoding encoding, int level, std::string& output) noexcept;
+
+    /**
+     * @brief Decompresses data encoded with the given content coding
+     * @param input Data to decompress
+     * @param encoding Content coding of the data
+     * @param maxSize Maximum allowed size of the decompressed data
+     * @param[out] output Decompressed data
+     * @return bool True on success, false if the data is malformed, truncated or exceeds maxSize
+     */
+    [[nodiscard]] static bool decompress(std::string_view input, ContentEncoding encoding, size_t maxSize, std::string& output) noexcept;
+
+private:
+    /**
+     * @brief Compresses data with a thread-local zlib stream
+     * @param input Data to compress
+     * @param windowBits zlib window bits selecting gzip or zlib format
+     * @param level Compression level
+     * @param[out] output Compressed data
+     * @return bool True on success, false otherwise
+     */
+    [[nodiscard]] static bool deflateData(std::string_view input, int windowBits, int level, std::string& output) noexcept;
+
+    /**
+     * @brief Decompresses gzip or zlib data with a thread-local zlib stream
+     * @param input Data to decompress
+     * @param maxSize Maximum allowed size of the decompressed data
+     * @param[out] output Decompressed data
+     * @return bool True on success, false otherwise
+     */
+    [[nodiscard]] static bool inflateData(std::string_view input, size_t maxSize, std::string& output) noexcept;
+
+#ifdef NOVA_CHAT_WITH_BROTLI
+    /**
+     * @brief Compresses data with Brotli
+     * @param input Data to compress
+     * @param level Compression level (1-9, mapped to Brotli quality)
+     * @param[out] output Compressed data
+     * @return bool True on success, false otherwise
+     */
+    [[nodiscard]] static bool brotliCompress(std::string_view input, int level, std::string& output) noexcept;
+
+    /**
+     * @brief Decompresses Brotli data
+     * @param input Data to decompress
+     * @param maxSize Maximum allowed size of the decompressed data
+     * @param[out] output Decompressed data
+     * @return bool True on success, false otherwise
+     */
+    [[nodiscard]] static bool brotliDecompress(std::string_view input, size_t maxSize, std::string& output) noexcept;
+#endif
+};
+}
+
+#endif // COMPRESSOR_H
@@ -0,0 +1,152 @@
+#include "Deadline.h"
+#include <algorithm>
+
+namespace utils
+{
+/**
+ * @struct CancelRegistration::State
+ * @brief State shared by the copies of a Deadline
+ */
+struct CancelRegistration::State final
+{
+    std::chrono::steady_clock::time_point expiry;       ///< Time the deadline passes
+    std::chrono::steady_clock::duration budget;         ///< Whole time budget
+    std::atomic<bool> isCancelled{ false };             ///< Whether the request was cancelled
+    std::mutex mutex;                                   ///< Mutex for handlers and nextId, held while handlers run
+    std::map<uint64_t, std::function<void()>> handlers; ///< Cancel handlers by id
+    uint64_t nextId{ 1 };                               ///< Id of the next handler
+};
+
+thread_local const Deadline* DeadlineScope::current_{ nullptr };
+
+CancelRegistration::CancelRegistration(std::shared_ptr<State> state, uint64_t id) noexcept :
+    state_{ std::move(state) },
+    id_{ id }
+{
+}
+
+CancelRegistration::~CancelRegistration() noexcept
+{
+    reset();
+}
+
+CancelRegistration& CancelRegistration::operator=(CancelRegistration&& other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        state_ = std::move(other.state_);
+        id_ = other.id_;
+    }
+
+    return *this;
+}
+
+void CancelRegistration::reset() noexcept
+{
+    if (state_)
+    {
+        std::lock_guard lock{ state_->mutex };
+        state_->handlers.erase(id_);
+    }
+
+    state_.reset();
+}
+
+Deadline::Deadline(std::chrono::steady_clock::duration budget) :
+    state_{ std::make_shared<State>() }
+{
+    state_->budget = std::max(budget, std::chrono::steady_clock::duration::zero());
+    state_->expiry = std::chrono::steady_clock::now() + state_->budget;
+}
+
+bool Deadline::hasLimit() const noexcept
+{
+    return state_ != nullptr;
+}
+
+std::chrono::steady_clock::duration Deadline::getBudget() const noexcept
+{
+    return state_ ? state_->budget : std::chrono::steady_clock::duration::zero();
+}
+
+std::chrono::steady_clock::duration Deadline::getRemaining() const noexcept
+{
+    if (!state_)
+    {
+        return std::chrono::steady_clock::duration::max();
+    }
+
+    return std::max(state_->expiry - std::chrono::steady_clock::now(), std::chrono::steady_clock::duration::zero());
+}
+
+bool Deadline::isExpired() const noexcept
+{
+    return state_ && std::chrono::steady_clock::now() >= state_->expiry;
+}
+
+void Deadline::cancel() noexcept
+{
+    if (!state_ || state_->isCancelled.exchange(true))
+    {
+        return;
+    }
+
+    // handlers run under the lock, so a registration released meanwhile waits for its handler to finish
+    std::lock_guard lock{ state_->mutex };
+    for (const auto& [_, handler] : state_->handlers)
+    {
+        try
+        {
+            handler();
+        }
+        catch (...)
+        {
+            // a failed cancellation leaves the request to its time budget
+        }
+    }
+
+    state_->handlers.clear();
+}
+
+bool Deadline::isCancelled() const noexcept
+{
+    return state_ && state_->isCancelled.load();
+}
+
+CancelRegistration Deadline::onCancel(std::function<void()> handler) const
+{
+    if (!state_)
+    {
+        return CancelRegistration{};
+    }
+
+    std::unique_lock lock{ state_->mutex };
+    if (state_->isCancelled.load())
+    {
+        lock.unlock();
+        handler();
+        return CancelRegistration{};
+    }
+
+    const auto id{ state_->nextId++ };
+    state_->handlers.emplace(id, std::move(handler));
+    return CancelRegistration{ state_, id };
+}
+
+DeadlineScope::DeadlineScope(const Deadline& deadline) noexcept :
+    previous_{ current_ }
+{
+    current_ = &deadline;
+}
+
+DeadlineScope::~DeadlineScope() noexcept
+{
+    current_ = previous_;
+}
+
+const Deadline* DeadlineScope::getCurrent() noexcept
+{
+    return current_;
+}
+}
@@ -0,0 +1,251 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace utils
+{
+class Deadline;
+
+/**
+ * @class CancelRegistration
+ * @brief Cancel handler of a Deadline, unregistered when the registration is destroyed
+ * @see Deadline::onCancel
+ */
+class CancelRegistration final
+{
+public:
+    /**
+     * @brief Constructs an empty registration
+     */
+    CancelRegistration() noexcept = default;
+
+    /**
+     * @brief Destructor that unregisters the handler
+     */
+    ~CancelRegistration() noexcept;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note A handler is registered once
+     */
+    CancelRegistration(const CancelRegistration&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note A handler is registered once
+     */
+    CancelRegistration& operator=(const CancelRegistration&) = delete;
+
+    /**
+     * @brief Default move constructor
+     * @note The moved-from registration becomes empty
+     */
+    CancelRegistration(CancelRegistration&&) noexcept = default;
+
+    /**
+     * @brief Move assignment operator that unregisters the current handler first
+     * @param other Registration to take over
+     * @return CancelRegistration& Reference to this registration
+     */
+    CancelRegistration& operator=(CancelRegistration&& other) noexcept;
+
+    /**
+     * @brief Unregisters the handler and empties the registration
+     * @note Waits for the handler if it is running, so its captures may be released afterwards
+     */
+    void reset() noexcept;
+
+private:
+    friend class Deadline;
+
+    struct State;
+
+    /**
+     * @brief Constructs a registration of a handler
+     * @param state Shared state of the deadline
+     * @param id Id of the handler
+     */
+    CancelRegistration(std::shared_ptr<State> state, uint64_t id) noexcept;
+
+private:
+    std::shared_ptr<State> state_; ///< Shared state of the deadline, null if empty
+    uint64_t id_{ 0 };             ///< Id of the handler
+};
+
+/**
+ * @class Deadline
+ * @brief Time budget of one request and its cancellation by the client
+ *
+ * Created when a request arrives and handed down to the code that serves it,
+ * which bounds its waits by getRemaining and gives up once the request is
+ * cancelled. Copies share their state, so a request cancelled by its session
+ * (e.g. when the client resets the stream or disconnects) is cancelled for
+ * every holder, and the registered cancel handlers run once.
+ *
+ * A default constructed deadline never expires and cannot be cancelled.
+ *
+ * @note Thread-safe
+ * @see DeadlineScope
+ */
+class Deadline final
+{
+public:
+    /**
+     * @brief Constructs a deadline without a time limit
+     */
+    Deadline() noexcept = default;
+
+    /**
+     * @brief Constructs a deadline that expires after a budget from now
+     * @param budget Time the request may take
+     */
+    explicit Deadline(std::chrono::steady_clock::duration budget);
+
+    /**
+     * @brief Default destructor
+     */
+    ~Deadline() noexcept = default;
+
+    /**
+     * @brief Default copy constructor
+     * @note The copy shares the expiry and cancellation
+     */
+    Deadline(const Deadline&) = default;
+
+    /**
+     * @brief Default copy assignment operator
+     * @note The copy shares the expiry and cancellation
+     */
+    Deadline& operator=(const Deadline&) = default;
+
+    /**
+     * @brief Default move constructor
+     */
+    Deadline(Deadline&&) noexcept = default;
+
+    /**
+     * @brief Default move assignment operator
+     */
+    Deadline& operator=(Deadline&&) noexcept = default;
+
+    /**
+     * @brief Checks if the deadline has a time limit
+     * @return bool True if the deadline expires
+     */
+    [[nodiscard]] bool hasLimit() const noexcept;
+
+    /**
+     * @brief Gets the whole time budget
+     * @return std::chrono::steady_clock::duration Budget given at construction, zero without a time limit
+     */
+    [[nodiscard]] std::chrono::steady_clock::duration getBudget() const noexcept;
+
+    /**
+     * @brief Gets the time left
+     * @return std::chrono::steady_clock::duration Time until expiry, zero once expired, the maximum duration without a time limit
+     */
+    [[nodiscard]] std::chrono::steady_clock::duration getRemaining() const noexcept;
+
+    /**
+     * @brief Checks if the time budget is used up
+     * @return bool True if the deadline has passed
+     */
+    [[nodiscard]] bool isExpired() const noexcept;
+
+    /**
+     * @brief Cancels the request and runs the cancel handlers
+     * @note Only the first call runs the handlers
+     * @note The handlers may block, e.g. to cancel a database query, so I/O threads should cancel from another thread
+     */
+    void cancel() noexcept;
+
+    /**
+     * @brief Checks if the request was cancelled
+     * @return bool True after cancel
+     */
+    [[nodiscard]] bool isCancelled() const noexcept;
+
+    /**
+     * @brief Registers a handler that runs when the request is cancelled
+     * @param handler Handler, runs on the thread that cancels and must not use this deadline
+     * @return CancelRegistration Registration that keeps the handler until it is destroyed,
+     *         empty if the deadline cannot be cancelled
+     * @note The handler runs at once if the request is cancelled already
+     */
+    [[nodiscard]] CancelRegistration onCancel(std::function<void()> handler) const;
+
+private:
+    using State = CancelRegistration::State;
+
+    std::shared_ptr<State> state_; ///< Shared state, null without a time limit
+};
+
+/**
+ * @class DeadlineScope
+ * @brief Makes a deadline the current one of the calling thread while the scope lives
+ *
+ * Lets code deep in the call chain, such as the database layer, find the deadline
+ * of the request it serves without every function in between passing it on.
+ * Scopes nest; the previous deadline is current again when a scope ends.
+ *
+ * @warning The deadline must outlive the scope
+ */
+class DeadlineScope final
+{
+public:
+    /**
+     * @brief Makes a deadline current
+     * @param deadline Deadline of the request served by this thread
+     */
+    explicit DeadlineScope(const Deadline& deadline) noexcept;
+
+    /**
+     * @brief Destructor that makes the previous deadline current again
+     */
+    ~DeadlineScope() noexcept;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note DeadlineScope should not be copied
+     */
+    DeadlineScope(const DeadlineScope&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note DeadlineScope should not be copied
+     */
+    DeadlineScope& operator=(const DeadlineScope&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note DeadlineScope should not be moved
+     */
+    DeadlineScope(DeadlineScope&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note DeadlineScope should not be moved
+     */
+    DeadlineScope& operator=(DeadlineScope&&) = delete;
+
+    /**
+     * @brief Gets the current deadline of the calling thread
+     * @return const Deadline* Deadline of the innermost scope, or nullptr outside of any scope
+     */
+    [[nodiscard]] static const Deadline* getCurrent() noexcept;
+
+private:
+    const Deadline* previous_; ///< Deadline that was current before this scope
+
+    static thread_local const Deadline* current_; ///< Current deadline of the thread
+};
+}
+
+#endif // DEADLINE_H
@@ -0,0 +1,328 @@
+#include "FileWriter.h"
+
+#ifdef NOVA_CHAT_WITH_IO_URING
+#include <cerrno>
+#include <limits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utils
+{
+#ifdef NOVA_CHAT_WITH_IO_URING
+constexpr unsigned RING_ENTRIES{ 64 };
+constexpr size_t MAX_PENDING_WRITES{ RING_ENTRIES };
+constexpr mode_t FILE_PERMISSIONS{ 0644 };
+constexpr std::uint64_t NO_WRITE_ID{ std::numeric_limits<std::uint64_t>::max() };
+#endif
+
+FileWriter::FileWriter() noexcept :
+#ifdef NOVA_CHAT_WITH_IO_URING
+    fileDescriptor_{ -1 },
+    ring_{},
+    isRingReady_{ false },
+    nextWriteId_{ 0 },
+#endif
+    size_{ 0 },
+    isFailed_{ false }
+{
+}
+
+FileWriter::~FileWriter() noexcept
+{
+    if (isOpen())
+    {
+        close();
+    }
+}
+
+bool FileWriter::open(const std::filesystem::path& path, bool isTruncate) noexcept
+{
+    if (isOpen())
+    {
+        return false;
+    }
+
+    isFailed_ = false;
+
+#ifdef NOVA_CHAT_WITH_IO_URING
+    // no O_APPEND: every write carries its own offset, which pwrite would ignore in append mode
+    fileDescriptor_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (isTruncate ? O_TRUNC : 0), FILE_PERMISSIONS);
+    if (fileDescriptor_ < 0)
+    {
+        fileDescriptor_ = -1;
+        return false;
+    }
+
+    struct stat status{};
+    if (::fstat(fileDescriptor_, &status) != 0)
+    {
+        ::close(fileDescriptor_);
+        fileDescriptor_ = -1;
+        return false;
+    }
+
+    size_ = static_cast<std::uint64_t>(status.st_size);
+
+    // the same writes are made with pwrite when the kernel lacks io_uring
+    isRingReady_ = io_uring_queue_init(RING_ENTRIES, &ring_, 0) == 0;
+    return true;
+#else
+    file_.open(path, std::ios::binary | (isTruncate ? std::ios::trunc : std::ios::app));
+    if (!file_.is_open())
+    {
+        return false;
+    }
+
+    std::error_code ec{};
+    const auto size{ std::filesystem::file_size(path, ec) };
+    size_ = ec ? 0 : static_cast<std::uint64_t>(size);
+    return true;
+#endif
+}
+
+bool FileWriter::isOpen() const noexcept
+{
+#ifdef NOVA_CHAT_WITH_IO_URING
+    return fileDescriptor_ >= 0;
+#else
+    return file_.is_open();
+#endif
+}
+
+bool FileWriter::write(std::string_view data) noexcept
+{
+    if (!isOpen() || isFailed_)
+    {
+        return false;
+    }
+
+    if (data.empty())
+    {
+        return true;
+    }
+
+#ifdef NOVA_CHAT_WITH_IO_URING
+    isFailed_ = !(isRingReady_ ? submit(data) : writeAt(data, size_));
+#else
+    // flushed right away, like a write system call, so that the data is visible to readers of the file
+    file_.write(data.data(), static_cast<std::streamsize>(data.size()));
+    file_.flush();
+    isFailed_ = !file_;
+#endif
+
+    size_ += data.size();
+    return !isFailed_;
+}
+
+void FileWriter::flush() noexcept
+{
+#ifdef NOVA_CHAT_WITH_IO_URING
+    while (!pendingWrites_.empty())
+    {
+        if (!reap(true))
+        {
+            isFailed_ = true;
+            return;
+        }
+    }
+#else
+    if (file_.is_open() && !file_.flush())
+    {
+        isFailed_ = true;
+    }
+#endif
+}
+
+bool FileWriter::close() noexcept
+{
+    if (!isOpen())
+    {
+        return false;
+    }
+
+    flush();
+
+#ifdef NOVA_CHAT_WITH_IO_URING
+    if (isRingReady_)
+    {
+        io_uring_queue_exit(&ring_);
+        isRingReady_ = false;
+    }
+
+    if (::close(fileDescriptor_) != 0)
+    {
+        isFailed_ = true;
+    }
+
+    fileDescriptor_ = -1;
+    pendingWrites_.clear();
+#else
+    file_.close();
+    if (!file_)
+    {
+        isFailed_ = true;
+    }
+#endif
+
+    return !isFailed_;
+}
+
+std::uint64_t FileWriter::getSize() const noexcept
+{
+    return size_;
+}
+
+bool FileWriter::isIoUringEnabled() const noexcept
+{
+#ifdef NOVA_CHAT_WITH_IO_URING
+    return isRingReady_;
+#else
+    return false;
+#endif
+}
+
+bool FileWriter::isIoUringSupported() noexcept
+{
+#ifdef NOVA_CHAT_WITH_IO_URING
+    static const auto isSupported{ []() noexcept
+    {
+        io_uring ring{};
+        if (io_uring_queue_init(1, &ring, 0) != 0)
+        {
+            return false;
+        }
+
+        io_uring_queue_exit(&ring);
+        return true;
+    }() };
+
+    return isSupported;
+#else
+    return false;
+#endif
+}
+
+#ifdef NOVA_CHAT_WITH_IO_URING
+bool FileWriter::submit(std::string_view data) noexcept
+{
+    if (data.size() > std::numeric_limits<unsigned>::max())
+    {
+        return writeAt(data, size_);
+    }
+
+    try
+    {
+        // bounds the memory held for writes the kernel has not finished
+        if (pendingWrites_.size() >= MAX_PENDING_WRITES && !reap(true))
+        {
+            return false;
+        }
+
+        auto* const sqe{ io_uring_get_sqe(&ring_) };
+        if (sqe == nullptr)
+        {
+            return writeAt(data, size_);
+        }
+
+        // map nodes do not move, so the kernel can read the data in place
+        const auto id{ nextWriteId_++ };
+        const auto& pending{ pendingWrites_.try_emplace(id, PendingWrite{ std::string{ data }, size_ }).first->second };
+
+        io_uring_prep_write(sqe, fileDescriptor_, pending.data.data(), static_cast<unsigned>(pending.data.size()), pending.offset);
+        io_uring_sqe_set_data64(sqe, id);
+
+        if (io_uring_submit(&ring_) < 0)
+        {
+            // the entry stays queued, so it becomes a no-op that no longer refers to the data
+            io_uring_prep_nop(sqe);
+            io_uring_sqe_set_data64(sqe, NO_WRITE_ID);
+            pendingWrites_.erase(id);
+            return writeAt(data, size_);
+        }
+
+        return reap(false);
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+bool FileWriter::reap(bool isWait) noexcept
+{
+    io_uring_cqe* cqe{ nullptr };
+
+    if (isWait)
+    {
+        auto result{ io_uring_wait_cqe(&ring_, &cqe) };
+        while (result == -EINTR)
+        {
+            result = io_uring_wait_cqe(&ring_, &cqe);
+        }
+
+        if (result < 0)
+        {
+            return false;
+        }
+    }
+    else if (io_uring_peek_cqe(&ring_, &cqe) != 0)
+    {
+        return true;
+    }
+
+    // the other completions that are ready are collected together with the first one
+    do
+    {
+        complete(io_uring_cqe_get_data64(cqe), cqe->res);
+        io_uring_cqe_seen(&ring_, cqe);
+    } while (io_uring_peek_cqe(&ring_, &cqe) == 0);
+
+    return true;
+}
+
+void FileWriter::complete(std::uint64_t id, int result) noexcept
+{
+    const auto it{ pendingWrites_.find(id) };
+    if (it == pendingWrites_.end())
+    {
+        return;
+    }
+
+    const auto& [data, offset] { it->second };
+    if (result < 0)
+    {
+        isFailed_ = true;
+    }
+    else if (static_cast<size_t>(result) < data.size() && !writeAt(std::string_view{ data }.substr(static_cast<size_t>(result)), offset + static_cast<std::uint64_t>(result)))
+    {
+        isFailed_ = true;
+    }
+
+    pendingWrites_.erase(it);
+}
+
+bool FileWriter::writeAt(std::string_view data, std::uint64_t offset) const noexcept
+{
+    while (!data.empty())
+    {
+        const auto written{ ::pwrite(fileDescriptor_, data.data(), data.size(), static_cast<off_t>(offset)) };
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (written <= 0)
+        {
+            return false;
+        }
+
+        data.remove_prefix(static_cast<size_t>(written));
+        offset += static_cast<std::uint64_t>(written);
+    }
+
+    return true;
+}
+#endif
+}
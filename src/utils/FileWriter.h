@@ -0,0 +1,179 @@
+#ifndef FILE_WRITER_H
+#define FILE_WRITER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#ifdef NOVA_CHAT_WITH_IO_URING
+#include <unordered_map>
+#include <liburing.h>
+#else
+#include <fstream>
+#endif
+
+namespace utils
+{
+/**
+ * @class FileWriter
+ * @brief Sequential writer of log and upload files
+ *
+ * When the server is built with io_uring (-DWITH_IO_URING=ON), writes are submitted
+ * to a ring owned by the writer and the caller does not wait for the disk: the data
+ * is copied and kept until the kernel reports the write complete. Each write has its
+ * own file offset, so the file content keeps the order of the calls even when writes
+ * complete out of order. If the kernel does not provide io_uring, the writer falls
+ * back to pwrite. Other builds write through a std::ofstream.
+ *
+ * A failed write is reported by the next call to write() or by close().
+ *
+ * @note Not thread-safe; callers serialize access (the logger with its mutexes, sessions on their strands)
+ * @warning Must not log: the logger writes its files through this class
+ */
+class FileWriter final
+{
+public:
+    /**
+     * @brief Constructs a writer without an open file
+     */
+    FileWriter() noexcept;
+
+    /**
+     * @brief Destructor that waits for pending writes and closes the file
+     */
+    ~FileWriter() noexcept;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note FileWriter should not be copied
+     */
+    FileWriter(const FileWriter&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note FileWriter should not be copied
+     */
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note FileWriter should not be moved, the kernel holds pointers to its pending data
+     */
+    FileWriter(FileWriter&&) noexcept = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note FileWriter should not be moved, the kernel holds pointers to its pending data
+     */
+    FileWriter& operator=(FileWriter&&) noexcept = delete;
+
+    /**
+     * @brief Opens a file for writing, creating it if missing
+     * @param path File to write
+     * @param isTruncate True to discard the current content, false to append to it
+     * @return bool True on success, false if the file cannot be opened or a file is already open
+     */
+    [[nodiscard]] bool open(const std::filesystem::path& path, bool isTruncate) noexcept;
+
+    /**
+     * @brief Checks if a file is open
+     * @return bool True if a file is open
+     */
+    [[nodiscard]] bool isOpen() const noexcept;
+
+    /**
+     * @brief Writes data at the end of the file
+     * @param data Data to write, copied if the write completes later
+     * @return bool False if no file is open or this or an earlier write has failed
+     */
+    [[nodiscard]] bool write(std::string_view data) noexcept;
+
+    /**
+     * @brief Waits until all written data has reached the file
+     */
+    void flush() noexcept;
+
+    /**
+     * @brief Waits for pending writes and closes the file
+     * @return bool True if every write since open succeeded
+     */
+    bool close() noexcept;
+
+    /**
+     * @brief Gets the size of the file including the data written so far
+     * @return std::uint64_t Size in bytes
+     */
+    [[nodiscard]] std::uint64_t getSize() const noexcept;
+
+    /**
+     * @brief Checks if writes of the open file are submitted to io_uring
+     * @return bool True if io_uring is used, false if writes block the caller
+     */
+    [[nodiscard]] bool isIoUringEnabled() const noexcept;
+
+    /**
+     * @brief Checks if the server is built with io_uring and the kernel provides it
+     * @return bool True if io_uring can be used
+     * @note The kernel is probed once; io_uring may be missing or disabled (kernel.io_uring_disabled)
+     */
+    [[nodiscard]] static bool isIoUringSupported() noexcept;
+
+private:
+#ifdef NOVA_CHAT_WITH_IO_URING
+    /**
+     * @struct PendingWrite
+     * @brief Data of a write the kernel has not completed yet
+     */
+    struct PendingWrite final
+    {
+        std::string data;     ///< Data being written, must stay in place until the write completes
+        std::uint64_t offset; ///< File offset of the data
+    };
+
+    /**
+     * @brief Submits a write of data at the end of the file to the ring
+     * @param data Data to write
+     * @return bool True if the write was submitted or written directly
+     */
+    [[nodiscard]] bool submit(std::string_view data) noexcept;
+
+    /**
+     * @brief Collects completed writes from the ring
+     * @param isWait True to wait for at least one completion
+     * @return bool False if waiting failed
+     */
+    [[nodiscard]] bool reap(bool isWait) noexcept;
+
+    /**
+     * @brief Finishes a write reported by the kernel
+     * @param id Identifier of the pending write
+     * @param result Number of bytes written, or a negative errno value
+     * @note A short write is finished with pwrite
+     */
+    void complete(std::uint64_t id, int result) noexcept;
+
+    /**
+     * @brief Writes data at an offset with pwrite, blocking the caller
+     * @param data Data to write
+     * @param offset File offset of the data
+     * @return bool True if all data was written
+     */
+    [[nodiscard]] bool writeAt(std::string_view data, std::uint64_t offset) const noexcept;
+
+private:
+    int fileDescriptor_;                                          ///< Descriptor of the open file, or -1
+    io_uring ring_;                                               ///< Queues of the file's writes
+    bool isRingReady_;                                            ///< Whether ring_ is initialized; writes block otherwise
+    std::uint64_t nextWriteId_;                                   ///< Identifier of the next submitted write
+    std::unordered_map<std::uint64_t, PendingWrite> pendingWrites_; ///< Writes not completed yet, by identifier
+#else
+    std::ofstream file_; ///< Open file
+#endif
+
+    std::uint64_t size_; ///< File size including the data written so far
+    bool isFailed_;      ///< Whether a write has failed since open
+};
+}
+
+#endif // FILE_WRITER_H
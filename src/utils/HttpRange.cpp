@@ -0,0 +1,95 @@
+#include "HttpRange.h"
+#include <algorithm>
+#include <charconv>
+#include <format>
+
+namespace utils
+{
+constexpr std::string_view BYTES_UNIT{ "bytes=" };
+
+RangeStatus HttpRange::parse(std::string_view header, std::uint64_t size, ByteRange& range) noexcept
+{
+    // only a single range in bytes is served partially
+    if (!header.starts_with(BYTES_UNIT) || header.find(',') != std::string_view::npos)
+    {
+        return RangeStatus::None;
+    }
+
+    const auto spec{ header.substr(BYTES_UNIT.size()) };
+    const auto dash{ spec.find('-') };
+    if (dash == std::string_view::npos)
+    {
+        return RangeStatus::None;
+    }
+
+    const auto firstText{ spec.substr(0, dash) };
+    const auto lastText{ spec.substr(dash + 1) };
+
+    // suffix range: the last N bytes
+    if (firstText.empty())
+    {
+        std::uint64_t suffix{ 0 };
+        if (!parseNumber(lastText, suffix))
+        {
+            return RangeStatus::None;
+        }
+
+        if (suffix == 0 || size == 0)
+        {
+            return RangeStatus::Unsatisfiable;
+        }
+
+        range.first = suffix >= size ? 0 : size - suffix;
+        range.last = size - 1;
+        return RangeStatus::Satisfiable;
+    }
+
+    std::uint64_t first{ 0 };
+    if (!parseNumber(firstText, first))
+    {
+        return RangeStatus::None;
+    }
+
+    auto last{ size > 0 ? size - 1 : 0 };
+    if (!lastText.empty())
+    {
+        std::uint64_t requestedLast{ 0 };
+        if (!parseNumber(lastText, requestedLast) || requestedLast < first)
+        {
+            return RangeStatus::None;
+        }
+
+        last = std::min(last, requestedLast);
+    }
+
+    if (first >= size)
+    {
+        return RangeStatus::Unsatisfiable;
+    }
+
+    range.first = first;
+    range.last = last;
+    return RangeStatus::Satisfiable;
+}
+
+std::string HttpRange::toContentRange(const ByteRange& range, std::uint64_t size)
+{
+    return std::format("bytes {}-{}/{}", range.first, range.last, size);
+}
+
+std::string HttpRange::toUnsatisfiedContentRange(std::uint64_t size)
+{
+    return std::format("bytes */{}", size);
+}
+
+bool HttpRange::parseNumber(std::string_view text, std::uint64_t& value) noexcept
+{
+    if (text.empty())
+    {
+        return false;
+    }
+
+    const auto [end, ec] { std::from_chars(text.data(), text.data() + text.size(), value) };
+    return ec == std::errc{} && end == text.data() + text.size();
+}
+}
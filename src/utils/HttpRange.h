@@ -0,0 +1,86 @@
+#ifndef HTTP_RANGE_H
+#define HTTP_RANGE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace utils
+{
+/**
+ * @struct ByteRange
+ * @brief Inclusive range of bytes of a representation
+ */
+struct ByteRange final
+{
+    std::uint64_t first{ 0 }; ///< Offset of the first byte
+    std::uint64_t last{ 0 };  ///< Offset of the last byte (inclusive)
+
+    /**
+     * @brief Gets the number of bytes in the range
+     * @return std::uint64_t Range length in bytes
+     */
+    [[nodiscard]] std::uint64_t length() const noexcept
+    {
+        return last - first + 1;
+    }
+};
+
+/**
+ * @enum RangeStatus
+ * @brief Result of evaluating a Range header against a representation
+ */
+enum class RangeStatus
+{
+    None,         ///< No usable range: the full representation is sent (200)
+    Satisfiable,  ///< A single satisfiable range: a partial response is sent (206)
+    Unsatisfiable ///< The range lies outside the representation (416)
+};
+
+/**
+ * @class HttpRange
+ * @brief Parses HTTP Range request headers (RFC 9110, section 14)
+ *
+ * Supports a single byte range in the forms "bytes=first-last", "bytes=first-"
+ * and "bytes=-suffix". Multiple ranges, other range units and malformed headers
+ * are ignored, as the RFC allows, and the full representation is served instead.
+ */
+class HttpRange final
+{
+public:
+    /**
+     * @brief Evaluates a Range header against a representation of a given size
+     * @param header Value of the Range header (may be empty)
+     * @param size Size of the representation in bytes
+     * @param range[out] Selected range if the result is RangeStatus::Satisfiable
+     * @return RangeStatus How the request must be answered
+     */
+    [[nodiscard]] static RangeStatus parse(std::string_view header, std::uint64_t size, ByteRange& range) noexcept;
+
+    /**
+     * @brief Formats the Content-Range header value of a partial response
+     * @param range Range being sent
+     * @param size Size of the full representation in bytes
+     * @return std::string Value in the form "bytes first-last/size"
+     */
+    [[nodiscard]] static std::string toContentRange(const ByteRange& range, std::uint64_t size);
+
+    /**
+     * @brief Formats the Content-Range header value of a 416 response
+     * @param size Size of the full representation in bytes
+     * @return std::string Value with an asterisk in place of the range followed by the size
+     */
+    [[nodiscard]] static std::string toUnsatisfiedContentRange(std::uint64_t size);
+
+private:
+    /**
+     * @brief Parses a non-empty decimal number that spans the whole string
+     * @param text Text to parse
+     * @param value[out] Parsed value
+     * @return bool True if the text is a valid number
+     */
+    [[nodiscard]] static bool parseNumber(std::string_view text, std::uint64_t& value) noexcept;
+};
+}
+
+#endif // HTTP_RANGE_H
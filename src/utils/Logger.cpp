@@ -21,12 +21,12 @@ Logger::Logger() noexcept :
 
 Logger::~Logger() noexcept
 {
-    if (accessFile_.is_open()) 
+    if (accessFile_.isOpen()) 
     {
         accessFile_.close();
     }
 
-    if (errorFile_.is_open()) 
+    if (errorFile_.isOpen()) 
     {
         errorFile_.close();
     }
@@ -49,14 +49,12 @@ void Logger::initialize(const std::string& level, const std::string& accessLogPa
 
     try 
     {
-        accessFile_.open(accessLogPath_, std::ios::app);
-        if (!accessFile_.is_open()) 
+        if (!accessFile_.open(accessLogPath_, false)) 
         {
             throw std::runtime_error{ "Cannot open access log file: " + accessLogPath_ };
         }
 
-        errorFile_.open(errorLogPath_, std::ios::app);
-        if (!errorFile_.is_open()) 
+        if (!errorFile_.open(errorLogPath_, false)) 
         {
             throw std::runtime_error{ "Cannot open error log file: " + errorLogPath_ };
         }
@@ -69,6 +67,7 @@ void Logger::initialize(const std::string& level, const std::string& accessLogPa
         info("Log level: " + level, "Logger");
         info("Console output: " + std::string{ isConsoleOutput_ ? "enabled" : "disabled" }, "Logger");
         info("Log access: " + std::string{ isLogAccess_ ? "enabled" : "disabled" }, "Logger");
+        info("Log file writes: " + std::string{ errorFile_.isIoUringEnabled() ? "io_uring" : "blocking" }, "Logger");
     }
     catch (const std::exception& e) 
     {
@@ -118,10 +117,9 @@ void Logger::access(const std::string& message) noexcept
 
     const auto formattedMessage{ "[" + getCurrentTime() + "] " + message };
 
-    if (accessFile_.is_open()) 
+    if (accessFile_.isOpen()) 
     {
-        accessFile_ << formattedMessage << std::endl;
-        accessFile_.flush();
+        static_cast<void>(accessFile_.write(formattedMessage + '\n'));
     }
 
     if (isConsoleOutput_) 
@@ -130,6 +128,17 @@ void Logger::access(const std::string& message) noexcept
     }
 }
 
+void Logger::flush() noexcept
+{
+    {
+        std::lock_guard lock{ accessMutex_ };
+        accessFile_.flush();
+    }
+
+    std::lock_guard lock{ errorMutex_ };
+    errorFile_.flush();
+}
+
 void Logger::log(LogLevel level, const std::string& message, const std::string& component) noexcept
 {
     auto shouldLog = [this](LogLevel level) noexcept
@@ -146,10 +155,9 @@ void Logger::log(LogLevel level, const std::string& message, const std::string&
 
     const auto formattedMessage{ formatMessage(level, message, component) };
 
-    if (errorFile_.is_open()) 
+    if (errorFile_.isOpen()) 
     {
-        errorFile_ << formattedMessage << std::endl;
-        errorFile_.flush();
+        static_cast<void>(errorFile_.write(formattedMessage + '\n'));
     }
 
     if (isConsoleOutput_) 
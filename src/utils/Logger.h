@@ -2,8 +2,8 @@
 #define LOGGER_H
 
 #include <string>
-#include <fstream>
 #include <mutex>
+#include "FileWriter.h"
 
 namespace utils
 {
@@ -32,6 +32,7 @@ enum class LogLevel
  * Provides configurable logging to both console and files with multiple
  * severity levels. Supports separate access logging for HTTP requests.
  * Implements the singleton pattern to ensure a single logging instance.
+ * File writes go through FileWriter, so with io_uring they do not block the caller.
  *
  * @note Thread-safe for concurrent logging from multiple threads
  * @warning Must be initialized before use via initialize() method
@@ -129,6 +130,12 @@ public:
      */
     void access(const std::string& message) noexcept;
 
+    /**
+     * @brief Waits until all logged messages have reached the log files
+     * @note Messages may still be in flight when the files are written through io_uring
+     */
+    void flush() noexcept;
+
 #ifdef UNIT_TESTING
     /**
      * @brief Resets logger state for unit testing
@@ -137,12 +144,12 @@ public:
     void reset() noexcept
     {
         std::lock_guard configLock{ configMutex_ };
-        if (accessFile_.is_open())
+        if (accessFile_.isOpen())
         {
             accessFile_.close();
         }
 
-        if (errorFile_.is_open())
+        if (errorFile_.isOpen())
         {
             errorFile_.close();
         }
@@ -204,8 +211,8 @@ private:
     [[nodiscard]] std::string formatMessage(LogLevel level, const std::string& message, const std::string& component) const noexcept;
 
 private:
-    std::ofstream accessFile_;  ///< File stream for access log
-    std::ofstream errorFile_;   ///< File stream for error log
+    FileWriter accessFile_;     ///< Writer of the access log
+    FileWriter errorFile_;      ///< Writer of the error log
 
     LogLevel currentLevel_;     ///< Current minimum log level
 
@@ -0,0 +1,151 @@
+#include "PatternScanner.h"
+#include "CharClass.h"
+#include <queue>
+#include <stdexcept>
+
+namespace utils
+{
+constexpr uint32_t INITIAL_STATE{ 0 };
+constexpr auto NO_STATE{ UINT32_MAX };
+constexpr unsigned char ASCII_CASE_BIT{ 0x20 };
+
+constexpr auto LETTER_CHARS{ makeCharClass("azAZ") };
+
+PatternScanner::PatternScanner(std::span<const ScanPattern> patterns)
+{
+    // only bytes that occur in patterns get columns, both cases of a letter share one
+    for (const auto& pattern : patterns)
+    {
+        if (pattern.text.empty())
+        {
+            throw std::invalid_argument{ "Scan pattern is empty" };
+        }
+
+        for (const auto c : pattern.text)
+        {
+            const auto byte{ static_cast<unsigned char>(c) };
+            if (symbols_[byte] != 0)
+            {
+                continue;
+            }
+
+            symbols_[byte] = static_cast<uint8_t>(symbolCount_++);
+            if (isInClass(LETTER_CHARS, c))
+            {
+                symbols_[byte ^ ASCII_CASE_BIT] = symbols_[byte];
+            }
+        }
+    }
+
+    // trie of the patterns
+    states_.emplace_back();
+    transitions_.assign(symbolCount_, NO_STATE);
+
+    for (const auto& pattern : patterns)
+    {
+        auto state{ INITIAL_STATE };
+        for (const auto c : pattern.text)
+        {
+            const auto index{ state * symbolCount_ + getSymbol(c) };
+            if (transitions_[index] == NO_STATE)
+            {
+                transitions_[index] = static_cast<uint32_t>(states_.size());
+                states_.emplace_back();
+                transitions_.resize(transitions_.size() + symbolCount_, NO_STATE);
+            }
+
+            state = transitions_[index];
+        }
+
+        if (pattern.isWholeWord)
+        {
+            states_[state].wholeWordLengths.push_back(pattern.text.size());
+        }
+        else
+        {
+            states_[state].isMatch = true;
+        }
+    }
+
+    // breadth-first, so the fallback of a state (its longest proper suffix in the trie)
+    // is complete before the state takes over its matches and missing transitions
+    std::vector<uint32_t> fallbacks(states_.size(), INITIAL_STATE);
+    std::queue<uint32_t> queue{};
+
+    for (size_t symbol{ 0 }; symbol < symbolCount_; ++symbol)
+    {
+        if (transitions_[symbol] == NO_STATE)
+        {
+            transitions_[symbol] = INITIAL_STATE;
+        }
+        else
+        {
+            queue.push(transitions_[symbol]);
+        }
+    }
+
+    while (!queue.empty())
+    {
+        const auto state{ queue.front() };
+        queue.pop();
+
+        const auto fallback{ fallbacks[state] };
+        states_[state].isMatch = states_[state].isMatch || states_[fallback].isMatch;
+        const auto& inherited{ states_[fallback].wholeWordLengths };
+        states_[state].wholeWordLengths.insert(states_[state].wholeWordLengths.end(), inherited.begin(), inherited.end());
+
+        for (size_t symbol{ 0 }; symbol < symbolCount_; ++symbol)
+        {
+            const auto index{ state * symbolCount_ + symbol };
+            const auto fallbackNext{ transitions_[fallback * symbolCount_ + symbol] };
+
+            if (transitions_[index] == NO_STATE)
+            {
+                transitions_[index] = fallbackNext;
+            }
+            else
+            {
+                fallbacks[transitions_[index]] = fallbackNext;
+                queue.push(transitions_[index]);
+            }
+        }
+    }
+}
+
+bool PatternScanner::contains(std::string_view text) const noexcept
+{
+    auto state{ INITIAL_STATE };
+
+    for (size_t i{ 0 }; i < text.size(); ++i)
+    {
+        state = transitions_[state * symbolCount_ + getSymbol(text[i])];
+
+        const auto& current{ states_[state] };
+        if (current.isMatch)
+        {
+            return true;
+        }
+
+        const auto end{ i + 1 };
+        if (current.wholeWordLengths.empty() || (end < text.size() && isInClass(WORD_CHARS, text[end])))
+        {
+            continue;
+        }
+
+        for (const auto length : current.wholeWordLengths)
+        {
+            if (const auto start{ end - length }; start == 0 || !isInClass(WORD_CHARS, text[start - 1]))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+uint8_t PatternScanner::getSymbol(char c) const noexcept
+{
+    return symbols_[static_cast<unsigned char>(c)];
+}
+}
@@ -0,0 +1,105 @@
+#ifndef PATTERN_SCANNER_H
+#define PATTERN_SCANNER_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace utils
+{
+/**
+ * @struct ScanPattern
+ * @brief Pattern searched by a PatternScanner
+ */
+struct ScanPattern final
+{
+    std::string_view text;     ///< Text of the pattern, ASCII letters match either case
+    bool isWholeWord{ false }; ///< Whether the pattern matches only between non-word characters
+};
+
+/**
+ * @class PatternScanner
+ * @brief Finds any of a set of patterns in a text in one pass
+ *
+ * Builds an Aho-Corasick automaton once from all patterns, so a text is
+ * scanned byte by byte a single time however many patterns there are,
+ * instead of once per pattern. Matching ignores the case of ASCII letters.
+ * A whole-word pattern matches only where it is not preceded or followed by
+ * a letter, digit or underscore.
+ *
+ * @note Thread-safe, the automaton is immutable once built
+ */
+class PatternScanner final
+{
+public:
+    /**
+     * @brief Builds the automaton
+     * @param patterns Non-empty patterns to search for
+     */
+    explicit PatternScanner(std::span<const ScanPattern> patterns);
+
+    /**
+     * @brief Default destructor
+     */
+    ~PatternScanner() noexcept = default;
+
+    /**
+     * @brief Deleted copy constructor
+     * @note PatternScanner should not be copied
+     */
+    PatternScanner(const PatternScanner&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator
+     * @note PatternScanner should not be copied
+     */
+    PatternScanner& operator=(const PatternScanner&) = delete;
+
+    /**
+     * @brief Deleted move constructor
+     * @note PatternScanner should not be moved
+     */
+    PatternScanner(PatternScanner&&) = delete;
+
+    /**
+     * @brief Deleted move assignment operator
+     * @note PatternScanner should not be moved
+     */
+    PatternScanner& operator=(PatternScanner&&) = delete;
+
+    /**
+     * @brief Checks if a text contains any of the patterns
+     * @param text Text to scan
+     * @return bool True at the first match
+     */
+    [[nodiscard]] bool contains(std::string_view text) const noexcept;
+
+private:
+    /**
+     * @struct State
+     * @brief State of the automaton, the longest pattern prefix that ends at the scanned byte
+     */
+    struct State final
+    {
+        bool isMatch{ false };                ///< Whether a pattern that is not a whole word ends here
+        std::vector<size_t> wholeWordLengths; ///< Lengths of the whole-word patterns that end here
+    };
+
+    /**
+     * @brief Maps a byte to its symbol, the column of the transition table
+     * @param c Byte of a pattern or a text
+     * @return uint8_t Symbol, 0 for bytes that occur in no pattern
+     */
+    [[nodiscard]] uint8_t getSymbol(char c) const noexcept;
+
+private:
+    std::array<uint8_t, 256> symbols_{}; ///< Symbol of each byte, both cases of a letter share one
+    size_t symbolCount_{ 1 };           ///< Number of symbols, including the one of all other bytes
+    std::vector<uint32_t> transitions_; ///< Next state by state and symbol, symbolCount_ columns per state
+    std::vector<State> states_;         ///< States, the initial one first
+};
+}
+
+#endif // PATTERN_SCANNER_H
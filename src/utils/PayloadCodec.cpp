@@ -0,0 +1,239 @@
+#include "PayloadCodec.h"
+#include "Utf8.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <limits>
+#include <ranges>
+#include <vector>
+#include <boost/algorithm/string.hpp>
+
+namespace utils
+{
+constexpr auto JSON_INDENT{ 4 };
+
+// index of a format in the negotiation arrays
+constexpr std::array FORMATS{ PayloadFormat::Json, PayloadFormat::MessagePack, PayloadFormat::Cbor };
+
+bool PayloadCodec::fromContentType(std::string_view contentType, PayloadFormat& format) noexcept
+{
+    try
+    {
+        // media type parameters (charset, ...) do not affect the format
+        auto mediaType{ boost::algorithm::trim_copy(std::string{ contentType.substr(0, contentType.find(';')) }) };
+        boost::algorithm::to_lower(mediaType);
+
+        if (mediaType == "application/json")
+        {
+            format = PayloadFormat::Json;
+            return true;
+        }
+
+        if (mediaType == "application/msgpack" || mediaType == "application/x-msgpack" || mediaType == "application/vnd.msgpack")
+        {
+            format = PayloadFormat::MessagePack;
+            return true;
+        }
+
+        if (mediaType == "application/cbor")
+        {
+            format = PayloadFormat::Cbor;
+            return true;
+        }
+
+        return false;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+PayloadFormat PayloadCodec::negotiate(std::string_view accept) noexcept
+{
+    try
+    {
+        std::array<double, FORMATS.size()> qValues{};
+        std::array<size_t, FORMATS.size()> positions{};
+        qValues.fill(-1.0);
+
+        auto wildcard{ -1.0 };
+        size_t position{ 0 };
+
+        for (const auto& range : accept | std::views::split(','))
+        {
+            const std::string_view item{ range.begin(), range.end() };
+            ++position;
+
+            auto qValue{ 1.0 };
+            if (const auto semicolon{ item.find(';') }; semicolon != std::string_view::npos)
+            {
+                auto params{ std::string{ item.substr(semicolon + 1) } };
+                boost::algorithm::to_lower(params);
+                boost::algorithm::erase_all(params, " ");
+
+                if (const auto q{ params.find("q=") }; q != std::string::npos)
+                {
+                    if (std::from_chars(params.data() + q + 2, params.data() + params.size(), qValue).ec != std::errc{})
+                    {
+                        continue;
+                    }
+                }
+            }
+
+            auto mediaType{ boost::algorithm::trim_copy(std::string{ item.substr(0, item.find(';')) }) };
+            boost::algorithm::to_lower(mediaType);
+
+            if (mediaType == "*/*" || mediaType == "application/*")
+            {
+                wildcard = std::max(wildcard, qValue);
+                continue;
+            }
+
+            auto format{ PayloadFormat::Json };
+            if (!fromContentType(mediaType, format))
+            {
+                continue;
+            }
+
+            const auto index{ static_cast<size_t>(std::ranges::find(FORMATS, format) - FORMATS.begin()) };
+            if (qValues[index] < 0.0)
+            {
+                qValues[index] = qValue;
+                positions[index] = position;
+            }
+        }
+
+        auto best{ PayloadFormat::Json };
+        auto bestQValue{ 0.0 };
+        auto bestPosition{ std::numeric_limits<size_t>::max() };
+
+        for (auto i : std::views::iota(0u, FORMATS.size()))
+        {
+            // formats that are not listed explicitly take the wildcard q-value and rank after listed ones
+            const auto isListed{ qValues[i] >= 0.0 };
+            const auto qValue{ isListed ? qValues[i] : wildcard };
+            const auto itemPosition{ isListed ? positions[i] : std::numeric_limits<size_t>::max() };
+
+            if (qValue > bestQValue || (qValue == bestQValue && qValue > 0.0 && itemPosition < bestPosition))
+            {
+                best = FORMATS[i];
+                bestQValue = qValue;
+                bestPosition = itemPosition;
+            }
+        }
+
+        return best;
+    }
+    catch (const std::exception&)
+    {
+        return PayloadFormat::Json;
+    }
+}
+
+std::string_view PayloadCodec::toContentType(PayloadFormat format) noexcept
+{
+    switch (format)
+    {
+    case PayloadFormat::MessagePack:
+        return "application/msgpack";
+    case PayloadFormat::Cbor:
+        return "application/cbor";
+    default:
+        return "application/json";
+    }
+}
+
+std::string PayloadCodec::encode(const nlohmann::json& json, PayloadFormat format)
+{
+    std::string body{};
+
+    switch (format)
+    {
+    case PayloadFormat::MessagePack:
+        nlohmann::json::to_msgpack(json, body);
+        break;
+    case PayloadFormat::Cbor:
+        nlohmann::json::to_cbor(json, body);
+        break;
+    default:
+        body = json.dump(JSON_INDENT);
+        break;
+    }
+
+    return body;
+}
+
+bool PayloadCodec::decode(std::string_view body, PayloadFormat format, nlohmann::json& json) noexcept
+{
+    if (body.empty())
+    {
+        return false;
+    }
+
+    try
+    {
+        // exceptions are disabled, invalid input yields a discarded value
+        switch (format)
+        {
+        case PayloadFormat::MessagePack:
+            json = nlohmann::json::from_msgpack(body.begin(), body.end(), true, false);
+            break;
+        case PayloadFormat::Cbor:
+            json = nlohmann::json::from_cbor(body.begin(), body.end(), true, false);
+            break;
+        default:
+            json = nlohmann::json::parse(body.begin(), body.end(), nullptr, false);
+            break;
+        }
+
+        // the JSON parser rejects ill-formed UTF-8 itself, the binary parsers take strings as bytes
+        return !json.is_discarded() && (format == PayloadFormat::Json || hasValidStrings(json));
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+bool PayloadCodec::hasValidStrings(const nlohmann::json& json)
+{
+    // iterative, the nesting depth is up to the client
+    std::vector<const nlohmann::json*> pending{ &json };
+
+    while (!pending.empty())
+    {
+        const auto* value{ pending.back() };
+        pending.pop_back();
+
+        if (value->is_string())
+        {
+            if (!Utf8::isValid(value->get_ref<const std::string&>()))
+            {
+                return false;
+            }
+        }
+        else if (value->is_object())
+        {
+            for (auto it{ value->cbegin() }; it != value->cend(); ++it)
+            {
+                if (!Utf8::isValid(it.key()))
+                {
+                    return false;
+                }
+
+                pending.push_back(&it.value());
+            }
+        }
+        else if (value->is_array())
+        {
+            for (const auto& item : *value)
+            {
+                pending.push_back(&item);
+            }
+        }
+    }
+
+    return true;
+}
+}
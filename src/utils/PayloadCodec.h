@@ -0,0 +1,92 @@
+#ifndef PAYLOAD_CODEC_H
+#define PAYLOAD_CODEC_H
+
+#include <string>
+#include <string_view>
+#include <nlohmann/json.hpp>
+
+namespace utils
+{
+/**
+ * @enum PayloadFormat
+ * @brief Wire formats supported for request and response bodies
+ */
+enum class PayloadFormat
+{
+    Json,        ///< application/json
+    MessagePack, ///< application/msgpack
+    Cbor         ///< application/cbor
+};
+
+/**
+ * @class PayloadCodec
+ * @brief Provides media type negotiation and encoding/decoding of request and response bodies
+ *
+ * Handlers work with nlohmann::json values only; this class converts them
+ * to and from the wire format selected by the Accept and Content-Type headers.
+ *
+ * @note All methods are thread-safe
+ */
+class PayloadCodec final
+{
+public:
+    /**
+     * @brief Deleted default constructor
+     * @note This is a utility class with only static methods
+     */
+    PayloadCodec() noexcept = delete;
+
+    /**
+     * @brief Parses a Content-Type header value
+     * @param contentType Content-Type header value (parameters such as charset are ignored)
+     * @param[out] format Parsed payload format
+     * @return bool True if the media type is supported, false otherwise
+     */
+    [[nodiscard]] static bool fromContentType(std::string_view contentType, PayloadFormat& format) noexcept;
+
+    /**
+     * @brief Selects the response format from an Accept header value
+     * @param accept Accept header value
+     * @return PayloadFormat Best supported format, Json if none is acceptable or the header is empty
+     * @note Honors q-values; explicit media types win over wildcards, and on equal
+     *       q-values the first listed media type wins
+     */
+    [[nodiscard]] static PayloadFormat negotiate(std::string_view accept) noexcept;
+
+    /**
+     * @brief Converts a payload format to its media type
+     * @param format Payload format
+     * @return std::string_view Media type for the Content-Type header
+     */
+    [[nodiscard]] static std::string_view toContentType(PayloadFormat format) noexcept;
+
+    /**
+     * @brief Serializes a JSON value in the given format
+     * @param json Value to serialize
+     * @param format Target wire format
+     * @return std::string Serialized body (JSON is pretty printed with 4 spaces)
+     * @throws nlohmann::json::exception if the value cannot be serialized (e.g. invalid UTF-8)
+     */
+    [[nodiscard]] static std::string encode(const nlohmann::json& json, PayloadFormat format);
+
+    /**
+     * @brief Parses a body in the given format
+     * @param body Serialized body
+     * @param format Wire format of the body
+     * @param[out] json Parsed value
+     * @return bool True if the body is valid, false otherwise
+     * @note Bodies with strings or keys that are not valid UTF-8 are invalid in every format
+     */
+    [[nodiscard]] static bool decode(std::string_view body, PayloadFormat format, nlohmann::json& json) noexcept;
+
+private:
+    /**
+     * @brief Checks that all strings and object keys of a value are valid UTF-8
+     * @param json Parsed value
+     * @return bool True if every string is valid UTF-8, false otherwise
+     */
+    [[nodiscard]] static bool hasValidStrings(const nlohmann::json& json);
+};
+}
+
+#endif // PAYLOAD_CODEC_H
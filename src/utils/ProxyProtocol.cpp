@@ -0,0 +1,179 @@
+#include "ProxyProtocol.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <ranges>
+#include <string>
+
+namespace utils
+{
+constexpr std::string_view V1_PREFIX{ "PROXY " };
+constexpr size_t V1_MAX_SIZE{ 107 };
+constexpr size_t V1_MAX_FIELDS{ 5 };
+constexpr std::string_view V2_SIGNATURE{ "\r\n\r\n\0\r\nQUIT\n", 12 };
+constexpr size_t V2_HEADER_SIZE{ 16 };
+constexpr uint8_t V2_VERSION{ 2 };
+constexpr uint8_t V2_COMMAND_LOCAL{ 0 };
+constexpr uint8_t V2_COMMAND_PROXY{ 1 };
+constexpr uint8_t V2_FAMILY_INET{ 1 };
+constexpr uint8_t V2_FAMILY_INET6{ 2 };
+
+ProxyStatus ProxyProtocol::parse(std::string_view data, ProxyHeader& header) noexcept
+{
+    if (data.starts_with(V2_SIGNATURE))
+    {
+        return parseVersion2(data, header);
+    }
+
+    if (data.starts_with(V1_PREFIX))
+    {
+        return parseVersion1(data, header);
+    }
+
+    // too short to tell which version follows
+    if (V2_SIGNATURE.starts_with(data) || V1_PREFIX.starts_with(data))
+    {
+        return ProxyStatus::Incomplete;
+    }
+
+    return ProxyStatus::Invalid;
+}
+
+ProxyStatus ProxyProtocol::parseVersion1(std::string_view data, ProxyHeader& header) noexcept
+{
+    const auto end{ data.substr(0, V1_MAX_SIZE).find("\r\n") };
+    if (end == std::string_view::npos)
+    {
+        return data.size() < V1_MAX_SIZE ? ProxyStatus::Incomplete : ProxyStatus::Invalid;
+    }
+
+    std::array<std::string_view, V1_MAX_FIELDS> fields{};
+    size_t fieldCount{ 0 };
+
+    for (const auto field : std::views::split(data.substr(V1_PREFIX.size(), end - V1_PREFIX.size()), ' '))
+    {
+        if (fieldCount == fields.size())
+        {
+            return ProxyStatus::Invalid;
+        }
+
+        fields[fieldCount++] = std::string_view{ field.begin(), field.end() };
+    }
+
+    header.size = end + 2;
+    header.source.reset();
+
+    // the balancer does not know the client (e.g. its own health checks); whatever follows is ignored
+    if (fieldCount > 0 && fields[0] == "UNKNOWN")
+    {
+        return ProxyStatus::Complete;
+    }
+
+    if (fieldCount != fields.size() || (fields[0] != "TCP4" && fields[0] != "TCP6"))
+    {
+        return ProxyStatus::Invalid;
+    }
+
+    boost::system::error_code ec{};
+    const auto sourceAddress{ boost::asio::ip::make_address(std::string{ fields[1] }, ec) };
+    if (ec || sourceAddress.is_v4() != (fields[0] == "TCP4"))
+    {
+        return ProxyStatus::Invalid;
+    }
+
+    const auto destinationAddress{ boost::asio::ip::make_address(std::string{ fields[2] }, ec) };
+    if (ec || destinationAddress.is_v4() != sourceAddress.is_v4())
+    {
+        return ProxyStatus::Invalid;
+    }
+
+    unsigned short sourcePort{ 0 };
+    unsigned short destinationPort{ 0 };
+    if (!parsePort(fields[3], sourcePort) || !parsePort(fields[4], destinationPort))
+    {
+        return ProxyStatus::Invalid;
+    }
+
+    header.source.emplace(sourceAddress, sourcePort);
+    return ProxyStatus::Complete;
+}
+
+ProxyStatus ProxyProtocol::parseVersion2(std::string_view data, ProxyHeader& header) noexcept
+{
+    if (data.size() < V2_HEADER_SIZE)
+    {
+        return ProxyStatus::Incomplete;
+    }
+
+    const auto byteAt{ [&data](size_t index) { return static_cast<uint8_t>(data[index]); } };
+
+    const auto version{ static_cast<uint8_t>(byteAt(12) >> 4) };
+    const auto command{ static_cast<uint8_t>(byteAt(12) & 0x0F) };
+    if (version != V2_VERSION || (command != V2_COMMAND_LOCAL && command != V2_COMMAND_PROXY))
+    {
+        return ProxyStatus::Invalid;
+    }
+
+    const size_t length{ static_cast<size_t>(byteAt(14) << 8 | byteAt(15)) };
+    if (V2_HEADER_SIZE + length > MAX_HEADER_SIZE)
+    {
+        return ProxyStatus::Invalid;
+    }
+
+    if (data.size() < V2_HEADER_SIZE + length)
+    {
+        return ProxyStatus::Incomplete;
+    }
+
+    header.size = V2_HEADER_SIZE + length;
+    header.source.reset();
+
+    // LOCAL connections are made by the balancer itself, and other families carry no IP address
+    const auto family{ static_cast<uint8_t>(byteAt(13) >> 4) };
+    if (command == V2_COMMAND_LOCAL || (family != V2_FAMILY_INET && family != V2_FAMILY_INET6))
+    {
+        return ProxyStatus::Complete;
+    }
+
+    const auto addresses{ data.substr(V2_HEADER_SIZE, length) };
+    const auto portAt{ [&addresses](size_t index)
+    {
+        return static_cast<unsigned short>(static_cast<uint8_t>(addresses[index]) << 8 | static_cast<uint8_t>(addresses[index + 1]));
+    } };
+
+    if (family == V2_FAMILY_INET)
+    {
+        boost::asio::ip::address_v4::bytes_type source{};
+        if (addresses.size() < 2 * source.size() + 4)
+        {
+            return ProxyStatus::Invalid;
+        }
+
+        std::ranges::transform(addresses.substr(0, source.size()), source.begin(), [](char byte) { return static_cast<unsigned char>(byte); });
+        header.source.emplace(boost::asio::ip::address_v4{ source }, portAt(2 * source.size()));
+        return ProxyStatus::Complete;
+    }
+
+    boost::asio::ip::address_v6::bytes_type source{};
+    if (addresses.size() < 2 * source.size() + 4)
+    {
+        return ProxyStatus::Invalid;
+    }
+
+    std::ranges::transform(addresses.substr(0, source.size()), source.begin(), [](char byte) { return static_cast<unsigned char>(byte); });
+    header.source.emplace(boost::asio::ip::address_v6{ source }, portAt(2 * source.size()));
+    return ProxyStatus::Complete;
+}
+
+bool ProxyProtocol::parsePort(std::string_view text, unsigned short& port) noexcept
+{
+    if (text.empty() || (text.size() > 1 && text.front() == '0'))
+    {
+        return false;
+    }
+
+    const auto [end, ec] { std::from_chars(text.data(), text.data() + text.size(), port) };
+    return ec == std::errc{} && end == text.data() + text.size();
+}
+}
@@ -0,0 +1,89 @@
+#ifndef PROXY_PROTOCOL_H
+#define PROXY_PROTOCOL_H
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <boost/asio/ip/tcp.hpp>
+
+namespace utils
+{
+/**
+ * @struct ProxyHeader
+ * @brief Connection information sent by a load balancer in front of the server
+ */
+struct ProxyHeader final
+{
+    size_t size{ 0 };                                       ///< Length of the header in bytes, to be consumed before the client's data
+    std::optional<boost::asio::ip::tcp::endpoint> source;   ///< Address of the client, unset for health checks (LOCAL and UNKNOWN)
+};
+
+/**
+ * @enum ProxyStatus
+ * @brief Result of parsing the start of a connection as a PROXY protocol header
+ */
+enum class ProxyStatus
+{
+    Complete,   ///< A whole valid header was parsed
+    Incomplete, ///< The data is a valid start of a header but ends too early
+    Invalid     ///< The data is not a PROXY protocol header or is malformed
+};
+
+/**
+ * @class ProxyProtocol
+ * @brief Parses PROXY protocol version 1 and 2 headers (HAProxy PROXY protocol specification)
+ *
+ * Load balancers that terminate TLS or forward TCP prepend the header to the connection,
+ * so the server sees the address of the client instead of the address of the balancer.
+ * Version 1 is a text line, version 2 a binary block; TLVs of version 2 are skipped.
+ *
+ * @warning Only accept PROXY headers on listeners reachable from trusted balancers only,
+ *          as any client could otherwise spoof its address
+ */
+class ProxyProtocol final
+{
+public:
+    static constexpr size_t MAX_HEADER_SIZE{ 536 }; ///< Largest header accepted: a version 1 line, or version 2 with the addresses and common TLVs
+
+    /**
+     * @brief Deleted default constructor
+     * @note Static utility class
+     */
+    ProxyProtocol() noexcept = delete;
+
+    /**
+     * @brief Parses a PROXY protocol header at the start of a connection
+     * @param data First bytes received on the connection
+     * @param header[out] Parsed header if the result is ProxyStatus::Complete
+     * @return ProxyStatus Whether the data holds a complete and valid header
+     */
+    [[nodiscard]] static ProxyStatus parse(std::string_view data, ProxyHeader& header) noexcept;
+
+private:
+    /**
+     * @brief Parses a version 1 (text) header
+     * @param data First bytes received, starting with "PROXY "
+     * @param header[out] Parsed header
+     * @return ProxyStatus Whether the data holds a complete and valid header
+     */
+    [[nodiscard]] static ProxyStatus parseVersion1(std::string_view data, ProxyHeader& header) noexcept;
+
+    /**
+     * @brief Parses a version 2 (binary) header
+     * @param data First bytes received, starting with the version 2 signature
+     * @param header[out] Parsed header
+     * @return ProxyStatus Whether the data holds a complete and valid header
+     */
+    [[nodiscard]] static ProxyStatus parseVersion2(std::string_view data, ProxyHeader& header) noexcept;
+
+    /**
+     * @brief Parses a decimal TCP port without sign or leading zeros
+     * @param text Text to parse
+     * @param port[out] Parsed port
+     * @return bool True if the text is a valid port
+     */
+    [[nodiscard]] static bool parsePort(std::string_view text, unsigned short& port) noexcept;
+};
+}
+
+#endif // PROXY_PROTOCOL_H
@@ -17,7 +17,7 @@ std::string SecurityUtils::sanitizeUserInput(const std::string& input) noexcept
         return sanitized;
     }
 
-    if (Validators::isSQLInjection(sanitized) || Validators::isXSS(sanitized)) 
+    if (Validators::isSQLInjectionOrXSS(sanitized)) 
     {
         return "";
     }
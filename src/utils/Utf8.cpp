@@ -0,0 +1,106 @@
+#include "Utf8.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace utils
+{
+constexpr size_t WORD_SIZE{ sizeof(uint64_t) };
+constexpr size_t ASCII_BLOCK_SIZE{ 4 * WORD_SIZE };
+constexpr uint64_t HIGH_BITS{ 0x8080808080808080 };
+
+constexpr unsigned char MAX_ASCII{ 0x7F };
+constexpr unsigned char CONTINUATION_MASK{ 0xC0 };
+constexpr unsigned char CONTINUATION_BITS{ 0x80 };
+constexpr unsigned char MIN_CONTINUATION{ 0x80 };
+constexpr unsigned char MAX_CONTINUATION{ 0xBF };
+
+bool Utf8::isAsciiBlock(const unsigned char* data) noexcept
+{
+    std::array<uint64_t, ASCII_BLOCK_SIZE / WORD_SIZE> words{};
+    std::memcpy(words.data(), data, ASCII_BLOCK_SIZE);
+
+    // independent words, so the compiler can check them in vector registers
+    return ((words[0] | words[1] | words[2] | words[3]) & HIGH_BITS) == 0;
+}
+
+bool Utf8::isValid(std::string_view text) noexcept
+{
+    size_t count{ 0 };
+    return countCodePoints(text, count);
+}
+
+bool Utf8::countCodePoints(std::string_view text, size_t& count) noexcept
+{
+    const auto* data{ reinterpret_cast<const unsigned char*>(text.data()) };
+    const auto size{ text.size() };
+
+    count = 0;
+    size_t i{ 0 };
+
+    while (i < size)
+    {
+        const auto lead{ data[i] };
+
+        if (lead <= MAX_ASCII)
+        {
+            if (size - i >= ASCII_BLOCK_SIZE && isAsciiBlock(data + i))
+            {
+                i += ASCII_BLOCK_SIZE;
+                count += ASCII_BLOCK_SIZE;
+            }
+            else
+            {
+                ++i;
+                ++count;
+            }
+
+            continue;
+        }
+
+        // well-formed sequences, Unicode Table 3-7: the second byte range depends on the lead byte
+        size_t length{ 0 };
+        auto minSecond{ MIN_CONTINUATION };
+        auto maxSecond{ MAX_CONTINUATION };
+
+        if (lead >= 0xC2 && lead <= 0xDF)
+        {
+            length = 2;
+        }
+        else if (lead >= 0xE0 && lead <= 0xEF)
+        {
+            length = 3;
+            minSecond = lead == 0xE0 ? 0xA0 : minSecond; // overlong
+            maxSecond = lead == 0xED ? 0x9F : maxSecond; // surrogates
+        }
+        else if (lead >= 0xF0 && lead <= 0xF4)
+        {
+            length = 4;
+            minSecond = lead == 0xF0 ? 0x90 : minSecond; // overlong
+            maxSecond = lead == 0xF4 ? 0x8F : maxSecond; // above U+10FFFF
+        }
+        else
+        {
+            return false;
+        }
+
+        if (size - i < length || data[i + 1] < minSecond || data[i + 1] > maxSecond)
+        {
+            return false;
+        }
+
+        for (size_t k{ 2 }; k < length; ++k)
+        {
+            if ((data[i + k] & CONTINUATION_MASK) != CONTINUATION_BITS)
+            {
+                return false;
+            }
+        }
+
+        i += length;
+        ++count;
+    }
+
+    return true;
+}
+}
@@ -0,0 +1,55 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace utils
+{
+/**
+ * @class Utf8
+ * @brief Validates UTF-8 text and counts its characters
+ *
+ * Accepts well-formed UTF-8 only: no overlong forms, no surrogates and
+ * nothing above U+10FFFF, so invalid encodings are rejected before they
+ * cost a failed query. U+0000 is valid UTF-8 and is accepted, although
+ * PostgreSQL rejects it in text. Runs of ASCII are checked a block of
+ * bytes at a time.
+ *
+ * @note All methods are thread-safe
+ */
+class Utf8 final
+{
+public:
+    /**
+     * @brief Deleted default constructor
+     * @note This is a utility class with only static methods
+     */
+    Utf8() noexcept = delete;
+
+    /**
+     * @brief Checks if a text is well-formed UTF-8
+     * @param text Text to check
+     * @return bool True if the text is valid UTF-8, false otherwise
+     */
+    [[nodiscard]] static bool isValid(std::string_view text) noexcept;
+
+    /**
+     * @brief Validates a text and counts its code points, the characters LENGTH() counts in SQL
+     * @param text Text to check
+     * @param[out] count Number of code points, undefined if the text is invalid
+     * @return bool True if the text is valid UTF-8, false otherwise
+     */
+    [[nodiscard]] static bool countCodePoints(std::string_view text, size_t& count) noexcept;
+
+private:
+    /**
+     * @brief Checks if a block of ASCII_BLOCK_SIZE bytes is all ASCII
+     * @param data First byte of the block
+     * @return bool True if no byte has the high bit set
+     */
+    [[nodiscard]] static bool isAsciiBlock(const unsigned char* data) noexcept;
+};
+}
+
+#endif // UTF8_H
@@ -1,6 +1,9 @@
 #include "Validators.h"
-#include <regex>
-#include <boost/algorithm/string.hpp>
+#include "CharClass.h"
+#include "Utf8.h"
+#include <algorithm>
+#include <string_view>
+#include <vector>
 
 namespace utils
 {
@@ -8,7 +11,49 @@ constexpr auto MIN_LOGIN_SIZE{ 3 };
 constexpr auto MAX_LOGIN_SIZE{ 50 };
 constexpr auto MIN_PASSWORD_SIZE{ 6 };
 constexpr auto MAX_PASSWORD_SIZE{ 128 };
+constexpr auto UUID_SIZE{ 36 };
+constexpr std::array<size_t, 4> UUID_DASH_POSITIONS{ 8, 13, 18, 23 }; // 8-4-4-4-12 hex digits
 constexpr auto JWT_PARTS{ 3 };
+constexpr auto MAX_FILE_NAME_SIZE{ 255 };
+constexpr size_t MAX_UTF8_CHAR_SIZE{ 4 };
+
+constexpr auto LOGIN_CHARS{ WORD_CHARS };
+constexpr auto HEX_CHARS{ makeCharClass("afAF09") };
+constexpr auto BASE64URL_CHARS{ makeCharClass("azAZ09--__") };
+constexpr auto FILE_NAME_CHARS{ makeCharClass("azAZ09..--__") };
+
+constexpr std::string_view WHITESPACE{ " \t\n\v\f\r" }; // trimmed by sanitizeString, as std::isspace in the classic locale
+
+/**
+ * @brief Lists the patterns of one kind for a PatternScanner
+ * @param texts Texts of the patterns
+ * @param isWholeWord Whether the patterns match only as whole words
+ * @return std::vector<ScanPattern> Patterns
+ */
+template<size_t N>
+std::vector<ScanPattern> makeScanPatterns(const std::array<std::string_view, N>& texts, bool isWholeWord)
+{
+    std::vector<ScanPattern> patterns{};
+    patterns.reserve(N);
+
+    for (const auto text : texts)
+    {
+        patterns.push_back({ text, isWholeWord });
+    }
+
+    return patterns;
+}
+
+// built once at startup, SQL keywords count only as whole words
+const PatternScanner Validators::sqlScanner_{ makeScanPatterns(sqlKeywords_, true) };
+const PatternScanner Validators::xssScanner_{ makeScanPatterns(xssPatterns_, false) };
+const PatternScanner Validators::sqlAndXssScanner_{ []()
+    {
+        auto patterns{ makeScanPatterns(sqlKeywords_, true) };
+        const auto xssPatterns{ makeScanPatterns(xssPatterns_, false) };
+        patterns.insert(patterns.end(), xssPatterns.begin(), xssPatterns.end());
+        return patterns;
+    }() };
 
 bool Validators::isLoginValid(const std::string& login) noexcept
 {
@@ -17,8 +62,7 @@ bool Validators::isLoginValid(const std::string& login) noexcept
         return false;
     }
 
-    const std::regex pattern{ "^[a-zA-Z0-9_]+$" };
-    return std::regex_match(login, pattern);
+    return std::ranges::all_of(login, [](char c) noexcept { return isInClass(LOGIN_CHARS, c); });
 }
 
 bool Validators::isPasswordValid(const std::string& password) noexcept
@@ -53,86 +97,139 @@ bool Validators::isPasswordValid(const std::string& password) noexcept
 
 bool Validators::isUUIDValid(const std::string& uuid) noexcept
 {
-    const std::regex pattern{ R"(^[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}$)" };
-    return std::regex_match(uuid, pattern);
-}
-
-bool Validators::isMessageLengthValid(const std::string& message, size_t maxLength) noexcept
-{
-    return !message.empty() && message.size() <= maxLength;
-}
-
-std::string Validators::sanitizeString(const std::string& input) noexcept
-{
-    auto sanitized{ input };
-
-    std::erase(sanitized, '\0');
-
-    std::vector<std::pair<std::string, std::string>> replacements
-	{
-        {"'",  "''"},
-        {"\"", "\\\""},
-        {"\\", "\\\\"},
-        {"\0", ""},
-        {"\n", " "},
-        {"\r", " "},
-        {"\t", " "}
-    };
-
-    for (const auto& [fst, snd] : replacements) 
+    if (uuid.size() != UUID_SIZE)
     {
-        boost::replace_all(sanitized, fst, snd);
+        return false;
     }
 
-    boost::trim(sanitized);
+    size_t dash{ 0 };
+    for (size_t i{ 0 }; i < uuid.size(); ++i)
+    {
+        if (dash < UUID_DASH_POSITIONS.size() && i == UUID_DASH_POSITIONS[dash])
+        {
+            if (uuid[i] != '-')
+            {
+                return false;
+            }
 
-    return sanitized;
+            ++dash;
+        }
+        else if (!isInClass(HEX_CHARS, uuid[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
 }
 
-bool Validators::isSQLInjection(const std::string& input) noexcept
+bool Validators::isJWTShapeValid(const std::string& token) noexcept
 {
-    auto isWordBoundary = [](char c) noexcept
-	{
-        return !std::isalnum(static_cast<unsigned char>(c)) && c != '_';
-    };
-
-    auto upperInput{ boost::to_upper_copy(input) };
+    auto parts{ 1 };
+    size_t partSize{ 0 };
 
-    for (const auto& keyword : sqlKeywords_) 
+    for (const auto c : token)
     {
-        size_t pos{ 0 };
-        while ((pos = upperInput.find(keyword, pos)) != std::string::npos) 
+        if (c == '.')
         {
-	        const auto leftBoundary{ (pos == 0) || isWordBoundary(upperInput[pos - 1]) };
-
-            const size_t endPos{ pos + keyword.size() };
-
-            bool isRightBoundary{ (endPos >= upperInput.size()) || isWordBoundary(upperInput[endPos]) };
-
-            if (leftBoundary && isRightBoundary) 
+            if (partSize == 0 || ++parts > JWT_PARTS)
             {
-                return true;
+                return false;
             }
 
-            pos = endPos;
+            partSize = 0;
+        }
+        else if (isInClass(BASE64URL_CHARS, c))
+        {
+            ++partSize;
+        }
+        else
+        {
+            return false;
         }
     }
 
-    return false;
+    return parts == JWT_PARTS && partSize != 0;
 }
 
-bool Validators::isXSS(const std::string& input) noexcept
+bool Validators::isMessageLengthValid(const std::string& message, size_t maxLength) noexcept
 {
-	const auto lowerInput{ boost::to_lower_copy(input) };
+    // a character takes at most MAX_UTF8_CHAR_SIZE bytes, longer texts need no scan
+    if (message.empty() || message.size() / MAX_UTF8_CHAR_SIZE > maxLength)
+    {
+        return false;
+    }
+
+    size_t length{ 0 };
+    return Utf8::countCodePoints(message, length) && length <= maxLength;
+}
+
+bool Validators::isFileNameValid(const std::string& fileName) noexcept
+{
+    if (fileName.empty() || fileName.size() > MAX_FILE_NAME_SIZE || fileName.front() == '.')
+    {
+        return false;
+    }
+
+    return std::ranges::all_of(fileName, [](char c) noexcept { return isInClass(FILE_NAME_CHARS, c); });
+}
+
+std::string Validators::sanitizeString(const std::string& input, bool escapeQuotes) noexcept
+{
+    std::string sanitized{};
+    sanitized.reserve(input.size());
 
-    for (const auto& pattern : xssPatterns_) 
+    for (const auto c : input)
     {
-        if (lowerInput.find(pattern) != std::string::npos) 
+        switch (c)
         {
-            return true;
+        case '\0':
+            break;
+        case '\'':
+            sanitized += escapeQuotes ? "''" : "'";
+            break;
+        case '"':
+            // the backslash escaping the quote is escaped as well
+            sanitized += "\\\\\"";
+            break;
+        case '\\':
+            sanitized += "\\\\";
+            break;
+        case '\n':
+        case '\r':
+        case '\t':
+            sanitized += ' ';
+            break;
+        default:
+            sanitized += c;
+            break;
         }
     }
 
-    return false;
+    const auto first{ sanitized.find_first_not_of(WHITESPACE) };
+    if (first == std::string::npos)
+    {
+        return {};
+    }
+
+    sanitized.erase(sanitized.find_last_not_of(WHITESPACE) + 1);
+    sanitized.erase(0, first);
+
+    return sanitized;
+}
+
+bool Validators::isSQLInjection(const std::string& input) noexcept
+{
+    return sqlScanner_.contains(input);
+}
+
+bool Validators::isXSS(const std::string& input) noexcept
+{
+    return xssScanner_.contains(input);
+}
+
+bool Validators::isSQLInjectionOrXSS(const std::string& input) noexcept
+{
+    return sqlAndXssScanner_.contains(input);
 }
 }
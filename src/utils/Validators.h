@@ -3,6 +3,7 @@
 
 #include <string>
 #include <array>
+#include "PatternScanner.h"
 
 namespace utils
 {
@@ -49,20 +50,40 @@ public:
      */
     static [[nodiscard]] bool isUUIDValid(const std::string& uuid) noexcept;
 
+    /**
+     * @brief Validates JWT format
+     * @param token Token string to validate
+     * @return bool True if token has the shape of a signed JWT, false otherwise
+     * @details Validates compact format: header.payload.signature, three non-empty base64url parts
+     * @note Checks the shape only, the signature is not verified
+     */
+    static [[nodiscard]] bool isJWTShapeValid(const std::string& token) noexcept;
+
     /**
      * @brief Validates message length
      * @param message Message string to validate
-     * @param maxLength Maximum allowed message length (default: 4096)
+     * @param maxLength Maximum allowed message length in characters (default: 4096)
      * @return bool True if message length is valid, false otherwise
+     * @details Validates that message is valid UTF-8 of 1 to maxLength code points, as the database counts them
      */
     static [[nodiscard]] bool isMessageLengthValid(const std::string& message, size_t maxLength = 4096) noexcept;
 
+    /**
+     * @brief Validates an attachment file name
+     * @param fileName File name to validate
+     * @return bool True if file name is valid, false otherwise
+     * @details Validates that file name is 1-255 characters of letters, numbers, dots, dashes and underscores
+     *          and does not start with a dot, so it is safe in a Content-Disposition header
+     */
+    static [[nodiscard]] bool isFileNameValid(const std::string& fileName) noexcept;
+
     /**
      * @brief Sanitizes string by removing dangerous characters and escaping special ones
      * @param input String to sanitize
+     * @param escapeQuotes Double single quotes for a SQL string literal, false for a bound parameter
      * @return std::string Sanitized string safe for database storage
      */
-    static [[nodiscard]] std::string sanitizeString(const std::string& input) noexcept;
+    static [[nodiscard]] std::string sanitizeString(const std::string& input, bool escapeQuotes = true) noexcept;
 
     /**
      * @brief Detects potential SQL injection attempts in input string
@@ -79,6 +100,14 @@ public:
      */
     static [[nodiscard]] bool isXSS(const std::string& input) noexcept;
 
+    /**
+     * @brief Detects potential SQL injection or XSS attacks in input string
+     * @param input String to check
+     * @return bool True if isSQLInjection or isXSS would detect an attack, false otherwise
+     * @note Scans the input once for both kinds of patterns
+     */
+    static [[nodiscard]] bool isSQLInjectionOrXSS(const std::string& input) noexcept;
+
 private:
     static constexpr std::array<std::string_view, 16> sqlKeywords_ ///< Common SQL keywords for injection detection
     {
@@ -91,6 +120,10 @@ private:
         "<script", "javascript:", "onload=", "onerror=", "onclick=",
         "eval(", "alert(", "document.cookie", "<iframe"
     };
+
+    static const PatternScanner sqlScanner_;       ///< Scanner of sqlKeywords_ as whole words
+    static const PatternScanner xssScanner_;       ///< Scanner of xssPatterns_
+    static const PatternScanner sqlAndXssScanner_; ///< Scanner of both sets of patterns
 };
 }
 
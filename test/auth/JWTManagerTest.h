@@ -216,6 +216,20 @@ TEST_F(JWTManagerTest, TokenBlacklist_BlacklistedToken_ThrowsOnVerify)
     }, std::invalid_argument);
 }
 
+TEST_F(JWTManagerTest, TokenBlacklist_VerifiedTokenBlacklisted_ThrowsOnVerify)
+{
+    const auto token{ jwtManager_->generateAccessToken(userID_, login_) };
+
+    // the first verification puts the token into the verified tokens cache
+    EXPECT_TRUE(jwtManager_->verifyAndDecode(token).isValid);
+
+    jwtManager_->addTokenToBlacklist(token);
+
+    EXPECT_THROW({
+        const auto payload{ jwtManager_->verifyAndDecode(token) };
+    }, std::invalid_argument);
+}
+
 TEST_F(JWTManagerTest, TokenBlacklist_MultipleTokens_Independent)
 {
     const auto token1{ jwtManager_->generateAccessToken("user1", "login1") };
@@ -213,6 +213,219 @@ TEST_F(ConfigManagerTest, Validation_MissingServerThreads_ThrowsException)
     }, std::runtime_error);
 }
 
+TEST_F(ConfigManagerTest, ServerSection_TlsDisabled_DoesNotRequireSSLFiles)
+{
+    auto config = baseConfig_; // braces would wrap the object in an array
+    config["server"]["tls_enabled"] = false;
+    config["server"]["proxy_protocol"] = true;
+    config.erase("ssl");
+
+    const auto configPath{ testDir_ + "/tls_disabled.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_FALSE(manager.getServerTlsEnabled());
+    EXPECT_TRUE(manager.getServerProxyProtocolEnabled());
+}
+
+TEST_F(ConfigManagerTest, ServerSection_TlsAndProxyProtocol_ReturnDefaults)
+{
+    const auto configPath{ testDir_ + "/tls_defaults.json" };
+    createConfigFile(configPath, baseConfig_);
+
+    ConfigManager manager(configPath);
+    EXPECT_TRUE(manager.getServerTlsEnabled());
+    EXPECT_FALSE(manager.getServerProxyProtocolEnabled());
+}
+
+TEST_F(ConfigManagerTest, ServerSection_UnixSocket_ParsesOctalPermissions)
+{
+    auto config = baseConfig_; // braces would wrap the object in an array
+    config["server"]["unix_socket_path"] = "/run/nova_chat/server.sock";
+    config["server"]["unix_socket_permissions"] = "0600";
+
+    const auto configPath{ testDir_ + "/unix_socket.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_EQ(manager.getServerUnixSocketPath(), "/run/nova_chat/server.sock");
+    EXPECT_EQ(manager.getServerUnixSocketPermissions(), std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+}
+
+TEST_F(ConfigManagerTest, ServerSection_UnixSocketInvalidPermissions_ReturnDefault)
+{
+    const auto defaultPermissions{ std::filesystem::perms::owner_read | std::filesystem::perms::owner_write |
+        std::filesystem::perms::group_read | std::filesystem::perms::group_write };
+
+    for (const auto* permissions : { "", "0689", "1777", "rw-rw----" })
+    {
+        auto config = baseConfig_;
+        config["server"]["unix_socket_permissions"] = permissions;
+
+        const auto configPath{ testDir_ + "/unix_socket_invalid.json" };
+        createConfigFile(configPath, config);
+
+        ConfigManager manager(configPath);
+        EXPECT_TRUE(manager.getServerUnixSocketPath().empty());
+        EXPECT_EQ(manager.getServerUnixSocketPermissions(), defaultPermissions) << permissions;
+    }
+}
+
+TEST_F(ConfigManagerTest, ServerSection_HandlerThreads_DefaultsToServerThreads)
+{
+    const auto configPath{ testDir_ + "/handler_threads_default.json" };
+    createConfigFile(configPath, baseConfig_);
+
+    ConfigManager manager(configPath);
+    EXPECT_EQ(manager.getServerHandlerThreads(), 4);
+}
+
+TEST_F(ConfigManagerTest, ServerSection_HandlerThreads_ReadsClampedValue)
+{
+    auto config = baseConfig_; // braces would wrap the object in an array
+    config["server"]["handler_threads"] = 16;
+
+    const auto configPath{ testDir_ + "/handler_threads.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_EQ(manager.getServerHandlerThreads(), 16);
+
+    config["server"]["handler_threads"] = 5000;
+    createConfigFile(configPath, config);
+
+    ConfigManager clamped(configPath);
+    EXPECT_EQ(clamped.getServerHandlerThreads(), 1024);
+}
+
+TEST_F(ConfigManagerTest, ServerSection_ConnectionLimits_ReturnDefaults)
+{
+    const auto configPath{ testDir_ + "/connection_limits_defaults.json" };
+    createConfigFile(configPath, baseConfig_);
+
+    ConfigManager manager(configPath);
+    EXPECT_EQ(manager.getServerMaxConnections(), 10000);
+    EXPECT_EQ(manager.getServerMaxConnectionsPerIp(), 100);
+    EXPECT_EQ(manager.getServerAcceptRate(), 0);
+    EXPECT_EQ(manager.getServerAcceptBurst(), 100);
+}
+
+TEST_F(ConfigManagerTest, ServerSection_ConnectionLimits_ReadsValues)
+{
+    auto config = baseConfig_; // braces would wrap the object in an array
+    config["server"]["max_connections"] = 500;
+    config["server"]["max_connections_per_ip"] = 0;
+    config["server"]["accept_rate"] = 200;
+    config["server"]["accept_burst"] = 0;
+
+    const auto configPath{ testDir_ + "/connection_limits.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_EQ(manager.getServerMaxConnections(), 500);
+    EXPECT_EQ(manager.getServerMaxConnectionsPerIp(), 0);
+    EXPECT_EQ(manager.getServerAcceptRate(), 200);
+    EXPECT_EQ(manager.getServerAcceptBurst(), 1);
+}
+
+TEST_F(ConfigManagerTest, RateLimitsSection_MissingAndConfigured)
+{
+    {
+        const auto configPath{ testDir_ + "/rate_limits_defaults.json" };
+        createConfigFile(configPath, baseConfig_);
+
+        ConfigManager manager(configPath);
+        EXPECT_TRUE(manager.getRateLimitRoutes().empty());
+        EXPECT_EQ(manager.getRateLimitMaxBuckets(), 100000);
+    }
+
+    auto config = baseConfig_; // braces would wrap the object in an array
+    config["rate_limits"]["max_buckets"] = 1;
+    config["rate_limits"]["routes"] = nlohmann::json::array({
+        { {"path", "/api/v1/messages/send"}, {"user_rate", 2.5}, {"user_burst", 10}, {"ip_rate", 20} },
+        { {"user_rate", 1} },
+        { {"path", "/api/v1/users/search"}, {"ip_rate", "fast"} },
+        { {"path", "/api/v1/users"}, {"user_rate", -1}, {"ip_burst", 0} }
+    });
+
+    const auto configPath{ testDir_ + "/rate_limits.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    const auto routes{ manager.getRateLimitRoutes() };
+    ASSERT_EQ(routes.size(), 2);
+
+    EXPECT_EQ(routes[0].path, "/api/v1/messages/send");
+    EXPECT_DOUBLE_EQ(routes[0].userRate, 2.5);
+    EXPECT_EQ(routes[0].userBurst, 10);
+    EXPECT_DOUBLE_EQ(routes[0].ipRate, 20.0);
+    EXPECT_EQ(routes[0].ipBurst, 1);
+
+    EXPECT_EQ(routes[1].path, "/api/v1/users");
+    EXPECT_DOUBLE_EQ(routes[1].userRate, 0.0);
+    EXPECT_EQ(routes[1].ipBurst, 1);
+
+    EXPECT_EQ(manager.getRateLimitMaxBuckets(), 16);
+}
+
+TEST_F(ConfigManagerTest, DatabaseConcurrency_MissingAndConfigured)
+{
+    {
+        const auto configPath{ testDir_ + "/database_concurrency_defaults.json" };
+        createConfigFile(configPath, baseConfig_);
+
+        ConfigManager manager(configPath);
+        EXPECT_FALSE(manager.getDatabaseAdaptiveConcurrency());
+        EXPECT_EQ(manager.getDatabaseMinConcurrency(), 1);
+        EXPECT_EQ(manager.getDatabaseCircuitFailureThreshold(), 5);
+        EXPECT_EQ(manager.getDatabaseReconnectInterval(), 1000);
+    }
+
+    auto config = baseConfig_; // braces would wrap the object in an array
+    config["database"]["adaptive_concurrency"] = true;
+    config["database"]["min_concurrency"] = 0;
+    config["database"]["circuit_failure_threshold"] = 0;
+    config["database"]["reconnect_interval_ms"] = 1;
+
+    const auto configPath{ testDir_ + "/database_concurrency.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_TRUE(manager.getDatabaseAdaptiveConcurrency());
+    EXPECT_EQ(manager.getDatabaseMinConcurrency(), 1);
+    EXPECT_EQ(manager.getDatabaseCircuitFailureThreshold(), 1);
+    EXPECT_EQ(manager.getDatabaseReconnectInterval(), 10);
+}
+
+TEST_F(ConfigManagerTest, LoadSheddingSection_MissingAndConfigured)
+{
+    {
+        const auto configPath{ testDir_ + "/load_shedding_defaults.json" };
+        createConfigFile(configPath, baseConfig_);
+
+        ConfigManager manager(configPath);
+        EXPECT_FALSE(manager.getLoadSheddingEnabled());
+        EXPECT_EQ(manager.getLoadSheddingMaxQueueDepth(), 64);
+        EXPECT_EQ(manager.getLoadSheddingLowPriorityRoutes(), std::vector<std::string>{ "/api/v1/users" });
+        EXPECT_DOUBLE_EQ(manager.getLoadSheddingLowPriorityShare(), 0.5);
+    }
+
+    auto config = baseConfig_; // braces would wrap the object in an array
+    config["load_shedding"]["enabled"] = true;
+    config["load_shedding"]["max_queue_depth"] = 0;
+    config["load_shedding"]["low_priority_routes"] = nlohmann::json::array({ "/api/v1/users/search", "/api/v1/messages/export" });
+    config["load_shedding"]["low_priority_share"] = 1.5;
+
+    const auto configPath{ testDir_ + "/load_shedding.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_TRUE(manager.getLoadSheddingEnabled());
+    EXPECT_EQ(manager.getLoadSheddingMaxQueueDepth(), 0);
+    EXPECT_EQ(manager.getLoadSheddingLowPriorityRoutes(), (std::vector<std::string>{ "/api/v1/users/search", "/api/v1/messages/export" }));
+    EXPECT_DOUBLE_EQ(manager.getLoadSheddingLowPriorityShare(), 1.0);
+}
+
 TEST_F(ConfigManagerTest, Validation_MissingSSLCertificateFile_ThrowsException)
 {
     auto config{ baseConfig_ };
@@ -945,6 +1158,147 @@ TEST_F(ConfigManagerTest, NestedConfig_AdditionalFields_Ignored)
     });
 }
 
+TEST_F(ConfigManagerTest, HttpSection_Missing_ReturnsDefaults)
+{
+    const auto configPath{ testDir_ + "/http_defaults.json" };
+    createConfigFile(configPath, baseConfig_);
+
+    ConfigManager manager(configPath);
+    EXPECT_EQ(manager.getHttpCacheControl(), "no-cache");
+    EXPECT_TRUE(manager.getHttpCompressionEnabled());
+    EXPECT_EQ(manager.getHttpCompressionMinSize(), 1024u);
+    EXPECT_EQ(manager.getHttpCompressionLevel(), 6);
+    EXPECT_EQ(manager.getHttpMaxRequestBodySize(), 1048576u);
+    EXPECT_EQ(manager.getHttpRequestTimeout(), 5000u);
+    EXPECT_TRUE(manager.getHttp2Enabled());
+    EXPECT_EQ(manager.getHttp2MaxConcurrentStreams(), 100u);
+    EXPECT_EQ(manager.getHttp2InitialWindowSize(), 1048576u);
+}
+
+TEST_F(ConfigManagerTest, HttpSection_Compression_ReturnsConfiguredValues)
+{
+    auto config{ baseConfig_ };
+    config["http"]["compression_enabled"] = false;
+    config["http"]["compression_min_size"] = 256;
+    config["http"]["compression_level"] = 42;
+    config["http"]["max_request_body_size"] = 4096;
+
+    const auto configPath{ testDir_ + "/http_compression.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_FALSE(manager.getHttpCompressionEnabled());
+    EXPECT_EQ(manager.getHttpCompressionMinSize(), 256u);
+    EXPECT_EQ(manager.getHttpCompressionLevel(), 9); // clamped to the zlib range
+    EXPECT_EQ(manager.getHttpMaxRequestBodySize(), 4096u);
+}
+
+TEST_F(ConfigManagerTest, HttpSection_RequestTimeout_ReturnsClampedValue)
+{
+    auto config = baseConfig_; // braces would wrap the object in an array
+    config["http"]["request_timeout_ms"] = 2500;
+
+    const auto configPath{ testDir_ + "/http_request_timeout.json" };
+    createConfigFile(configPath, config);
+
+    {
+        ConfigManager manager(configPath);
+        EXPECT_EQ(manager.getHttpRequestTimeout(), 2500u);
+    }
+
+    config["http"]["request_timeout_ms"] = 0;
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_EQ(manager.getHttpRequestTimeout(), 1u);
+}
+
+TEST_F(ConfigManagerTest, HttpSection_Http2_ReturnsClampedValues)
+{
+    auto config = baseConfig_; // braces would wrap the object in an array
+    config["http"]["http2_enabled"] = false;
+    config["http"]["http2_max_concurrent_streams"] = 0;
+    config["http"]["http2_initial_window_size"] = 1024;
+
+    const auto configPath{ testDir_ + "/http2.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_FALSE(manager.getHttp2Enabled());
+    EXPECT_EQ(manager.getHttp2MaxConcurrentStreams(), 1u);
+    EXPECT_EQ(manager.getHttp2InitialWindowSize(), 65535u); // the HTTP/2 default window is the minimum
+}
+
+TEST_F(ConfigManagerTest, HttpSection_CacheControl_ReturnsConfiguredValue)
+{
+    auto config{ baseConfig_ };
+    config["http"]["cache_control"] = "private, max-age=0";
+
+    const auto configPath{ testDir_ + "/http_cache_control.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_EQ(manager.getHttpCacheControl(), "private, max-age=0");
+}
+
+TEST_F(ConfigManagerTest, AttachmentsSection_MissingAndConfigured)
+{
+    const auto defaultsPath{ testDir_ + "/attachments_defaults.json" };
+    createConfigFile(defaultsPath, baseConfig_);
+
+    ConfigManager defaults(defaultsPath);
+    EXPECT_EQ(defaults.getAttachmentsDirectory(), "attachments");
+    EXPECT_EQ(defaults.getAttachmentsMaxSize(), 104857600u);
+
+    auto config{ baseConfig_ };
+    config["attachments"]["directory"] = "/var/lib/novachat/attachments";
+    config["attachments"]["max_size"] = 1024;
+
+    const auto configPath{ testDir_ + "/attachments.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_EQ(manager.getAttachmentsDirectory(), "/var/lib/novachat/attachments");
+    EXPECT_EQ(manager.getAttachmentsMaxSize(), 1024u);
+}
+
+TEST_F(ConfigManagerTest, SSLSessionSettings_MissingAndConfigured)
+{
+    const auto defaultsPath{ testDir_ + "/ssl_session_defaults.json" };
+    createConfigFile(defaultsPath, baseConfig_);
+
+    ConfigManager defaults(defaultsPath);
+    EXPECT_FALSE(defaults.getSSLCipherList().empty());
+    EXPECT_EQ(defaults.getSSLCipherSuites(), "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256");
+    EXPECT_EQ(defaults.getSSLGroups(), "X25519:P-256:P-384");
+    EXPECT_EQ(defaults.getSSLSessionCacheSize(), 20480u);
+    EXPECT_EQ(defaults.getSSLSessionTimeout(), 86400u);
+    EXPECT_TRUE(defaults.getSSLSessionTicketsEnabled());
+    EXPECT_EQ(defaults.getSSLTicketKeyRotationMinutes(), 720u);
+    EXPECT_TRUE(defaults.getSSLKernelTlsEnabled());
+
+    auto config{ baseConfig_ };
+    config["ssl"]["cipher_list"] = "ECDHE-RSA-AES128-GCM-SHA256";
+    config["ssl"]["groups"] = "X25519";
+    config["ssl"]["session_cache_size"] = 1000;
+    config["ssl"]["session_timeout"] = 3600;
+    config["ssl"]["session_tickets_enabled"] = false;
+    config["ssl"]["ticket_key_rotation_minutes"] = 0;
+    config["ssl"]["ktls_enabled"] = false;
+
+    const auto configPath{ testDir_ + "/ssl_session.json" };
+    createConfigFile(configPath, config);
+
+    ConfigManager manager(configPath);
+    EXPECT_EQ(manager.getSSLCipherList(), "ECDHE-RSA-AES128-GCM-SHA256");
+    EXPECT_EQ(manager.getSSLGroups(), "X25519");
+    EXPECT_EQ(manager.getSSLSessionCacheSize(), 1000u);
+    EXPECT_EQ(manager.getSSLSessionTimeout(), 3600u);
+    EXPECT_FALSE(manager.getSSLSessionTicketsEnabled());
+    EXPECT_EQ(manager.getSSLTicketKeyRotationMinutes(), 1u);
+    EXPECT_FALSE(manager.getSSLKernelTlsEnabled());
+}
+
 TEST_F(ConfigManagerTest, Integration_AllMethods_ReturnConsistentValues)
 {
     const auto configPath{ testDir_ + "/integration_test.json" };
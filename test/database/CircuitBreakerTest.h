@@ -0,0 +1,75 @@
+#ifndef CIRCUIT_BREAKER_TEST_H
+#define CIRCUIT_BREAKER_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "database/CircuitBreaker.h"
+
+namespace database
+{
+TEST(CircuitBreakerTest, RecordFailure_ThresholdReached_Opens)
+{
+    CircuitBreaker breaker{ 3 };
+    EXPECT_EQ(breaker.getState(), CircuitState::Closed);
+
+    EXPECT_FALSE(breaker.recordFailure());
+    EXPECT_FALSE(breaker.recordFailure());
+    EXPECT_TRUE(breaker.isAllowed());
+
+    EXPECT_TRUE(breaker.recordFailure());
+    EXPECT_EQ(breaker.getState(), CircuitState::Open);
+    EXPECT_FALSE(breaker.isAllowed());
+    EXPECT_EQ(breaker.getOpenCount(), 1);
+
+    // further failures while open change nothing
+    EXPECT_FALSE(breaker.recordFailure());
+    EXPECT_EQ(breaker.getOpenCount(), 1);
+}
+
+TEST(CircuitBreakerTest, RecordSuccess_ResetsConsecutiveFailures)
+{
+    CircuitBreaker breaker{ 2 };
+
+    EXPECT_FALSE(breaker.recordFailure());
+    breaker.recordSuccess();
+    EXPECT_FALSE(breaker.recordFailure());
+
+    EXPECT_EQ(breaker.getState(), CircuitState::Closed);
+}
+
+TEST(CircuitBreakerTest, RecordRecovery_HalfOpen_ClosesOnSuccess)
+{
+    CircuitBreaker breaker{ 1 };
+
+    // recovery of a closed circuit changes nothing
+    breaker.recordRecovery();
+    EXPECT_EQ(breaker.getState(), CircuitState::Closed);
+
+    ASSERT_TRUE(breaker.recordFailure());
+    breaker.recordRecovery();
+    EXPECT_EQ(breaker.getState(), CircuitState::HalfOpen);
+    EXPECT_TRUE(breaker.isAllowed());
+
+    breaker.recordSuccess();
+    EXPECT_EQ(breaker.getState(), CircuitState::Closed);
+}
+
+TEST(CircuitBreakerTest, RecordFailure_HalfOpen_OpensAtOnce)
+{
+    CircuitBreaker breaker{ 5 };
+
+    for (int i{ 0 }; i < 5; ++i)
+    {
+        static_cast<void>(breaker.recordFailure());
+    }
+
+    ASSERT_EQ(breaker.getState(), CircuitState::Open);
+    breaker.recordRecovery();
+
+    EXPECT_TRUE(breaker.recordFailure());
+    EXPECT_EQ(breaker.getState(), CircuitState::Open);
+    EXPECT_EQ(breaker.getOpenCount(), 2);
+}
+}
+
+#endif // CIRCUIT_BREAKER_TEST_H
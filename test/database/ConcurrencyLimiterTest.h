@@ -0,0 +1,145 @@
+#ifndef CONCURRENCY_LIMITER_TEST_H
+#define CONCURRENCY_LIMITER_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "database/ConcurrencyLimiter.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace database
+{
+class ConcurrencyLimiterTest : public ::testing::Test
+{
+protected:
+    // runs rounds of queries that keep the whole limit busy, each taking rttOf(concurrency)
+    template<typename RttFunction>
+    static void runRounds(ConcurrencyLimiter& limiter, int rounds, RttFunction rttOf)
+    {
+        for (int round{ 0 }; round < rounds; ++round)
+        {
+            const auto concurrency{ limiter.getLimit() };
+            for (unsigned int i{ 0 }; i < concurrency; ++i)
+            {
+                ASSERT_TRUE(limiter.acquire(std::chrono::milliseconds{ 0 }));
+            }
+
+            for (unsigned int i{ 0 }; i < concurrency; ++i)
+            {
+                limiter.release(rttOf(concurrency), false);
+            }
+        }
+    }
+};
+
+TEST_F(ConcurrencyLimiterTest, Acquire_LimitReached_WaitsForRelease)
+{
+    ConcurrencyLimiter limiter{ 2, 4 };
+    EXPECT_EQ(limiter.getLimit(), 2);
+
+    ASSERT_TRUE(limiter.acquire(std::chrono::milliseconds{ 0 }));
+    ASSERT_TRUE(limiter.acquire(std::chrono::milliseconds{ 0 }));
+    EXPECT_FALSE(limiter.acquire(std::chrono::milliseconds{ 10 }));
+    EXPECT_EQ(limiter.getStatistics().inFlight, 2);
+
+    std::thread releaser{ [&limiter]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        limiter.release(std::chrono::milliseconds{ 5 }, false);
+    } };
+
+    EXPECT_TRUE(limiter.acquire(std::chrono::seconds{ 5 }));
+    releaser.join();
+
+    limiter.release(std::chrono::milliseconds{ 5 }, false);
+    limiter.release(std::chrono::milliseconds{ 5 }, false);
+    EXPECT_EQ(limiter.getStatistics().inFlight, 0);
+}
+
+TEST_F(ConcurrencyLimiterTest, Release_LatencyInflates_LimitShrinks)
+{
+    ConcurrencyLimiter limiter{ 1, 50 };
+
+    // the database serves 8 queries in parallel, more only queue inside it
+    runRounds(limiter, 200, [](unsigned int concurrency)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::milliseconds{ 10 } * std::max(1.0, concurrency / 8.0));
+    });
+
+    const auto statistics{ limiter.getStatistics() };
+    EXPECT_LT(statistics.limit, 20);
+    EXPECT_GE(statistics.limit, 4);
+    EXPECT_EQ(statistics.minRtt, std::chrono::milliseconds{ 10 });
+    EXPECT_GT(statistics.samples, 0);
+}
+
+TEST_F(ConcurrencyLimiterTest, Release_ConstantLatency_LimitGrowsToMaximum)
+{
+    ConcurrencyLimiter limiter{ 1, 20 };
+    EXPECT_EQ(limiter.getLimit(), 1);
+
+    runRounds(limiter, 50, [](unsigned int) { return std::chrono::milliseconds{ 10 }; });
+
+    EXPECT_EQ(limiter.getLimit(), 20);
+}
+
+TEST_F(ConcurrencyLimiterTest, Release_Dropped_LimitBacksOffToMinimum)
+{
+    ConcurrencyLimiter limiter{ 3, 10 };
+
+    runRounds(limiter, 50, [](unsigned int) { return std::chrono::milliseconds{ 10 }; });
+    ASSERT_EQ(limiter.getLimit(), 10);
+
+    for (int i{ 0 }; i < 50; ++i)
+    {
+        ASSERT_TRUE(limiter.acquire(std::chrono::milliseconds{ 0 }));
+        limiter.release(std::chrono::seconds{ 30 }, true);
+    }
+
+    const auto statistics{ limiter.getStatistics() };
+    EXPECT_EQ(statistics.limit, 3);
+    EXPECT_EQ(statistics.drops, 50);
+}
+
+TEST_F(ConcurrencyLimiterTest, Abandon_FreesSlotWithoutSample)
+{
+    ConcurrencyLimiter limiter{ 3, 10 };
+
+    runRounds(limiter, 50, [](unsigned int) { return std::chrono::milliseconds{ 10 }; });
+    const auto before{ limiter.getStatistics() };
+    ASSERT_EQ(before.limit, 10);
+
+    for (int i{ 0 }; i < 50; ++i)
+    {
+        ASSERT_TRUE(limiter.acquire(std::chrono::milliseconds{ 0 }));
+        limiter.abandon();
+    }
+
+    const auto after{ limiter.getStatistics() };
+    EXPECT_EQ(after.limit, 10);
+    EXPECT_EQ(after.inFlight, 0);
+    EXPECT_EQ(after.minRtt, before.minRtt);
+    EXPECT_EQ(after.samples, before.samples);
+    EXPECT_EQ(after.drops, 0);
+}
+
+TEST_F(ConcurrencyLimiterTest, GetRttSamples_KeepsRecentSamplesInOrder)
+{
+    ConcurrencyLimiter limiter{ 1, 1 };
+
+    for (int i{ 1 }; i <= static_cast<int>(ConcurrencyLimiter::RTT_HISTORY_SIZE) + 10; ++i)
+    {
+        ASSERT_TRUE(limiter.acquire(std::chrono::milliseconds{ 0 }));
+        limiter.release(std::chrono::microseconds{ i }, false);
+    }
+
+    const auto samples{ limiter.getRttSamples() };
+    ASSERT_EQ(samples.size(), ConcurrencyLimiter::RTT_HISTORY_SIZE);
+    EXPECT_EQ(samples.front(), std::chrono::microseconds{ 11 });
+    EXPECT_EQ(samples.back(), std::chrono::microseconds{ ConcurrencyLimiter::RTT_HISTORY_SIZE + 10 });
+    EXPECT_TRUE(std::ranges::is_sorted(samples));
+}
+}
+
+#endif // CONCURRENCY_LIMITER_TEST_H
@@ -344,6 +344,27 @@ TEST_F(DatabaseManagerTest, RecoveryAfterError)
     // health check should work
     EXPECT_TRUE(manager.healthCheck());
 }
+
+TEST_F(DatabaseManagerTest, EstimateWait)
+{
+    PoolStatistics statistics{};
+    statistics.poolSize = 8;
+    statistics.concurrencyLimit = 4;
+    statistics.availableConnections = 2;
+    statistics.waitingQueries = 1;
+    statistics.averageHoldTime = std::chrono::milliseconds{ 40 };
+
+    // an idle connection is left for a new query
+    EXPECT_EQ(DatabaseManager::estimateWait(statistics), std::chrono::milliseconds::zero());
+
+    // the new query waits behind 7 others, 4 concurrent queries finish every 40 ms
+    statistics.availableConnections = 0;
+    statistics.waitingQueries = 7;
+    EXPECT_EQ(DatabaseManager::estimateWait(statistics), std::chrono::milliseconds{ 80 });
+
+    statistics.concurrencyLimit = 0;
+    EXPECT_EQ(DatabaseManager::estimateWait(statistics), std::chrono::milliseconds::zero());
+}
 }
 
 #endif // DATABASE_MANAGER_TEST_H
@@ -0,0 +1,134 @@
+#ifndef ATTACHMENT_HANDLERS_TEST_H
+#define ATTACHMENT_HANDLERS_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "handlers/AttachmentHandlers.h"
+#include "auth/JWTManager.h"
+#include "utils/UUIDUtils.h"
+
+#include <boost/beast/http.hpp>
+#include <nlohmann/json.hpp>
+
+namespace handlers
+{
+class AttachmentHandlersTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        jwtManager_ = std::make_shared<auth::JWTManager>("test_secret_key_which_is_long_enough_for_tests", 15, 7);
+        rootDir_ = std::filesystem::temp_directory_path() / ("attachment_handlers_test_" + utils::UUIDUtils::generateUUID());
+
+        // deliberately pass a null database manager for tests that don't touch DB
+        attachmentHandlers_ = std::make_unique<AttachmentHandlers>(jwtManager_, nullptr, std::make_shared<storage::AttachmentStore>(rootDir_));
+    }
+
+    void TearDown() override
+    {
+        attachmentHandlers_.reset();
+        std::filesystem::remove_all(rootDir_);
+    }
+
+    boost::beast::http::request<boost::beast::http::string_body> createUploadRequest(const std::string& target) const
+    {
+        boost::beast::http::request<boost::beast::http::string_body> req{};
+        req.method(boost::beast::http::verb::post);
+        req.target(target);
+        req.set("Authorization", "Bearer " + jwtManager_->generateAccessToken("user1", "sender"));
+        return req;
+    }
+
+    std::shared_ptr<auth::JWTManager> jwtManager_;
+    std::filesystem::path rootDir_;
+    std::unique_ptr<AttachmentHandlers> attachmentHandlers_;
+};
+
+TEST_F(AttachmentHandlersTest, IsUploadAndStreamingRequest_MatchEndpoints)
+{
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::post);
+    req.target("/api/v1/attachments?file_name=a.txt");
+    EXPECT_TRUE(attachmentHandlers_->isUploadRequest(req));
+    EXPECT_FALSE(attachmentHandlers_->isStreamingRequest(req));
+
+    req.method(boost::beast::http::verb::get);
+    req.target("/api/v1/attachments/5b1d7c4e-2f0a-4f7e-9d3b-8a6c1e2f4b90");
+    EXPECT_FALSE(attachmentHandlers_->isUploadRequest(req));
+    EXPECT_TRUE(attachmentHandlers_->isStreamingRequest(req));
+
+    req.target("/api/v1/attachments/");
+    EXPECT_FALSE(attachmentHandlers_->isStreamingRequest(req));
+}
+
+TEST_F(AttachmentHandlersTest, HandleRequest_DirectOnlyEndpoints_ReturnStreamingRequired)
+{
+    auto req{ createUploadRequest("/api/v1/attachments?file_name=a.txt") };
+
+    const auto resp{ attachmentHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+    EXPECT_EQ(nlohmann::json::parse(resp.body())["code"], "STREAMING_REQUIRED");
+}
+
+TEST_F(AttachmentHandlersTest, UploadHeader_MissingAccessToken_ReturnsUnauthorized)
+{
+    auto req{ createUploadRequest("/api/v1/attachments?file_name=a.txt") };
+    req.erase("Authorization");
+
+    std::filesystem::path bodyFile{};
+    const auto resp{ attachmentHandlers_->processUploadHeader(req, bodyFile) };
+    ASSERT_TRUE(resp.has_value());
+    EXPECT_EQ(resp->result(), boost::beast::http::status::unauthorized);
+    EXPECT_TRUE(bodyFile.empty());
+}
+
+TEST_F(AttachmentHandlersTest, UploadHeader_InvalidFileName_ReturnsBadRequest)
+{
+    std::filesystem::path bodyFile{};
+
+    const auto missing{ attachmentHandlers_->processUploadHeader(createUploadRequest("/api/v1/attachments"), bodyFile) };
+    ASSERT_TRUE(missing.has_value());
+    EXPECT_EQ(nlohmann::json::parse(missing->body())["code"], "INVALID_FILE_NAME");
+
+    const auto traversal{ attachmentHandlers_->processUploadHeader(createUploadRequest("/api/v1/attachments?file_name=../x"), bodyFile) };
+    ASSERT_TRUE(traversal.has_value());
+    EXPECT_EQ(traversal->result(), boost::beast::http::status::bad_request);
+}
+
+TEST_F(AttachmentHandlersTest, UploadHeader_ContentEncoding_ReturnsUnsupportedMediaType)
+{
+    auto req{ createUploadRequest("/api/v1/attachments?file_name=a.txt") };
+    req.set(boost::beast::http::field::content_encoding, "gzip");
+
+    std::filesystem::path bodyFile{};
+    const auto resp{ attachmentHandlers_->processUploadHeader(req, bodyFile) };
+    ASSERT_TRUE(resp.has_value());
+    EXPECT_EQ(resp->result(), boost::beast::http::status::unsupported_media_type);
+}
+
+TEST_F(AttachmentHandlersTest, UploadHeader_ValidRequest_ProvidesTemporaryFile)
+{
+    auto req{ createUploadRequest("/api/v1/attachments?file_name=report.pdf") };
+    req.set(boost::beast::http::field::content_type, "application/pdf");
+
+    std::filesystem::path bodyFile{};
+    EXPECT_FALSE(attachmentHandlers_->processUploadHeader(req, bodyFile).has_value());
+    EXPECT_FALSE(bodyFile.empty());
+    EXPECT_EQ(bodyFile.parent_path().parent_path(), rootDir_);
+}
+
+TEST_F(AttachmentHandlersTest, Download_InvalidAttachmentId_ReturnsBadRequest)
+{
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::get);
+    req.target("/api/v1/attachments/not-a-uuid");
+    req.set("Authorization", "Bearer " + jwtManager_->generateAccessToken("user1", "sender"));
+
+    boost::beast::http::response<boost::beast::http::string_body> resp{};
+    EXPECT_EQ(attachmentHandlers_->processStream(req, resp), nullptr);
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+    EXPECT_EQ(nlohmann::json::parse(resp.body())["code"], "INVALID_ATTACHMENT_ID");
+}
+}
+
+#endif // ATTACHMENT_HANDLERS_TEST_H
@@ -75,6 +75,19 @@ TEST_F(AuthHandlersTest, HandleRegister_InvalidContentType_ReturnsBadRequest)
     EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
 }
 
+TEST_F(AuthHandlersTest, HandleRegister_InvalidPassword_ReturnsBadRequest)
+{
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::post);
+    req.target("/api/v1/auth/register");
+    req.set("Content-Type", "application/json");
+    req.body() = R"({"login":"new_user","password":"short"})"; // rejected before DB access
+    req.prepare_payload();
+
+    const auto resp{ authHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+}
+
 TEST_F(AuthHandlersTest, HandleLogin_InvalidContentType_ReturnsBadRequest)
 {
     boost::beast::http::request<boost::beast::http::string_body> req{};
@@ -0,0 +1,271 @@
+#ifndef BATCH_HANDLERS_TEST_H
+#define BATCH_HANDLERS_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "handlers/BatchHandlers.h"
+#include "auth/JWTManager.h"
+#include "server/Router.h"
+
+#include <boost/asio/thread_pool.hpp>
+#include <boost/beast/http.hpp>
+#include <nlohmann/json.hpp>
+
+#include <future>
+#include <thread>
+
+namespace handlers
+{
+class EchoHandler : public IHandler
+{
+public:
+    ~EchoHandler() noexcept override = default;
+
+    boost::beast::http::response<boost::beast::http::string_body> handleRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) noexcept override
+    {
+        nlohmann::json json{};
+        json["method"] = std::string{ request.method_string() };
+        json["target"] = std::string{ request.target() };
+        json["body"] = request.body();
+        json["authorization"] = std::string{ request[boost::beast::http::field::authorization] };
+
+        return createJsonResponse(json);
+    }
+
+    std::vector<boost::beast::http::verb> getSupportedMethods() const noexcept override { return { boost::beast::http::verb::get, boost::beast::http::verb::post }; }
+
+protected:
+    bool isAuthTokenValid(const std::string&, std::string&) const noexcept override { return true; }
+};
+
+// counts how many requests it handles at once
+class ConcurrencyCountingHandler : public EchoHandler
+{
+public:
+    boost::beast::http::response<boost::beast::http::string_body> handleRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) noexcept override
+    {
+        const auto running{ ++running_ };
+        for (auto peak{ peak_.load() }; running > peak && !peak_.compare_exchange_weak(peak, running);)
+        {
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        --running_;
+
+        return EchoHandler::handleRequest(request);
+    }
+
+    int getPeak() const noexcept { return peak_; }
+
+private:
+    std::atomic<int> running_{ 0 };
+    std::atomic<int> peak_{ 0 };
+};
+
+class BatchHandlersTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        jwtManager_ = std::make_shared<auth::JWTManager>("test_secret_key_which_is_long_enough_for_tests", 15, 7);
+        router_ = std::make_shared<server::Router>();
+        batchHandlers_ = std::make_shared<BatchHandlers>(jwtManager_, router_, pool_.get_executor());
+
+        router_->registerHandler("/api/v1/echo", std::make_shared<EchoHandler>());
+        router_->registerHandler("/api/v1/counting", countingHandler_);
+        router_->registerHandler("/api/v1/batch", batchHandlers_);
+
+        token_ = jwtManager_->generateAccessToken("user1", "sender");
+    }
+
+    void TearDown() override
+    {
+        router_.reset();
+        batchHandlers_.reset();
+        jwtManager_.reset();
+    }
+
+    [[nodiscard]] static std::string makeGetBatch(const std::string& path, int count)
+    {
+        auto requests{ nlohmann::json::array() };
+        for (auto i{ 0 }; i < count; ++i)
+        {
+            requests.push_back({ { "method", "GET" }, { "path", path } });
+        }
+
+        return nlohmann::json{ { "requests", requests } }.dump();
+    }
+
+    [[nodiscard]] boost::beast::http::request<boost::beast::http::string_body> makeRequest(const std::string& body) const
+    {
+        boost::beast::http::request<boost::beast::http::string_body> req{};
+        req.method(boost::beast::http::verb::post);
+        req.target("/api/v1/batch");
+        req.set("Authorization", "Bearer " + token_);
+        req.set("Content-Type", "application/json");
+        req.body() = body;
+        req.prepare_payload();
+        return req;
+    }
+
+    boost::asio::thread_pool pool_{ 8 };
+    std::shared_ptr<auth::JWTManager> jwtManager_;
+    std::shared_ptr<server::Router> router_;
+    std::shared_ptr<BatchHandlers> batchHandlers_;
+    std::shared_ptr<ConcurrencyCountingHandler> countingHandler_{ std::make_shared<ConcurrencyCountingHandler>() };
+    std::string token_;
+};
+
+TEST_F(BatchHandlersTest, GetSupportedMethods_ReturnsPost)
+{
+    const auto methods{ batchHandlers_->getSupportedMethods() };
+    ASSERT_EQ(methods.size(), 1u);
+    EXPECT_EQ(methods[0], boost::beast::http::verb::post);
+}
+
+TEST_F(BatchHandlersTest, HandleBatch_MissingAccessToken_ReturnsUnauthorized)
+{
+    auto req{ makeRequest(R"({"requests":[]})") };
+    req.erase(boost::beast::http::field::authorization);
+
+    const auto resp{ batchHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::unauthorized);
+}
+
+TEST_F(BatchHandlersTest, HandleBatch_EmptyRequests_ReturnsBadRequest)
+{
+    const auto resp{ batchHandlers_->handleRequest(makeRequest(R"({"requests":[]})")) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+}
+
+TEST_F(BatchHandlersTest, HandleBatch_TooManyRequests_ReturnsBadRequest)
+{
+    nlohmann::json j{};
+    j["requests"] = nlohmann::json::array();
+    for (int i = 0; i < 21; ++i)
+    {
+        j["requests"].push_back({ { "method", "GET" }, { "path", "/api/v1/echo" } });
+    }
+
+    const auto resp{ batchHandlers_->handleRequest(makeRequest(j.dump())) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+}
+
+TEST_F(BatchHandlersTest, HandleBatch_NestedBatch_ReturnsBadRequest)
+{
+    const auto resp{ batchHandlers_->handleRequest(makeRequest(R"({"requests":[{"method":"POST","path":"/api/v1/batch"}]})")) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+}
+
+TEST_F(BatchHandlersTest, HandleBatch_UnknownMethod_ReturnsBadRequest)
+{
+    const auto resp{ batchHandlers_->handleRequest(makeRequest(R"({"requests":[{"method":"FETCH","path":"/api/v1/echo"}]})")) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+}
+
+TEST_F(BatchHandlersTest, HandleBatch_MixedRequests_ReturnsResponsesInOrder)
+{
+    const auto resp{ batchHandlers_->handleRequest(makeRequest(R"({"requests":[
+        {"id":"a","method":"GET","path":"/api/v1/echo?limit=1"},
+        {"id":"b","method":"GET","path":"/api/v1/echo?limit=2"},
+        {"id":"c","method":"POST","path":"/api/v1/echo","body":{"key":"value"}},
+        {"method":"GET","path":"/api/v1/unknown"}
+    ]})")) };
+    ASSERT_EQ(resp.result(), boost::beast::http::status::ok);
+
+    const auto body{ nlohmann::json::parse(resp.body()) };
+    const auto& responses{ body["data"]["responses"] };
+    ASSERT_EQ(responses.size(), 4u);
+
+    EXPECT_EQ(responses[0]["id"], "a");
+    EXPECT_EQ(responses[0]["status"], 200);
+    EXPECT_EQ(responses[0]["body"]["target"], "/api/v1/echo?limit=1");
+    EXPECT_EQ(responses[0]["body"]["authorization"], "Bearer " + token_);
+
+    EXPECT_EQ(responses[1]["id"], "b");
+    EXPECT_EQ(responses[1]["body"]["target"], "/api/v1/echo?limit=2");
+
+    EXPECT_EQ(responses[2]["id"], "c");
+    EXPECT_EQ(responses[2]["body"]["method"], "POST");
+    EXPECT_EQ(nlohmann::json::parse(responses[2]["body"]["body"].get<std::string>())["key"], "value");
+
+    EXPECT_EQ(responses[3]["id"], 3);
+    EXPECT_EQ(responses[3]["status"], 404);
+}
+
+TEST_F(BatchHandlersTest, HandleBatch_ParallelGets_RunAtMostFourAtOnce)
+{
+    const auto resp{ batchHandlers_->handleRequest(makeRequest(makeGetBatch("/api/v1/counting", 20))) };
+    ASSERT_EQ(resp.result(), boost::beast::http::status::ok);
+
+    const auto body{ nlohmann::json::parse(resp.body()) };
+    ASSERT_EQ(body["data"]["responses"].size(), 20u);
+
+    for (const auto& response : body["data"]["responses"])
+    {
+        EXPECT_EQ(response["status"], 200);
+    }
+
+    EXPECT_GT(countingHandler_->getPeak(), 1);
+    EXPECT_LE(countingHandler_->getPeak(), 4);
+}
+
+TEST_F(BatchHandlersTest, HandleBatch_ExecutorBusy_CallingThreadRunsSubRequests)
+{
+    // every thread of the executor is blocked, as under load
+    boost::asio::thread_pool busyPool{ 1 };
+    std::promise<void> release{};
+    boost::asio::post(busyPool, [future = release.get_future()]() { future.wait(); });
+
+    const auto batchHandlers{ std::make_shared<BatchHandlers>(jwtManager_, router_, busyPool.get_executor()) };
+    const auto resp{ batchHandlers->handleRequest(makeRequest(makeGetBatch("/api/v1/echo", 5))) };
+
+    release.set_value();
+    busyPool.join();
+
+    ASSERT_EQ(resp.result(), boost::beast::http::status::ok);
+    EXPECT_EQ(nlohmann::json::parse(resp.body())["data"]["responses"].size(), 5u);
+}
+
+TEST_F(BatchHandlersTest, Process_MessagePackRequestAndAccept_RespondsWithMessagePack)
+{
+    const nlohmann::json body{ { "requests", { { { "id", "a" }, { "method", "GET" }, { "path", "/api/v1/echo" } } } } };
+
+    auto req{ makeRequest("") };
+    req.set("Content-Type", "application/msgpack");
+    req.set("Accept", "application/msgpack");
+    req.body() = utils::PayloadCodec::encode(body, utils::PayloadFormat::MessagePack);
+    req.prepare_payload();
+
+    const auto resp{ batchHandlers_->process(req) };
+    ASSERT_EQ(resp.result(), boost::beast::http::status::ok);
+    EXPECT_EQ(resp[boost::beast::http::field::content_type], "application/msgpack");
+
+    // sub-requests are always executed as JSON
+    const auto decoded{ nlohmann::json::from_msgpack(resp.body()) };
+    EXPECT_EQ(decoded["data"]["responses"][0]["body"]["target"], "/api/v1/echo");
+}
+
+TEST_F(BatchHandlersTest, Process_CborAccept_ErrorResponseIsCbor)
+{
+    auto req{ makeRequest("{invalid") };
+    req.set("Accept", "application/cbor");
+
+    const auto resp{ batchHandlers_->process(req) };
+    ASSERT_EQ(resp.result(), boost::beast::http::status::bad_request);
+    EXPECT_EQ(resp[boost::beast::http::field::content_type], "application/cbor");
+    EXPECT_EQ(nlohmann::json::from_cbor(resp.body())["code"], "INVALID_JSON");
+}
+
+TEST_F(BatchHandlersTest, HandleBatch_UnsupportedContentType_ReturnsBadRequest)
+{
+    auto req{ makeRequest(R"({"requests":[]})") };
+    req.set("Content-Type", "text/plain");
+
+    const auto resp{ batchHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+    EXPECT_EQ(resp[boost::beast::http::field::content_type], "application/json");
+}
+}
+
+#endif // BATCH_HANDLERS_TEST_H
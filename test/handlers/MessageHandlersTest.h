@@ -273,6 +273,228 @@ TEST_F(MessageHandlersTest, HandleMarkAsRead_EmptyMessageIds_ReturnsBadRequest)
     const auto resp{ messageHandlers_->handleRequest(req) };
     EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
 }
+TEST_F(MessageHandlersTest, HandleSendMessageBatch_MissingAccessToken_ReturnsUnauthorized)
+{
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::post);
+    req.target("/api/v1/messages/send_batch");
+
+    const auto resp{ messageHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::unauthorized);
+}
+
+TEST_F(MessageHandlersTest, HandleSendMessageBatch_InvalidContentType_ReturnsBadRequest)
+{
+    const auto token{ jwtManager_->generateAccessToken("user1", "sender") };
+
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::post);
+    req.target("/api/v1/messages/send_batch");
+    req.set("Authorization", std::string("Bearer ") + token);
+    req.body() = R"({"to_logins":["recipient"],"message":"hello"})";
+    req.prepare_payload();
+
+    const auto resp{ messageHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+}
+
+TEST_F(MessageHandlersTest, HandleSendMessageBatch_MissingFields_ReturnsBadRequest)
+{
+    const auto token{ jwtManager_->generateAccessToken("user1", "sender") };
+
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::post);
+    req.target("/api/v1/messages/send_batch");
+    req.set("Authorization", std::string("Bearer ") + token);
+    req.set("Content-Type", "application/json");
+    req.body() = R"({"to_logins":["recipient"]})"; // missing message
+    req.prepare_payload();
+
+    const auto resp{ messageHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+}
+
+TEST_F(MessageHandlersTest, HandleSendMessageBatch_EmptyBatch_ReturnsBadRequest)
+{
+    const auto token{ jwtManager_->generateAccessToken("user1", "sender") };
+
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::post);
+    req.target("/api/v1/messages/send_batch");
+    req.set("Authorization", std::string("Bearer ") + token);
+    req.set("Content-Type", "application/json");
+    req.body() = R"({"messages":[]})";
+    req.prepare_payload();
+
+    const auto resp{ messageHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+}
+
+TEST_F(MessageHandlersTest, HandleSendMessageBatch_TooLarge_ReturnsBadRequest)
+{
+    const auto token{ jwtManager_->generateAccessToken("user1", "sender") };
+
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::post);
+    req.target("/api/v1/messages/send_batch");
+    req.set("Authorization", std::string("Bearer ") + token);
+    req.set("Content-Type", "application/json");
+
+    nlohmann::json j{};
+    j["to_logins"] = std::vector<std::string>(501, "recipient");
+    j["message"] = "hello";
+    req.body() = j.dump();
+    req.prepare_payload();
+
+    const auto resp{ messageHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+}
+
+TEST_F(MessageHandlersTest, HandleSendMessageBatch_InvalidItems_ReturnsPerItemFailures)
+{
+    const auto token{ jwtManager_->generateAccessToken("user1", "sender") };
+
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::post);
+    req.target("/api/v1/messages/send_batch");
+    req.set("Authorization", std::string("Bearer ") + token);
+    req.set("Content-Type", "application/json");
+
+    // every item is rejected before DB access
+    nlohmann::json j{};
+    j["messages"] = nlohmann::json::array({
+        { { "to_login", "recipient" }, { "message", "" } },
+        { { "to_login", "recipient" }, { "message", std::string(5000, 'x') } },
+        { { "to_login", "recipient" } }
+    });
+    req.body() = j.dump();
+    req.prepare_payload();
+
+    const auto resp{ messageHandlers_->handleRequest(req) };
+    ASSERT_EQ(resp.result(), boost::beast::http::status::ok);
+
+    const auto body{ nlohmann::json::parse(resp.body()) };
+    EXPECT_EQ(body["data"]["sent_count"], 0);
+    EXPECT_EQ(body["data"]["failed_count"], 3);
+    EXPECT_EQ(body["data"]["results"][0]["code"], "EMPTY_MESSAGE");
+    EXPECT_EQ(body["data"]["results"][1]["code"], "MESSAGE_TOO_LONG");
+    EXPECT_EQ(body["data"]["results"][2]["code"], "MISSING_FIELDS");
+}
+TEST_F(MessageHandlersTest, HandleGetMessages_MatchingIfNoneMatch_ReturnsNotModified)
+{
+    const auto token{ jwtManager_->generateAccessToken("user1", "sender") };
+
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::get);
+    req.target("/api/v1/messages?limit=10");
+    req.set("Authorization", std::string("Bearer ") + token);
+    req.set(boost::beast::http::field::if_none_match, "*"); // answered before DB access
+
+    const auto resp{ messageHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::not_modified);
+    EXPECT_TRUE(resp.body().empty());
+    EXPECT_FALSE(resp[boost::beast::http::field::etag].empty());
+}
+
+TEST_F(MessageHandlersTest, IsStreamingRequest_OnlyForExportGet)
+{
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::get);
+    req.target("/api/v1/messages/export?conversation_with=bob");
+    EXPECT_TRUE(messageHandlers_->isStreamingRequest(req));
+
+    req.target("/api/v1/messages?limit=10");
+    EXPECT_FALSE(messageHandlers_->isStreamingRequest(req));
+
+    req.method(boost::beast::http::verb::post);
+    req.target("/api/v1/messages/export");
+    EXPECT_FALSE(messageHandlers_->isStreamingRequest(req));
+}
+
+TEST_F(MessageHandlersTest, HandleExport_WithoutStreaming_ReturnsBadRequest)
+{
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::get);
+    req.target("/api/v1/messages/export");
+
+    const auto resp{ messageHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+    EXPECT_EQ(nlohmann::json::parse(resp.body())["code"], "STREAMING_REQUIRED");
+}
+
+TEST_F(MessageHandlersTest, HandleExport_MissingAccessToken_ReturnsUnauthorized)
+{
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::get);
+    req.target("/api/v1/messages/export");
+
+    boost::beast::http::response<boost::beast::http::string_body> resp{};
+    EXPECT_EQ(messageHandlers_->processStream(req, resp), nullptr);
+    EXPECT_EQ(resp.result(), boost::beast::http::status::unauthorized);
+}
+
+TEST_F(MessageHandlersTest, HandleExport_InvalidConversationLogin_ReturnsBadRequest)
+{
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::get);
+    req.target("/api/v1/messages/export?conversation_with=a");
+    req.set("Authorization", "Bearer " + jwtManager_->generateAccessToken("user1", "sender"));
+
+    boost::beast::http::response<boost::beast::http::string_body> resp{};
+    EXPECT_EQ(messageHandlers_->processStream(req, resp), nullptr);
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+}
+
+TEST_F(MessageHandlersTest, HandleExport_ValidToken_ReturnsChunkedNdjsonStream)
+{
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::get);
+    req.target("/api/v1/messages/export");
+    req.set("Authorization", "Bearer " + jwtManager_->generateAccessToken("user1", "sender"));
+
+    // the database is not queried until the first chunk is requested
+    boost::beast::http::response<boost::beast::http::string_body> resp{};
+    EXPECT_NE(messageHandlers_->processStream(req, resp), nullptr);
+    EXPECT_EQ(resp.result(), boost::beast::http::status::ok);
+    EXPECT_TRUE(resp.chunked());
+    EXPECT_EQ(resp[boost::beast::http::field::content_type], "application/x-ndjson");
+}
+
+TEST_F(MessageHandlersTest, HandleSendMessage_InvalidAttachmentId_ReturnsBadRequest)
+{
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::post);
+    req.target("/api/v1/messages/send");
+    req.set("Authorization", "Bearer " + jwtManager_->generateAccessToken("user1", "sender"));
+    req.set(boost::beast::http::field::content_type, "application/json");
+    req.body() = R"({"to_login":"recipient","message":"hello","attachment_ids":["not-a-uuid"]})";
+    req.prepare_payload();
+
+    const auto resp{ messageHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+    EXPECT_EQ(nlohmann::json::parse(resp.body())["code"], "INVALID_ATTACHMENT_ID");
+}
+
+TEST_F(MessageHandlersTest, HandleSendMessage_TooManyAttachments_ReturnsBadRequest)
+{
+    nlohmann::json body{ { "to_login", "recipient" }, { "message", "hello" }, { "attachment_ids", nlohmann::json::array() } };
+    for (auto _ : std::ranges::views::iota(0, 11))
+    {
+        body["attachment_ids"].push_back("5b1d7c4e-2f0a-4f7e-9d3b-8a6c1e2f4b90");
+    }
+
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::post);
+    req.target("/api/v1/messages/send");
+    req.set("Authorization", "Bearer " + jwtManager_->generateAccessToken("user1", "sender"));
+    req.set(boost::beast::http::field::content_type, "application/json");
+    req.body() = body.dump();
+    req.prepare_payload();
+
+    const auto resp{ messageHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::bad_request);
+    EXPECT_EQ(nlohmann::json::parse(resp.body())["code"], "INVALID_ATTACHMENTS");
+}
 }
 
 #endif // MESSAGE_HANDLERS_TEST_H
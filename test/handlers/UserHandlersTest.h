@@ -117,6 +117,35 @@ TEST_F(UserHandlersTest, HandleSearchUsers_MalformedToken_ReturnsUnauthorized)
     const auto resp{ userHandlers_->handleRequest(req) };
     EXPECT_EQ(resp.result(), boost::beast::http::status::unauthorized);
 }
+TEST_F(UserHandlersTest, HandleGetUsers_MatchingIfNoneMatch_ReturnsNotModified)
+{
+    const auto token{ jwtManager_->generateAccessToken("user123", "tester") };
+
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::get);
+    req.target("/api/v1/users?page=1");
+    req.set("Authorization", std::string("Bearer ") + token);
+    req.set(boost::beast::http::field::if_none_match, "*"); // answered before DB access
+
+    const auto resp{ userHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::not_modified);
+    EXPECT_TRUE(resp.body().empty());
+    EXPECT_EQ(std::string{ resp[boost::beast::http::field::etag] }.rfind("W/\"", 0), 0u);
+}
+
+TEST_F(UserHandlersTest, HandleSearchUsers_MatchingIfNoneMatch_ReturnsNotModified)
+{
+    const auto token{ jwtManager_->generateAccessToken("user123", "tester") };
+
+    boost::beast::http::request<boost::beast::http::string_body> req{};
+    req.method(boost::beast::http::verb::get);
+    req.target("/api/v1/users/search?query=test");
+    req.set("Authorization", std::string("Bearer ") + token);
+    req.set(boost::beast::http::field::if_none_match, "W/\"0000000000000000\", *");
+
+    const auto resp{ userHandlers_->handleRequest(req) };
+    EXPECT_EQ(resp.result(), boost::beast::http::status::not_modified);
+}
 }
 
 #endif // USER_HANDLERS_TEST_H
@@ -0,0 +1,117 @@
+#ifndef MESSAGE_PAGE_TEST_H
+#define MESSAGE_PAGE_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "models/MessagePage.h"
+#include <chrono>
+#include <stdexcept>
+
+namespace models
+{
+class MessagePageTest : public ::testing::Test
+{
+protected:
+    MessageFields makeFields(std::string_view messageId, bool isFromAlice) const
+    {
+        MessageFields fields{};
+        fields.messageId = messageId;
+        fields.fromUserId = isFromAlice ? ALICE_ID : BOB_ID;
+        fields.toUserId = isFromAlice ? BOB_ID : ALICE_ID;
+        fields.fromLogin = isFromAlice ? "alice" : "bob";
+        fields.toLogin = isFromAlice ? "bob" : "alice";
+        fields.text = isFromAlice ? "hello bob" : "hi alice";
+        fields.createdAt = 1'735'725'600'123'456; // 2025-01-01 10:00:00.123456 UTC
+        fields.isRead = !isFromAlice;
+        return fields;
+    }
+
+    static constexpr std::string_view ALICE_ID{ "8caf53c4-0507-4c9c-b5e9-095b3188304a" };
+    static constexpr std::string_view BOB_ID{ "ffdb8ebd-be03-49c5-b59e-a2911f6b5af8" };
+    static constexpr std::string_view MESSAGE_ID{ "956f52da-2655-4d09-a5e2-bffa0138ae7c" };
+};
+
+TEST_F(MessagePageTest, Add_ConversationPage_InternsLogins)
+{
+    MessagePage page{};
+    page.reserve(200);
+
+    for (auto i{ 0 }; i < 200; ++i)
+    {
+        page.add(makeFields(MESSAGE_ID, i % 2 == 0));
+    }
+
+    EXPECT_EQ(page.getSize(), 200u);
+    EXPECT_EQ(page.getLoginCount(), 2u);
+
+    EXPECT_EQ(page.getFromLogin(0), "alice");
+    EXPECT_EQ(page.getToLogin(0), "bob");
+    EXPECT_EQ(page.getFromLogin(199), "bob");
+    EXPECT_EQ(&page.getFromLogin(0), &page.getToLogin(1));
+
+    EXPECT_EQ(page.getMessageText(0), "hello bob");
+    EXPECT_EQ(page.getMessageText(199), "hi alice");
+    EXPECT_FALSE(page.getIsRead(0));
+    EXPECT_TRUE(page.getIsRead(199));
+}
+
+TEST_F(MessagePageTest, Getters_RoundTripFields)
+{
+    auto fields{ makeFields("956F52DA-2655-4D09-A5E2-BFFA0138AE7C", true) };
+    fields.attachmentIds = "5b1d7c4e-2f0a-4f7e-9d3b-8a6c1e2f4b90,0a1b2c3d-4e5f-4a6b-8c7d-9e0f1a2b3c4d";
+
+    MessagePage page{};
+    page.add(fields);
+    page.add(makeFields(MESSAGE_ID, false));
+
+    // UUIDs come back in the lowercase form PostgreSQL uses
+    EXPECT_EQ(page.getMessageId(0), MESSAGE_ID);
+    EXPECT_EQ(page.getFromUserId(0), ALICE_ID);
+    EXPECT_EQ(page.getToUserId(0), BOB_ID);
+    EXPECT_EQ(page.getCreatedAtEpoch(0), fields.createdAt);
+    EXPECT_EQ(page.getCreatedAt(0), "2025-01-01 10:00:00.123456+00");
+
+    const std::vector<std::string> attachmentIds{ "5b1d7c4e-2f0a-4f7e-9d3b-8a6c1e2f4b90", "0a1b2c3d-4e5f-4a6b-8c7d-9e0f1a2b3c4d" };
+    EXPECT_EQ(page.getAttachmentIds(0), attachmentIds);
+    EXPECT_TRUE(page.getAttachmentIds(1).empty());
+}
+
+TEST_F(MessagePageTest, Add_InvalidUuid_ThrowsAndKeepsPage)
+{
+    MessagePage page{};
+    page.add(makeFields(MESSAGE_ID, true));
+
+    auto fields{ makeFields(MESSAGE_ID, true) };
+    fields.attachmentIds = "5b1d7c4e-2f0a-4f7e-9d3b-8a6c1e2f4b90,not-a-uuid";
+    EXPECT_THROW(page.add(fields), std::invalid_argument);
+
+    EXPECT_THROW(page.add(makeFields("956f52da-2655-4d09-a5e2_bffa0138ae7c", true)), std::invalid_argument);
+    EXPECT_THROW(page.add(makeFields("956f52da-2655-4d09-a5e2-bffa0138ae7g", true)), std::invalid_argument);
+    EXPECT_THROW(page.add(makeFields("", true)), std::invalid_argument);
+
+    ASSERT_EQ(page.getSize(), 1u);
+    page.add(makeFields(MESSAGE_ID, false));
+    EXPECT_TRUE(page.getAttachmentIds(1).empty());
+}
+
+TEST_F(MessagePageTest, FormatTimestamp_MatchesPostgreSqlIsoStyle)
+{
+    using namespace std::chrono;
+
+    const auto epoch{ [](sys_time<microseconds> time) { return time.time_since_epoch().count(); } };
+    const auto time{ epoch(sys_days{ 2025y / 11 / 27 } + 12h + 39min + 35s + 868799us) };
+
+    EXPECT_EQ(MessagePage::formatTimestamp(time, 3600), "2025-11-27 13:39:35.868799+01");
+    EXPECT_EQ(MessagePage::formatTimestamp(time, 0), "2025-11-27 12:39:35.868799+00");
+    EXPECT_EQ(MessagePage::formatTimestamp(time, -3 * 3600), "2025-11-27 09:39:35.868799-03");
+    EXPECT_EQ(MessagePage::formatTimestamp(time, 5 * 3600 + 30 * 60), "2025-11-27 18:09:35.868799+05:30");
+    EXPECT_EQ(MessagePage::formatTimestamp(time, 12 * 3600), "2025-11-28 00:39:35.868799+12");
+
+    // the fraction loses its trailing zeros, and is left out if it is zero
+    EXPECT_EQ(MessagePage::formatTimestamp(epoch(sys_days{ 2025y / 1 / 1 } + 10h + 500ms), 0), "2025-01-01 10:00:00.5+00");
+    EXPECT_EQ(MessagePage::formatTimestamp(epoch(sys_days{ 2025y / 1 / 1 } + 10h), 0), "2025-01-01 10:00:00+00");
+    EXPECT_EQ(MessagePage::formatTimestamp(epoch(sys_days{ 1969y / 12 / 31 } + 23h + 59min + 59s + 250ms), 0), "1969-12-31 23:59:59.25+00");
+}
+}
+
+#endif // MESSAGE_PAGE_TEST_H
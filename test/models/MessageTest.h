@@ -104,6 +104,15 @@ TEST_F(MessageTest, SetValidMessageText)
     EXPECT_EQ(msg.getMessageText(), validText);
 }
 
+TEST_F(MessageTest, SetMessageTextWithQuotes_StoredTextIsNotEscaped)
+{
+    Message msg{};
+    msg.setMessageText("it's ''quoted''");
+
+    EXPECT_EQ(msg.getMessageText(), "it''s ''''quoted''''");
+    EXPECT_EQ(msg.getStoredMessageText(), "it's ''quoted''");
+}
+
 TEST_F(MessageTest, SetShortMessageText)
 {
     Message msg{};
@@ -124,6 +133,18 @@ TEST_F(MessageTest, SetLongMessageTextThrows)
     EXPECT_THROW(msg.setMessageText(longText), std::invalid_argument);
 }
 
+TEST_F(MessageTest, SetEscapedMessageTextOverLimitThrows)
+{
+    Message msg{};
+
+    // the limit applies to the stored text, where a quote takes three characters and a backslash two
+    EXPECT_THROW(msg.setMessageText(std::string(1400, '"')), std::invalid_argument);
+    EXPECT_THROW(msg.setMessageText(std::string(2049, '\\')), std::invalid_argument);
+
+    EXPECT_NO_THROW(msg.setMessageText(std::string(2048, '\\')));
+    EXPECT_EQ(msg.getStoredMessageText().size(), 4096u);
+}
+
 TEST_F(MessageTest, SetEmptyMessageTextThrows)
 {
     Message msg{};
@@ -634,6 +655,33 @@ TEST_F(MessageTest, TableNameAndPrimaryKey)
     msg.setMessageId("primary-key-test");
     EXPECT_EQ(msg.getPrimaryKeyValue(), "primary-key-test");
 }
+
+TEST_F(MessageTest, AttachmentIds_SerializedOnlyWhenPresent)
+{
+    Message msg(validFromUserId, validToUserId, validText);
+    EXPECT_FALSE(msg.toJson().contains("attachment_ids"));
+
+    msg.setAttachmentIds({ "5b1d7c4e-2f0a-4f7e-9d3b-8a6c1e2f4b90" });
+    const auto json{ msg.toJson() };
+    ASSERT_TRUE(json.contains("attachment_ids"));
+    EXPECT_EQ(json["attachment_ids"].size(), 1u);
+}
+
+TEST_F(MessageTest, FromDatabase_AggregatedAttachmentIds_AreSplit)
+{
+    const nlohmann::json row
+    {
+        {"message_id", "5d6f0f7a-3a3c-4d0e-9a43-9b6f3f1e2a10"},
+        {"from_user_id", validFromUserId},
+        {"to_user_id", validToUserId},
+        {"message_text", validText},
+        {"attachment_ids", "5b1d7c4e-2f0a-4f7e-9d3b-8a6c1e2f4b90,0c3a9f1e-7b2d-4e8a-9f6c-1d2e3f4a5b6c"}
+    };
+
+    const auto msg{ Message::fromDatabase(row) };
+    ASSERT_EQ(msg.getAttachmentIds().size(), 2u);
+    EXPECT_EQ(msg.getAttachmentIds()[1], "0c3a9f1e-7b2d-4e8a-9f6c-1d2e3f4a5b6c");
+}
 }
 
 #endif // MESSAGE_MODEL_TEST_H
@@ -0,0 +1,99 @@
+#ifndef CONNECTION_LIMITER_TEST_H
+#define CONNECTION_LIMITER_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "server/ConnectionLimiter.h"
+
+#include <vector>
+
+namespace server
+{
+TEST(ConnectionLimiterTest, TryAcquire_MaxConnectionsReached_RejectsUntilReleased)
+{
+    ConnectionLimits limits{};
+    limits.maxConnections = 2;
+    const auto limiter{ std::make_shared<ConnectionLimiter>(limits) };
+
+    auto first{ limiter->tryAcquire("10.0.0.1") };
+    auto second{ limiter->tryAcquire("10.0.0.2") };
+    EXPECT_TRUE(first.isGranted());
+    EXPECT_TRUE(second.isGranted());
+    EXPECT_FALSE(limiter->tryAcquire("10.0.0.3").isGranted());
+    EXPECT_EQ(limiter->getAcceptDelay(), ConnectionLimiter::CAPACITY_RETRY_INTERVAL);
+
+    first = ConnectionPermit{};
+    EXPECT_EQ(limiter->getAcceptDelay(), std::chrono::steady_clock::duration::zero());
+    EXPECT_TRUE(limiter->tryAcquire("10.0.0.3").isGranted());
+
+    const auto statistics{ limiter->getStatistics() };
+    EXPECT_EQ(statistics.activeConnections, 1);
+    EXPECT_EQ(statistics.peakConnections, 2);
+    EXPECT_EQ(statistics.acceptedConnections, 3);
+    EXPECT_EQ(statistics.rejectedConnections, 1);
+    EXPECT_EQ(statistics.delayedAccepts, 1);
+}
+
+TEST(ConnectionLimiterTest, TryAcquire_PerAddressLimitReached_RejectsOnlyThatAddress)
+{
+    ConnectionLimits limits{};
+    limits.maxConnectionsPerAddress = 2;
+    const auto limiter{ std::make_shared<ConnectionLimiter>(limits) };
+
+    std::vector<ConnectionPermit> permits{};
+    permits.push_back(limiter->tryAcquire("10.0.0.1"));
+    permits.push_back(limiter->tryAcquire("10.0.0.1"));
+    EXPECT_TRUE(permits[0].isGranted());
+    EXPECT_TRUE(permits[1].isGranted());
+
+    EXPECT_FALSE(limiter->tryAcquire("10.0.0.1").isGranted());
+    EXPECT_TRUE(limiter->tryAcquire("10.0.0.2").isGranted());
+
+    // connections without an address are not counted per address
+    EXPECT_TRUE(limiter->tryAcquire("").isGranted());
+
+    permits.pop_back();
+    EXPECT_TRUE(limiter->tryAcquire("10.0.0.1").isGranted());
+}
+
+TEST(ConnectionLimiterTest, GetAcceptDelay_RateExceeded_WaitsForNextToken)
+{
+    ConnectionLimits limits{};
+    limits.acceptRate = 10;
+    limits.acceptBurst = 2;
+    const auto limiter{ std::make_shared<ConnectionLimiter>(limits) };
+
+    EXPECT_EQ(limiter->getAcceptDelay(), std::chrono::steady_clock::duration::zero());
+    const auto first{ limiter->tryAcquire("10.0.0.1") };
+    const auto second{ limiter->tryAcquire("10.0.0.2") };
+
+    // one token is earned every 100 ms
+    const auto delay{ limiter->getAcceptDelay() };
+    EXPECT_GT(delay, std::chrono::steady_clock::duration::zero());
+    EXPECT_LE(delay, std::chrono::milliseconds{ 100 });
+
+    // the rate only delays accepting, admitted connections are not rejected for it
+    EXPECT_TRUE(limiter->tryAcquire("10.0.0.3").isGranted());
+    EXPECT_GT(limiter->getAcceptDelay(), std::chrono::milliseconds{ 100 });
+    EXPECT_EQ(limiter->getStatistics().delayedAccepts, 2);
+}
+
+TEST(ConnectionLimiterTest, Permit_MovedAndReleased_CountsConnectionOnce)
+{
+    const auto limiter{ std::make_shared<ConnectionLimiter>(ConnectionLimits{}) };
+
+    auto permit{ limiter->tryAcquire("10.0.0.1") };
+    auto moved{ std::move(permit) };
+    EXPECT_TRUE(moved.isGranted());
+    EXPECT_EQ(limiter->getStatistics().activeConnections, 1);
+
+    moved = limiter->tryAcquire("10.0.0.2");
+    EXPECT_EQ(limiter->getStatistics().activeConnections, 1);
+
+    moved = ConnectionPermit{};
+    EXPECT_EQ(limiter->getStatistics().activeConnections, 0);
+    EXPECT_EQ(limiter->getStatistics().acceptedConnections, 2);
+}
+}
+
+#endif // CONNECTION_LIMITER_TEST_H
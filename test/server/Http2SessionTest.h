@@ -0,0 +1,487 @@
+#ifndef HTTP2_SESSION_TEST_H
+#define HTTP2_SESSION_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "server/Http2Session.h"
+#include "server/Session.h"
+#include "server/RouterTest.h"
+#include "server/TlsSessionManagerTest.h"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace server
+{
+// blocks the first request until a second one arrives, which only works if both are handled at once
+class RendezvousHandler : public handlers::IHandler
+{
+public:
+    ~RendezvousHandler() noexcept override = default;
+
+    boost::beast::http::response<boost::beast::http::string_body> handleRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) noexcept override
+    {
+        std::unique_lock lock{ mutex_ };
+        ++arrived_;
+        condition_.notify_all();
+
+        const auto isMet{ condition_.wait_for(lock, std::chrono::seconds(5), [this]() { return arrived_ >= 2; }) };
+
+        boost::beast::http::response<boost::beast::http::string_body> response{ boost::beast::http::status::ok, request.version() };
+        response.set(boost::beast::http::field::content_type, "text/plain");
+        response.body() = isMet ? "met" : "alone";
+        response.prepare_payload();
+        return response;
+    }
+
+    std::vector<boost::beast::http::verb> getSupportedMethods() const noexcept override { return { boost::beast::http::verb::get }; }
+
+protected:
+    bool isAuthTokenValid(const std::string&, std::string&) const noexcept override { return true; }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    int arrived_{ 0 };
+};
+
+// streams a body of several chunks and records the threads that produce them
+class ChunkedHandler : public MockHandler
+{
+public:
+    static constexpr int CHUNK_COUNT{ 4 };
+    static constexpr size_t CHUNK_SIZE{ 40000 };
+
+    class ChunkStream : public handlers::IResponseStream
+    {
+    public:
+        explicit ChunkStream(ChunkedHandler& handler) :
+            handler_{ handler }
+        {
+        }
+
+        bool readNextChunk(std::string& chunk) override
+        {
+            if (count_ == CHUNK_COUNT)
+            {
+                return false;
+            }
+
+            std::lock_guard lock{ handler_.mutex_ };
+            handler_.producers_.push_back(std::this_thread::get_id());
+            handler_.isDeadlineCurrent_ = handler_.isDeadlineCurrent_ && utils::DeadlineScope::getCurrent() != nullptr;
+
+            chunk.assign(CHUNK_SIZE, static_cast<char>('a' + count_++));
+            return true;
+        }
+
+    private:
+        ChunkedHandler& handler_;
+        int count_{ 0 };
+    };
+
+    bool isStreamingRequest(const boost::beast::http::request<boost::beast::http::string_body>&) const noexcept override { return true; }
+
+    std::shared_ptr<handlers::IResponseStream> handleStreamRequest(const boost::beast::http::request<boost::beast::http::string_body>& request,
+        boost::beast::http::response<boost::beast::http::string_body>& response) noexcept override
+    {
+        response = boost::beast::http::response<boost::beast::http::string_body>{ boost::beast::http::status::ok, request.version() };
+        response.set(boost::beast::http::field::content_type, "text/plain");
+        return std::make_shared<ChunkStream>(*this);
+    }
+
+    std::vector<std::thread::id> getProducers()
+    {
+        std::lock_guard lock{ mutex_ };
+        return producers_;
+    }
+
+    bool isDeadlineCurrent()
+    {
+        std::lock_guard lock{ mutex_ };
+        return isDeadlineCurrent_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::thread::id> producers_;
+    bool isDeadlineCurrent_{ true };
+};
+
+// waits until its request is cancelled and records the thread that ran the cancel handler
+class CancellableHandler : public MockHandler
+{
+public:
+    boost::beast::http::response<boost::beast::http::string_body> handleRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) noexcept override
+    {
+        const auto registration{ utils::DeadlineScope::getCurrent()->onCancel([this]()
+        {
+            std::lock_guard lock{ mutex_ };
+            canceller_ = std::this_thread::get_id();
+            isCancelled_ = true;
+            condition_.notify_all();
+        }) };
+
+        std::unique_lock lock{ mutex_ };
+        isStarted_ = true;
+        condition_.notify_all();
+        condition_.wait_for(lock, std::chrono::seconds(5), [this]() { return isCancelled_; });
+
+        return MockHandler::handleRequest(request);
+    }
+
+    bool waitUntilStarted()
+    {
+        std::unique_lock lock{ mutex_ };
+        return condition_.wait_for(lock, std::chrono::seconds(5), [this]() { return isStarted_; });
+    }
+
+    std::optional<std::thread::id> waitForCanceller()
+    {
+        std::unique_lock lock{ mutex_ };
+        if (!condition_.wait_for(lock, std::chrono::seconds(5), [this]() { return isCancelled_; }))
+        {
+            return std::nullopt;
+        }
+
+        return canceller_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool isStarted_{ false };
+    bool isCancelled_{ false };
+    std::thread::id canceller_;
+};
+
+// minimal blocking HTTP/2 client on top of nghttp2
+class Http2TestClient
+{
+public:
+    struct Response
+    {
+        int status{ 0 };
+        std::map<std::string, std::string> headers;
+        std::string body;
+        uint32_t errorCode{ 0 };
+        bool isClosed{ false };
+    };
+
+    explicit Http2TestClient(boost::asio::ssl::stream<boost::asio::ip::tcp::socket>& stream) :
+        stream_{ stream }
+    {
+        nghttp2_session_callbacks* callbacks{ nullptr };
+        nghttp2_session_callbacks_new(&callbacks);
+
+        nghttp2_session_callbacks_set_on_header_callback(callbacks, [](nghttp2_session*, const nghttp2_frame* frame, const uint8_t* name, size_t nameLength,
+            const uint8_t* value, size_t valueLength, uint8_t, void* userData)
+        {
+            auto& response{ static_cast<Http2TestClient*>(userData)->responses_[frame->hd.stream_id] };
+            const std::string fieldName{ reinterpret_cast<const char*>(name), nameLength };
+            const std::string fieldValue{ reinterpret_cast<const char*>(value), valueLength };
+
+            if (fieldName == ":status")
+            {
+                response.status = std::stoi(fieldValue);
+            }
+            else
+            {
+                response.headers[fieldName] = fieldValue;
+            }
+
+            return 0;
+        });
+
+        nghttp2_session_callbacks_set_on_data_chunk_recv_callback(callbacks, [](nghttp2_session*, uint8_t, int32_t streamId, const uint8_t* data, size_t length, void* userData)
+        {
+            static_cast<Http2TestClient*>(userData)->responses_[streamId].body.append(reinterpret_cast<const char*>(data), length);
+            return 0;
+        });
+
+        nghttp2_session_callbacks_set_on_stream_close_callback(callbacks, [](nghttp2_session*, int32_t streamId, uint32_t errorCode, void* userData)
+        {
+            auto& response{ static_cast<Http2TestClient*>(userData)->responses_[streamId] };
+            response.errorCode = errorCode;
+            response.isClosed = true;
+            return 0;
+        });
+
+        nghttp2_session_client_new(&session_, callbacks, this);
+        nghttp2_session_callbacks_del(callbacks);
+
+        nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE, nullptr, 0);
+    }
+
+    ~Http2TestClient()
+    {
+        nghttp2_session_del(session_);
+    }
+
+    int32_t submit(const std::string& method, const std::string& path, const std::string& body = {})
+    {
+        std::vector<std::pair<std::string, std::string>> fields{ { ":method", method }, { ":scheme", "https" }, { ":authority", "localhost" }, { ":path", path } };
+
+        std::vector<nghttp2_nv> headers{};
+        for (auto& [name, value] : fields)
+        {
+            headers.push_back({ reinterpret_cast<uint8_t*>(name.data()), reinterpret_cast<uint8_t*>(value.data()), name.size(), value.size(), NGHTTP2_NV_FLAG_NONE });
+        }
+
+        bodies_.push_back(std::make_unique<std::pair<std::string, size_t>>(body, 0));
+
+        nghttp2_data_provider provider{};
+        provider.source.ptr = bodies_.back().get();
+        provider.read_callback = [](nghttp2_session*, int32_t, uint8_t* buffer, size_t length, uint32_t* dataFlags, nghttp2_data_source* source, void*) -> ssize_t
+        {
+            auto& [data, offset] { *static_cast<std::pair<std::string, size_t>*>(source->ptr) };
+            const auto size{ std::min(length, data.size() - offset) };
+            std::memcpy(buffer, data.data() + offset, size);
+            offset += size;
+
+            if (offset == data.size())
+            {
+                *dataFlags |= NGHTTP2_DATA_FLAG_EOF;
+            }
+
+            return static_cast<ssize_t>(size);
+        };
+
+        const auto streamId{ nghttp2_submit_request(session_, nullptr, headers.data(), headers.size(), body.empty() ? nullptr : &provider, nullptr) };
+        responses_[streamId] = {};
+        return streamId;
+    }
+
+    void reset(int32_t streamId)
+    {
+        nghttp2_submit_rst_stream(session_, NGHTTP2_FLAG_NONE, streamId, NGHTTP2_CANCEL);
+    }
+
+    // sends the frames submitted so far
+    void flush()
+    {
+        const uint8_t* data{ nullptr };
+        for (auto size{ nghttp2_session_mem_send(session_, &data) }; size > 0; size = nghttp2_session_mem_send(session_, &data))
+        {
+            boost::asio::write(stream_, boost::asio::buffer(data, static_cast<size_t>(size)));
+        }
+    }
+
+    // exchanges frames until every submitted stream is closed
+    void run()
+    {
+        std::array<uint8_t, 16384> buffer{};
+
+        while (true)
+        {
+            flush();
+
+            if (std::ranges::all_of(responses_, [](const auto& response) { return response.second.isClosed; }))
+            {
+                return;
+            }
+
+            const auto size{ stream_.read_some(boost::asio::buffer(buffer)) };
+            ASSERT_GE(nghttp2_session_mem_recv(session_, buffer.data(), size), 0);
+        }
+    }
+
+    const Response& getResponse(int32_t streamId)
+    {
+        return responses_[streamId];
+    }
+
+private:
+    boost::asio::ssl::stream<boost::asio::ip::tcp::socket>& stream_;
+    nghttp2_session* session_{ nullptr };
+    std::map<int32_t, Response> responses_;
+    std::vector<std::unique_ptr<std::pair<std::string, size_t>>> bodies_;
+};
+
+class Http2SessionTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        TlsSessionManagerTest::useSelfSignedCertificate(serverContext_->native_handle());
+        tlsSessionManager_ = std::make_unique<TlsSessionManager>(serverContext_, TlsSettings{});
+
+        router_->registerHandler("/api/test", std::make_shared<MockHandler>());
+        router_->registerHandler("/api/rendezvous", std::make_shared<RendezvousHandler>());
+        router_->registerHandler("/api/chunked", chunkedHandler_);
+        router_->registerHandler("/api/cancellable", cancellableHandler_);
+
+        auto settings{ std::make_shared<SessionSettings>() };
+        settings->maxRequestBodySize = 1024;
+        settings_ = settings;
+    }
+
+    // connects a client that offers the given ALPN protocols (wire format) and starts the server session
+    void connect(std::string_view alpnProtocols)
+    {
+        if (!alpnProtocols.empty())
+        {
+            SSL_set_alpn_protos(client_.native_handle(), reinterpret_cast<const unsigned char*>(alpnProtocols.data()), static_cast<unsigned int>(alpnProtocols.size()));
+        }
+
+        boost::asio::ip::tcp::acceptor acceptor{ ioc_, { boost::asio::ip::make_address("127.0.0.1"), 0 } };
+        client_.next_layer().connect(acceptor.local_endpoint());
+
+        std::make_shared<Session>(acceptor.accept(boost::asio::make_strand(ioc_)), serverContext_.get(), router_, settings_, std::make_shared<TimerWheel>(ioc_.get_executor()),
+            handlerPool_.get_executor(), ConnectionPermit{})->start();
+
+        threads_.emplace_back([this]() { ioc_.run(); });
+
+        client_.handshake(boost::asio::ssl::stream_base::client);
+    }
+
+    void TearDown() override
+    {
+        boost::system::error_code ec{};
+        client_.next_layer().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+        client_.next_layer().close(ec);
+
+        for (auto& thread : threads_)
+        {
+            thread.join();
+        }
+
+        handlerPool_.join();
+    }
+
+    [[nodiscard]] std::string_view getClientAlpnProtocol()
+    {
+        const unsigned char* protocol{ nullptr };
+        unsigned int length{ 0 };
+        SSL_get0_alpn_selected(client_.native_handle(), &protocol, &length);
+        return { reinterpret_cast<const char*>(protocol), length };
+    }
+
+    boost::asio::io_context ioc_;
+    std::shared_ptr<boost::asio::ssl::context> serverContext_{ std::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tls_server) };
+    std::unique_ptr<TlsSessionManager> tlsSessionManager_;
+    std::shared_ptr<Router> router_{ std::make_shared<Router>() };
+    std::shared_ptr<const SessionSettings> settings_;
+    std::shared_ptr<ChunkedHandler> chunkedHandler_{ std::make_shared<ChunkedHandler>() };
+    std::shared_ptr<CancellableHandler> cancellableHandler_{ std::make_shared<CancellableHandler>() };
+    std::vector<std::thread> threads_;
+    boost::asio::thread_pool handlerPool_{ 2 }; // two threads, so that handlers of different streams can run at the same time
+
+    boost::asio::ssl::context clientContext_{ boost::asio::ssl::context::tls_client };
+    boost::asio::ssl::stream<boost::asio::ip::tcp::socket> client_{ ioc_, clientContext_ };
+};
+
+TEST_F(Http2SessionTest, Alpn_H2Offered_MultiplexesRequests)
+{
+    connect(std::string_view{ "\x02h2\x08http/1.1", 12 });
+    ASSERT_EQ(getClientAlpnProtocol(), "h2");
+
+    Http2TestClient client{ client_ };
+    const auto first{ client.submit("GET", "/api/test") };
+    const auto second{ client.submit("GET", "/api/test") };
+    const auto missing{ client.submit("GET", "/api/missing") };
+    client.run();
+
+    for (const auto streamId : { first, second })
+    {
+        EXPECT_EQ(client.getResponse(streamId).status, 200);
+        EXPECT_EQ(client.getResponse(streamId).body, R"({"status": "ok"})");
+        EXPECT_EQ(client.getResponse(streamId).headers.at("content-type"), "application/json");
+        EXPECT_EQ(client.getResponse(streamId).headers.count("connection"), 0u);
+    }
+
+    EXPECT_EQ(client.getResponse(missing).status, 404);
+}
+
+TEST_F(Http2SessionTest, Streams_AreHandledConcurrently)
+{
+    connect(std::string_view{ "\x02h2", 3 });
+
+    Http2TestClient client{ client_ };
+    const auto first{ client.submit("GET", "/api/rendezvous") };
+    const auto second{ client.submit("GET", "/api/rendezvous") };
+    client.run();
+
+    EXPECT_EQ(client.getResponse(first).body, "met");
+    EXPECT_EQ(client.getResponse(second).body, "met");
+}
+
+TEST_F(Http2SessionTest, StreamingResponse_ChunksAreProducedOnHandlerThreads)
+{
+    connect(std::string_view{ "\x02h2", 3 });
+
+    Http2TestClient client{ client_ };
+    const auto streamId{ client.submit("GET", "/api/chunked") };
+    client.run();
+
+    std::string expected{};
+    for (auto i{ 0 }; i < ChunkedHandler::CHUNK_COUNT; ++i)
+    {
+        expected.append(ChunkedHandler::CHUNK_SIZE, static_cast<char>('a' + i));
+    }
+
+    EXPECT_EQ(client.getResponse(streamId).status, 200);
+    EXPECT_EQ(client.getResponse(streamId).errorCode, NGHTTP2_NO_ERROR);
+    EXPECT_EQ(client.getResponse(streamId).body, expected);
+
+    // none on the I/O thread, which would stall every stream of the connection while a chunk is produced
+    const auto producers{ chunkedHandler_->getProducers() };
+    ASSERT_EQ(producers.size(), static_cast<size_t>(ChunkedHandler::CHUNK_COUNT));
+    EXPECT_TRUE(std::ranges::none_of(producers, [this](const auto id) { return id == threads_.front().get_id(); }));
+    EXPECT_TRUE(chunkedHandler_->isDeadlineCurrent());
+}
+
+TEST_F(Http2SessionTest, StreamReset_CancelsRequestOffTheIoThread)
+{
+    connect(std::string_view{ "\x02h2", 3 });
+
+    Http2TestClient client{ client_ };
+    const auto streamId{ client.submit("GET", "/api/cancellable") };
+    client.flush();
+    ASSERT_TRUE(cancellableHandler_->waitUntilStarted());
+
+    client.reset(streamId);
+    client.run();
+
+    // a cancel handler that blocks, like the one of a database query, must not stall the connection
+    const auto canceller{ cancellableHandler_->waitForCanceller() };
+    ASSERT_TRUE(canceller.has_value());
+    EXPECT_NE(*canceller, threads_.front().get_id());
+}
+
+TEST_F(Http2SessionTest, RequestBody_OverLimit_IsRejected)
+{
+    connect(std::string_view{ "\x02h2", 3 });
+
+    Http2TestClient client{ client_ };
+    const auto streamId{ client.submit("POST", "/api/test", std::string(4096, 'x')) };
+    client.run();
+
+    EXPECT_EQ(client.getResponse(streamId).status, 413);
+    EXPECT_NE(client.getResponse(streamId).body.find("PAYLOAD_TOO_LARGE"), std::string::npos);
+}
+
+TEST_F(Http2SessionTest, Alpn_NotOffered_FallsBackToHttp11)
+{
+    connect({});
+    EXPECT_TRUE(getClientAlpnProtocol().empty());
+
+    boost::beast::http::request<boost::beast::http::string_body> request{ boost::beast::http::verb::get, "/api/test", 11 };
+    request.set(boost::beast::http::field::host, "localhost");
+    request.keep_alive(false);
+    boost::beast::http::write(client_, request);
+
+    boost::beast::flat_buffer buffer{};
+    boost::beast::http::response<boost::beast::http::string_body> response{};
+    boost::beast::http::read(client_, buffer, response);
+
+    EXPECT_EQ(response.result(), boost::beast::http::status::ok);
+    EXPECT_EQ(response.version(), 11);
+    EXPECT_EQ(response.body(), R"({"status": "ok"})");
+}
+}
+
+#endif // HTTP2_SESSION_TEST_H
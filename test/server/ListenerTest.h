@@ -0,0 +1,151 @@
+#ifndef LISTENER_TEST_H
+#define LISTENER_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "server/Listener.h"
+#include "server/RouterTest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+namespace server
+{
+class ListenerUnixSocketTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        router_->registerHandler("/api/test", std::make_shared<MockHandler>());
+        std::filesystem::remove(socketPath_);
+
+        // plaintext TCP on an ephemeral port, next to the Unix domain socket
+        listener_ = std::make_shared<Listener>(ioc_, nullptr, std::make_unique<boost::asio::ip::tcp::endpoint>(boost::asio::ip::make_address("127.0.0.1"), 0),
+            router_, std::make_shared<SessionSettings>(), socketPath_, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+    }
+
+    void TearDown() override
+    {
+        listener_->stop();
+        ioc_->stop();
+
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+
+        std::filesystem::remove(socketPath_);
+    }
+
+    void run()
+    {
+        thread_ = std::thread{ [this]() { ioc_->run(); } };
+    }
+
+    const std::filesystem::path socketPath_{ std::filesystem::temp_directory_path() / "nova_chat_listener_test.sock" };
+    std::shared_ptr<boost::asio::io_context> ioc_{ std::make_shared<boost::asio::io_context>() };
+    std::shared_ptr<Router> router_{ std::make_shared<Router>() };
+    std::shared_ptr<Listener> listener_;
+    std::thread thread_;
+};
+
+TEST_F(ListenerUnixSocketTest, Start_CreatesSocketFileWithPermissions)
+{
+    listener_->start();
+
+    const auto status{ std::filesystem::status(socketPath_) };
+    ASSERT_TRUE(std::filesystem::is_socket(status));
+    EXPECT_EQ(status.permissions(), std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+
+    listener_->stop();
+    EXPECT_FALSE(std::filesystem::exists(socketPath_));
+}
+
+TEST_F(ListenerUnixSocketTest, Request_OverUnixSocket_IsServed)
+{
+    listener_->start();
+    run();
+
+    boost::asio::io_context clientIoc{};
+    boost::asio::local::stream_protocol::socket client{ clientIoc };
+    client.connect(boost::asio::local::stream_protocol::endpoint{ socketPath_.string() });
+
+    boost::beast::http::request<boost::beast::http::string_body> request{ boost::beast::http::verb::get, "/api/test", 11 };
+    request.set(boost::beast::http::field::host, "localhost");
+    request.keep_alive(false);
+    boost::beast::http::write(client, request);
+
+    boost::beast::flat_buffer buffer{};
+    boost::beast::http::response<boost::beast::http::string_body> response{};
+    boost::beast::http::read(client, buffer, response);
+
+    EXPECT_EQ(response.result(), boost::beast::http::status::ok);
+    EXPECT_EQ(response.body(), R"({"status": "ok"})");
+}
+
+TEST_F(ListenerUnixSocketTest, ConnectionLimitReached_FurtherConnectionsWaitInBacklog)
+{
+    ConnectionLimits limits{};
+    limits.maxConnections = 1;
+    listener_ = std::make_shared<Listener>(ioc_, nullptr, std::make_unique<boost::asio::ip::tcp::endpoint>(boost::asio::ip::make_address("127.0.0.1"), 0),
+        router_, std::make_shared<SessionSettings>(), socketPath_, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write, limits);
+    listener_->start();
+    run();
+
+    boost::asio::io_context clientIoc{};
+    boost::asio::local::stream_protocol::socket admitted{ clientIoc };
+    admitted.connect(boost::asio::local::stream_protocol::endpoint{ socketPath_.string() });
+
+    // connects to the listen backlog, accepting is paused while the admitted connection is open
+    boost::asio::local::stream_protocol::socket waiting{ clientIoc };
+    waiting.connect(boost::asio::local::stream_protocol::endpoint{ socketPath_.string() });
+
+    boost::beast::http::request<boost::beast::http::string_body> request{ boost::beast::http::verb::get, "/api/test", 11 };
+    request.set(boost::beast::http::field::host, "localhost");
+    request.keep_alive(false);
+
+    for (auto* socket : { &admitted, &waiting })
+    {
+        // the waiting connection is served once the admitted one is closed
+        boost::beast::http::write(*socket, request);
+
+        boost::beast::flat_buffer buffer{};
+        boost::beast::http::response<boost::beast::http::string_body> response{};
+        boost::beast::http::read(*socket, buffer, response);
+        EXPECT_EQ(response.result(), boost::beast::http::status::ok);
+
+        // the session releases its permit when it sees the close
+        socket->close();
+    }
+
+    const auto statistics{ listener_->getConnectionStatistics() };
+    EXPECT_EQ(statistics.acceptedConnections, 2);
+    EXPECT_EQ(statistics.rejectedConnections, 0);
+    EXPECT_GE(statistics.delayedAccepts, 1);
+}
+
+TEST_F(ListenerUnixSocketTest, Start_StaleSocketFile_IsReplaced)
+{
+    {
+        // a socket file left behind by a server that did not stop cleanly
+        boost::asio::io_context ioc{};
+        boost::asio::local::stream_protocol::acceptor stale{ ioc, boost::asio::local::stream_protocol::endpoint{ socketPath_.string() } };
+    }
+
+    ASSERT_TRUE(std::filesystem::is_socket(socketPath_));
+    EXPECT_NO_THROW(listener_->start());
+}
+
+TEST_F(ListenerUnixSocketTest, Start_PathTakenByRegularFile_Throws)
+{
+    std::ofstream{ socketPath_ } << "not a socket";
+
+    EXPECT_THROW(listener_->start(), std::runtime_error);
+    EXPECT_TRUE(std::filesystem::is_regular_file(socketPath_));
+}
+}
+#endif
+
+#endif // LISTENER_TEST_H
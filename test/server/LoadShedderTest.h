@@ -0,0 +1,116 @@
+#ifndef LOAD_SHEDDER_TEST_H
+#define LOAD_SHEDDER_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "server/LoadShedder.h"
+
+namespace server
+{
+class LoadShedderTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        settings_.maxQueueDepth = 10;
+        settings_.lowPriorityRoutes = { "/api/v1/users" };
+        settings_.lowPriorityShare = 0.5;
+    }
+
+    static boost::beast::http::request<boost::beast::http::string_body> createRequest(const std::string& target)
+    {
+        return boost::beast::http::request<boost::beast::http::string_body>{ boost::beast::http::verb::get, target, 11 };
+    }
+
+    LoadShedder::LoadProbe createProbe()
+    {
+        return [this]() { return load_; };
+    }
+
+    LoadShedSettings settings_;
+    const utils::Deadline deadline_{ std::chrono::milliseconds{ 1000 } };
+    LoadSample load_;
+    std::chrono::seconds retryAfter_{};
+};
+
+TEST_F(LoadShedderTest, TryAdmit_IdlePool_AdmitsAll)
+{
+    LoadShedder shedder{ settings_, createProbe() };
+
+    EXPECT_TRUE(shedder.tryAdmit(createRequest("/api/v1/messages/send"), deadline_, retryAfter_));
+    EXPECT_TRUE(shedder.tryAdmit(createRequest("/api/v1/users/search?q=ab"), deadline_, retryAfter_));
+    EXPECT_EQ(shedder.getShedCount(), 0);
+}
+
+TEST_F(LoadShedderTest, TryAdmit_ExpectedWaitExceedsTimeout_ShedsWithRetryAfter)
+{
+    LoadShedder shedder{ settings_, createProbe() };
+    load_.expectedWait = std::chrono::milliseconds{ 2500 };
+
+    EXPECT_FALSE(shedder.tryAdmit(createRequest("/api/v1/messages/send"), deadline_, retryAfter_));
+    EXPECT_EQ(retryAfter_, std::chrono::seconds{ 3 });
+    EXPECT_EQ(shedder.getShedCount(), 1);
+}
+
+TEST_F(LoadShedderTest, TryAdmit_LessTimeLeft_ShedsEarlier)
+{
+    LoadShedder shedder{ settings_, createProbe() };
+    load_.expectedWait = std::chrono::milliseconds{ 600 };
+
+    EXPECT_TRUE(shedder.tryAdmit(createRequest("/api/v1/messages/send"), deadline_, retryAfter_));
+    EXPECT_FALSE(shedder.tryAdmit(createRequest("/api/v1/messages/send"), utils::Deadline{ std::chrono::milliseconds{ 500 } }, retryAfter_));
+
+    // the minimum hint is one second
+    EXPECT_EQ(retryAfter_, std::chrono::seconds{ 1 });
+}
+
+TEST_F(LoadShedderTest, TryAdmit_NoTimeLimit_ChecksQueueDepthOnly)
+{
+    LoadShedder shedder{ settings_, createProbe() };
+    load_.expectedWait = std::chrono::milliseconds{ 60000 };
+
+    EXPECT_TRUE(shedder.tryAdmit(createRequest("/api/v1/messages/send"), utils::Deadline{}, retryAfter_));
+
+    load_.queueDepth = 10;
+    EXPECT_FALSE(shedder.tryAdmit(createRequest("/api/v1/messages/send"), utils::Deadline{}, retryAfter_));
+}
+
+TEST_F(LoadShedderTest, TryAdmit_LowPriorityRoutes_ShedFirst)
+{
+    LoadShedder shedder{ settings_, createProbe() };
+
+    load_.expectedWait = std::chrono::milliseconds{ 700 };
+    EXPECT_TRUE(shedder.tryAdmit(createRequest("/api/v1/messages/send"), deadline_, retryAfter_));
+    EXPECT_FALSE(shedder.tryAdmit(createRequest("/api/v1/users/search"), deadline_, retryAfter_));
+    EXPECT_FALSE(shedder.tryAdmit(createRequest("/api/v1/users/"), deadline_, retryAfter_));
+
+    // routes that only share the prefix are not low priority
+    EXPECT_TRUE(shedder.tryAdmit(createRequest("/api/v1/usersettings"), deadline_, retryAfter_));
+
+    load_.expectedWait = std::chrono::milliseconds::zero();
+    load_.queueDepth = 5;
+    EXPECT_TRUE(shedder.tryAdmit(createRequest("/api/v1/messages/send"), deadline_, retryAfter_));
+    EXPECT_FALSE(shedder.tryAdmit(createRequest("/api/v1/users"), deadline_, retryAfter_));
+}
+
+TEST_F(LoadShedderTest, TryAdmit_QueueDepth_ShedsAtThreshold)
+{
+    {
+        LoadShedder shedder{ settings_, createProbe() };
+
+        load_.queueDepth = 9;
+        EXPECT_TRUE(shedder.tryAdmit(createRequest("/api/v1/messages/send"), deadline_, retryAfter_));
+
+        load_.queueDepth = 10;
+        EXPECT_FALSE(shedder.tryAdmit(createRequest("/api/v1/messages/send"), deadline_, retryAfter_));
+    }
+
+    // a depth of 0 sheds by expected wait only
+    settings_.maxQueueDepth = 0;
+    LoadShedder shedder{ settings_, createProbe() };
+    load_.queueDepth = 1000;
+    EXPECT_TRUE(shedder.tryAdmit(createRequest("/api/v1/messages/send"), deadline_, retryAfter_));
+}
+}
+
+#endif // LOAD_SHEDDER_TEST_H
@@ -0,0 +1,115 @@
+#ifndef RATE_LIMITER_TEST_H
+#define RATE_LIMITER_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "server/RateLimiter.h"
+
+#include <thread>
+
+namespace server
+{
+class RateLimiterTest : public ::testing::Test
+{
+protected:
+    static boost::beast::http::request<boost::beast::http::string_body> createRequest(const std::string& target, const std::string& token = "")
+    {
+        boost::beast::http::request<boost::beast::http::string_body> request{ boost::beast::http::verb::post, target, 11 };
+        if (!token.empty())
+        {
+            request.set(boost::beast::http::field::authorization, "Bearer " + token);
+        }
+
+        return request;
+    }
+
+    static RateLimiter::UserResolver createResolver()
+    {
+        // tokens of the form "valid-<user>" belong to <user>
+        return [](const std::string& token) { return token.starts_with("valid-") ? token.substr(6) : std::string{}; };
+    }
+
+    std::chrono::seconds retryAfter_{};
+};
+
+TEST_F(RateLimiterTest, TryAcquire_UnlistedRoute_IsNotLimited)
+{
+    RateLimiter limiter{ RateLimitSettings{ { RateLimitRule{ "/api/v1/messages/send", 0.0, 1, 1.0, 1 } } }, createResolver() };
+
+    for (int i{ 0 }; i < 10; ++i)
+    {
+        EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/messages"), "10.0.0.1", retryAfter_));
+    }
+
+    EXPECT_EQ(limiter.getBucketCount(), 0);
+}
+
+TEST_F(RateLimiterTest, TryAcquire_IpBurstExceeded_RejectsWithRetryAfter)
+{
+    RateLimiter limiter{ RateLimitSettings{ { RateLimitRule{ "/api/v1/users/search", 0.0, 1, 0.5, 2 } } }, createResolver() };
+
+    EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/users/search?q=ab"), "10.0.0.1", retryAfter_));
+    EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/users/search/"), "10.0.0.1", retryAfter_));
+    EXPECT_FALSE(limiter.tryAcquire(createRequest("/api/v1/users/search"), "10.0.0.1", retryAfter_));
+
+    // one token is earned every two seconds
+    EXPECT_EQ(retryAfter_, std::chrono::seconds{ 2 });
+    EXPECT_EQ(limiter.getLimitedCount(), 1);
+
+    // other addresses have their own buckets
+    EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/users/search"), "10.0.0.2", retryAfter_));
+}
+
+TEST_F(RateLimiterTest, TryAcquire_UserLimit_AppliesAcrossAddresses)
+{
+    RateLimiter limiter{ RateLimitSettings{ { RateLimitRule{ "/api/v1/messages/send", 1.0, 1, 0.0, 1 } } }, createResolver() };
+
+    EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/messages/send", "valid-alice"), "10.0.0.1", retryAfter_));
+    EXPECT_FALSE(limiter.tryAcquire(createRequest("/api/v1/messages/send", "valid-alice"), "10.0.0.2", retryAfter_));
+    EXPECT_EQ(retryAfter_, std::chrono::seconds{ 1 });
+
+    EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/messages/send", "valid-bob"), "10.0.0.1", retryAfter_));
+
+    // requests without a valid token are only limited per address, which is off here
+    EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/messages/send", "forged-alice"), "10.0.0.1", retryAfter_));
+    EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/messages/send"), "10.0.0.1", retryAfter_));
+}
+
+TEST_F(RateLimiterTest, TryAcquire_IpLimitRejects_DoesNotChargeUser)
+{
+    RateLimiter limiter{ RateLimitSettings{ { RateLimitRule{ "/api/v1/messages/send", 1.0, 2, 1.0, 1 } } }, createResolver() };
+
+    EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/messages/send", "valid-alice"), "10.0.0.1", retryAfter_));
+    EXPECT_FALSE(limiter.tryAcquire(createRequest("/api/v1/messages/send", "valid-alice"), "10.0.0.1", retryAfter_));
+
+    // the user still has the second token of the burst
+    EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/messages/send", "valid-alice"), "10.0.0.2", retryAfter_));
+}
+
+TEST_F(RateLimiterTest, TryAcquire_TokensRefillOverTime)
+{
+    RateLimiter limiter{ RateLimitSettings{ { RateLimitRule{ "/api/v1/messages/send", 0.0, 1, 20.0, 1 } } }, createResolver() };
+
+    EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/messages/send"), "10.0.0.1", retryAfter_));
+    EXPECT_FALSE(limiter.tryAcquire(createRequest("/api/v1/messages/send"), "10.0.0.1", retryAfter_));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 100 });
+    EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/messages/send"), "10.0.0.1", retryAfter_));
+}
+
+TEST_F(RateLimiterTest, TryAcquire_ManyClients_BucketCountStaysBounded)
+{
+    RateLimitSettings settings{ { RateLimitRule{ "/api/v1/messages/send", 0.0, 1, 0.001, 1 } } };
+    settings.maxBuckets = 64;
+    RateLimiter limiter{ std::move(settings), createResolver() };
+
+    for (int i{ 0 }; i < 1000; ++i)
+    {
+        EXPECT_TRUE(limiter.tryAcquire(createRequest("/api/v1/messages/send"), "10.0." + std::to_string(i / 256) + "." + std::to_string(i % 256), retryAfter_));
+    }
+
+    EXPECT_LE(limiter.getBucketCount(), 64);
+}
+}
+
+#endif // RATE_LIMITER_TEST_H
@@ -0,0 +1,172 @@
+#ifndef REQUEST_PROCESSOR_TEST_H
+#define REQUEST_PROCESSOR_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "server/RequestProcessor.h"
+#include "server/RouterTest.h"
+#include "utils/Compressor.h"
+
+#include <nlohmann/json.hpp>
+
+namespace server
+{
+class DeadlineCapturingHandler : public MockHandler
+{
+public:
+    boost::beast::http::response<boost::beast::http::string_body> handleRequest(const boost::beast::http::request<boost::beast::http::string_body>& request) noexcept override
+    {
+        const auto* deadline{ utils::DeadlineScope::getCurrent() };
+        budget = deadline ? deadline->getBudget() : std::chrono::steady_clock::duration::zero();
+
+        return MockHandler::handleRequest(request);
+    }
+
+    std::chrono::steady_clock::duration budget{};
+};
+
+class RequestProcessorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        router_.registerHandler("/api/test", std::make_shared<MockHandler>());
+
+        request_.method(boost::beast::http::verb::get);
+        request_.target("/api/test");
+        request_.version(11);
+    }
+
+    Router router_;
+    SessionSettings settings_;
+    boost::beast::http::request<boost::beast::http::string_body> request_;
+    std::shared_ptr<handlers::IResponseStream> responseStream_;
+};
+
+TEST_F(RequestProcessorTest, Process_RegisteredPath_CallsHandler)
+{
+    const auto response{ RequestProcessor::process(request_, router_, settings_, "127.0.0.1", utils::Deadline{ settings_.requestTimeout }, responseStream_) };
+
+    EXPECT_EQ(response.result(), boost::beast::http::status::ok);
+    EXPECT_EQ(response.body(), R"({"status": "ok"})");
+    EXPECT_EQ(responseStream_, nullptr);
+}
+
+TEST_F(RequestProcessorTest, Process_UnknownPath_ReturnsNotFound)
+{
+    request_.target("/api/unknown");
+
+    const auto response{ RequestProcessor::process(request_, router_, settings_, "127.0.0.1", utils::Deadline{ settings_.requestTimeout }, responseStream_) };
+    EXPECT_EQ(response.result(), boost::beast::http::status::not_found);
+}
+
+TEST_F(RequestProcessorTest, Process_RateLimited_ReturnsTooManyRequests)
+{
+    router_.setRateLimiter(std::make_shared<RateLimiter>(RateLimitSettings{ { RateLimitRule{ "/api/test", 0.0, 1, 1.0, 1 } } }, nullptr));
+
+    EXPECT_EQ(RequestProcessor::process(request_, router_, settings_, "127.0.0.1", utils::Deadline{ settings_.requestTimeout }, responseStream_).result(), boost::beast::http::status::ok);
+
+    const auto response{ RequestProcessor::process(request_, router_, settings_, "127.0.0.1", utils::Deadline{ settings_.requestTimeout }, responseStream_) };
+    EXPECT_EQ(response.result(), boost::beast::http::status::too_many_requests);
+    EXPECT_EQ(response[boost::beast::http::field::retry_after], "1");
+    EXPECT_EQ(nlohmann::json::parse(response.body())["code"], "RATE_LIMITED");
+}
+
+TEST_F(RequestProcessorTest, Process_Overloaded_ReturnsServiceUnavailable)
+{
+    router_.setLoadShedder(std::make_shared<LoadShedder>(LoadShedSettings{}, []()
+    {
+        return LoadSample{ std::chrono::milliseconds{ 7500 }, 3 };
+    }));
+
+    const auto response{ RequestProcessor::process(request_, router_, settings_, "127.0.0.1", utils::Deadline{ settings_.requestTimeout }, responseStream_) };
+    EXPECT_EQ(response.result(), boost::beast::http::status::service_unavailable);
+    EXPECT_EQ(response[boost::beast::http::field::retry_after], "8");
+    EXPECT_EQ(nlohmann::json::parse(response.body())["code"], "SERVICE_OVERLOADED");
+}
+
+TEST_F(RequestProcessorTest, Process_BackendUnavailable_ReturnsServiceUnavailable)
+{
+    router_.setAvailabilityProbe([](std::chrono::seconds& retryAfter)
+    {
+        retryAfter = std::chrono::seconds{ 2 };
+        return false;
+    });
+
+    const auto response{ RequestProcessor::process(request_, router_, settings_, "127.0.0.1", utils::Deadline{ settings_.requestTimeout }, responseStream_) };
+    EXPECT_EQ(response.result(), boost::beast::http::status::service_unavailable);
+    EXPECT_EQ(response[boost::beast::http::field::retry_after], "2");
+    EXPECT_EQ(nlohmann::json::parse(response.body())["code"], "SERVICE_UNAVAILABLE");
+
+    router_.setAvailabilityProbe([](std::chrono::seconds&) { return true; });
+    EXPECT_EQ(RequestProcessor::process(request_, router_, settings_, "127.0.0.1", utils::Deadline{ settings_.requestTimeout }, responseStream_).result(), boost::beast::http::status::ok);
+}
+
+TEST_F(RequestProcessorTest, Process_Handler_RunsWithinRequestDeadline)
+{
+    const auto handler{ std::make_shared<DeadlineCapturingHandler>() };
+    router_.registerHandler("/api/deadline", handler);
+    request_.target("/api/deadline");
+
+    EXPECT_EQ(RequestProcessor::process(request_, router_, settings_, "127.0.0.1", utils::Deadline{ std::chrono::milliseconds{ 1500 } }, responseStream_).result(),
+        boost::beast::http::status::ok);
+    EXPECT_EQ(handler->budget, std::chrono::milliseconds{ 1500 });
+
+    // the deadline ends with the request
+    EXPECT_EQ(utils::DeadlineScope::getCurrent(), nullptr);
+}
+
+TEST_F(RequestProcessorTest, DecodeRequestBody_Gzip_DecodesInPlace)
+{
+    std::string compressed{};
+    ASSERT_TRUE(utils::Compressor::compress(R"({"text":"hello"})", utils::ContentEncoding::Gzip, 6, compressed));
+
+    request_.set(boost::beast::http::field::content_encoding, "gzip");
+    request_.body() = compressed;
+
+    EXPECT_FALSE(RequestProcessor::decodeRequestBody(request_, settings_));
+    EXPECT_EQ(request_.body(), R"({"text":"hello"})");
+    EXPECT_EQ(request_.count(boost::beast::http::field::content_encoding), 0u);
+}
+
+TEST_F(RequestProcessorTest, DecodeRequestBody_UnsupportedCoding_ReturnsError)
+{
+    request_.set(boost::beast::http::field::content_encoding, "compress");
+
+    const auto error{ RequestProcessor::decodeRequestBody(request_, settings_) };
+    ASSERT_TRUE(error);
+    EXPECT_EQ(error->result(), boost::beast::http::status::unsupported_media_type);
+    EXPECT_EQ(nlohmann::json::parse(error->body())["code"], "UNSUPPORTED_CONTENT_ENCODING");
+}
+
+TEST_F(RequestProcessorTest, EncodeResponseBody_AcceptedCoding_CompressesLargeJson)
+{
+    request_.set(boost::beast::http::field::accept_encoding, "gzip");
+
+    boost::beast::http::response<boost::beast::http::string_body> response{ boost::beast::http::status::ok, 11 };
+    response.set(boost::beast::http::field::content_type, "application/json");
+    response.body() = std::string(4096, 'a');
+    response.prepare_payload();
+
+    RequestProcessor::encodeResponseBody(request_, response, settings_);
+
+    EXPECT_EQ(response[boost::beast::http::field::content_encoding], "gzip");
+    EXPECT_EQ(response[boost::beast::http::field::vary], "Accept-Encoding");
+    EXPECT_LT(response.body().size(), 4096u);
+}
+
+TEST_F(RequestProcessorTest, CreateErrorResponse_ReturnsJsonError)
+{
+    const auto response{ RequestProcessor::createErrorResponse(request_, boost::beast::http::status::bad_request, "INVALID_REQUEST", "Invalid request") };
+
+    EXPECT_EQ(response.result(), boost::beast::http::status::bad_request);
+    EXPECT_EQ(response[boost::beast::http::field::content_type], "application/json");
+
+    const auto json = nlohmann::json::parse(response.body());
+    EXPECT_EQ(json["status"], "error");
+    EXPECT_EQ(json["code"], "INVALID_REQUEST");
+    EXPECT_EQ(json["message"], "Invalid request");
+}
+}
+
+#endif // REQUEST_PROCESSOR_TEST_H
@@ -0,0 +1,162 @@
+#ifndef TIMER_WHEEL_TEST_H
+#define TIMER_WHEEL_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "server/TimerWheel.h"
+
+#include <chrono>
+#include <vector>
+
+namespace server
+{
+class TimerWheelTest : public ::testing::Test
+{
+protected:
+    static constexpr std::chrono::milliseconds RESOLUTION{ 10 };
+
+    boost::asio::io_context ioc_{};
+    std::shared_ptr<TimerWheel> wheel_{ std::make_shared<TimerWheel>(ioc_.get_executor(), RESOLUTION, 8) };
+};
+
+TEST_F(TimerWheelTest, Constructor_InvalidArguments_Throws)
+{
+    EXPECT_THROW(TimerWheel(ioc_.get_executor(), std::chrono::milliseconds{ 0 }), std::invalid_argument);
+    EXPECT_THROW(TimerWheel(ioc_.get_executor(), RESOLUTION, 0), std::invalid_argument);
+}
+
+TEST_F(TimerWheelTest, ExpiresAfter_FiresAfterTimeout)
+{
+    int fired{ 0 };
+    const auto timer{ wheel_->createTimer(ioc_.get_executor(), [&fired]() { ++fired; }) };
+    EXPECT_FALSE(timer->isArmed());
+
+    const auto start{ std::chrono::steady_clock::now() };
+    timer->expiresAfter(std::chrono::milliseconds{ 50 });
+    EXPECT_TRUE(timer->isArmed());
+    EXPECT_EQ(wheel_->getArmedCount(), 1);
+
+    ioc_.run();
+
+    EXPECT_EQ(fired, 1);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds{ 50 });
+    EXPECT_FALSE(timer->isArmed());
+    EXPECT_EQ(wheel_->getArmedCount(), 0);
+}
+
+TEST_F(TimerWheelTest, ExpiresAfter_BeyondOneTurn_FiresAfterTimeout)
+{
+    int fired{ 0 };
+    const auto timer{ wheel_->createTimer(ioc_.get_executor(), [&fired]() { ++fired; }) };
+
+    // 8 slots of 10 ms make one turn of 80 ms
+    const auto start{ std::chrono::steady_clock::now() };
+    timer->expiresAfter(std::chrono::milliseconds{ 200 });
+
+    ioc_.run();
+
+    EXPECT_EQ(fired, 1);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds{ 200 });
+}
+
+TEST_F(TimerWheelTest, ExpiresAfter_Rearmed_PostponesExpiry)
+{
+    int fired{ 0 };
+    const auto timer{ wheel_->createTimer(ioc_.get_executor(), [&fired]() { ++fired; }) };
+
+    const auto start{ std::chrono::steady_clock::now() };
+    timer->expiresAfter(std::chrono::milliseconds{ 30 });
+
+    boost::asio::steady_timer rearm{ ioc_, std::chrono::milliseconds{ 20 } };
+    rearm.async_wait([&timer](const boost::system::error_code&) { timer->expiresAfter(std::chrono::milliseconds{ 100 }); });
+
+    ioc_.run();
+
+    EXPECT_EQ(fired, 1);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds{ 120 });
+}
+
+TEST_F(TimerWheelTest, ExpiresAfter_Shortened_FiresEarlier)
+{
+    int fired{ 0 };
+    const auto timer{ wheel_->createTimer(ioc_.get_executor(), [&fired]() { ++fired; }) };
+
+    const auto start{ std::chrono::steady_clock::now() };
+    timer->expiresAfter(std::chrono::seconds{ 10 });
+    timer->expiresAfter(std::chrono::milliseconds{ 30 });
+
+    ioc_.run();
+
+    EXPECT_EQ(fired, 1);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{ 5 });
+}
+
+TEST_F(TimerWheelTest, Cancel_DoesNotFireAndStopsTicking)
+{
+    int fired{ 0 };
+    const auto timer{ wheel_->createTimer(ioc_.get_executor(), [&fired]() { ++fired; }) };
+
+    timer->expiresAfter(std::chrono::milliseconds{ 50 });
+    timer->cancel();
+    EXPECT_FALSE(timer->isArmed());
+    EXPECT_EQ(wheel_->getArmedCount(), 0);
+
+    // run returns because the wheel stops ticking without armed timers
+    const auto start{ std::chrono::steady_clock::now() };
+    ioc_.run();
+
+    EXPECT_EQ(fired, 0);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{ 5 });
+}
+
+TEST_F(TimerWheelTest, Destructor_DisarmsTimer)
+{
+    int fired{ 0 };
+    auto timer{ wheel_->createTimer(ioc_.get_executor(), [&fired]() { ++fired; }) };
+
+    timer->expiresAfter(std::chrono::milliseconds{ 50 });
+    timer.reset();
+    EXPECT_EQ(wheel_->getArmedCount(), 0);
+
+    ioc_.run();
+
+    EXPECT_EQ(fired, 0);
+}
+
+TEST_F(TimerWheelTest, ManyTimers_EachFiresOnce)
+{
+    constexpr size_t TIMER_COUNT{ 1000 };
+
+    std::vector<int> fired(TIMER_COUNT, 0);
+    std::vector<std::shared_ptr<WheelTimer>> timers{};
+    timers.reserve(TIMER_COUNT);
+
+    for (size_t i{ 0 }; i < TIMER_COUNT; ++i)
+    {
+        timers.push_back(wheel_->createTimer(ioc_.get_executor(), [&fired, i]() { ++fired[i]; }));
+        timers.back()->expiresAfter(std::chrono::milliseconds{ 10 + static_cast<int>(i % 100) });
+    }
+
+    // every other timer is re-armed once, every tenth is cancelled
+    for (size_t i{ 0 }; i < TIMER_COUNT; i += 2)
+    {
+        timers[i]->expiresAfter(std::chrono::milliseconds{ 60 });
+    }
+
+    for (size_t i{ 0 }; i < TIMER_COUNT; i += 10)
+    {
+        timers[i]->cancel();
+    }
+
+    ioc_.run();
+
+    for (size_t i{ 0 }; i < TIMER_COUNT; ++i)
+    {
+        EXPECT_EQ(fired[i], i % 10 == 0 ? 0 : 1) << "timer " << i;
+    }
+
+    EXPECT_EQ(wheel_->getArmedCount(), 0);
+}
+}
+
+#endif // TIMER_WHEEL_TEST_H
@@ -0,0 +1,177 @@
+#ifndef TLS_SESSION_MANAGER_TEST_H
+#define TLS_SESSION_MANAGER_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "server/TlsSessionManager.h"
+
+#include <openssl/x509.h>
+
+namespace server
+{
+class TlsSessionManagerTest : public ::testing::Test
+{
+public:
+    // installs a fresh P-256 key and a self-signed certificate, so no files are needed
+    static void useSelfSignedCertificate(SSL_CTX* context)
+    {
+        auto* const key{ EVP_EC_gen("P-256") };
+        auto* const certificate{ X509_new() };
+
+        X509_set_version(certificate, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+        X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+        X509_gmtime_adj(X509_getm_notAfter(certificate), 3600);
+        X509_set_pubkey(certificate, key);
+        X509_NAME_add_entry_by_txt(X509_get_subject_name(certificate), "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(certificate, X509_get_subject_name(certificate));
+        X509_sign(certificate, key, EVP_sha256());
+
+        SSL_CTX_use_certificate(context, certificate);
+        SSL_CTX_use_PrivateKey(context, key);
+
+        X509_free(certificate);
+        EVP_PKEY_free(key);
+    }
+
+protected:
+    void SetUp() override
+    {
+        serverContext_ = std::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tls_server);
+        useSelfSignedCertificate(serverContext_->native_handle());
+
+        clientContext_ = SSL_CTX_new(TLS_client_method());
+        ASSERT_NE(clientContext_, nullptr);
+    }
+
+    void TearDown() override
+    {
+        SSL_SESSION_free(session_);
+        SSL_CTX_free(clientContext_);
+    }
+
+    // runs a handshake over an in-memory BIO pair, resuming session_ if set, and keeps the new session
+    bool handshake()
+    {
+        auto* const server{ SSL_new(serverContext_->native_handle()) };
+        auto* const client{ SSL_new(clientContext_) };
+
+        BIO* serverBio{ nullptr };
+        BIO* clientBio{ nullptr };
+        BIO_new_bio_pair(&serverBio, 0, &clientBio, 0);
+        SSL_set_bio(server, serverBio, serverBio);
+        SSL_set_bio(client, clientBio, clientBio);
+        SSL_set_accept_state(server);
+        SSL_set_connect_state(client);
+
+        if (session_ != nullptr)
+        {
+            SSL_set_session(client, session_);
+        }
+
+        auto isServerDone{ false };
+        auto isClientDone{ false };
+        for (auto i{ 0 }; i < 20 && !(isServerDone && isClientDone); ++i)
+        {
+            isClientDone = isClientDone || SSL_do_handshake(client) == 1;
+            isServerDone = isServerDone || SSL_do_handshake(server) == 1;
+        }
+
+        // TLS 1.3 tickets arrive after the handshake
+        char buffer[1]{};
+        SSL_read(client, buffer, sizeof(buffer));
+
+        SSL_SESSION_free(session_);
+        session_ = SSL_get1_session(client);
+
+        // an unclean close makes the session non-resumable
+        SSL_shutdown(client);
+        SSL_shutdown(server);
+
+        SSL_free(client);
+        SSL_free(server);
+        return isServerDone && isClientDone;
+    }
+
+    std::shared_ptr<boost::asio::ssl::context> serverContext_;
+    SSL_CTX* clientContext_{ nullptr };
+    SSL_SESSION* session_{ nullptr };
+};
+
+TEST_F(TlsSessionManagerTest, Constructor_NullContext_Throws)
+{
+    EXPECT_THROW(TlsSessionManager(nullptr, TlsSettings{}), std::invalid_argument);
+}
+
+TEST_F(TlsSessionManagerTest, Constructor_InvalidLists_Throw)
+{
+    TlsSettings settings{};
+    settings.cipherList = "NOT-A-CIPHER";
+    EXPECT_THROW(TlsSessionManager(serverContext_, settings), std::runtime_error);
+
+    settings = TlsSettings{};
+    settings.groups = "not-a-group";
+    EXPECT_THROW(TlsSessionManager(serverContext_, settings), std::runtime_error);
+}
+
+TEST_F(TlsSessionManagerTest, Handshake_WithTicket_ResumesSession)
+{
+    TlsSessionManager manager{ serverContext_, TlsSettings{} };
+
+    ASSERT_TRUE(handshake());
+    ASSERT_TRUE(handshake());
+
+    const auto statistics{ manager.getStatistics() };
+    EXPECT_EQ(statistics.handshakes, 2u);
+    EXPECT_EQ(statistics.resumedHandshakes, 1u);
+    EXPECT_DOUBLE_EQ(statistics.getResumptionRate(), 0.5);
+}
+
+TEST_F(TlsSessionManagerTest, Handshake_TicketOfPreviousKey_IsAcceptedOnce)
+{
+    TlsSessionManager manager{ serverContext_, TlsSettings{} };
+
+    ASSERT_TRUE(handshake());
+    manager.rotateTicketKeys();
+    ASSERT_TRUE(handshake());
+    EXPECT_EQ(manager.getStatistics().resumedHandshakes, 1u);
+
+    // the ticket was renewed under the current key, so the next rotation keeps it usable
+    manager.rotateTicketKeys();
+    ASSERT_TRUE(handshake());
+    EXPECT_EQ(manager.getStatistics().resumedHandshakes, 2u);
+}
+
+TEST_F(TlsSessionManagerTest, Handshake_TicketOfExpiredKey_FallsBackToFullHandshake)
+{
+    TlsSessionManager manager{ serverContext_, TlsSettings{} };
+
+    ASSERT_TRUE(handshake());
+    manager.rotateTicketKeys();
+    manager.rotateTicketKeys();
+    ASSERT_TRUE(handshake());
+
+    const auto statistics{ manager.getStatistics() };
+    EXPECT_EQ(statistics.handshakes, 2u);
+    EXPECT_EQ(statistics.resumedHandshakes, 0u);
+    EXPECT_EQ(statistics.ticketKeyRotations, 2u);
+}
+
+TEST_F(TlsSessionManagerTest, Handshake_TicketsDisabled_ResumesFromSessionCache)
+{
+    TlsSettings settings{};
+    settings.isSessionTicketsEnabled = false;
+    TlsSessionManager manager{ serverContext_, settings };
+
+    ASSERT_TRUE(handshake());
+    ASSERT_TRUE(handshake());
+    EXPECT_EQ(manager.getStatistics().resumedHandshakes, 1u);
+}
+
+TEST(TlsStatisticsTest, GetResumptionRate_NoHandshakes_ReturnsZero)
+{
+    EXPECT_DOUBLE_EQ(TlsStatistics{}.getResumptionRate(), 0.0);
+}
+}
+
+#endif // TLS_SESSION_MANAGER_TEST_H
@@ -0,0 +1,359 @@
+#ifndef TLS_STREAM_TEST_H
+#define TLS_STREAM_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "server/TlsStream.h"
+#include "server/TlsSessionManagerTest.h"
+
+#include <boost/asio.hpp>
+#include <boost/beast/http.hpp>
+
+namespace server
+{
+class TlsStreamTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        TlsSessionManagerTest::useSelfSignedCertificate(serverContext_.native_handle());
+
+        boost::asio::ip::tcp::acceptor acceptor{ ioc_, { boost::asio::ip::make_address("127.0.0.1"), 0 } };
+        client_.next_layer().connect(acceptor.local_endpoint());
+        server_ = std::make_unique<TlsStream>(acceptor.accept(), serverContext_);
+    }
+
+    // runs the client side synchronously on its own thread while the server side runs on ioc_
+    template<typename Function>
+    void runWithClient(Function clientSide)
+    {
+        std::thread client{ [this, clientSide]()
+        {
+            boost::system::error_code ec{};
+            client_.handshake(boost::asio::ssl::stream_base::client, ec);
+            ASSERT_FALSE(ec) << ec.message();
+            clientSide(client_);
+        } };
+
+        ioc_.run();
+        client.join();
+    }
+
+    boost::asio::io_context ioc_;
+    boost::asio::ssl::context serverContext_{ boost::asio::ssl::context::tls_server };
+    boost::asio::ssl::context clientContext_{ boost::asio::ssl::context::tls_client };
+    boost::asio::ssl::stream<boost::asio::ip::tcp::socket> client_{ ioc_, clientContext_ };
+    std::unique_ptr<TlsStream> server_;
+};
+
+TEST_F(TlsStreamTest, ReadAndWrite_LargePayload_RoundTrips)
+{
+    const std::string payload(256 * 1024, 'x');
+    std::string received(payload.size(), '\0');
+    boost::system::error_code serverEc{};
+
+    server_->async_handshake([this, &received, &serverEc](const boost::system::error_code& ec)
+    {
+        ASSERT_FALSE(ec) << ec.message();
+
+        boost::asio::async_read(*server_, boost::asio::buffer(received), [this, &received, &serverEc](const boost::system::error_code& ec, std::size_t)
+        {
+            ASSERT_FALSE(ec) << ec.message();
+
+            boost::asio::async_write(*server_, boost::asio::buffer(received), [&serverEc](const boost::system::error_code& ec, std::size_t)
+            {
+                serverEc = ec;
+            });
+        });
+    });
+
+    std::string echoed(payload.size(), '\0');
+    runWithClient([&payload, &echoed](auto& client)
+    {
+        boost::asio::write(client, boost::asio::buffer(payload));
+        boost::asio::read(client, boost::asio::buffer(echoed));
+    });
+
+    EXPECT_FALSE(serverEc) << serverEc.message();
+    EXPECT_EQ(received, payload);
+    EXPECT_EQ(echoed, payload);
+}
+
+TEST_F(TlsStreamTest, HttpRequest_IsParsedByBeast)
+{
+    boost::beast::flat_buffer buffer{};
+    boost::beast::http::request<boost::beast::http::string_body> request{};
+    boost::system::error_code serverEc{};
+
+    server_->async_handshake([this, &buffer, &request, &serverEc](const boost::system::error_code& ec)
+    {
+        ASSERT_FALSE(ec) << ec.message();
+
+        boost::beast::http::async_read(*server_, buffer, request, [&serverEc](const boost::system::error_code& ec, std::size_t)
+        {
+            serverEc = ec;
+        });
+    });
+
+    runWithClient([](auto& client)
+    {
+        boost::beast::http::request<boost::beast::http::string_body> clientRequest{ boost::beast::http::verb::post, "/api/v1/messages/send", 11 };
+        clientRequest.body() = R"({"to_login":"user2","text":"hello"})";
+        clientRequest.prepare_payload();
+        boost::beast::http::write(client, clientRequest);
+    });
+
+    EXPECT_FALSE(serverEc) << serverEc.message();
+    EXPECT_EQ(request.target(), "/api/v1/messages/send");
+    EXPECT_EQ(request.body(), R"({"to_login":"user2","text":"hello"})");
+}
+
+TEST_F(TlsStreamTest, Read_ClientShutdown_CompletesWithEof)
+{
+    boost::system::error_code serverEc{};
+    std::array<char, 16> data{};
+
+    server_->async_handshake([this, &data, &serverEc](const boost::system::error_code& ec)
+    {
+        ASSERT_FALSE(ec) << ec.message();
+
+        server_->async_read_some(boost::asio::buffer(data), [this, &serverEc](const boost::system::error_code& ec, std::size_t)
+        {
+            serverEc = ec;
+
+            // the client waits for the server's close_notify
+            server_->async_shutdown([](const boost::system::error_code&) {});
+        });
+    });
+
+    runWithClient([](auto& client)
+    {
+        boost::system::error_code ec{};
+        client.shutdown(ec);
+        EXPECT_FALSE(ec) << ec.message();
+    });
+
+    EXPECT_EQ(serverEc, boost::asio::error::eof);
+}
+
+TEST_F(TlsStreamTest, Read_ClientDisconnect_CompletesWithError)
+{
+    boost::system::error_code serverEc{};
+    std::array<char, 16> data{};
+
+    server_->async_handshake([this, &data, &serverEc](const boost::system::error_code& ec)
+    {
+        ASSERT_FALSE(ec) << ec.message();
+
+        server_->async_read_some(boost::asio::buffer(data), [&serverEc](const boost::system::error_code& ec, std::size_t)
+        {
+            serverEc = ec;
+        });
+    });
+
+    runWithClient([](auto& client)
+    {
+        client.next_layer().close();
+    });
+
+    EXPECT_TRUE(serverEc);
+}
+
+TEST_F(TlsStreamTest, Read_Cancel_CompletesWithOperationAborted)
+{
+    boost::system::error_code serverEc{};
+    std::array<char, 16> data{};
+
+    server_->async_handshake([this, &data, &serverEc](const boost::system::error_code& ec)
+    {
+        ASSERT_FALSE(ec) << ec.message();
+
+        server_->async_read_some(boost::asio::buffer(data), [&serverEc](const boost::system::error_code& ec, std::size_t)
+        {
+            serverEc = ec;
+        });
+
+        boost::asio::post(server_->get_executor(), [this]()
+        {
+            server_->next_layer().cancel();
+        });
+    });
+
+    runWithClient([](auto&) {});
+
+    EXPECT_EQ(serverEc, boost::asio::error::operation_aborted);
+}
+
+TEST_F(TlsStreamTest, SendFile_KernelTlsRequested_FallsBackWhenUnavailable)
+{
+    // ssl.ktls_enabled sets the option on the context; the stream has to be created after that
+    SSL_CTX_set_options(serverContext_.native_handle(), SSL_OP_ENABLE_KTLS);
+    server_ = std::make_unique<TlsStream>(std::move(server_->next_layer().socket()), serverContext_);
+
+    const std::string payload(256 * 1024, 'x');
+    std::string received(payload.size(), '\0');
+    boost::system::error_code serverEc{};
+
+    server_->async_handshake([this, &received, &serverEc](const boost::system::error_code& ec)
+    {
+        ASSERT_FALSE(ec) << ec.message();
+
+        // sendfile only where the kernel took over the record layer, SSL_write everywhere else
+        EXPECT_EQ(server_->isSendFileAvailable(), server_->isKernelSendEnabled());
+
+        boost::asio::async_read(*server_, boost::asio::buffer(received), [this, &received, &serverEc](const boost::system::error_code& ec, std::size_t)
+        {
+            ASSERT_FALSE(ec) << ec.message();
+
+            boost::asio::async_write(*server_, boost::asio::buffer(received), [&serverEc](const boost::system::error_code& ec, std::size_t)
+            {
+                serverEc = ec;
+            });
+        });
+    });
+
+    std::string echoed(payload.size(), '\0');
+    runWithClient([&payload, &echoed](auto& client)
+    {
+        boost::asio::write(client, boost::asio::buffer(payload));
+        boost::asio::read(client, boost::asio::buffer(echoed));
+    });
+
+    EXPECT_FALSE(serverEc) << serverEc.message();
+    EXPECT_EQ(echoed, payload);
+}
+
+TEST_F(TlsStreamTest, ProxyHeader_BeforeHandshake_ReplacesRemoteEndpoint)
+{
+    boost::system::error_code serverEc{};
+    std::array<char, 5> data{};
+
+    // the balancer sends the header ahead of the client's ClientHello
+    boost::asio::write(client_.next_layer(), boost::asio::buffer(std::string_view{ "PROXY TCP4 203.0.113.7 10.0.0.1 51000 443\r\n" }));
+
+    server_->async_read_proxy_header([this, &data, &serverEc](const boost::system::error_code& ec)
+    {
+        ASSERT_FALSE(ec) << ec.message();
+
+        server_->async_handshake([this, &data, &serverEc](const boost::system::error_code& ec)
+        {
+            ASSERT_FALSE(ec) << ec.message();
+            boost::asio::async_read(*server_, boost::asio::buffer(data), [&serverEc](const boost::system::error_code& ec, std::size_t)
+            {
+                serverEc = ec;
+            });
+        });
+    });
+
+    runWithClient([](auto& client)
+    {
+        boost::asio::write(client, boost::asio::buffer(std::string_view{ "hello" }));
+    });
+
+    EXPECT_FALSE(serverEc) << serverEc.message();
+    EXPECT_EQ(std::string_view(data.data(), data.size()), "hello");
+
+    EXPECT_EQ(server_->getRemoteAddress(), "203.0.113.7");
+}
+
+TEST(TlsStreamPlaintextTest, ReadAndWrite_WithoutTls_RoundTrips)
+{
+    boost::asio::io_context ioc{};
+    boost::asio::ip::tcp::acceptor acceptor{ ioc, { boost::asio::ip::make_address("127.0.0.1"), 0 } };
+    boost::asio::ip::tcp::socket client{ ioc };
+    client.connect(acceptor.local_endpoint());
+    TlsStream server{ acceptor.accept() };
+
+    EXPECT_FALSE(server.isEncrypted());
+    EXPECT_TRUE(server.isSendFileAvailable());
+    EXPECT_TRUE(server.getAlpnProtocol().empty());
+
+    const std::string payload(256 * 1024, 'x');
+    std::string received(payload.size(), '\0');
+    boost::system::error_code serverEc{};
+
+    server.async_handshake([&server, &received, &serverEc](const boost::system::error_code& ec)
+    {
+        ASSERT_FALSE(ec) << ec.message();
+
+        boost::asio::async_read(server, boost::asio::buffer(received), [&server, &received, &serverEc](const boost::system::error_code& ec, std::size_t)
+        {
+            ASSERT_FALSE(ec) << ec.message();
+
+            boost::asio::async_write(server, boost::asio::buffer(received), [&server, &serverEc](const boost::system::error_code& ec, std::size_t)
+            {
+                serverEc = ec;
+                server.async_shutdown([](const boost::system::error_code&) {});
+            });
+        });
+    });
+
+    std::string echoed{};
+    std::thread clientThread{ [&client, &payload, &echoed]()
+    {
+        boost::asio::write(client, boost::asio::buffer(payload));
+
+        // the server's shutdown ends the echo
+        boost::system::error_code ec{};
+        boost::asio::read(client, boost::asio::dynamic_buffer(echoed), ec);
+        EXPECT_EQ(ec, boost::asio::error::eof);
+    } };
+
+    ioc.run();
+    clientThread.join();
+
+    EXPECT_FALSE(serverEc) << serverEc.message();
+    EXPECT_EQ(echoed, payload);
+}
+
+TEST(TlsStreamPlaintextTest, ProxyHeader_Missing_FailsWithProtocolError)
+{
+    boost::asio::io_context ioc{};
+    boost::asio::ip::tcp::acceptor acceptor{ ioc, { boost::asio::ip::make_address("127.0.0.1"), 0 } };
+    boost::asio::ip::tcp::socket client{ ioc };
+    client.connect(acceptor.local_endpoint());
+    TlsStream server{ acceptor.accept() };
+
+    boost::asio::write(client, boost::asio::buffer(std::string_view{ "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n" }));
+
+    boost::system::error_code serverEc{};
+    server.async_read_proxy_header([&serverEc](const boost::system::error_code& ec)
+    {
+        serverEc = ec;
+    });
+
+    ioc.run();
+
+    EXPECT_EQ(serverEc, boost::system::errc::protocol_error);
+
+    // without a header the client address is the peer of the socket
+    EXPECT_EQ(server.getRemoteAddress(), "127.0.0.1");
+}
+
+TEST(TlsStreamPlaintextTest, ProxyHeader_Read_LeavesSocketBlocking)
+{
+    boost::asio::io_context ioc{};
+    boost::asio::ip::tcp::acceptor acceptor{ ioc, { boost::asio::ip::make_address("127.0.0.1"), 0 } };
+    boost::asio::ip::tcp::socket client{ ioc };
+    client.connect(acceptor.local_endpoint());
+    TlsStream server{ acceptor.accept() };
+
+    boost::asio::write(client, boost::asio::buffer(std::string_view{ "PROXY TCP4 203.0.113.7 10.0.0.1 51000 80\r\nGET" }));
+
+    boost::system::error_code serverEc{};
+    server.async_read_proxy_header([&serverEc](const boost::system::error_code& ec)
+    {
+        serverEc = ec;
+    });
+
+    ioc.run();
+
+    EXPECT_FALSE(serverEc) << serverEc.message();
+    EXPECT_EQ(server.getRemoteAddress(), "203.0.113.7");
+
+    // plaintext reads and writes are the socket's own operations, which io_uring only performs on a blocking socket
+    EXPECT_FALSE(server.next_layer().socket().native_non_blocking());
+}
+}
+
+#endif // TLS_STREAM_TEST_H
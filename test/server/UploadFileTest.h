@@ -0,0 +1,60 @@
+#ifndef UPLOAD_FILE_TEST_H
+#define UPLOAD_FILE_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "server/UploadFile.h"
+#include "utils/UUIDUtils.h"
+
+#include <array>
+#include <boost/beast/http.hpp>
+#include <fstream>
+#include <sstream>
+
+namespace server
+{
+TEST(UploadFileTest, Parser_WritesBodyToFile)
+{
+    const auto path{ std::filesystem::temp_directory_path() / ("upload_file_test_" + utils::UUIDUtils::generateUUID()) };
+
+    boost::beast::http::request_parser<UploadBody> parser{};
+    parser.eager(true);
+    boost::beast::error_code ec{};
+    parser.get().body().open(path.string().c_str(), boost::beast::file_mode::write, ec);
+    ASSERT_FALSE(ec);
+
+    const std::string data{ "POST /api/v1/attachments HTTP/1.1\r\nHost: localhost\r\nContent-Length: 11\r\n\r\nhello world" };
+    parser.put(boost::asio::buffer(data), ec);
+    ASSERT_FALSE(ec);
+    ASSERT_TRUE(parser.is_done());
+
+    parser.get().body().file().close(ec);
+    EXPECT_FALSE(ec);
+
+    std::ifstream file{ path, std::ios::binary };
+    std::stringstream content{};
+    content << file.rdbuf();
+    EXPECT_EQ(content.str(), "hello world");
+
+    std::filesystem::remove(path);
+}
+
+TEST(UploadFileTest, ReadingAndSeeking_NotSupported)
+{
+    UploadFile file{};
+    boost::beast::error_code ec{};
+
+    file.open("unused", boost::beast::file_mode::read, ec);
+    EXPECT_EQ(ec, boost::beast::errc::operation_not_supported);
+    EXPECT_FALSE(file.is_open());
+
+    std::array<char, 4> buffer{};
+    EXPECT_EQ(file.read(buffer.data(), buffer.size(), ec), 0u);
+    EXPECT_EQ(ec, boost::beast::errc::operation_not_supported);
+
+    EXPECT_EQ(file.write(buffer.data(), buffer.size(), ec), 0u);
+    EXPECT_TRUE(ec);
+}
+}
+
+#endif // UPLOAD_FILE_TEST_H
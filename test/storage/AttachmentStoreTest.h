@@ -0,0 +1,97 @@
+#ifndef ATTACHMENT_STORE_TEST_H
+#define ATTACHMENT_STORE_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "storage/AttachmentStore.h"
+#include "utils/UUIDUtils.h"
+
+#include <fstream>
+
+namespace storage
+{
+class AttachmentStoreTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        rootDir_ = std::filesystem::temp_directory_path() / ("attachment_store_test_" + utils::UUIDUtils::generateUUID());
+        store_ = std::make_unique<AttachmentStore>(rootDir_);
+    }
+
+    void TearDown() override
+    {
+        store_.reset();
+        std::filesystem::remove_all(rootDir_);
+    }
+
+    std::filesystem::path writeTempFile(const std::string& content) const
+    {
+        const auto path{ store_->createTempPath() };
+        std::ofstream file{ path, std::ios::binary };
+        file << content;
+        return path;
+    }
+
+    std::filesystem::path rootDir_;
+    std::unique_ptr<AttachmentStore> store_;
+};
+
+TEST_F(AttachmentStoreTest, Commit_StoresFileUnderSha256Digest)
+{
+    const auto tempFile{ writeTempFile("hello") };
+
+    std::string digest;
+    std::uintmax_t size{ 0 };
+    ASSERT_TRUE(store_->commit(tempFile, digest, size));
+
+    EXPECT_EQ(digest, "2cf24dba5fb0a30e26e83b2ac5b9e29e1b161e5c1fa7425e73043362938b9824");
+    EXPECT_EQ(size, 5u);
+    EXPECT_FALSE(std::filesystem::exists(tempFile));
+
+    const auto path{ store_->getPath(digest) };
+    EXPECT_EQ(path, rootDir_ / "2c" / "f2" / digest);
+    EXPECT_TRUE(std::filesystem::exists(path));
+}
+
+TEST_F(AttachmentStoreTest, Commit_SameContent_IsStoredOnce)
+{
+    std::string firstDigest;
+    std::string secondDigest;
+    std::uintmax_t size{ 0 };
+
+    ASSERT_TRUE(store_->commit(writeTempFile("duplicate"), firstDigest, size));
+    const auto secondFile{ writeTempFile("duplicate") };
+    ASSERT_TRUE(store_->commit(secondFile, secondDigest, size));
+
+    EXPECT_EQ(firstDigest, secondDigest);
+    EXPECT_FALSE(std::filesystem::exists(secondFile));
+}
+
+TEST_F(AttachmentStoreTest, Commit_MissingFile_ReturnsFalse)
+{
+    std::string digest;
+    std::uintmax_t size{ 0 };
+
+    EXPECT_FALSE(store_->commit(store_->createTempPath(), digest, size));
+}
+
+TEST_F(AttachmentStoreTest, GetPath_MalformedDigest_ReturnsEmptyPath)
+{
+    EXPECT_TRUE(store_->getPath("").empty());
+    EXPECT_TRUE(store_->getPath("../../etc/passwd").empty());
+    EXPECT_TRUE(store_->getPath(std::string(64, 'A')).empty());
+    EXPECT_FALSE(store_->getPath(std::string(64, 'a')).empty());
+}
+
+TEST_F(AttachmentStoreTest, Constructor_RemovesInterruptedUploads)
+{
+    const auto tempFile{ writeTempFile("partial") };
+    ASSERT_TRUE(std::filesystem::exists(tempFile));
+
+    AttachmentStore reopened{ rootDir_ };
+    EXPECT_FALSE(std::filesystem::exists(tempFile));
+}
+}
+
+#endif // ATTACHMENT_STORE_TEST_H
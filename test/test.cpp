@@ -9,8 +9,16 @@
 #include "utils/PasswordHasherTest.h"
 #include "utils/UUIDUtilsTest.h"
 #include "utils/ValidatorsTest.h"
+#include "utils/PatternScannerTest.h"
+#include "utils/Utf8Test.h"
 #include "utils/SecurityUtilsTest.h"
 #include "utils/LoggerTest.h"
+#include "utils/CompressorTest.h"
+#include "utils/PayloadCodecTest.h"
+#include "utils/HttpRangeTest.h"
+#include "utils/ProxyProtocolTest.h"
+#include "utils/FileWriterTest.h"
+#include "utils/DeadlineTest.h"
 
 #include "auth/JWTManagerTest.h"
 
@@ -18,14 +26,31 @@
 
 #include "models/UserTest.h"
 #include "models/MessageTest.h"
+#include "models/MessagePageTest.h"
 
 #include "database/DatabaseManagerTest.h"
+#include "database/ConcurrencyLimiterTest.h"
+#include "database/CircuitBreakerTest.h"
 
 #include "server/RouterTest.h"
+#include "server/TlsSessionManagerTest.h"
+#include "server/TlsStreamTest.h"
+#include "server/RequestProcessorTest.h"
+#include "server/Http2SessionTest.h"
+#include "server/ListenerTest.h"
+#include "server/UploadFileTest.h"
+#include "server/TimerWheelTest.h"
+#include "server/ConnectionLimiterTest.h"
+#include "server/RateLimiterTest.h"
+#include "server/LoadShedderTest.h"
+
+#include "storage/AttachmentStoreTest.h"
 
 #include "handlers/AuthHandlersTest.h"
 #include "handlers/UserHandlersTest.h"
 #include "handlers/MessageHandlersTest.h"
+#include "handlers/BatchHandlersTest.h"
+#include "handlers/AttachmentHandlersTest.h"
 
 int main(int argc, char** argv)
 {
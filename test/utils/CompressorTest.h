@@ -0,0 +1,160 @@
+#ifndef COMPRESSOR_TEST_H
+#define COMPRESSOR_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "utils/Compressor.h"
+
+namespace utils
+{
+class CompressorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            payload_ += R"({"message_id":")" + std::to_string(i) + R"(","from_login":"alice","to_login":"bob","message":"Hello, Bob!"},)";
+        }
+    }
+
+    std::string payload_;
+};
+
+TEST_F(CompressorTest, Negotiate_EmptyHeader_ReturnsIdentity)
+{
+    EXPECT_EQ(Compressor::negotiate(""), ContentEncoding::Identity);
+}
+
+TEST_F(CompressorTest, Negotiate_GzipAndDeflate_PrefersGzip)
+{
+    EXPECT_EQ(Compressor::negotiate("deflate, gzip"), ContentEncoding::Gzip);
+}
+
+TEST_F(CompressorTest, Negotiate_QValues_PicksHighest)
+{
+    EXPECT_EQ(Compressor::negotiate("gzip;q=0.5, deflate;q=0.8"), ContentEncoding::Deflate);
+    EXPECT_EQ(Compressor::negotiate("GZIP ; Q=1.0, deflate;q=0.8"), ContentEncoding::Gzip);
+}
+
+TEST_F(CompressorTest, Negotiate_ZeroQValue_ExcludesCoding)
+{
+    EXPECT_EQ(Compressor::negotiate("gzip;q=0, deflate"), ContentEncoding::Deflate);
+    EXPECT_EQ(Compressor::negotiate("gzip;q=0"), ContentEncoding::Identity);
+}
+
+TEST_F(CompressorTest, Negotiate_Wildcard_AppliesToUnlistedCodings)
+{
+    EXPECT_EQ(Compressor::negotiate("*"), Compressor::negotiate("br, gzip, deflate"));
+    EXPECT_EQ(Compressor::negotiate("gzip;q=0, br;q=0, *"), ContentEncoding::Deflate);
+    EXPECT_EQ(Compressor::negotiate("*;q=0"), ContentEncoding::Identity);
+}
+
+TEST_F(CompressorTest, Negotiate_UnsupportedCoding_ReturnsIdentity)
+{
+    EXPECT_EQ(Compressor::negotiate("zstd, compress"), ContentEncoding::Identity);
+}
+
+TEST_F(CompressorTest, FromString_KnownAndUnknownCodings)
+{
+    auto encoding{ ContentEncoding::Identity };
+
+    EXPECT_TRUE(Compressor::fromString("GZIP", encoding));
+    EXPECT_EQ(encoding, ContentEncoding::Gzip);
+
+    EXPECT_TRUE(Compressor::fromString("deflate", encoding));
+    EXPECT_EQ(encoding, ContentEncoding::Deflate);
+
+    EXPECT_TRUE(Compressor::fromString("identity", encoding));
+    EXPECT_EQ(encoding, ContentEncoding::Identity);
+
+    EXPECT_FALSE(Compressor::fromString("zstd", encoding));
+}
+
+TEST_F(CompressorTest, CompressDecompress_Gzip_RoundTrip)
+{
+    std::string compressed{};
+    ASSERT_TRUE(Compressor::compress(payload_, ContentEncoding::Gzip, 6, compressed));
+    EXPECT_LT(compressed.size(), payload_.size() / 5);
+
+    // gzip magic bytes
+    ASSERT_GE(compressed.size(), 2u);
+    EXPECT_EQ(static_cast<unsigned char>(compressed[0]), 0x1f);
+    EXPECT_EQ(static_cast<unsigned char>(compressed[1]), 0x8b);
+
+    std::string decompressed{};
+    ASSERT_TRUE(Compressor::decompress(compressed, ContentEncoding::Gzip, payload_.size(), decompressed));
+    EXPECT_EQ(decompressed, payload_);
+}
+
+TEST_F(CompressorTest, CompressDecompress_Deflate_RoundTrip)
+{
+    std::string compressed{};
+    ASSERT_TRUE(Compressor::compress(payload_, ContentEncoding::Deflate, 1, compressed));
+
+    std::string decompressed{};
+    ASSERT_TRUE(Compressor::decompress(compressed, ContentEncoding::Deflate, payload_.size(), decompressed));
+    EXPECT_EQ(decompressed, payload_);
+}
+
+TEST_F(CompressorTest, Compress_ReusedStreamWithDifferentLevels_ProducesValidOutput)
+{
+    for (const auto level : { 1, 9, 6, 6, 1 })
+    {
+        std::string compressed{};
+        ASSERT_TRUE(Compressor::compress(payload_, ContentEncoding::Gzip, level, compressed));
+
+        std::string decompressed{};
+        ASSERT_TRUE(Compressor::decompress(compressed, ContentEncoding::Gzip, payload_.size(), decompressed));
+        EXPECT_EQ(decompressed, payload_);
+    }
+}
+
+TEST_F(CompressorTest, Decompress_ExceedsMaxSize_ReturnsFalse)
+{
+    std::string compressed{};
+    ASSERT_TRUE(Compressor::compress(payload_, ContentEncoding::Gzip, 6, compressed));
+
+    std::string decompressed{};
+    EXPECT_FALSE(Compressor::decompress(compressed, ContentEncoding::Gzip, payload_.size() - 1, decompressed));
+    EXPECT_TRUE(decompressed.empty());
+}
+
+TEST_F(CompressorTest, Decompress_MalformedOrTruncatedData_ReturnsFalse)
+{
+    std::string decompressed{};
+    EXPECT_FALSE(Compressor::decompress("not compressed at all", ContentEncoding::Gzip, 1024, decompressed));
+
+    std::string compressed{};
+    ASSERT_TRUE(Compressor::compress(payload_, ContentEncoding::Gzip, 6, compressed));
+    compressed.resize(compressed.size() / 2);
+
+    EXPECT_FALSE(Compressor::decompress(compressed, ContentEncoding::Gzip, payload_.size(), decompressed));
+
+    // the thread-local stream is still usable after a failure
+    ASSERT_TRUE(Compressor::compress(payload_, ContentEncoding::Gzip, 6, compressed));
+    EXPECT_TRUE(Compressor::decompress(compressed, ContentEncoding::Gzip, payload_.size(), decompressed));
+}
+
+#ifdef NOVA_CHAT_WITH_BROTLI
+TEST_F(CompressorTest, CompressDecompress_Brotli_RoundTrip)
+{
+    EXPECT_EQ(Compressor::negotiate("gzip, deflate, br"), ContentEncoding::Brotli);
+
+    std::string compressed{};
+    ASSERT_TRUE(Compressor::compress(payload_, ContentEncoding::Brotli, 6, compressed));
+
+    std::string decompressed{};
+    ASSERT_TRUE(Compressor::decompress(compressed, ContentEncoding::Brotli, payload_.size(), decompressed));
+    EXPECT_EQ(decompressed, payload_);
+}
+#endif
+
+TEST_F(CompressorTest, Compress_Identity_ReturnsFalse)
+{
+    std::string output{};
+    EXPECT_FALSE(Compressor::compress(payload_, ContentEncoding::Identity, 6, output));
+}
+}
+
+#endif // COMPRESSOR_TEST_H
@@ -0,0 +1,102 @@
+#ifndef DEADLINE_TEST_H
+#define DEADLINE_TEST_H
+
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "utils/Deadline.h"
+
+namespace utils
+{
+TEST(DeadlineTest, DefaultConstructed_NeverExpires)
+{
+    Deadline deadline{};
+
+    EXPECT_FALSE(deadline.hasLimit());
+    EXPECT_FALSE(deadline.isExpired());
+    EXPECT_EQ(deadline.getRemaining(), std::chrono::steady_clock::duration::max());
+    EXPECT_EQ(deadline.getBudget(), std::chrono::steady_clock::duration::zero());
+
+    // nothing to cancel
+    deadline.cancel();
+    EXPECT_FALSE(deadline.isCancelled());
+}
+
+TEST(DeadlineTest, Budget_ExpiresAfterBudget)
+{
+    const Deadline deadline{ std::chrono::milliseconds{ 20 } };
+
+    EXPECT_TRUE(deadline.hasLimit());
+    EXPECT_EQ(deadline.getBudget(), std::chrono::milliseconds{ 20 });
+    EXPECT_FALSE(deadline.isExpired());
+    EXPECT_LE(deadline.getRemaining(), std::chrono::milliseconds{ 20 });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 30 });
+
+    EXPECT_TRUE(deadline.isExpired());
+    EXPECT_EQ(deadline.getRemaining(), std::chrono::steady_clock::duration::zero());
+}
+
+TEST(DeadlineTest, Cancel_RunsHandlersOnceForAllCopies)
+{
+    const Deadline deadline{ std::chrono::seconds{ 5 } };
+    auto copy{ deadline };
+
+    int calls{ 0 };
+    const auto registration{ deadline.onCancel([&calls]() { ++calls; }) };
+
+    copy.cancel();
+    copy.cancel();
+
+    EXPECT_TRUE(deadline.isCancelled());
+    EXPECT_EQ(calls, 1);
+
+    // a handler registered after the cancellation runs at once
+    const auto late{ deadline.onCancel([&calls]() { ++calls; }) };
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(DeadlineTest, CancelRegistration_Reset_UnregistersHandler)
+{
+    Deadline deadline{ std::chrono::seconds{ 5 } };
+
+    int calls{ 0 };
+    auto registration{ deadline.onCancel([&calls]() { ++calls; }) };
+    {
+        const auto scoped{ deadline.onCancel([&calls]() { calls += 10; }) };
+    }
+
+    registration.reset();
+    deadline.cancel();
+
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(DeadlineTest, DeadlineScope_NestsPerThread)
+{
+    EXPECT_EQ(DeadlineScope::getCurrent(), nullptr);
+
+    const Deadline outer{ std::chrono::seconds{ 5 } };
+    const Deadline inner{ std::chrono::seconds{ 1 } };
+    {
+        const DeadlineScope outerScope{ outer };
+        EXPECT_EQ(DeadlineScope::getCurrent(), &outer);
+
+        {
+            const DeadlineScope innerScope{ inner };
+            EXPECT_EQ(DeadlineScope::getCurrent(), &inner);
+
+            // other threads do not see the deadline
+            const Deadline* other{ &outer };
+            std::thread{ [&other]() { other = DeadlineScope::getCurrent(); } }.join();
+            EXPECT_EQ(other, nullptr);
+        }
+
+        EXPECT_EQ(DeadlineScope::getCurrent(), &outer);
+    }
+
+    EXPECT_EQ(DeadlineScope::getCurrent(), nullptr);
+}
+}
+
+#endif // DEADLINE_TEST_H
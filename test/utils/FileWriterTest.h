@@ -0,0 +1,89 @@
+#ifndef FILE_WRITER_TEST_H
+#define FILE_WRITER_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "utils/FileWriter.h"
+#include "utils/UUIDUtils.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace utils
+{
+class FileWriterTest : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        std::filesystem::remove(path_);
+    }
+
+    std::string readFile() const
+    {
+        std::ifstream file{ path_, std::ios::binary };
+        std::stringstream content{};
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    const std::filesystem::path path_{ std::filesystem::temp_directory_path() / ("file_writer_test_" + UUIDUtils::generateUUID()) };
+};
+
+TEST_F(FileWriterTest, Write_ManyWrites_KeepOrder)
+{
+    FileWriter writer{};
+    ASSERT_TRUE(writer.open(path_, true));
+    EXPECT_EQ(writer.isIoUringEnabled(), FileWriter::isIoUringSupported());
+
+    // more writes than the ring has entries
+    std::string expected{};
+    for (auto i{ 0 }; i < 500; ++i)
+    {
+        const auto line{ "line " + std::to_string(i) + "\n" };
+        ASSERT_TRUE(writer.write(line));
+        expected += line;
+    }
+
+    EXPECT_EQ(writer.getSize(), expected.size());
+
+    writer.flush();
+    EXPECT_EQ(readFile(), expected);
+
+    EXPECT_TRUE(writer.close());
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_EQ(readFile(), expected);
+}
+
+TEST_F(FileWriterTest, Open_AppendOrTruncate)
+{
+    std::ofstream{ path_, std::ios::binary } << "existing\n";
+
+    FileWriter writer{};
+    ASSERT_TRUE(writer.open(path_, false));
+    EXPECT_EQ(writer.getSize(), 9u);
+    ASSERT_TRUE(writer.write("appended\n"));
+    ASSERT_TRUE(writer.close());
+    EXPECT_EQ(readFile(), "existing\nappended\n");
+
+    ASSERT_TRUE(writer.open(path_, true));
+    EXPECT_EQ(writer.getSize(), 0u);
+    ASSERT_TRUE(writer.write("new"));
+    ASSERT_TRUE(writer.close());
+    EXPECT_EQ(readFile(), "new");
+}
+
+TEST_F(FileWriterTest, InvalidUse_ReturnsFalse)
+{
+    FileWriter writer{};
+    EXPECT_FALSE(writer.write("data"));
+    EXPECT_FALSE(writer.close());
+    EXPECT_FALSE(writer.open(path_.parent_path() / "missing_directory" / "file", true));
+
+    ASSERT_TRUE(writer.open(path_, true));
+    EXPECT_FALSE(writer.open(path_, true));
+    EXPECT_TRUE(writer.write(""));
+}
+}
+
+#endif // FILE_WRITER_TEST_H
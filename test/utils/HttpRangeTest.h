@@ -0,0 +1,70 @@
+#ifndef HTTP_RANGE_TEST_H
+#define HTTP_RANGE_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "utils/HttpRange.h"
+
+namespace utils
+{
+TEST(HttpRangeTest, Parse_NoOrUnsupportedRange_ReturnsNone)
+{
+    ByteRange range{};
+
+    EXPECT_EQ(HttpRange::parse("", 100, range), RangeStatus::None);
+    EXPECT_EQ(HttpRange::parse("items=0-10", 100, range), RangeStatus::None);
+    EXPECT_EQ(HttpRange::parse("bytes=0-10,20-30", 100, range), RangeStatus::None);
+    EXPECT_EQ(HttpRange::parse("bytes=abc", 100, range), RangeStatus::None);
+    EXPECT_EQ(HttpRange::parse("bytes=10-5", 100, range), RangeStatus::None);
+    EXPECT_EQ(HttpRange::parse("bytes=-", 100, range), RangeStatus::None);
+}
+
+TEST(HttpRangeTest, Parse_ClosedRange_ClampsToSize)
+{
+    ByteRange range{};
+
+    ASSERT_EQ(HttpRange::parse("bytes=0-9", 100, range), RangeStatus::Satisfiable);
+    EXPECT_EQ(range.first, 0u);
+    EXPECT_EQ(range.last, 9u);
+    EXPECT_EQ(range.length(), 10u);
+
+    ASSERT_EQ(HttpRange::parse("bytes=90-1000", 100, range), RangeStatus::Satisfiable);
+    EXPECT_EQ(range.first, 90u);
+    EXPECT_EQ(range.last, 99u);
+}
+
+TEST(HttpRangeTest, Parse_OpenAndSuffixRanges)
+{
+    ByteRange range{};
+
+    ASSERT_EQ(HttpRange::parse("bytes=50-", 100, range), RangeStatus::Satisfiable);
+    EXPECT_EQ(range.first, 50u);
+    EXPECT_EQ(range.last, 99u);
+
+    ASSERT_EQ(HttpRange::parse("bytes=-10", 100, range), RangeStatus::Satisfiable);
+    EXPECT_EQ(range.first, 90u);
+    EXPECT_EQ(range.last, 99u);
+
+    // a suffix longer than the representation selects all of it
+    ASSERT_EQ(HttpRange::parse("bytes=-500", 100, range), RangeStatus::Satisfiable);
+    EXPECT_EQ(range.first, 0u);
+    EXPECT_EQ(range.last, 99u);
+}
+
+TEST(HttpRangeTest, Parse_OutsideRepresentation_ReturnsUnsatisfiable)
+{
+    ByteRange range{};
+
+    EXPECT_EQ(HttpRange::parse("bytes=100-", 100, range), RangeStatus::Unsatisfiable);
+    EXPECT_EQ(HttpRange::parse("bytes=200-300", 100, range), RangeStatus::Unsatisfiable);
+    EXPECT_EQ(HttpRange::parse("bytes=-0", 100, range), RangeStatus::Unsatisfiable);
+}
+
+TEST(HttpRangeTest, ContentRange_Formatting)
+{
+    EXPECT_EQ(HttpRange::toContentRange({ 0, 9 }, 100), "bytes 0-9/100");
+    EXPECT_EQ(HttpRange::toUnsatisfiedContentRange(100), "bytes */100");
+}
+}
+
+#endif // HTTP_RANGE_TEST_H
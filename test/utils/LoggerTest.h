@@ -40,6 +40,9 @@ protected:
 
     std::string readFileContent(const std::string& filepath)
 	{
+        // writes through io_uring may still be in flight
+        Logger::getInstance().flush();
+
         std::ifstream file{ filepath };
         if (!file.is_open()) 
         {
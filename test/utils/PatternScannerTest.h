@@ -0,0 +1,60 @@
+#ifndef PATTERN_SCANNER_TEST_H
+#define PATTERN_SCANNER_TEST_H
+
+#include <gtest/gtest.h>
+#include <array>
+#include <stdexcept>
+
+#include "utils/PatternScanner.h"
+
+namespace utils
+{
+TEST(PatternScannerTest, Contains_IgnoresAsciiCase)
+{
+    constexpr std::array<ScanPattern, 2> patterns{ { { "<script" }, { "eval(" } } };
+    const PatternScanner scanner{ patterns };
+
+    EXPECT_TRUE(scanner.contains("<ScRiPt>alert(1)</script>"));
+    EXPECT_TRUE(scanner.contains("x = EVAL(y)"));
+    EXPECT_FALSE(scanner.contains("<scrip t>"));
+    EXPECT_FALSE(scanner.contains("evaluate"));
+    EXPECT_FALSE(scanner.contains(""));
+}
+
+TEST(PatternScannerTest, Contains_FindsOverlappingPatterns)
+{
+    // "he" is a suffix of "she" and "hers" starts inside "she"
+    constexpr std::array<ScanPattern, 3> patterns{ { { "he" }, { "she" }, { "hers" } } };
+    const PatternScanner scanner{ patterns };
+
+    EXPECT_TRUE(scanner.contains("ushers"));
+    EXPECT_TRUE(scanner.contains("sHe"));
+    EXPECT_FALSE(scanner.contains("h e r s"));
+}
+
+TEST(PatternScannerTest, Contains_WholeWordNeedsBoundaries)
+{
+    constexpr std::array<ScanPattern, 3> patterns{ { { "OR", true }, { "ORDER", true }, { "--" } } };
+    const PatternScanner scanner{ patterns };
+
+    EXPECT_TRUE(scanner.contains("or"));
+    EXPECT_TRUE(scanner.contains("' or '1'='1"));
+    EXPECT_TRUE(scanner.contains("x=1 ORDER"));
+    EXPECT_TRUE(scanner.contains("admin'--"));
+
+    EXPECT_FALSE(scanner.contains("ordinary"));
+    EXPECT_FALSE(scanner.contains("color"));
+    EXPECT_FALSE(scanner.contains("or_"));
+    EXPECT_FALSE(scanner.contains("orders"));
+    EXPECT_FALSE(scanner.contains("border9"));
+}
+
+TEST(PatternScannerTest, Constructor_EmptyPattern_Throws)
+{
+    constexpr std::array<ScanPattern, 2> patterns{ { { "a" }, { "" } } };
+
+    EXPECT_THROW({ const PatternScanner scanner{ patterns }; }, std::invalid_argument);
+}
+}
+
+#endif // PATTERN_SCANNER_TEST_H
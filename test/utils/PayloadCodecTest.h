@@ -0,0 +1,113 @@
+#ifndef PAYLOAD_CODEC_TEST_H
+#define PAYLOAD_CODEC_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "utils/PayloadCodec.h"
+
+namespace utils
+{
+TEST(PayloadCodecTest, FromContentType_SupportedMediaTypes)
+{
+    auto format{ PayloadFormat::Json };
+
+    EXPECT_TRUE(PayloadCodec::fromContentType("application/json; charset=utf-8", format));
+    EXPECT_EQ(format, PayloadFormat::Json);
+
+    EXPECT_TRUE(PayloadCodec::fromContentType("application/msgpack", format));
+    EXPECT_EQ(format, PayloadFormat::MessagePack);
+
+    EXPECT_TRUE(PayloadCodec::fromContentType("Application/X-MsgPack", format));
+    EXPECT_EQ(format, PayloadFormat::MessagePack);
+
+    EXPECT_TRUE(PayloadCodec::fromContentType("application/cbor", format));
+    EXPECT_EQ(format, PayloadFormat::Cbor);
+}
+
+TEST(PayloadCodecTest, FromContentType_UnsupportedMediaTypes)
+{
+    auto format{ PayloadFormat::Json };
+
+    EXPECT_FALSE(PayloadCodec::fromContentType("", format));
+    EXPECT_FALSE(PayloadCodec::fromContentType("text/plain", format));
+    EXPECT_FALSE(PayloadCodec::fromContentType("application/jsonp", format));
+}
+
+TEST(PayloadCodecTest, Negotiate_EmptyOrWildcard_ReturnsJson)
+{
+    EXPECT_EQ(PayloadCodec::negotiate(""), PayloadFormat::Json);
+    EXPECT_EQ(PayloadCodec::negotiate("*/*"), PayloadFormat::Json);
+    EXPECT_EQ(PayloadCodec::negotiate("text/html"), PayloadFormat::Json);
+}
+
+TEST(PayloadCodecTest, Negotiate_ExplicitType_WinsOverWildcard)
+{
+    EXPECT_EQ(PayloadCodec::negotiate("*/*, application/cbor"), PayloadFormat::Cbor);
+    EXPECT_EQ(PayloadCodec::negotiate("application/msgpack"), PayloadFormat::MessagePack);
+}
+
+TEST(PayloadCodecTest, Negotiate_QValues_PicksHighest)
+{
+    EXPECT_EQ(PayloadCodec::negotiate("application/json;q=0.5, application/msgpack;q=0.9"), PayloadFormat::MessagePack);
+    EXPECT_EQ(PayloadCodec::negotiate("application/msgpack;q=0, application/json"), PayloadFormat::Json);
+}
+
+TEST(PayloadCodecTest, Negotiate_EqualQValues_FirstListedWins)
+{
+    EXPECT_EQ(PayloadCodec::negotiate("application/msgpack, application/json"), PayloadFormat::MessagePack);
+    EXPECT_EQ(PayloadCodec::negotiate("application/json, application/msgpack"), PayloadFormat::Json);
+}
+
+TEST(PayloadCodecTest, EncodeDecode_AllFormats_RoundTrip)
+{
+    const nlohmann::json value{ { "status", "success" }, { "data", { { "count", 2 }, { "logins", { "alice", "bob" } } } } };
+
+    for (const auto format : { PayloadFormat::Json, PayloadFormat::MessagePack, PayloadFormat::Cbor })
+    {
+        const auto body{ PayloadCodec::encode(value, format) };
+
+        nlohmann::json decoded{};
+        ASSERT_TRUE(PayloadCodec::decode(body, format, decoded));
+        EXPECT_EQ(decoded, value);
+    }
+}
+
+TEST(PayloadCodecTest, Encode_BinaryFormats_AreSmallerThanJson)
+{
+    const nlohmann::json value{ { "message_id", "0b7d1f2e-8e4a-4c1b-9a3e-5f6d7c8b9a01" }, { "is_read", false }, { "timestamp", 1700000000 } };
+    const auto json{ PayloadCodec::encode(value, PayloadFormat::Json) };
+
+    EXPECT_LT(PayloadCodec::encode(value, PayloadFormat::MessagePack).size(), json.size());
+    EXPECT_LT(PayloadCodec::encode(value, PayloadFormat::Cbor).size(), json.size());
+}
+
+TEST(PayloadCodecTest, Decode_InvalidBody_ReturnsFalse)
+{
+    nlohmann::json decoded{};
+
+    EXPECT_FALSE(PayloadCodec::decode("", PayloadFormat::Json, decoded));
+    EXPECT_FALSE(PayloadCodec::decode("{invalid", PayloadFormat::Json, decoded));
+    EXPECT_FALSE(PayloadCodec::decode("\xc1", PayloadFormat::MessagePack, decoded)); // 0xc1 is never used in MessagePack
+    EXPECT_FALSE(PayloadCodec::decode("\xff", PayloadFormat::Cbor, decoded));
+}
+
+TEST(PayloadCodecTest, Decode_InvalidUtf8_ReturnsFalse)
+{
+    const nlohmann::json value{ { "message", "\xC3\xA9t\xC3\xA9" }, { "items", { "ok", "\xE2\x82\xAC" } } };
+    const nlohmann::json invalid{ { "message", "ok" }, { "items", { "ok", std::string{ "\xED\xA0\x80" } } } };
+    const nlohmann::json invalidKey{ { std::string{ "\xFF" }, 1 } };
+
+    for (const auto format : { PayloadFormat::MessagePack, PayloadFormat::Cbor })
+    {
+        nlohmann::json decoded{};
+        EXPECT_TRUE(PayloadCodec::decode(PayloadCodec::encode(value, format), format, decoded));
+        EXPECT_FALSE(PayloadCodec::decode(PayloadCodec::encode(invalid, format), format, decoded));
+        EXPECT_FALSE(PayloadCodec::decode(PayloadCodec::encode(invalidKey, format), format, decoded));
+    }
+
+    nlohmann::json decoded{};
+    EXPECT_FALSE(PayloadCodec::decode("{\"message\": \"\xED\xA0\x80\"}", PayloadFormat::Json, decoded));
+}
+}
+
+#endif // PAYLOAD_CODEC_TEST_H
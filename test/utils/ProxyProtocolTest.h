@@ -0,0 +1,123 @@
+#ifndef PROXY_PROTOCOL_TEST_H
+#define PROXY_PROTOCOL_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "utils/ProxyProtocol.h"
+
+#include <string>
+
+namespace utils
+{
+// builds a version 2 header from its command, family and address block
+inline std::string makeProxyV2Header(uint8_t command, uint8_t family, const std::string& addresses)
+{
+    std::string header{ "\r\n\r\n\0\r\nQUIT\n", 12 };
+    header += static_cast<char>(0x20 | command);
+    header += static_cast<char>(family);
+    header += static_cast<char>(addresses.size() >> 8);
+    header += static_cast<char>(addresses.size() & 0xFF);
+    return header + addresses;
+}
+
+TEST(ProxyProtocolTest, Parse_Version1Tcp4_ReturnsSourceAndSize)
+{
+    const std::string line{ "PROXY TCP4 203.0.113.7 10.0.0.1 51000 443\r\n" };
+    ProxyHeader header{};
+
+    ASSERT_EQ(ProxyProtocol::parse(line + "GET / HTTP/1.1\r\n", header), ProxyStatus::Complete);
+    EXPECT_EQ(header.size, line.size());
+    ASSERT_TRUE(header.source);
+    EXPECT_EQ(header.source->address().to_string(), "203.0.113.7");
+    EXPECT_EQ(header.source->port(), 51000);
+}
+
+TEST(ProxyProtocolTest, Parse_Version1Tcp6AndUnknown)
+{
+    ProxyHeader header{};
+
+    ASSERT_EQ(ProxyProtocol::parse("PROXY TCP6 2001:db8::1 2001:db8::2 443 8443\r\n", header), ProxyStatus::Complete);
+    ASSERT_TRUE(header.source);
+    EXPECT_EQ(header.source->address().to_string(), "2001:db8::1");
+    EXPECT_EQ(header.source->port(), 443);
+
+    ASSERT_EQ(ProxyProtocol::parse("PROXY UNKNOWN\r\n", header), ProxyStatus::Complete);
+    EXPECT_EQ(header.size, 15u);
+    EXPECT_FALSE(header.source);
+}
+
+TEST(ProxyProtocolTest, Parse_Version1Malformed_ReturnsInvalid)
+{
+    ProxyHeader header{};
+
+    EXPECT_EQ(ProxyProtocol::parse("PROXY TCP4 203.0.113.7 10.0.0.1 51000\r\n", header), ProxyStatus::Invalid);
+    EXPECT_EQ(ProxyProtocol::parse("PROXY TCP4 2001:db8::1 10.0.0.1 51000 443\r\n", header), ProxyStatus::Invalid);
+    EXPECT_EQ(ProxyProtocol::parse("PROXY TCP4 203.0.113.7 10.0.0.1 65536 443\r\n", header), ProxyStatus::Invalid);
+    EXPECT_EQ(ProxyProtocol::parse("PROXY TCP4 203.0.113.7 10.0.0.1 051000 443\r\n", header), ProxyStatus::Invalid);
+    EXPECT_EQ(ProxyProtocol::parse("PROXY UDP4 203.0.113.7 10.0.0.1 51000 443\r\n", header), ProxyStatus::Invalid);
+    EXPECT_EQ(ProxyProtocol::parse("PROXY " + std::string(200, 'x'), header), ProxyStatus::Invalid);
+}
+
+TEST(ProxyProtocolTest, Parse_Version2Inet_ReturnsSourceAndSkipsTlvs)
+{
+    // source 192.0.2.10:8080, destination 10.0.0.1:443, followed by a 4-byte TLV
+    const std::string addresses{ "\xC0\x00\x02\x0A\x0A\x00\x00\x01\x1F\x90\x01\xBB\x04\x00\x01\x00", 16 };
+    const auto data{ makeProxyV2Header(0x1, 0x11, addresses) };
+    ProxyHeader header{};
+
+    ASSERT_EQ(ProxyProtocol::parse(data + "\x16\x03\x01", header), ProxyStatus::Complete);
+    EXPECT_EQ(header.size, data.size());
+    ASSERT_TRUE(header.source);
+    EXPECT_EQ(header.source->address().to_string(), "192.0.2.10");
+    EXPECT_EQ(header.source->port(), 8080);
+}
+
+TEST(ProxyProtocolTest, Parse_Version2Inet6AndLocal)
+{
+    std::string addresses(36, '\0');
+    addresses[0] = '\x20';
+    addresses[1] = '\x01';
+    addresses[15] = '\x05';
+    addresses[32] = '\x01';
+    addresses[33] = '\xBB';
+    ProxyHeader header{};
+
+    ASSERT_EQ(ProxyProtocol::parse(makeProxyV2Header(0x1, 0x21, addresses), header), ProxyStatus::Complete);
+    ASSERT_TRUE(header.source);
+    EXPECT_EQ(header.source->address().to_string(), "2001::5");
+    EXPECT_EQ(header.source->port(), 443);
+
+    // health checks of the balancer itself
+    ASSERT_EQ(ProxyProtocol::parse(makeProxyV2Header(0x0, 0x00, ""), header), ProxyStatus::Complete);
+    EXPECT_EQ(header.size, 16u);
+    EXPECT_FALSE(header.source);
+}
+
+TEST(ProxyProtocolTest, Parse_Version2Malformed_ReturnsInvalid)
+{
+    ProxyHeader header{};
+
+    // wrong version, unknown command, address block too short for the family, header too large
+    auto data{ makeProxyV2Header(0x1, 0x11, std::string(12, '\0')) };
+    data[12] = '\x11';
+    EXPECT_EQ(ProxyProtocol::parse(data, header), ProxyStatus::Invalid);
+    EXPECT_EQ(ProxyProtocol::parse(makeProxyV2Header(0x2, 0x11, std::string(12, '\0')), header), ProxyStatus::Invalid);
+    EXPECT_EQ(ProxyProtocol::parse(makeProxyV2Header(0x1, 0x11, std::string(8, '\0')), header), ProxyStatus::Invalid);
+    EXPECT_EQ(ProxyProtocol::parse(makeProxyV2Header(0x1, 0x11, std::string(ProxyProtocol::MAX_HEADER_SIZE, '\0')), header), ProxyStatus::Invalid);
+}
+
+TEST(ProxyProtocolTest, Parse_PartialOrForeignData)
+{
+    ProxyHeader header{};
+
+    EXPECT_EQ(ProxyProtocol::parse("", header), ProxyStatus::Incomplete);
+    EXPECT_EQ(ProxyProtocol::parse("PRO", header), ProxyStatus::Incomplete);
+    EXPECT_EQ(ProxyProtocol::parse("PROXY TCP4 203.0.113.7", header), ProxyStatus::Incomplete);
+    EXPECT_EQ(ProxyProtocol::parse(makeProxyV2Header(0x1, 0x11, std::string(12, '\0')).substr(0, 20), header), ProxyStatus::Incomplete);
+
+    EXPECT_EQ(ProxyProtocol::parse("GET / HTTP/1.1\r\n", header), ProxyStatus::Invalid);
+    EXPECT_EQ(ProxyProtocol::parse(std::string_view{ "\x16\x03\x01\x02\x00", 5 }, header), ProxyStatus::Invalid);
+}
+}
+
+#endif // PROXY_PROTOCOL_TEST_H
@@ -0,0 +1,64 @@
+#ifndef UTF8_TEST_H
+#define UTF8_TEST_H
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "utils/Utf8.h"
+
+namespace utils
+{
+TEST(Utf8Test, CountCodePoints_ValidText_CountsCharacters)
+{
+    size_t count{ 0 };
+
+    EXPECT_TRUE(Utf8::countCodePoints("", count));
+    EXPECT_EQ(count, 0u);
+
+    EXPECT_TRUE(Utf8::countCodePoints("hello", count));
+    EXPECT_EQ(count, 5u);
+
+    // 2, 3 and 4 byte sequences: é, €, 😀
+    EXPECT_TRUE(Utf8::countCodePoints("\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", count));
+    EXPECT_EQ(count, 3u);
+
+    // boundaries of the ranges: U+007F, U+0080, U+07FF, U+0800, U+D7FF, U+E000, U+FFFF, U+10000, U+10FFFF
+    EXPECT_TRUE(Utf8::countCodePoints("\x7F\xC2\x80\xDF\xBF\xE0\xA0\x80\xED\x9F\xBF\xEE\x80\x80\xEF\xBF\xBF\xF0\x90\x80\x80\xF4\x8F\xBF\xBF", count));
+    EXPECT_EQ(count, 9u);
+}
+
+TEST(Utf8Test, CountCodePoints_MixedBlocks_CountsEveryCharacter)
+{
+    // ASCII runs longer than a block, split by multibyte characters at every offset
+    for (size_t offset{ 0 }; offset < 40; ++offset)
+    {
+        auto text{ std::string(offset, 'a') + "\xD0\x96" + std::string(70, 'b') + "\xE2\x82\xAC" };
+
+        size_t count{ 0 };
+        ASSERT_TRUE(Utf8::countCodePoints(text, count));
+        EXPECT_EQ(count, offset + 72);
+
+        // a stray continuation byte inside the ASCII run
+        text[offset + 2 + 35] = '\x80';
+        EXPECT_FALSE(Utf8::isValid(text)) << "offset " << offset;
+    }
+}
+
+TEST(Utf8Test, IsValid_IllFormedSequences_ReturnsFalse)
+{
+    EXPECT_FALSE(Utf8::isValid("\x80"));             // lone continuation byte
+    EXPECT_FALSE(Utf8::isValid("\xC0\x80"));         // overlong NUL
+    EXPECT_FALSE(Utf8::isValid("\xC1\xBF"));         // overlong ASCII
+    EXPECT_FALSE(Utf8::isValid("\xE0\x9F\xBF"));     // overlong 3 byte form
+    EXPECT_FALSE(Utf8::isValid("\xED\xA0\x80"));     // surrogate U+D800
+    EXPECT_FALSE(Utf8::isValid("\xF0\x8F\xBF\xBF")); // overlong 4 byte form
+    EXPECT_FALSE(Utf8::isValid("\xF4\x90\x80\x80")); // above U+10FFFF
+    EXPECT_FALSE(Utf8::isValid("\xF5\x80\x80\x80")); // invalid lead byte
+    EXPECT_FALSE(Utf8::isValid("\xFF"));
+    EXPECT_FALSE(Utf8::isValid("abc\xE2\x82"));      // truncated at the end
+    EXPECT_FALSE(Utf8::isValid("\xE2\x28\xA1"));     // ASCII inside a sequence
+    EXPECT_FALSE(Utf8::isValid("\xF0\x9F\x98"));
+}
+}
+
+#endif // UTF8_TEST_H